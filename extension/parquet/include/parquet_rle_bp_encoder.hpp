@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// parquet_rle_bp_encoder.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb.hpp"
+#ifndef DUCKDB_AMALGAMATION
+#include "duckdb/common/serializer.hpp"
+#endif
+
+namespace duckdb {
+
+//! Encodes values with the RLE/bit-packing hybrid encoding of Parquet: runs of at least MINIMUM_RLE_COUNT equal
+//! values are written as RLE runs, all other values are bit-packed in groups of eight
+class RleBpEncoder {
+public:
+	static constexpr const idx_t MINIMUM_RLE_COUNT = 8;
+
+	explicit RleBpEncoder(uint32_t bit_width) : bit_width(bit_width), byte_width((bit_width + 7) / 8) {
+		D_ASSERT(bit_width <= 32);
+	}
+
+	void Encode(Serializer &ser, const uint32_t *values, idx_t count) {
+		idx_t literal_start = 0;
+		idx_t run_start = 0;
+		while (run_start < count) {
+			idx_t run_end = run_start + 1;
+			while (run_end < count && values[run_end] == values[run_start]) {
+				run_end++;
+			}
+			if (run_end - run_start < MINIMUM_RLE_COUNT) {
+				// too short for an RLE run: the values are bit-packed
+				run_start = run_end;
+				continue;
+			}
+			// a bit-packed run can only be padded at the end of the data
+			// so the first values of the RLE run complete the last group of the bit-packed values before it
+			run_start += (8 - (run_start - literal_start) % 8) % 8;
+			WriteBitPacked(ser, values + literal_start, run_start - literal_start);
+			WriteRepeated(ser, values[run_start], run_end - run_start);
+			literal_start = run_start = run_end;
+		}
+		WriteBitPacked(ser, values + literal_start, count - literal_start);
+	}
+
+private:
+	uint32_t bit_width;
+	uint32_t byte_width;
+
+	static void VarintEncode(uint64_t val, Serializer &ser) {
+		do {
+			uint8_t byte = val & 127;
+			val >>= 7;
+			if (val != 0) {
+				byte |= 128;
+			}
+			ser.Write<uint8_t>(byte);
+		} while (val != 0);
+	}
+
+	void WriteRepeated(Serializer &ser, uint32_t value, idx_t count) {
+		// the lsb of the indicator is 0 for RLE runs
+		VarintEncode(count << 1, ser);
+		for (idx_t i = 0; i < byte_width; i++) {
+			ser.Write<uint8_t>((value >> (i * 8)) & 0xFF);
+		}
+	}
+
+	void WriteBitPacked(Serializer &ser, const uint32_t *values, idx_t count) {
+		if (count == 0) {
+			return;
+		}
+		// the lsb of the indicator is 1 for bit-packed runs, which are padded with zeros to groups of eight values
+		auto group_count = (count + 7) / 8;
+		VarintEncode((group_count << 1) | 1, ser);
+		uint64_t buffer = 0;
+		idx_t buffer_bits = 0;
+		for (idx_t i = 0; i < group_count * 8; i++) {
+			uint64_t value = i < count ? values[i] : 0;
+			buffer |= value << buffer_bits;
+			buffer_bits += bit_width;
+			while (buffer_bits >= 8) {
+				ser.Write<uint8_t>(buffer & 0xFF);
+				buffer >>= 8;
+				buffer_bits -= 8;
+			}
+		}
+		D_ASSERT(buffer_bits == 0);
+	}
+};
+
+} // namespace duckdb
@@ -14,6 +14,7 @@
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/mutex.hpp"
 #include "duckdb/common/serializer/buffered_file_writer.hpp"
+#include "duckdb/common/serializer/buffered_serializer.hpp"
 #include "duckdb/common/types/chunk_collection.hpp"
 #endif
 
@@ -24,6 +25,28 @@ namespace duckdb {
 class FileSystem;
 class FileOpener;
 
+//! A page that has been encoded and compressed, but not yet written to the file
+struct PreparedPage {
+	duckdb_parquet::format::PageHeader page_header;
+	unique_ptr<data_t[]> compressed_data;
+	idx_t compressed_size;
+};
+
+//! A column of a row group that has been encoded and compressed, but not yet written to the file
+struct PreparedColumnChunk {
+	//! The amount of entries in the dictionary page, or 0 if the column chunk is not dictionary encoded
+	idx_t dictionary_size = 0;
+	PreparedPage dictionary_page;
+	PreparedPage data_page;
+	duckdb_parquet::format::Statistics statistics;
+};
+
+//! A row group of which all columns have been encoded and compressed
+struct PreparedRowGroup {
+	idx_t num_rows;
+	vector<PreparedColumnChunk> columns;
+};
+
 class ParquetWriter {
 public:
 	ParquetWriter(FileSystem &fs, string file_name, FileOpener *file_opener, vector<LogicalType> types,
@@ -33,6 +56,16 @@ public:
 	void Flush(ChunkCollection &buffer);
 	void Finalize();
 
+private:
+	//! Encodes and compresses the buffer into a row group, this does not require the lock
+	void PrepareRowGroup(ChunkCollection &buffer, PreparedRowGroup &result);
+	//! Writes a prepared row group to the file and adds it to the file meta data
+	void FlushRowGroup(PreparedRowGroup &row_group);
+	//! Compresses the contents of the temp_writer into the page
+	void CompressPage(BufferedSerializer &temp_writer, PreparedPage &page);
+	//! Writes a page to the file, returns its uncompressed size including the page header
+	idx_t WritePage(PreparedPage &page);
+
 private:
 	string file_name;
 	vector<LogicalType> sql_types;
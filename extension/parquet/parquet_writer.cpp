@@ -1,5 +1,6 @@
 #include "parquet_writer.hpp"
 #include "parquet_timestamp.hpp"
+#include "parquet_rle_bp_encoder.hpp"
 
 #include "duckdb.hpp"
 #ifndef DUCKDB_AMALGAMATION
@@ -9,6 +10,8 @@
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/connection.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/operator/comparison_operators.hpp"
+#include "duckdb/common/string_map_set.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types/date.hpp"
 #include "duckdb/common/types/hugeint.hpp"
@@ -196,14 +199,196 @@ struct ParquetHugeintOperator {
 	}
 };
 
+//! Dictionaries that grow larger than this are abandoned, and the column chunk is written as PLAIN values instead
+static constexpr idx_t PARQUET_MAX_DICTIONARY_SIZE = 1048576;
+
+template <class T>
+struct ParquetDictionaryMap {
+	using type = unordered_map<T, uint32_t>;
+};
+
+template <>
+struct ParquetDictionaryMap<string_t> {
+	using type = string_map_t<uint32_t>;
+};
+
+template <class T>
+static void WritePlainValue(Serializer &ser, const T &value) {
+	ser.Write<T>(value);
+}
+
+static void WritePlainValue(Serializer &ser, const string_t &value) {
+	ser.Write<uint32_t>(value.GetSize());
+	ser.WriteData((const_data_ptr_t)value.GetDataUnsafe(), value.GetSize());
+}
+
+template <class T>
+static idx_t GetPlainSize(const T &value) {
+	return sizeof(T);
+}
+
+static idx_t GetPlainSize(const string_t &value) {
+	return sizeof(uint32_t) + value.GetSize();
+}
+
+template <class T>
+static bool IsOrderedValue(const T &value) {
+	return true;
+}
+
+static bool IsOrderedValue(const float &value) {
+	// NaN values are not part of the min/max statistics
+	return !std::isnan(value);
+}
+
+static bool IsOrderedValue(const double &value) {
+	return !std::isnan(value);
+}
+
+template <class T>
+static string GetStatisticsValue(const T &value) {
+	return string((const char *)&value, sizeof(T));
+}
+
+static string GetStatisticsValue(const string_t &value) {
+	return value.GetString();
+}
+
+static uint8_t GetBitWidth(idx_t max_value) {
+	uint8_t bit_width = 1;
+	while (bit_width < 32 && max_value >= (idx_t(1) << bit_width)) {
+		bit_width++;
+	}
+	return bit_width;
+}
+
+//! Writes the values of a column chunk and gathers its statistics. The values are dictionary encoded if the dictionary
+//! and the indices are smaller than the PLAIN values, in which case the dictionary is written to the dictionary_writer
 template <class SRC, class TGT, class OP = ParquetCastOperator>
-static void TemplatedWritePlain(Vector &col, idx_t length, ValidityMask &mask, Serializer &ser) {
-	auto *ptr = FlatVector::GetData<SRC>(col);
-	for (idx_t r = 0; r < length; r++) {
-		if (mask.RowIsValid(r)) {
-			ser.Write<TGT>(OP::template Operation<SRC, TGT>(ptr[r]));
+static void TemplatedWriteColumn(ChunkCollection &buffer, idx_t col_idx, BufferedSerializer &temp_writer,
+                                 BufferedSerializer &dictionary_writer, PreparedColumnChunk &result) {
+	// floating point values are not dictionary encoded, as this would fold together -0.0 and 0.0
+	bool use_dictionary = !std::is_floating_point<TGT>::value;
+	typename ParquetDictionaryMap<TGT>::type dictionary;
+	vector<TGT> dictionary_values;
+	vector<uint32_t> dictionary_indices;
+	idx_t dictionary_size = 0;
+	idx_t plain_size = 0;
+
+	idx_t null_count = 0;
+	bool has_min_max = false;
+	TGT min_value = TGT();
+	TGT max_value = TGT();
+	for (auto &chunk : buffer.Chunks()) {
+		auto &input = chunk->data[col_idx];
+		auto *ptr = FlatVector::GetData<SRC>(input);
+		auto &mask = FlatVector::Validity(input);
+		for (idx_t r = 0; r < chunk->size(); r++) {
+			if (!mask.RowIsValid(r)) {
+				null_count++;
+				continue;
+			}
+			auto value = OP::template Operation<SRC, TGT>(ptr[r]);
+			if (IsOrderedValue(value)) {
+				if (!has_min_max || LessThan::Operation(value, min_value)) {
+					min_value = value;
+				}
+				if (!has_min_max || GreaterThan::Operation(value, max_value)) {
+					max_value = value;
+				}
+				has_min_max = true;
+			}
+			auto value_size = GetPlainSize(value);
+			plain_size += value_size;
+			if (!use_dictionary) {
+				continue;
+			}
+			auto entry = dictionary.find(value);
+			if (entry == dictionary.end()) {
+				if (dictionary_size + value_size > PARQUET_MAX_DICTIONARY_SIZE) {
+					// the dictionary grows too large: fall back to PLAIN values
+					use_dictionary = false;
+					dictionary.clear();
+					dictionary_values.clear();
+					dictionary_indices.clear();
+					continue;
+				}
+				entry = dictionary.insert(make_pair(value, uint32_t(dictionary_values.size()))).first;
+				dictionary_values.push_back(value);
+				dictionary_size += value_size;
+			}
+			dictionary_indices.push_back(entry->second);
+		}
+	}
+
+	result.statistics.null_count = null_count;
+	result.statistics.__isset.null_count = true;
+	if (has_min_max) {
+		result.statistics.min_value = GetStatisticsValue(min_value);
+		result.statistics.__isset.min_value = true;
+		result.statistics.max_value = GetStatisticsValue(max_value);
+		result.statistics.__isset.max_value = true;
+	}
+
+	if (use_dictionary && !dictionary_values.empty()) {
+		auto bit_width = GetBitWidth(dictionary_values.size() - 1);
+		auto indices_size = (dictionary_indices.size() * bit_width + 7) / 8;
+		if (dictionary_size + indices_size < plain_size) {
+			for (auto &value : dictionary_values) {
+				WritePlainValue(dictionary_writer, value);
+			}
+			result.dictionary_size = dictionary_values.size();
+			// the indices are prefixed with their bit width
+			temp_writer.Write<uint8_t>(bit_width);
+			RleBpEncoder encoder(bit_width);
+			encoder.Encode(temp_writer, dictionary_indices.data(), dictionary_indices.size());
+			return;
+		}
+	}
+
+	for (auto &chunk : buffer.Chunks()) {
+		auto &input = chunk->data[col_idx];
+		auto *ptr = FlatVector::GetData<SRC>(input);
+		auto &mask = FlatVector::Validity(input);
+		for (idx_t r = 0; r < chunk->size(); r++) {
+			if (mask.RowIsValid(r)) {
+				WritePlainValue(temp_writer, OP::template Operation<SRC, TGT>(ptr[r]));
+			}
+		}
+	}
+}
+
+static void WriteBooleanColumn(ChunkCollection &buffer, idx_t col_idx, BufferedSerializer &temp_writer,
+                               PreparedColumnChunk &result) {
+	// booleans are bit-packed PLAIN values, dictionary indices would not be any smaller
+	idx_t null_count = 0;
+	uint8_t byte = 0;
+	uint8_t byte_pos = 0;
+	for (auto &chunk : buffer.Chunks()) {
+		auto &input = chunk->data[col_idx];
+		auto *ptr = FlatVector::GetData<bool>(input);
+		auto &mask = FlatVector::Validity(input);
+		for (idx_t r = 0; r < chunk->size(); r++) {
+			if (mask.RowIsValid(r)) { // only encode if non-null
+				byte |= (ptr[r] & 1) << byte_pos;
+				byte_pos++;
+
+				if (byte_pos == 8) {
+					temp_writer.Write<uint8_t>(byte);
+					byte = 0;
+					byte_pos = 0;
+				}
+			} else {
+				null_count++;
+			}
 		}
 	}
+	// flush last byte if req
+	if (byte_pos > 0) {
+		temp_writer.Write<uint8_t>(byte);
+	}
+	result.statistics.null_count = null_count;
+	result.statistics.__isset.null_count = true;
 }
 
 ParquetWriter::ParquetWriter(FileSystem &fs, string file_name_p, FileOpener *file_opener_p, vector<LogicalType> types_p,
@@ -246,29 +431,28 @@ ParquetWriter::ParquetWriter(FileSystem &fs, string file_name_p, FileOpener *fil
 		schema_element.name = column_names[i];
 		schema_element.__isset.converted_type = DuckDBTypeToConvertedType(sql_types[i], schema_element.converted_type);
 	}
-}
 
-void ParquetWriter::Flush(ChunkCollection &buffer) {
-	if (buffer.Count() == 0) {
-		return;
+	// the min/max statistics of the columns are ordered according to their (logical) type
+	file_meta_data.column_orders.resize(sql_types.size());
+	for (auto &column_order : file_meta_data.column_orders) {
+		column_order.__isset.TYPE_ORDER = true;
 	}
-	lock_guard<mutex> glock(lock);
+	file_meta_data.__isset.column_orders = true;
+}
 
-	// set up a new row group for this chunk collection
-	ParquetRowGroup row_group;
-	row_group.num_rows = 0;
-	row_group.file_offset = writer->GetTotalWritten();
-	row_group.__isset.file_offset = true;
-	row_group.columns.resize(buffer.ColumnCount());
+void ParquetWriter::PrepareRowGroup(ChunkCollection &buffer, PreparedRowGroup &result) {
+	result.num_rows = buffer.Count();
+	result.columns.resize(buffer.ColumnCount());
 
-	// iterate over each of the columns of the chunk collection and write them
+	// iterate over each of the columns of the chunk collection and encode them
 	for (idx_t i = 0; i < buffer.ColumnCount(); i++) {
 		// we start off by writing everything into a temporary buffer
 		// this is necessary to (1) know the total written size, and (2) to compress it afterwards
 		BufferedSerializer temp_writer;
 
 		// set up some metadata
-		PageHeader hdr;
+		auto &column = result.columns[i];
+		auto &hdr = column.data_page.page_header;
 		hdr.compressed_page_size = 0;
 		hdr.uncompressed_page_size = 0;
 		hdr.type = PageType::DATA_PAGE;
@@ -278,12 +462,6 @@ void ParquetWriter::Flush(ChunkCollection &buffer) {
 		hdr.data_page_header.encoding = Encoding::PLAIN;
 		hdr.data_page_header.definition_level_encoding = Encoding::RLE;
 		hdr.data_page_header.repetition_level_encoding = Encoding::BIT_PACKED;
-		// hdr.data_page_header.statistics.__isset.max
-		// hdr.data_page_header.statistics.max
-
-		// record the current offset of the writer into the file
-		// this is the starting position of the current page
-		auto start_offset = writer->GetTotalWritten();
 
 		// write the definition levels (i.e. the inverse of the nullmask)
 		// we always bit pack everything
@@ -312,165 +490,202 @@ void ParquetWriter::Flush(ChunkCollection &buffer) {
 			}
 		}
 
-		// now write the actual payload: we write this as PLAIN values (for now? possibly for ever?)
-		for (auto &chunk : buffer.Chunks()) {
-			auto &input = *chunk;
-			auto &input_column = input.data[i];
-			auto &mask = FlatVector::Validity(input_column);
-
-			// write actual payload data
-			switch (sql_types[i].id()) {
-			case LogicalTypeId::BOOLEAN: {
-				auto *ptr = FlatVector::GetData<bool>(input_column);
-				uint8_t byte = 0;
-				uint8_t byte_pos = 0;
-				for (idx_t r = 0; r < input.size(); r++) {
-					if (mask.RowIsValid(r)) { // only encode if non-null
-						byte |= (ptr[r] & 1) << byte_pos;
-						byte_pos++;
-
-						if (byte_pos == 8) {
-							temp_writer.Write<uint8_t>(byte);
-							byte = 0;
-							byte_pos = 0;
-						}
-					}
-				}
-				// flush last byte if req
-				if (byte_pos > 0) {
-					temp_writer.Write<uint8_t>(byte);
-				}
-				break;
-			}
-			case LogicalTypeId::TINYINT:
-				TemplatedWritePlain<int8_t, int32_t>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::SMALLINT:
-				TemplatedWritePlain<int16_t, int32_t>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::INTEGER:
-			case LogicalTypeId::DATE:
-				TemplatedWritePlain<int32_t, int32_t>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::BIGINT:
-			case LogicalTypeId::TIMESTAMP:
-			case LogicalTypeId::TIMESTAMP_MS:
-				TemplatedWritePlain<int64_t, int64_t>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::HUGEINT:
-				TemplatedWritePlain<hugeint_t, double, ParquetHugeintOperator>(input_column, input.size(), mask,
-				                                                               temp_writer);
-				break;
-			case LogicalTypeId::TIMESTAMP_NS:
-				TemplatedWritePlain<int64_t, int64_t, ParquetTimestampNSOperator>(input_column, input.size(), mask,
-				                                                                  temp_writer);
-				break;
-			case LogicalTypeId::TIMESTAMP_SEC:
-				TemplatedWritePlain<int64_t, int64_t, ParquetTimestampSOperator>(input_column, input.size(), mask,
-				                                                                 temp_writer);
-				break;
-			case LogicalTypeId::UTINYINT:
-				TemplatedWritePlain<uint8_t, int32_t>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::USMALLINT:
-				TemplatedWritePlain<uint16_t, int32_t>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::UINTEGER:
-				TemplatedWritePlain<uint32_t, uint32_t>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::UBIGINT:
-				TemplatedWritePlain<uint64_t, uint64_t>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::FLOAT:
-				TemplatedWritePlain<float, float>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::DECIMAL: {
-				// FIXME: fixed length byte array...
-				Vector double_vec(LogicalType::DOUBLE);
-				VectorOperations::Cast(input_column, double_vec, input.size());
-				TemplatedWritePlain<double, double>(double_vec, input.size(), mask, temp_writer);
-				break;
-			}
-			case LogicalTypeId::DOUBLE:
-				TemplatedWritePlain<double, double>(input_column, input.size(), mask, temp_writer);
-				break;
-			case LogicalTypeId::BLOB:
-			case LogicalTypeId::VARCHAR: {
-				auto *ptr = FlatVector::GetData<string_t>(input_column);
-				for (idx_t r = 0; r < input.size(); r++) {
-					if (mask.RowIsValid(r)) {
-						temp_writer.Write<uint32_t>(ptr[r].GetSize());
-						temp_writer.WriteData((const_data_ptr_t)ptr[r].GetDataUnsafe(), ptr[r].GetSize());
-					}
-				}
-				break;
-			}
-			default:
-				throw NotImplementedException((sql_types[i].ToString()));
-			}
-		}
-
-		// now that we have finished writing the data we know the uncompressed size
-		hdr.uncompressed_page_size = temp_writer.blob.size;
-
-		// compress the data based
-		size_t compressed_size;
-		data_ptr_t compressed_data;
-		unique_ptr<data_t[]> compressed_buf;
-		switch (codec) {
-		case CompressionCodec::UNCOMPRESSED:
-			compressed_size = temp_writer.blob.size;
-			compressed_data = temp_writer.blob.data.get();
+		// now write the actual payload, which is dictionary encoded if that is smaller than the PLAIN values
+		BufferedSerializer dictionary_writer;
+		switch (sql_types[i].id()) {
+		case LogicalTypeId::BOOLEAN:
+			WriteBooleanColumn(buffer, i, temp_writer, column);
 			break;
-		case CompressionCodec::SNAPPY: {
-			compressed_size = duckdb_snappy::MaxCompressedLength(temp_writer.blob.size);
-			compressed_buf = unique_ptr<data_t[]>(new data_t[compressed_size]);
-			duckdb_snappy::RawCompress((const char *)temp_writer.blob.data.get(), temp_writer.blob.size,
-			                           (char *)compressed_buf.get(), &compressed_size);
-			compressed_data = compressed_buf.get();
+		case LogicalTypeId::TINYINT:
+			TemplatedWriteColumn<int8_t, int32_t>(buffer, i, temp_writer, dictionary_writer, column);
 			break;
-		}
-		case CompressionCodec::GZIP: {
-			MiniZStream s;
-			compressed_size = s.MaxCompressedLength(temp_writer.blob.size);
-			compressed_buf = unique_ptr<data_t[]>(new data_t[compressed_size]);
-			s.Compress((const char *)temp_writer.blob.data.get(), temp_writer.blob.size, (char *)compressed_buf.get(),
-			           &compressed_size);
-			compressed_data = compressed_buf.get();
+		case LogicalTypeId::SMALLINT:
+			TemplatedWriteColumn<int16_t, int32_t>(buffer, i, temp_writer, dictionary_writer, column);
 			break;
-		}
-		case CompressionCodec::ZSTD: {
-			compressed_size = duckdb_zstd::ZSTD_compressBound(temp_writer.blob.size);
-			compressed_buf = unique_ptr<data_t[]>(new data_t[compressed_size]);
-			compressed_size = duckdb_zstd::ZSTD_compress((void *)compressed_buf.get(), compressed_size,
-			                                             (const void *)temp_writer.blob.data.get(),
-			                                             temp_writer.blob.size, ZSTD_CLEVEL_DEFAULT);
-			compressed_data = compressed_buf.get();
+		case LogicalTypeId::INTEGER:
+		case LogicalTypeId::DATE:
+			TemplatedWriteColumn<int32_t, int32_t>(buffer, i, temp_writer, dictionary_writer, column);
+			break;
+		case LogicalTypeId::BIGINT:
+		case LogicalTypeId::TIMESTAMP:
+		case LogicalTypeId::TIMESTAMP_MS:
+			TemplatedWriteColumn<int64_t, int64_t>(buffer, i, temp_writer, dictionary_writer, column);
+			break;
+		case LogicalTypeId::HUGEINT:
+			TemplatedWriteColumn<hugeint_t, double, ParquetHugeintOperator>(buffer, i, temp_writer, dictionary_writer,
+			                                                                column);
+			break;
+		case LogicalTypeId::TIMESTAMP_NS:
+			TemplatedWriteColumn<int64_t, int64_t, ParquetTimestampNSOperator>(buffer, i, temp_writer,
+			                                                                   dictionary_writer, column);
+			break;
+		case LogicalTypeId::TIMESTAMP_SEC:
+			TemplatedWriteColumn<int64_t, int64_t, ParquetTimestampSOperator>(buffer, i, temp_writer,
+			                                                                  dictionary_writer, column);
+			break;
+		case LogicalTypeId::UTINYINT:
+			TemplatedWriteColumn<uint8_t, int32_t>(buffer, i, temp_writer, dictionary_writer, column);
+			break;
+		case LogicalTypeId::USMALLINT:
+			TemplatedWriteColumn<uint16_t, int32_t>(buffer, i, temp_writer, dictionary_writer, column);
+			break;
+		case LogicalTypeId::UINTEGER:
+			TemplatedWriteColumn<uint32_t, uint32_t>(buffer, i, temp_writer, dictionary_writer, column);
+			break;
+		case LogicalTypeId::UBIGINT:
+			TemplatedWriteColumn<uint64_t, uint64_t>(buffer, i, temp_writer, dictionary_writer, column);
+			break;
+		case LogicalTypeId::FLOAT:
+			TemplatedWriteColumn<float, float>(buffer, i, temp_writer, dictionary_writer, column);
+			break;
+		case LogicalTypeId::DECIMAL: {
+			// FIXME: fixed length byte array...
+			ChunkCollection double_buffer;
+			DataChunk double_chunk;
+			double_chunk.Initialize({LogicalType::DOUBLE});
+			for (auto &chunk : buffer.Chunks()) {
+				double_chunk.Reset();
+				VectorOperations::Cast(chunk->data[i], double_chunk.data[0], chunk->size());
+				double_chunk.SetCardinality(chunk->size());
+				double_buffer.Append(double_chunk);
+			}
+			TemplatedWriteColumn<double, double>(double_buffer, 0, temp_writer, dictionary_writer, column);
 			break;
 		}
+		case LogicalTypeId::DOUBLE:
+			TemplatedWriteColumn<double, double>(buffer, i, temp_writer, dictionary_writer, column);
+			break;
+		case LogicalTypeId::BLOB:
+		case LogicalTypeId::VARCHAR:
+			TemplatedWriteColumn<string_t, string_t>(buffer, i, temp_writer, dictionary_writer, column);
+			break;
 		default:
-			throw InternalException("Unsupported codec for Parquet Writer");
+			throw NotImplementedException((sql_types[i].ToString()));
 		}
 
-		hdr.compressed_page_size = compressed_size;
-		// now finally write the data to the actual file
-		hdr.write(protocol.get());
-		writer->WriteData(compressed_data, compressed_size);
+		if (column.dictionary_size > 0) {
+			// the data page holds the dictionary indices, the dictionary itself goes into a page of its own
+			hdr.data_page_header.encoding = Encoding::RLE_DICTIONARY;
 
+			auto &dictionary_hdr = column.dictionary_page.page_header;
+			dictionary_hdr.type = PageType::DICTIONARY_PAGE;
+			dictionary_hdr.__isset.dictionary_page_header = true;
+			dictionary_hdr.dictionary_page_header.num_values = column.dictionary_size;
+			dictionary_hdr.dictionary_page_header.encoding = Encoding::PLAIN;
+			CompressPage(dictionary_writer, column.dictionary_page);
+		}
+		CompressPage(temp_writer, column.data_page);
+	}
+}
+
+void ParquetWriter::CompressPage(BufferedSerializer &temp_writer, PreparedPage &page) {
+	// now that we have finished writing the data we know the uncompressed size
+	page.page_header.uncompressed_page_size = temp_writer.blob.size;
+
+	// compress the data based
+	size_t compressed_size;
+	unique_ptr<data_t[]> compressed_buf;
+	switch (codec) {
+	case CompressionCodec::UNCOMPRESSED:
+		compressed_size = temp_writer.blob.size;
+		compressed_buf = move(temp_writer.blob.data);
+		break;
+	case CompressionCodec::SNAPPY: {
+		compressed_size = duckdb_snappy::MaxCompressedLength(temp_writer.blob.size);
+		compressed_buf = unique_ptr<data_t[]>(new data_t[compressed_size]);
+		duckdb_snappy::RawCompress((const char *)temp_writer.blob.data.get(), temp_writer.blob.size,
+		                           (char *)compressed_buf.get(), &compressed_size);
+		break;
+	}
+	case CompressionCodec::GZIP: {
+		MiniZStream s;
+		compressed_size = s.MaxCompressedLength(temp_writer.blob.size);
+		compressed_buf = unique_ptr<data_t[]>(new data_t[compressed_size]);
+		s.Compress((const char *)temp_writer.blob.data.get(), temp_writer.blob.size, (char *)compressed_buf.get(),
+		           &compressed_size);
+		break;
+	}
+	case CompressionCodec::ZSTD: {
+		compressed_size = duckdb_zstd::ZSTD_compressBound(temp_writer.blob.size);
+		compressed_buf = unique_ptr<data_t[]>(new data_t[compressed_size]);
+		compressed_size = duckdb_zstd::ZSTD_compress((void *)compressed_buf.get(), compressed_size,
+		                                             (const void *)temp_writer.blob.data.get(), temp_writer.blob.size,
+		                                             ZSTD_CLEVEL_DEFAULT);
+		break;
+	}
+	default:
+		throw InternalException("Unsupported codec for Parquet Writer");
+	}
+
+	page.page_header.compressed_page_size = compressed_size;
+	page.compressed_data = move(compressed_buf);
+	page.compressed_size = compressed_size;
+}
+
+idx_t ParquetWriter::WritePage(PreparedPage &page) {
+	auto header_start = writer->GetTotalWritten();
+	page.page_header.write(protocol.get());
+	auto header_size = writer->GetTotalWritten() - header_start;
+	writer->WriteData(page.compressed_data.get(), page.compressed_size);
+	return header_size + page.page_header.uncompressed_page_size;
+}
+
+void ParquetWriter::FlushRowGroup(PreparedRowGroup &prepared) {
+	lock_guard<mutex> glock(lock);
+
+	// set up a new row group for the prepared columns
+	ParquetRowGroup row_group;
+	row_group.num_rows = prepared.num_rows;
+	row_group.file_offset = writer->GetTotalWritten();
+	row_group.__isset.file_offset = true;
+	row_group.columns.resize(prepared.columns.size());
+
+	for (idx_t i = 0; i < prepared.columns.size(); i++) {
+		auto &column = prepared.columns[i];
 		auto &column_chunk = row_group.columns[i];
+		// record the current offset of the writer into the file
+		// this is the starting position of the first page of the column
+		auto start_offset = writer->GetTotalWritten();
+
+		// now finally write the pages to the actual file, the dictionary page goes first
+		idx_t total_uncompressed_size = 0;
+		if (column.dictionary_size > 0) {
+			column_chunk.meta_data.dictionary_page_offset = start_offset;
+			column_chunk.meta_data.__isset.dictionary_page_offset = true;
+			total_uncompressed_size += WritePage(column.dictionary_page);
+		}
+		column_chunk.meta_data.data_page_offset = writer->GetTotalWritten();
+		total_uncompressed_size += WritePage(column.data_page);
+
 		column_chunk.__isset.meta_data = true;
-		column_chunk.meta_data.data_page_offset = start_offset;
 		column_chunk.meta_data.total_compressed_size = writer->GetTotalWritten() - start_offset;
+		column_chunk.meta_data.total_uncompressed_size = total_uncompressed_size;
 		column_chunk.meta_data.codec = codec;
 		column_chunk.meta_data.path_in_schema.push_back(file_meta_data.schema[i + 1].name);
-		column_chunk.meta_data.num_values = buffer.Count();
+		column_chunk.meta_data.num_values = prepared.num_rows;
 		column_chunk.meta_data.type = file_meta_data.schema[i + 1].type;
+		column_chunk.meta_data.encodings.push_back(Encoding::PLAIN);
+		column_chunk.meta_data.encodings.push_back(Encoding::RLE);
+		if (column.dictionary_size > 0) {
+			column_chunk.meta_data.encodings.push_back(Encoding::RLE_DICTIONARY);
+		}
+		column_chunk.meta_data.statistics = column.statistics;
+		column_chunk.meta_data.__isset.statistics = true;
 	}
-	row_group.num_rows += buffer.Count();
 
 	// append the row group to the file meta data
 	file_meta_data.row_groups.push_back(row_group);
-	file_meta_data.num_rows += buffer.Count();
+	file_meta_data.num_rows += prepared.num_rows;
+}
+
+void ParquetWriter::Flush(ChunkCollection &buffer) {
+	if (buffer.Count() == 0) {
+		return;
+	}
+	// encoding and compressing the row group does not touch the file, so threads can do this at the same time
+	PreparedRowGroup row_group;
+	PrepareRowGroup(buffer, row_group);
+	FlushRowGroup(row_group);
 }
 
 void ParquetWriter::Finalize() {
@@ -65,9 +65,15 @@ TableCatalogEntry::TableCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schem
 		for (auto &col_def : columns) {
 			colum_def_copy.push_back(col_def.Copy());
 		}
+		// the indexes of the UNIQUE and PRIMARY KEY constraints might have been stored in the checkpoint
+		vector<IndexPointer> index_pointers;
+		if (info->data) {
+			index_pointers = move(info->data->indexes);
+		}
 		storage = make_shared<DataTable>(catalog->db, schema->name, name, move(colum_def_copy), move(info->data));
 
 		// create the unique indexes for the UNIQUE and PRIMARY KEY constraints
+		idx_t unique_index_count = 0;
 		for (idx_t i = 0; i < bound_constraints.size(); i++) {
 			auto &constraint = bound_constraints[i];
 			if (constraint->type == ConstraintType::UNIQUE) {
@@ -87,9 +93,18 @@ TableCatalogEntry::TableCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schem
 					bound_expressions.push_back(make_unique<BoundReferenceExpression>(columns[key].type, key_nr++));
 					column_ids.push_back(key);
 				}
-				// create an adaptive radix tree around the expressions
-				auto art = make_unique<ART>(column_ids, move(unbound_expressions), true, unique.is_primary_key);
-				storage->AddIndex(move(art), bound_expressions);
+				if (unique_index_count < index_pointers.size()) {
+					// the index was stored in the checkpoint: load it instead of rebuilding it from the table
+					auto art = make_unique<ART>(column_ids, move(unbound_expressions), catalog->db, true,
+					                            unique.is_primary_key, index_pointers[unique_index_count]);
+					storage->info->indexes.AddIndex(move(art));
+				} else {
+					// create an adaptive radix tree around the expressions
+					auto art =
+					    make_unique<ART>(column_ids, move(unbound_expressions), catalog->db, true, unique.is_primary_key);
+					storage->AddIndex(move(art), bound_expressions);
+				}
+				unique_index_count++;
 			}
 		}
 	}
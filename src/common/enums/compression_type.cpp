@@ -19,6 +19,8 @@ CompressionType CompressionTypeFromString(const string &str) {
 		return CompressionType::COMPRESSION_BITPACKING;
 	} else if (compression == "fsst") {
 		return CompressionType::COMPRESSION_FSST;
+	} else if (compression == "chimp") {
+		return CompressionType::COMPRESSION_CHIMP;
 	} else {
 		return CompressionType::COMPRESSION_AUTO;
 	}
@@ -40,6 +42,8 @@ string CompressionTypeToString(CompressionType type) {
 		return "BitPacking";
 	case CompressionType::COMPRESSION_FSST:
 		return "FSST";
+	case CompressionType::COMPRESSION_CHIMP:
+		return "Chimp";
 	default:
 		throw InternalException("Unrecognized compression type!");
 	}
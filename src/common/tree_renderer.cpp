@@ -490,6 +490,9 @@ unique_ptr<RenderTreeNode> TreeRenderer::CreateNode(const QueryProfiler::TreeNod
 	result->extra_text += "\n" + to_string(op.info.elements);
 	string timing = StringUtil::Format("%.2f", op.info.time);
 	result->extra_text += "\n(" + timing + "s)";
+	for (auto &counter : op.info.counters) {
+		result->extra_text += "\n" + counter.first + ": " + to_string(counter.second);
+	}
 	if (config.detailed) {
 		for (auto &info : op.info.executors_info) {
 			if (!info) {
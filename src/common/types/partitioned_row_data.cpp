@@ -0,0 +1,171 @@
+#include "duckdb/common/types/partitioned_row_data.hpp"
+
+#include "duckdb/common/row_operations/row_operations.hpp"
+
+namespace duckdb {
+
+PartitionedRowData::PartitionedRowData(BufferManager &buffer_manager, const RowLayout &layout, idx_t radix_bits)
+    : buffer_manager(buffer_manager), layout(layout), radix_bits(radix_bits) {
+	D_ASSERT(radix_bits > 0 && radix_bits < sizeof(hash_t) * 8);
+	D_ASSERT(layout.GetTypes().back().id() == LogicalTypeId::HASH);
+	const idx_t row_width = layout.GetRowWidth();
+	const idx_t partition_count = (idx_t)1 << radix_bits;
+	for (idx_t i = 0; i < partition_count; i++) {
+		data.push_back(
+		    make_unique<RowDataCollection>(buffer_manager, (Storage::BLOCK_SIZE / row_width) + 1, row_width));
+		heaps.push_back(make_unique<RowDataCollection>(buffer_manager, (idx_t)Storage::BLOCK_SIZE, 1));
+	}
+}
+
+//! The block of a partition that is currently being appended to
+struct PartitionAppendState {
+	unique_ptr<RowDataBlock> data_block;
+	unique_ptr<BufferHandle> data_handle;
+	unique_ptr<RowDataBlock> heap_block;
+	unique_ptr<BufferHandle> heap_handle;
+	//! The amount of rows and heap bytes of this partition that are not appended yet
+	idx_t remaining_count = 0;
+	idx_t remaining_heap_size = 0;
+};
+
+void PartitionedRowData::SwizzleBlock(RowDataCollection &partition_data, RowDataCollection &partition_heap,
+                                      RowDataBlock &data_block, BufferHandle &data_handle, RowDataBlock *heap_block,
+                                      BufferHandle *heap_handle) {
+	if (!layout.AllConstant()) {
+		// the heap rows were appended in the same order as the rows, so the heap pointers can be swizzled to offsets
+		D_ASSERT(heap_block && heap_block->count == data_block.count);
+		RowOperations::SwizzleColumns(layout, data_handle.Ptr(), data_block.count);
+		RowOperations::SwizzleHeapPointer(layout, data_handle.Ptr(), heap_handle->Ptr(), data_block.count);
+		partition_heap.blocks.push_back(*heap_block);
+		partition_heap.count += heap_block->count;
+	}
+	partition_data.blocks.push_back(data_block);
+	partition_data.count += data_block.count;
+}
+
+void PartitionedRowData::Append(RowDataCollection &rows) {
+	if (rows.count == 0) {
+		return;
+	}
+	D_ASSERT(rows.entry_size == layout.GetRowWidth());
+	vector<unique_ptr<BufferHandle>> handles;
+	vector<BlockAppendEntry> row_blocks;
+	for (auto &block : rows.blocks) {
+		handles.push_back(buffer_manager.Pin(block.block));
+		row_blocks.emplace_back(handles.back()->Ptr(), block.count);
+	}
+	Append(row_blocks);
+}
+
+void PartitionedRowData::Append(const vector<BlockAppendEntry> &row_blocks) {
+	const idx_t partition_count = PartitionCount();
+	const idx_t row_width = layout.GetRowWidth();
+	// the hash is the last column, which is followed by the aggregate states (if any)
+	const idx_t hash_offset = layout.GetOffsets()[layout.ColumnCount() - 1];
+	const idx_t heap_pointer_offset = layout.GetHeapPointerOffset();
+	const bool all_constant = layout.AllConstant();
+
+	// first figure out how many rows (and heap bytes) go to every partition, so we can size the blocks accordingly
+	vector<PartitionAppendState> states(partition_count);
+	for (auto &block : row_blocks) {
+		auto row_ptr = block.baseptr;
+		for (idx_t i = 0; i < block.count; i++) {
+			auto &state = states[PartitionIndex(Load<hash_t>(row_ptr + hash_offset), radix_bits)];
+			state.remaining_count++;
+			if (!all_constant) {
+				state.remaining_heap_size += Load<uint32_t>(Load<data_ptr_t>(row_ptr + heap_pointer_offset));
+			}
+			row_ptr += row_width;
+		}
+	}
+
+	// now copy the rows (and their heap rows) to the blocks of their partition
+	// the swizzled blocks are collected locally first, and appended to the partitions at the end
+	const idx_t block_capacity = (Storage::BLOCK_SIZE / row_width) + 1;
+	PartitionedRowData local(buffer_manager, layout, radix_bits);
+	for (auto &block : row_blocks) {
+		auto row_ptr = block.baseptr;
+		for (idx_t i = 0; i < block.count; i++, row_ptr += row_width) {
+			auto partition = PartitionIndex(Load<hash_t>(row_ptr + hash_offset), radix_bits);
+			auto &state = states[partition];
+			data_ptr_t heap_row_ptr = nullptr;
+			idx_t heap_row_size = 0;
+			if (!all_constant) {
+				heap_row_ptr = Load<data_ptr_t>(row_ptr + heap_pointer_offset);
+				heap_row_size = Load<uint32_t>(heap_row_ptr);
+			}
+			if (state.data_block && (state.data_block->count == state.data_block->capacity ||
+			                         (!all_constant && state.heap_block->byte_offset + heap_row_size >
+			                                               state.heap_block->capacity))) {
+				// the current block of this partition is full
+				SwizzleBlock(*local.data[partition], *local.heaps[partition], *state.data_block, *state.data_handle,
+				             state.heap_block.get(), state.heap_handle.get());
+				state.data_block.reset();
+				state.data_handle.reset();
+				state.heap_block.reset();
+				state.heap_handle.reset();
+			}
+			if (!state.data_block) {
+				// create a new block for this partition, which is no larger than what remains to be appended
+				state.data_block = make_unique<RowDataBlock>(
+				    buffer_manager, MinValue<idx_t>(block_capacity, state.remaining_count), row_width);
+				state.data_handle = buffer_manager.Pin(state.data_block->block);
+				if (!all_constant) {
+					auto heap_capacity =
+					    MaxValue<idx_t>(heap_row_size, MinValue<idx_t>(Storage::BLOCK_SIZE, state.remaining_heap_size));
+					state.heap_block = make_unique<RowDataBlock>(buffer_manager, heap_capacity, 1);
+					state.heap_handle = buffer_manager.Pin(state.heap_block->block);
+				}
+			}
+			// copy the row (and its heap row) to the block
+			memcpy(state.data_handle->Ptr() + state.data_block->count * row_width, row_ptr, row_width);
+			state.data_block->count++;
+			state.remaining_count--;
+			if (!all_constant) {
+				memcpy(state.heap_handle->Ptr() + state.heap_block->byte_offset, heap_row_ptr, heap_row_size);
+				state.heap_block->byte_offset += heap_row_size;
+				state.heap_block->count++;
+				state.remaining_heap_size -= heap_row_size;
+			}
+		}
+	}
+	for (idx_t partition = 0; partition < partition_count; partition++) {
+		auto &state = states[partition];
+		if (state.data_block) {
+			SwizzleBlock(*local.data[partition], *local.heaps[partition], *state.data_block, *state.data_handle,
+			             state.heap_block.get(), state.heap_handle.get());
+		}
+	}
+
+	// append the blocks to the partitions, the data and heap blocks of a partition are appended together
+	lock_guard<mutex> append_lock(lock);
+	for (idx_t partition = 0; partition < partition_count; partition++) {
+		data[partition]->Merge(*local.data[partition]);
+		heaps[partition]->Merge(*local.heaps[partition]);
+	}
+}
+
+idx_t PartitionedRowData::Count() const {
+	idx_t count = 0;
+	for (auto &partition_data : data) {
+		count += partition_data->count;
+	}
+	return count;
+}
+
+idx_t PartitionedRowData::Count(idx_t partition) const {
+	return data[partition]->count;
+}
+
+idx_t PartitionedRowData::SizeInBytes(idx_t partition) const {
+	idx_t size = 0;
+	for (auto &block : data[partition]->blocks) {
+		size += block.capacity * block.entry_size;
+	}
+	for (auto &block : heaps[partition]->blocks) {
+		size += block.capacity;
+	}
+	return size;
+}
+
+} // namespace duckdb
@@ -259,6 +259,15 @@ idx_t GroupedAggregateHashTable::AddChunk(DataChunk &groups, DataChunk &payload)
 }
 
 idx_t GroupedAggregateHashTable::AddChunk(DataChunk &groups, Vector &group_hashes, DataChunk &payload) {
+	vector<idx_t> aggregate_filter;
+	for (idx_t i = 0; i < layout.GetAggregates().size(); i++) {
+		aggregate_filter.push_back(i);
+	}
+	return AddChunk(groups, group_hashes, payload, aggregate_filter);
+}
+
+idx_t GroupedAggregateHashTable::AddChunk(DataChunk &groups, Vector &group_hashes, DataChunk &payload,
+                                          const vector<idx_t> &filter) {
 	D_ASSERT(!is_finalized);
 
 	if (groups.size() == 0) {
@@ -274,21 +283,78 @@ idx_t GroupedAggregateHashTable::AddChunk(DataChunk &groups, Vector &group_hashe
 
 	Vector addresses(LogicalType::POINTER);
 	auto new_group_count = FindOrCreateGroups(groups, group_hashes, addresses, new_groups);
-	VectorOperations::AddInPlace(addresses, layout.GetAggrOffset(), payload.size());
 
 	// now every cell has an entry
 	// update the aggregates
+	UpdateAggregates(groups, payload, addresses, filter);
+
+	Verify();
+	return new_group_count;
+}
+
+idx_t GroupedAggregateHashTable::AppendChunk(DataChunk &groups, Vector &group_hashes, DataChunk &payload,
+                                             const vector<idx_t> &filter) {
+	// the appended groups are not inserted into the hashes, so the hashes cannot be used for lookups anymore
+	Finalize();
+
+	if (groups.size() == 0) {
+		return 0;
+	}
+	D_ASSERT(groups.ColumnCount() + 1 == layout.ColumnCount());
+	D_ASSERT(group_hashes.GetType() == LogicalType::HASH);
+
+	// every row gets its own entry at the end of the payload blocks
+	Vector addresses(LogicalType::POINTER);
+	auto addresses_ptr = FlatVector::GetData<data_ptr_t>(addresses);
+	for (idx_t i = 0; i < groups.size(); i++) {
+		if (payload_page_offset == tuples_per_block || payload_hds.empty()) {
+			NewBlock();
+		}
+		addresses_ptr[i] = payload_hds_ptrs.back() + (payload_page_offset++ * tuple_size);
+	}
+
+	DataChunk group_chunk;
+	group_chunk.InitializeEmpty(layout.GetTypes());
+	for (idx_t grp_idx = 0; grp_idx < groups.ColumnCount(); grp_idx++) {
+		group_chunk.data[grp_idx].Reference(groups.data[grp_idx]);
+	}
+	group_chunk.data[groups.ColumnCount()].Reference(group_hashes);
+	group_chunk.SetCardinality(groups);
+	auto group_data = group_chunk.Orrify();
+
+	auto sel = FlatVector::IncrementalSelectionVector();
+	RowOperations::Scatter(group_chunk, group_data.get(), layout, addresses, *string_heap, *sel, groups.size());
+	RowOperations::InitializeStates(layout, addresses, *sel, groups.size());
+	entries += groups.size();
+
+	UpdateAggregates(groups, payload, addresses, filter);
+	return groups.size();
+}
+
+void GroupedAggregateHashTable::UpdateAggregates(DataChunk &groups, DataChunk &payload, Vector &addresses,
+                                                 const vector<idx_t> &filter) {
+	SelectionVector new_groups(STANDARD_VECTOR_SIZE);
+	VectorOperations::AddInPlace(addresses, layout.GetAggrOffset(), payload.size());
+
 	idx_t payload_idx = 0;
 
 	auto &aggregates = layout.GetAggregates();
+	idx_t filter_idx = 0;
 	for (idx_t aggr_idx = 0; aggr_idx < aggregates.size(); aggr_idx++) {
-		// for any entries for which a group was found, update the aggregate
 		auto &aggr = aggregates[aggr_idx];
+		if (filter_idx >= filter.size() || aggr_idx < filter[filter_idx]) {
+			// this aggregate is not updated: skip its payload and its states
+			payload_idx += aggr.child_count;
+			VectorOperations::AddInPlace(addresses, aggr.payload_size, payload.size());
+			continue;
+		}
+		D_ASSERT(filter[filter_idx] == aggr_idx);
+		// for any entries for which a group was found, update the aggregate
 		if (aggr.distinct) {
 			// construct chunk for secondary hash table probing
 			vector<LogicalType> probe_types(groups.GetTypes());
 			for (idx_t i = 0; i < aggr.child_count; i++) {
-				probe_types.push_back(payload_types[payload_idx]);
+				probe_types.push_back(payload_types[payload_idx + i]);
 			}
 			DataChunk probe_chunk;
 			probe_chunk.Initialize(probe_types);
@@ -299,6 +365,22 @@ idx_t GroupedAggregateHashTable::AddChunk(DataChunk &groups, Vector &group_hashe
 				probe_chunk.data[groups.ColumnCount() + i].Reference(payload.data[payload_idx + i]);
 			}
 			probe_chunk.SetCardinality(groups);
+
+			// the FILTER is applied before probing, so values that are filtered out are not marked as seen
+			DataChunk filtered_payload;
+			filtered_payload.InitializeEmpty(payload.GetTypes());
+			Vector filtered_addresses(LogicalType::POINTER, nullptr);
+			if (aggr.filter) {
+				ExpressionExecutor filter_execution(aggr.filter);
+				SelectionVector true_sel(STANDARD_VECTOR_SIZE);
+				auto count = filter_execution.SelectExpression(payload, true_sel);
+				probe_chunk.Slice(true_sel, count);
+				filtered_payload.Slice(payload, true_sel, count);
+				filtered_addresses.Slice(addresses, true_sel, count);
+			} else {
+				filtered_payload.Reference(payload);
+				filtered_addresses.Reference(addresses);
+			}
 			probe_chunk.Verify();
 
 			Vector dummy_addresses(LogicalType::POINTER);
@@ -310,25 +392,14 @@ idx_t GroupedAggregateHashTable::AddChunk(DataChunk &groups, Vector &group_hashe
 			// now fix up the payload and addresses accordingly by creating
 			// a selection vector
 			if (new_group_count > 0) {
-				if (aggr.filter) {
-					Vector distinct_addresses(addresses, new_groups, new_group_count);
-					DataChunk distinct_payload;
-					auto pay_types = payload.GetTypes();
-					distinct_payload.Initialize(pay_types);
-					distinct_payload.Slice(payload, new_groups, new_group_count);
-					distinct_addresses.Verify(new_group_count);
-					distinct_addresses.Normalify(new_group_count);
-					RowOperations::UpdateFilteredStates(aggr, distinct_addresses, distinct_payload, payload_idx);
-				} else {
-					Vector distinct_addresses(addresses, new_groups, new_group_count);
-					for (idx_t i = 0; i < aggr.child_count; i++) {
-						payload.data[payload_idx + i].Slice(new_groups, new_group_count);
-						payload.data[payload_idx + i].Verify(new_group_count);
-					}
-					distinct_addresses.Verify(new_group_count);
-
-					RowOperations::UpdateStates(aggr, distinct_addresses, payload, payload_idx, new_group_count);
-				}
+				// the payload is shared with the other grouping sets, so we slice a copy of it
+				Vector distinct_addresses(filtered_addresses, new_groups, new_group_count);
+				distinct_addresses.Normalify(new_group_count);
+				DataChunk distinct_payload;
+				distinct_payload.InitializeEmpty(payload.GetTypes());
+				distinct_payload.Slice(filtered_payload, new_groups, new_group_count);
+				distinct_payload.Verify();
+				RowOperations::UpdateStates(aggr, distinct_addresses, distinct_payload, payload_idx, new_group_count);
 			}
 		} else if (aggr.filter) {
 			RowOperations::UpdateFilteredStates(aggr, addresses, payload, payload_idx);
@@ -339,10 +410,8 @@ idx_t GroupedAggregateHashTable::AddChunk(DataChunk &groups, Vector &group_hashe
 		// move to the next aggregate
 		payload_idx += aggr.child_count;
 		VectorOperations::AddInPlace(addresses, aggr.payload_size, payload.size());
+		filter_idx++;
 	}
-
-	Verify();
-	return new_group_count;
 }
 
 void GroupedAggregateHashTable::FetchAggregates(DataChunk &groups, DataChunk &result) {
@@ -456,7 +525,6 @@ idx_t GroupedAggregateHashTable::FindOrCreateGroupsInternal(DataChunk &groups, V
 				// update selection lists for outer loops
 				empty_vector.set_index(new_entry_count++, index);
 				new_groups_out.set_index(new_group_count++, index);
-				entries++;
 
 				addresses_ptr[index] = entry_payload_ptr;
 
@@ -480,6 +548,9 @@ idx_t GroupedAggregateHashTable::FindOrCreateGroupsInternal(DataChunk &groups, V
 		RowOperations::Scatter(group_chunk, group_data.get(), layout, addresses, *string_heap, empty_vector,
 		                       new_entry_count);
 		RowOperations::InitializeStates(layout, addresses, empty_vector, new_entry_count);
+		// the new entries are only counted once their states are initialized, so Destroy() does not touch them if
+		// anything above throws (e.g. because we run out of memory)
+		entries += new_entry_count;
 
 		// now we have only the tuples remaining that might match to an existing group
 		// start performing comparisons with each of the groups
@@ -636,6 +707,77 @@ void GroupedAggregateHashTable::Partition(vector<GroupedAggregateHashTable *> &p
 	D_ASSERT(total_count == entries);
 }
 
+void GroupedAggregateHashTable::Partition(PartitionedRowData &partitions) {
+	Finalize();
+	if (entries == 0) {
+		return;
+	}
+	while (!payload_hds.empty()) {
+		auto block_entries = MinValue(tuples_per_block, entries);
+		partitions.Append({BlockAppendEntry(payload_hds_ptrs[0], block_entries)});
+		// the partitions own the aggregate states of these groups now: drop them without destroying them
+		// the block is released right away, so that the HT does not have to fit in memory twice
+		entries -= block_entries;
+		payload_hds.erase(payload_hds.begin());
+		payload_hds_ptrs.erase(payload_hds_ptrs.begin());
+	}
+	D_ASSERT(entries == 0);
+	payload_page_offset = 0;
+	string_heap = make_unique<RowDataCollection>(buffer_manager, (idx_t)Storage::BLOCK_SIZE, 1, true);
+}
+
+void GroupedAggregateHashTable::Combine(PartitionedRowData &partitions, idx_t partition) {
+	D_ASSERT(!is_finalized);
+	D_ASSERT(partitions.layout.GetRowWidth() == layout.GetRowWidth());
+	auto &partition_data = *partitions.data[partition];
+	auto &partition_heap = *partitions.heaps[partition];
+
+	Vector addresses(LogicalType::POINTER);
+	auto addresses_ptr = FlatVector::GetData<data_ptr_t>(addresses);
+	Vector hashes(LogicalType::HASH);
+	auto hashes_ptr = FlatVector::GetData<hash_t>(hashes);
+	// CombineStates moves the addresses to the aggregate states, so the row pointers are kept separately
+	data_ptr_t row_pointers[STANDARD_VECTOR_SIZE];
+	Vector state_vector(LogicalType::POINTER, (data_ptr_t)row_pointers);
+
+	for (idx_t block_idx = 0; block_idx < partition_data.blocks.size(); block_idx++) {
+		auto &data_block = partition_data.blocks[block_idx];
+		auto data_handle = buffer_manager.Pin(data_block.block);
+		unique_ptr<BufferHandle> heap_handle;
+		if (!layout.AllConstant()) {
+			// the partition is consumed, so its rows can be unswizzled in place
+			heap_handle = buffer_manager.Pin(partition_heap.blocks[block_idx].block);
+			RowOperations::UnswizzlePointers(layout, data_handle->Ptr(), heap_handle->Ptr(), data_block.count);
+		}
+		auto row_ptr = data_handle->Ptr();
+		for (idx_t offset = 0; offset < data_block.count; offset += STANDARD_VECTOR_SIZE) {
+			auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, data_block.count - offset);
+			for (idx_t i = 0; i < count; i++) {
+				hashes_ptr[i] = Load<hash_t>(row_ptr + hash_offset);
+				addresses_ptr[i] = row_ptr;
+				row_pointers[i] = row_ptr;
+				row_ptr += tuple_size;
+			}
+			FlushMove(addresses, hashes, count);
+			// the states have been combined into this HT, the partition still owns the originals
+			RowOperations::DestroyStates(layout, state_vector, count);
+		}
+	}
+	partition_data.blocks.clear();
+	partition_data.count = 0;
+	partition_heap.blocks.clear();
+	partition_heap.count = 0;
+	Verify();
+}
+
+idx_t GroupedAggregateHashTable::SizeInBytes() {
+	idx_t size = payload_hds.size() * Storage::BLOCK_SIZE + string_heap->SizeInBytes();
+	if (hashes_hdl) {
+		size += capacity * (entry_type == HtEntryType::HT_WIDTH_64 ? sizeof(aggr_ht_entry_64) : sizeof(aggr_ht_entry_32));
+	}
+	return size;
+}
+
 idx_t GroupedAggregateHashTable::Scan(idx_t &scan_position, DataChunk &result) {
 	Vector addresses(LogicalType::POINTER);
 	auto data_pointers = FlatVector::GetData<data_ptr_t>(addresses);
@@ -1,19 +1,31 @@
 #include "duckdb/execution/index/art/art.hpp"
 
+#include "duckdb/common/pair.hpp"
 #include "duckdb/common/radix.hpp"
+#include "duckdb/common/set.hpp"
+#include "duckdb/common/sort/sort.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/buffer/block_handle.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
 
 #include <algorithm>
 #include <cstring>
 #include <ctgmath>
+#include <thread>
 
 namespace duckdb {
 
-ART::ART(const vector<column_t> &column_ids, const vector<unique_ptr<Expression>> &unbound_expressions, bool is_unique,
-         bool is_primary)
-    : Index(IndexType::ART, column_ids, unbound_expressions, is_unique, is_primary) {
-	tree = nullptr;
+ART::ART(const vector<column_t> &column_ids, const vector<unique_ptr<Expression>> &unbound_expressions,
+         DatabaseInstance &db, bool is_unique, bool is_primary)
+    : Index(IndexType::ART, column_ids, unbound_expressions, is_unique, is_primary), db(db), memory_size(0),
+      reserved_memory(0) {
+	serialized_root.block_id = INVALID_BLOCK;
+	serialized_root.offset = 0;
 	expression_result.Initialize(logical_types);
 	is_little_endian = IsLittleEndian();
 	for (idx_t i = 0; i < types.size(); i++) {
@@ -38,7 +50,24 @@ ART::ART(const vector<column_t> &column_ids, const vector<unique_ptr<Expression>
 	}
 }
 
+ART::ART(const vector<column_t> &column_ids, const vector<unique_ptr<Expression>> &unbound_expressions,
+         DatabaseInstance &db, bool is_unique, bool is_primary, const IndexPointer &pointer)
+    : ART(column_ids, unbound_expressions, db, is_unique, is_primary) {
+	// the index is written again by the next checkpoint: its current blocks can be reused after that
+	auto &block_manager = BlockManager::GetBlockManager(db);
+	for (auto &block_id : pointer.blocks) {
+		block_manager.MarkBlockAsModified(block_id);
+	}
+	if (pointer.root.block_id != INVALID_BLOCK) {
+		// only the root node is loaded here, the other nodes are loaded when they are first accessed
+		tree = Node::Deserialize(*this, pointer.root.block_id, pointer.root.offset);
+		serialized_root = pointer.root;
+	}
+	UpdateMemory();
+}
+
 ART::~ART() {
+	BufferManager::GetBufferManager(db).FreeReservedMemory(reserved_memory);
 }
 
 bool ART::LeafMatches(Node *node, Key &key, unsigned depth) {
@@ -217,6 +246,8 @@ bool ART::Insert(IndexLock &lock, DataChunk &input, Vector &row_ids) {
 	// generate the keys for the given input
 	vector<unique_ptr<Key>> keys;
 	GenerateKeys(input, keys);
+	tree.Unswizzle(*this);
+	SetModified();
 
 	// now insert the elements into the index
 	row_ids.Normalify(input.size());
@@ -234,24 +265,34 @@ bool ART::Insert(IndexLock &lock, DataChunk &input, Vector &row_ids) {
 			break;
 		}
 	}
-	if (failed_index != DConstants::INVALID_INDEX) {
-		// failed to insert because of constraint violation: remove previously inserted entries
-		// generate keys again
-		keys.clear();
-		GenerateKeys(input, keys);
-		unique_ptr<Key> key;
+	if (failed_index == DConstants::INVALID_INDEX) {
+		try {
+			// account for the memory of the new nodes, this fails if the memory limit cannot be kept
+			UpdateMemory();
+			return true;
+		} catch (OutOfMemoryException &) {
+			// remove all inserted entries again, so the index stays consistent with the table
+			EraseKeys(input, row_identifiers, input.size());
+			throw;
+		}
+	}
+	// failed to insert because of constraint violation: remove previously inserted entries
+	EraseKeys(input, row_identifiers, failed_index);
+	UpdateMemory();
+	return false;
+}
 
-		// now erase the entries
-		for (idx_t i = 0; i < failed_index; i++) {
-			if (!keys[i]) {
-				continue;
-			}
-			row_t row_id = row_identifiers[i];
-			Erase(tree, *keys[i], 0, row_id);
+void ART::EraseKeys(DataChunk &input, row_t row_identifiers[], idx_t count) {
+	// generate the keys again, the inserted keys were moved into the tree
+	vector<unique_ptr<Key>> keys;
+	GenerateKeys(input, keys);
+	for (idx_t i = 0; i < count; i++) {
+		if (!keys[i]) {
+			continue;
 		}
-		return false;
+		row_t row_id = row_identifiers[i];
+		Erase(tree, *keys[i], 0, row_id);
 	}
-	return true;
 }
 
 bool ART::Append(IndexLock &lock, DataChunk &appended_data, Vector &row_identifiers) {
@@ -282,6 +323,7 @@ void ART::VerifyAppend(DataChunk &chunk) {
 	vector<unique_ptr<Key>> keys;
 	GenerateKeys(expression_result, keys);
 
+	tree.Unswizzle(*this);
 	for (idx_t i = 0; i < chunk.size(); i++) {
 		if (!keys[i]) {
 			continue;
@@ -299,6 +341,7 @@ void ART::VerifyAppend(DataChunk &chunk) {
 			                          is_primary ? "primary key" : "unique");
 		}
 	}
+	UpdateMemory();
 }
 
 bool ART::InsertToLeaf(Leaf &leaf, row_t row_id) {
@@ -309,7 +352,7 @@ bool ART::InsertToLeaf(Leaf &leaf, row_t row_id) {
 	return true;
 }
 
-bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth, row_t row_id) {
+bool ART::Insert(SwizzleablePointer &node, unique_ptr<Key> value, unsigned depth, row_t row_id) {
 	Key &key = *value;
 	if (!node) {
 		// node is currently empty, create a leaf here with the key
@@ -335,11 +378,11 @@ bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth,
 			}
 		}
 
-		unique_ptr<Node> new_node = make_unique<Node4>(*this, new_prefix_length);
+		SwizzleablePointer new_node(make_unique<Node4>(*this, new_prefix_length));
 		new_node->prefix_length = new_prefix_length;
 		memcpy(new_node->prefix.get(), &key[depth], new_prefix_length);
 		Node4::Insert(*this, new_node, existing_key[depth + new_prefix_length], node);
-		unique_ptr<Node> leaf_node = make_unique<Leaf>(*this, move(value), row_id);
+		SwizzleablePointer leaf_node(make_unique<Leaf>(*this, move(value), row_id));
 		Node4::Insert(*this, new_node, key[depth + new_prefix_length], leaf_node);
 		node = move(new_node);
 		return true;
@@ -350,7 +393,7 @@ bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth,
 		uint32_t mismatch_pos = Node::PrefixMismatch(*this, node.get(), key, depth);
 		if (mismatch_pos != node->prefix_length) {
 			// Prefix differs, create new node
-			unique_ptr<Node> new_node = make_unique<Node4>(*this, mismatch_pos);
+			SwizzleablePointer new_node(make_unique<Node4>(*this, mismatch_pos));
 			new_node->prefix_length = mismatch_pos;
 			memcpy(new_node->prefix.get(), node->prefix.get(), mismatch_pos);
 			// Break up prefix
@@ -358,7 +401,7 @@ bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth,
 			Node4::Insert(*this, new_node, node->prefix[mismatch_pos], node);
 			node_ptr->prefix_length -= (mismatch_pos + 1);
 			memmove(node_ptr->prefix.get(), node_ptr->prefix.get() + mismatch_pos + 1, node_ptr->prefix_length);
-			unique_ptr<Node> leaf_node = make_unique<Leaf>(*this, move(value), row_id);
+			SwizzleablePointer leaf_node(make_unique<Leaf>(*this, move(value), row_id));
 			Node4::Insert(*this, new_node, key[depth + mismatch_pos], leaf_node);
 			node = move(new_node);
 			return true;
@@ -369,14 +412,448 @@ bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth,
 	// Recurse
 	idx_t pos = node->GetChildPos(key[depth]);
 	if (pos != DConstants::INVALID_INDEX) {
-		auto child = node->GetChild(pos);
+		auto child = node->GetChild(*this, pos);
 		return Insert(*child, move(value), depth + 1, row_id);
 	}
-	unique_ptr<Node> new_node = make_unique<Leaf>(*this, move(value), row_id);
+	SwizzleablePointer new_node(make_unique<Leaf>(*this, move(value), row_id));
 	Node::InsertLeaf(*this, node, key[depth], new_node);
 	return true;
 }
 
+//===--------------------------------------------------------------------===//
+// Construct
+//===--------------------------------------------------------------------===//
+struct ARTConstructState : public IndexConstructState {
+	//! The rows are sorted on the indexed columns, the payload holds the indexed columns and the row ids. If there is
+	//! no sort state, the rows are inserted directly.
+	unique_ptr<GlobalSortState> global_sort_state;
+	LocalSortState local_sort_state;
+	DataChunk sort_chunk;
+	DataChunk payload_chunk;
+	//! The local sort state is sorted once it holds this many bytes
+	idx_t memory_limit;
+};
+
+unique_ptr<IndexConstructState> ART::InitializeConstruct() {
+	auto result = make_unique<ARTConstructState>();
+	if (TaskScheduler::GetScheduler(db).NumberOfThreads() <= 1) {
+		// sorting only pays off if the subtrees can be built in parallel
+		return move(result);
+	}
+	// the keys are encoded in the same way as the radix sorting data: sorting on the indexed columns gives the order
+	// of the leaves of the tree
+	vector<BoundOrderByNode> orders;
+	vector<LogicalType> payload_types;
+	for (idx_t i = 0; i < logical_types.size(); i++) {
+		orders.emplace_back(OrderType::ASCENDING, OrderByNullType::NULLS_LAST,
+		                    make_unique<BoundReferenceExpression>(logical_types[i], i));
+		payload_types.push_back(logical_types[i]);
+	}
+	payload_types.push_back(LogicalType::ROW_TYPE);
+	RowLayout payload_layout;
+	payload_layout.Initialize(payload_types);
+
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	result->global_sort_state = make_unique<GlobalSortState>(buffer_manager, orders, payload_layout);
+	result->local_sort_state.Initialize(*result->global_sort_state, buffer_manager);
+	result->sort_chunk.InitializeEmpty(logical_types);
+	result->payload_chunk.Initialize(payload_types);
+	result->memory_limit = buffer_manager.GetMaxMemory() / 4;
+	return move(result);
+}
+
+bool ART::ConstructAppend(IndexLock &lock, IndexConstructState &state, DataChunk &input, Vector &row_ids) {
+	D_ASSERT(row_ids.GetType().InternalType() == ROW_TYPE);
+	D_ASSERT(logical_types[0] == input.data[0].GetType());
+	auto &cstate = (ARTConstructState &)state;
+	if (!cstate.global_sort_state) {
+		return Insert(lock, input, row_ids);
+	}
+
+	// rows with a NULL value in any of the indexed columns are not indexed
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	idx_t count = 0;
+	vector<VectorData> column_data(input.ColumnCount());
+	for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
+		input.data[col_idx].Orrify(input.size(), column_data[col_idx]);
+	}
+	for (idx_t i = 0; i < input.size(); i++) {
+		bool is_valid = true;
+		for (auto &vdata : column_data) {
+			if (!vdata.validity.RowIsValid(vdata.sel->get_index(i))) {
+				is_valid = false;
+				break;
+			}
+		}
+		if (is_valid) {
+			sel.set_index(count++, i);
+		}
+	}
+	if (count == 0) {
+		return true;
+	}
+
+	auto &sort_chunk = cstate.sort_chunk;
+	auto &payload_chunk = cstate.payload_chunk;
+	payload_chunk.Reset();
+	for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
+		sort_chunk.data[col_idx].Reference(input.data[col_idx]);
+		payload_chunk.data[col_idx].Reference(input.data[col_idx]);
+	}
+	payload_chunk.data[input.ColumnCount()].Reference(row_ids);
+	sort_chunk.SetCardinality(input.size());
+	payload_chunk.SetCardinality(input.size());
+	if (count < input.size()) {
+		sort_chunk.Slice(sel, count);
+		payload_chunk.Slice(sel, count);
+	}
+
+	auto &local_sort_state = cstate.local_sort_state;
+	local_sort_state.SinkChunk(sort_chunk, payload_chunk);
+	if (local_sort_state.SizeInBytes() >= cstate.memory_limit) {
+		local_sort_state.Sort(*cstate.global_sort_state, true);
+	}
+	return true;
+}
+
+//! Returns the first position from depth onwards at which the first and the last key of a sorted range differ, or
+//! DConstants::INVALID_INDEX if the keys are equal or one of them is a prefix of the other
+static idx_t GetMismatchPosition(vector<unique_ptr<Key>> &keys, idx_t start, idx_t end, idx_t depth) {
+	auto &first_key = *keys[start];
+	auto &last_key = *keys[end - 1];
+	idx_t pos = depth;
+	while (pos < first_key.len && pos < last_key.len) {
+		if (first_key[pos] != last_key[pos]) {
+			return pos;
+		}
+		pos++;
+	}
+	return DConstants::INVALID_INDEX;
+}
+
+//! A range of sorted keys whose subtree is built by a separate task
+struct ARTConstructPartition {
+	ARTConstructPartition(idx_t start, idx_t end, idx_t depth) : start(start), end(end), depth(depth) {
+	}
+
+	idx_t start;
+	idx_t end;
+	idx_t depth;
+	//! Copies of the first and the last key of the range, the keys themselves are moved into the subtree
+	unique_ptr<Key> first_key;
+	unique_ptr<Key> last_key;
+	SwizzleablePointer node;
+};
+
+//! Splits the sorted keys in the range [start, end) into the ranges of the subtrees that contain at most
+//! partition_size keys
+static void PartitionKeys(vector<unique_ptr<Key>> &keys, idx_t start, idx_t end, idx_t depth, idx_t partition_size,
+                          vector<ARTConstructPartition> &result) {
+	idx_t mismatch_pos = DConstants::INVALID_INDEX;
+	if (end - start > partition_size) {
+		mismatch_pos = GetMismatchPosition(keys, start, end, depth);
+	}
+	if (mismatch_pos == DConstants::INVALID_INDEX) {
+		result.emplace_back(start, end, depth);
+		return;
+	}
+	idx_t child_start = start;
+	while (child_start < end) {
+		auto key_byte = (*keys[child_start])[mismatch_pos];
+		idx_t child_end = child_start + 1;
+		while (child_end < end && (*keys[child_end])[mismatch_pos] == key_byte) {
+			child_end++;
+		}
+		PartitionKeys(keys, child_start, child_end, mismatch_pos + 1, partition_size, result);
+		child_start = child_end;
+	}
+}
+
+static unique_ptr<Key> CopyKey(Key &key) {
+	auto data = unique_ptr<data_t[]>(new data_t[key.len]);
+	memcpy(data.get(), key.data.get(), key.len);
+	return make_unique<Key>(move(data), key.len);
+}
+
+static unique_ptr<Node> CreateInnerNode(ART &art, idx_t child_count, idx_t prefix_length) {
+	if (child_count <= 4) {
+		return make_unique<Node4>(art, prefix_length);
+	} else if (child_count <= 16) {
+		return make_unique<Node16>(art, prefix_length);
+	} else if (child_count <= 48) {
+		return make_unique<Node48>(art, prefix_length);
+	} else {
+		return make_unique<Node256>(art, prefix_length);
+	}
+}
+
+//! Builds the top of the tree from the subtrees of the partitions in the range [start, end). Every partition lies
+//! entirely within one subtree, so the first and the last key of the partitions determine the inner nodes.
+static void ConstructFromPartitions(ART &art, vector<ARTConstructPartition> &partitions, idx_t start, idx_t end,
+                                    idx_t depth, SwizzleablePointer &node) {
+	if (end - start == 1) {
+		D_ASSERT(partitions[start].depth == depth);
+		node = move(partitions[start].node);
+		return;
+	}
+	auto &first_key = *partitions[start].first_key;
+	auto &last_key = *partitions[end - 1].last_key;
+	idx_t mismatch_pos = depth;
+	while (first_key[mismatch_pos] == last_key[mismatch_pos]) {
+		mismatch_pos++;
+	}
+	idx_t child_count = 1;
+	for (idx_t i = start + 1; i < end; i++) {
+		if ((*partitions[i].first_key)[mismatch_pos] != (*partitions[i - 1].first_key)[mismatch_pos]) {
+			child_count++;
+		}
+	}
+	auto prefix_length = mismatch_pos - depth;
+	node = CreateInnerNode(art, child_count, prefix_length);
+	node->prefix_length = prefix_length;
+	memcpy(node->prefix.get(), &first_key[depth], prefix_length);
+
+	idx_t child_start = start;
+	while (child_start < end) {
+		auto key_byte = (*partitions[child_start].first_key)[mismatch_pos];
+		idx_t child_end = child_start + 1;
+		while (child_end < end && (*partitions[child_end].first_key)[mismatch_pos] == key_byte) {
+			child_end++;
+		}
+		SwizzleablePointer child;
+		ConstructFromPartitions(art, partitions, child_start, child_end, mismatch_pos + 1, child);
+		Node::InsertLeaf(art, node, key_byte, child);
+		child_start = child_end;
+	}
+}
+
+class ARTConstructTask : public Task {
+public:
+	ARTConstructTask(ART &art, vector<unique_ptr<Key>> &keys, row_t *row_ids, vector<ARTConstructPartition> &partitions,
+	                 idx_t partition_start, idx_t partition_end, atomic<idx_t> &finished_tasks, atomic<bool> &success,
+	                 string &error, mutex &error_lock)
+	    : art(art), keys(keys), row_ids(row_ids), partitions(partitions), partition_start(partition_start),
+	      partition_end(partition_end), finished_tasks(finished_tasks), success(success), error(error),
+	      error_lock(error_lock) {
+	}
+
+	TaskExecutionResult Execute(TaskExecutionMode mode) override {
+		try {
+			for (idx_t i = partition_start; i < partition_end && success; i++) {
+				auto &partition = partitions[i];
+				if (!art.Construct(keys, row_ids, partition.start, partition.end, partition.depth, partition.node)) {
+					success = false;
+				}
+			}
+		} catch (std::exception &ex) {
+			lock_guard<mutex> guard(error_lock);
+			error = ex.what();
+		} catch (...) {
+			lock_guard<mutex> guard(error_lock);
+			error = "Unknown exception while constructing the index";
+		}
+		finished_tasks++;
+		return TaskExecutionResult::TASK_FINISHED;
+	}
+
+private:
+	ART &art;
+	vector<unique_ptr<Key>> &keys;
+	row_t *row_ids;
+	vector<ARTConstructPartition> &partitions;
+	idx_t partition_start;
+	idx_t partition_end;
+	atomic<idx_t> &finished_tasks;
+	atomic<bool> &success;
+	string &error;
+	mutex &error_lock;
+};
+
+bool ART::ConstructFinalize(IndexLock &lock, IndexConstructState &state) {
+	auto &cstate = (ARTConstructState &)state;
+	if (!cstate.global_sort_state) {
+		return true;
+	}
+	auto &global_sort_state = *cstate.global_sort_state;
+	D_ASSERT(!tree);
+
+	// sort the rows
+	global_sort_state.AddLocalState(cstate.local_sort_state);
+	if (global_sort_state.sorted_blocks.empty()) {
+		return true;
+	}
+	global_sort_state.PrepareMergePhase();
+	while (global_sort_state.sorted_blocks.size() > 1) {
+		global_sort_state.InitializeMergeRound();
+		MergeSorter merge_sorter(global_sort_state, global_sort_state.buffer_manager);
+		merge_sorter.PerformInMergeRound();
+		global_sort_state.CompleteMergeRound();
+	}
+
+	// generate the keys of the sorted rows
+	auto &sorted_block = *global_sort_state.sorted_blocks[0];
+	idx_t total_count = sorted_block.Count();
+	vector<unique_ptr<Key>> keys;
+	keys.reserve(total_count);
+	auto row_ids = unique_ptr<row_t[]>(new row_t[total_count]);
+
+	PayloadScanner scanner(*sorted_block.payload_data, global_sort_state);
+	auto &payload_chunk = cstate.payload_chunk;
+	auto &key_chunk = cstate.sort_chunk;
+	bool is_sorted = true;
+	while (true) {
+		payload_chunk.Reset();
+		scanner.Scan(payload_chunk);
+		if (payload_chunk.size() == 0) {
+			break;
+		}
+		for (idx_t col_idx = 0; col_idx < key_chunk.ColumnCount(); col_idx++) {
+			key_chunk.data[col_idx].Reference(payload_chunk.data[col_idx]);
+		}
+		key_chunk.SetCardinality(payload_chunk.size());
+		vector<unique_ptr<Key>> chunk_keys;
+		GenerateKeys(key_chunk, chunk_keys);
+		auto payload_row_ids = FlatVector::GetData<row_t>(payload_chunk.data[key_chunk.ColumnCount()]);
+		for (idx_t i = 0; i < payload_chunk.size(); i++) {
+			if (!keys.empty() && *chunk_keys[i] < *keys.back()) {
+				is_sorted = false;
+			}
+			row_ids[keys.size()] = payload_row_ids[i];
+			keys.push_back(move(chunk_keys[i]));
+		}
+	}
+	D_ASSERT(keys.size() == total_count);
+	if (!is_sorted) {
+		// the sort order of the columns should match the order of the keys, but fall back to sorting the keys
+		vector<idx_t> order(total_count);
+		for (idx_t i = 0; i < total_count; i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](idx_t a, idx_t b) { return *keys[a] < *keys[b]; });
+		vector<unique_ptr<Key>> sorted_keys(total_count);
+		auto sorted_row_ids = unique_ptr<row_t[]>(new row_t[total_count]);
+		for (idx_t i = 0; i < total_count; i++) {
+			sorted_keys[i] = move(keys[order[i]]);
+			sorted_row_ids[i] = row_ids[order[i]];
+		}
+		keys = move(sorted_keys);
+		row_ids = move(sorted_row_ids);
+	}
+
+	// build the tree bottom-up: the subtrees of the key partitions are built in parallel
+	auto &scheduler = TaskScheduler::GetScheduler(db);
+	idx_t num_threads = scheduler.NumberOfThreads();
+	idx_t partition_size = MaxValue<idx_t>(total_count / (num_threads * 8), STANDARD_VECTOR_SIZE * 8);
+	if (total_count <= partition_size) {
+		auto success = Construct(keys, row_ids.get(), 0, total_count, 0, tree);
+		UpdateMemory();
+		return success;
+	}
+	vector<ARTConstructPartition> partitions;
+	PartitionKeys(keys, 0, total_count, 0, partition_size, partitions);
+	for (auto &partition : partitions) {
+		partition.first_key = CopyKey(*keys[partition.start]);
+		partition.last_key = CopyKey(*keys[partition.end - 1]);
+	}
+
+	auto token = scheduler.CreateProducer();
+	atomic<idx_t> finished_tasks(0);
+	atomic<bool> success(true);
+	string error;
+	mutex error_lock;
+	idx_t task_count = 0;
+	idx_t partition_start = 0;
+	while (partition_start < partitions.size()) {
+		// combine adjacent partitions into tasks of roughly partition_size keys
+		idx_t partition_end = partition_start;
+		idx_t task_keys = 0;
+		while (partition_end < partitions.size() && task_keys < partition_size) {
+			auto &partition = partitions[partition_end++];
+			task_keys += partition.end - partition.start;
+		}
+		scheduler.ScheduleTask(*token, make_unique<ARTConstructTask>(*this, keys, row_ids.get(), partitions,
+		                                                             partition_start, partition_end, finished_tasks,
+		                                                             success, error, error_lock));
+		partition_start = partition_end;
+		task_count++;
+	}
+	// work on the tasks until all of them have been finished
+	unique_ptr<Task> task;
+	while (scheduler.GetTaskFromProducer(*token, task)) {
+		task->Execute(TaskExecutionMode::PROCESS_ALL);
+		task.reset();
+	}
+	while (finished_tasks < task_count) {
+		std::this_thread::yield();
+	}
+	if (!error.empty()) {
+		throw Exception(error);
+	}
+	if (!success) {
+		return false;
+	}
+	// build the top of the tree, the subtrees of the partitions are moved into it
+	ConstructFromPartitions(*this, partitions, 0, partitions.size(), 0, tree);
+	UpdateMemory();
+	return true;
+}
+
+bool ART::Construct(vector<unique_ptr<Key>> &keys, row_t *row_ids, idx_t start, idx_t end, idx_t depth,
+                    SwizzleablePointer &node) {
+	D_ASSERT(start < end);
+	auto &first_key = *keys[start];
+	auto &last_key = *keys[end - 1];
+	if (first_key == last_key) {
+		// all keys in the range are equal: they are stored in a single leaf
+		if (is_unique && end - start > 1) {
+			return false;
+		}
+		node = make_unique<Leaf>(*this, move(keys[start]), row_ids + start, end - start);
+		return true;
+	}
+
+	// the keys are sorted: the prefix shared by the first and the last key is shared by all of them
+	auto mismatch_pos = GetMismatchPosition(keys, start, end, depth);
+	if (mismatch_pos == DConstants::INVALID_INDEX) {
+		// one key is a prefix of another one, which the tree cannot branch on: insert the keys one by one instead
+		for (idx_t i = start; i < end; i++) {
+			if (!Insert(node, move(keys[i]), depth, row_ids[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// count the distinct bytes at the mismatch position to determine the node type
+	idx_t child_count = 1;
+	for (idx_t i = start + 1; i < end; i++) {
+		if ((*keys[i])[mismatch_pos] != (*keys[i - 1])[mismatch_pos]) {
+			child_count++;
+		}
+	}
+	auto prefix_length = mismatch_pos - depth;
+	node = CreateInnerNode(*this, child_count, prefix_length);
+	node->prefix_length = prefix_length;
+	memcpy(node->prefix.get(), &first_key[depth], prefix_length);
+
+	// build the children from the ranges of keys that share the byte at the mismatch position
+	idx_t child_start = start;
+	while (child_start < end) {
+		auto key_byte = (*keys[child_start])[mismatch_pos];
+		idx_t child_end = child_start + 1;
+		while (child_end < end && (*keys[child_end])[mismatch_pos] == key_byte) {
+			child_end++;
+		}
+		SwizzleablePointer child;
+		if (!Construct(keys, row_ids, child_start, child_end, mismatch_pos + 1, child)) {
+			return false;
+		}
+		Node::InsertLeaf(*this, node, key_byte, child);
+		child_start = child_end;
+	}
+	return true;
+}
+
 //===--------------------------------------------------------------------===//
 // Delete
 //===--------------------------------------------------------------------===//
@@ -394,6 +871,8 @@ void ART::Delete(IndexLock &state, DataChunk &input, Vector &row_ids) {
 	// now erase the elements from the database
 	row_ids.Normalify(input.size());
 	auto row_identifiers = FlatVector::GetData<row_t>(row_ids);
+	tree.Unswizzle(*this);
+	SetModified();
 
 	for (idx_t i = 0; i < input.size(); i++) {
 		if (!keys[i]) {
@@ -410,9 +889,15 @@ void ART::Delete(IndexLock &state, DataChunk &input, Vector &row_ids) {
 		}
 #endif
 	}
+	try {
+		UpdateMemory();
+	} catch (OutOfMemoryException &) {
+		// deletes are also used to clean up, so they cannot fail: the nodes that were loaded from disk are reserved
+		// by the next operation on the index instead
+	}
 }
 
-void ART::Erase(unique_ptr<Node> &node, Key &key, unsigned depth, row_t row_id) {
+void ART::Erase(SwizzleablePointer &node, Key &key, unsigned depth, row_t row_id) {
 	if (!node) {
 		return;
 	}
@@ -438,10 +923,10 @@ void ART::Erase(unique_ptr<Node> &node, Key &key, unsigned depth, row_t row_id)
 	}
 	idx_t pos = node->GetChildPos(key[depth]);
 	if (pos != DConstants::INVALID_INDEX) {
-		auto child = node->GetChild(pos);
+		auto child = node->GetChild(*this, pos);
 		D_ASSERT(child);
 
-		unique_ptr<Node> &child_ref = *child;
+		SwizzleablePointer &child_ref = *child;
 		if (child_ref->type == NodeType::NLeaf && LeafMatches(child_ref.get(), key, depth)) {
 			// Leaf found, remove entry
 			auto leaf = static_cast<Leaf *>(child_ref.get());
@@ -497,31 +982,25 @@ static unique_ptr<Key> CreateKey(ART &art, PhysicalType type, Value &value) {
 
 bool ART::SearchEqual(ARTIndexScanState *state, idx_t max_count, vector<row_t> &result_ids) {
 	auto key = CreateKey(*this, types[0], state->values[0]);
+	tree.Unswizzle(*this);
 	auto leaf = static_cast<Leaf *>(Lookup(tree, *key, 0));
 	if (!leaf) {
+		UpdateMemory();
 		return true;
 	}
 	if (leaf->num_elements > max_count) {
+		UpdateMemory();
 		return false;
 	}
 	for (idx_t i = 0; i < leaf->num_elements; i++) {
 		row_t row_id = leaf->GetRowId(i);
 		result_ids.push_back(row_id);
 	}
+	UpdateMemory();
 	return true;
 }
 
-void ART::SearchEqualJoinNoFetch(Value &equal_value, idx_t &result_size) {
-	//! We need to look for a leaf
-	auto key = CreateKey(*this, types[0], equal_value);
-	auto leaf = static_cast<Leaf *>(Lookup(tree, *key, 0));
-	if (!leaf) {
-		return;
-	}
-	result_size = leaf->num_elements;
-}
-
-Node *ART::Lookup(unique_ptr<Node> &node, Key &key, unsigned depth) {
+Node *ART::Lookup(SwizzleablePointer &node, Key &key, unsigned depth) {
 	auto node_val = node.get();
 
 	while (node_val) {
@@ -548,7 +1027,7 @@ Node *ART::Lookup(unique_ptr<Node> &node, Key &key, unsigned depth) {
 		if (pos == DConstants::INVALID_INDEX) {
 			return nullptr;
 		}
-		node_val = node_val->GetChild(pos)->get();
+		node_val = node_val->GetChild(*this, pos)->get();
 		D_ASSERT(node_val);
 
 		depth++;
@@ -557,6 +1036,100 @@ Node *ART::Lookup(unique_ptr<Node> &node, Key &key, unsigned depth) {
 	return nullptr;
 }
 
+void ART::SearchEqualJoin(Vector &input, idx_t count, bool fetch_ids, idx_t result_offsets[], idx_t result_sizes[],
+                          vector<row_t> &result_ids) {
+	DataChunk key_chunk;
+	key_chunk.InitializeEmpty(vector<LogicalType> {input.GetType()});
+	key_chunk.data[0].Reference(input);
+	key_chunk.SetCardinality(count);
+	vector<unique_ptr<Key>> keys;
+	GenerateKeys(key_chunk, keys);
+
+	// NULL keys have no matches, the other keys are looked up in sorted order
+	vector<idx_t> sorted;
+	sorted.reserve(count);
+	for (idx_t i = 0; i < count; i++) {
+		result_sizes[i] = 0;
+		if (keys[i]) {
+			sorted.push_back(i);
+		}
+	}
+	std::sort(sorted.begin(), sorted.end(), [&](const idx_t &lhs, const idx_t &rhs) { return *keys[lhs] < *keys[rhs]; });
+
+	tree.Unswizzle(*this);
+	// the nodes on the path of the previous key, with the depth at which they were reached
+	vector<pair<Node *, idx_t>> path;
+	Key *previous_key = nullptr;
+	idx_t previous_idx = 0;
+	for (auto &key_idx : sorted) {
+		auto &key = *keys[key_idx];
+		if (previous_key && key == *previous_key) {
+			// equal keys have the same matches
+			result_sizes[key_idx] = result_sizes[previous_idx];
+			result_offsets[key_idx] = result_offsets[previous_idx];
+			continue;
+		}
+		// the nodes that were reached through the prefix this key shares with the previous key can be reused
+		idx_t shared_length = 0;
+		if (previous_key) {
+			auto max_length = MinValue<idx_t>(key.len, previous_key->len);
+			while (shared_length < max_length && key[shared_length] == (*previous_key)[shared_length]) {
+				shared_length++;
+			}
+		}
+		while (!path.empty() && path.back().second > shared_length) {
+			path.pop_back();
+		}
+		if (path.empty() && tree.get()) {
+			path.emplace_back(tree.get(), 0);
+		}
+		previous_key = &key;
+		previous_idx = key_idx;
+
+		// descend from the deepest shared node, following the same steps as Lookup
+		Leaf *leaf = nullptr;
+		while (!path.empty()) {
+			auto node_val = path.back().first;
+			auto depth = path.back().second;
+			if (node_val->type == NodeType::NLeaf) {
+				if (LeafMatches(node_val, key, depth)) {
+					leaf = static_cast<Leaf *>(node_val);
+				}
+				break;
+			}
+			bool prefix_matches = true;
+			for (idx_t pos = 0; pos < node_val->prefix_length; pos++) {
+				if (key[depth + pos] != node_val->prefix[pos]) {
+					prefix_matches = false;
+					break;
+				}
+			}
+			if (!prefix_matches) {
+				break;
+			}
+			depth += node_val->prefix_length;
+			idx_t pos = node_val->GetChildPos(key[depth]);
+			if (pos == DConstants::INVALID_INDEX) {
+				break;
+			}
+			auto child = node_val->GetChild(*this, pos)->get();
+			D_ASSERT(child);
+			path.emplace_back(child, depth + 1);
+		}
+		if (!leaf) {
+			continue;
+		}
+		result_sizes[key_idx] = leaf->num_elements;
+		if (fetch_ids) {
+			result_offsets[key_idx] = result_ids.size();
+			for (idx_t i = 0; i < leaf->num_elements; i++) {
+				result_ids.push_back(leaf->GetRowId(i));
+			}
+		}
+	}
+	UpdateMemory();
+}
+
 //===--------------------------------------------------------------------===//
 // Iterator scans
 //===--------------------------------------------------------------------===//
@@ -617,7 +1190,7 @@ bool ART::IteratorNext(Iterator &it) {
 		top.pos = node->GetNextPos(top.pos);
 		if (top.pos != DConstants::INVALID_INDEX) {
 			// next node found: go there
-			it.SetEntry(it.depth, IteratorEntry(node->GetChild(top.pos)->get(), DConstants::INVALID_INDEX));
+			it.SetEntry(it.depth, IteratorEntry(node->GetChild(*this, top.pos)->get(), DConstants::INVALID_INDEX));
 			it.depth++;
 		} else {
 			// no node found: move up the tree
@@ -632,9 +1205,10 @@ bool ART::IteratorNext(Iterator &it) {
 // Returns: True (If found leaf >= key)
 //          False (Otherwise)
 //===--------------------------------------------------------------------===//
-bool ART::Bound(unique_ptr<Node> &n, Key &key, Iterator &it, bool inclusive) {
+bool ART::Bound(SwizzleablePointer &n, Key &key, Iterator &it, bool inclusive) {
 	it.depth = 0;
-	bool equal = false;
+	// start by descending along the key: only jump to the minimum of a subtree once it is known to be greater
+	bool equal = true;
 	if (!n) {
 		return false;
 	}
@@ -647,7 +1221,7 @@ bool ART::Bound(unique_ptr<Node> &n, Key &key, Iterator &it, bool inclusive) {
 		it.depth++;
 		if (!equal) {
 			while (node->type != NodeType::NLeaf) {
-				node = node->GetChild(node->GetMin())->get();
+				node = node->GetChild(*this, node->GetMin())->get();
 				auto &c_top = it.stack[it.depth];
 				c_top.node = node;
 				it.depth++;
@@ -705,10 +1279,11 @@ bool ART::Bound(unique_ptr<Node> &n, Key &key, Iterator &it, bool inclusive) {
 
 		top.pos = node->GetChildGreaterEqual(key[depth], equal);
 		if (top.pos == DConstants::INVALID_INDEX) {
-			// Find min leaf
-			top.pos = node->GetMin();
+			// all children are lower than the key: continue with the next subtree
+			it.depth--;
+			return IteratorNext(it);
 		}
-		node = node->GetChild(top.pos)->get();
+		node = node->GetChild(*this, top.pos)->get();
 		//! This means all children of this node qualify as geq
 
 		depth++;
@@ -736,7 +1311,7 @@ bool ART::SearchGreater(ARTIndexScanState *state, bool inclusive, idx_t max_coun
 //===--------------------------------------------------------------------===//
 // Less Than
 //===--------------------------------------------------------------------===//
-static Leaf &FindMinimum(Iterator &it, Node &node) {
+static Leaf &FindMinimum(ART &art, Iterator &it, Node &node) {
 	Node *next = nullptr;
 	idx_t pos = 0;
 	switch (node.type) {
@@ -744,17 +1319,15 @@ static Leaf &FindMinimum(Iterator &it, Node &node) {
 		it.node = (Leaf *)&node;
 		return (Leaf &)node;
 	case NodeType::N4:
-		next = ((Node4 &)node).child[0].get();
-		break;
 	case NodeType::N16:
-		next = ((Node16 &)node).child[0].get();
+		next = node.GetChild(art, 0)->get();
 		break;
 	case NodeType::N48: {
 		auto &n48 = (Node48 &)node;
 		while (n48.child_index[pos] == Node::EMPTY_MARKER) {
 			pos++;
 		}
-		next = n48.child[n48.child_index[pos]].get();
+		next = n48.GetChild(art, pos)->get();
 		break;
 	}
 	case NodeType::N256: {
@@ -762,13 +1335,13 @@ static Leaf &FindMinimum(Iterator &it, Node &node) {
 		while (!n256.child[pos]) {
 			pos++;
 		}
-		next = n256.child[pos].get();
+		next = n256.GetChild(art, pos)->get();
 		break;
 	}
 	}
 	it.SetEntry(it.depth, IteratorEntry(&node, pos));
 	it.depth++;
-	return FindMinimum(it, *next);
+	return FindMinimum(art, it, *next);
 }
 
 bool ART::SearchLess(ARTIndexScanState *state, bool inclusive, idx_t max_count, vector<row_t> &result_ids) {
@@ -781,7 +1354,7 @@ bool ART::SearchLess(ARTIndexScanState *state, bool inclusive, idx_t max_count,
 
 	if (!it->start) {
 		// first find the minimum value in the ART: we start scanning from this value
-		auto &minimum = FindMinimum(state->iterator, *tree);
+		auto &minimum = FindMinimum(*this, state->iterator, *tree);
 		// early out min value higher than upper bound query
 		if (*minimum.value > *upper_bound) {
 			return true;
@@ -830,6 +1403,7 @@ bool ART::Scan(Transaction &transaction, DataTable &table, IndexScanState &table
 	bool success = true;
 	if (state->values[1].is_null) {
 		lock_guard<mutex> l(lock);
+		tree.Unswizzle(*this);
 		// single predicate
 		switch (state->expressions[0]) {
 		case ExpressionType::COMPARE_EQUAL:
@@ -850,13 +1424,16 @@ bool ART::Scan(Transaction &transaction, DataTable &table, IndexScanState &table
 		default:
 			throw InternalException("Operation not implemented");
 		}
+		UpdateMemory();
 	} else {
 		lock_guard<mutex> l(lock);
+		tree.Unswizzle(*this);
 		// two predicates
 		D_ASSERT(state->values[1].type().InternalType() == types[0]);
 		bool left_inclusive = state->expressions[0] == ExpressionType ::COMPARE_GREATERTHANOREQUALTO;
 		bool right_inclusive = state->expressions[1] == ExpressionType ::COMPARE_LESSTHANOREQUALTO;
 		success = SearchCloseRange(state, left_inclusive, right_inclusive, max_count, row_ids);
+		UpdateMemory();
 	}
 	if (!success) {
 		return false;
@@ -878,4 +1455,67 @@ bool ART::Scan(Transaction &transaction, DataTable &table, IndexScanState &table
 	return true;
 }
 
+//===--------------------------------------------------------------------===//
+// Serialization
+//===--------------------------------------------------------------------===//
+IndexPointer ART::Serialize(MetaBlockWriter &writer) {
+	lock_guard<mutex> l(lock);
+	IndexPointer result;
+	if (!tree) {
+		result.root.block_id = INVALID_BLOCK;
+		result.root.offset = 0;
+		return result;
+	}
+	// keep track of the blocks the nodes are written to
+	auto start_block = writer.block->id;
+	auto written_blocks = writer.written_blocks;
+	result.root = tree.Serialize(*this, writer);
+
+	set<block_id_t> index_blocks_written {start_block, writer.block->id};
+	for (auto &block_id : writer.written_blocks) {
+		if (written_blocks.find(block_id) == written_blocks.end()) {
+			index_blocks_written.insert(block_id);
+		}
+	}
+	result.blocks.insert(result.blocks.end(), index_blocks_written.begin(), index_blocks_written.end());
+	// serializing loaded all the nodes of the tree: we no longer need the blocks they were read from
+	index_blocks.clear();
+	// the written blocks stay valid until the next checkpoint, which writes the tree again
+	serialized_root = result.root;
+	UpdateMemory();
+	return result;
+}
+
+void ART::RegisterIndexBlock(shared_ptr<BlockHandle> block) {
+	auto block_id = block->BlockId();
+	index_blocks[block_id] = move(block);
+}
+
+//===--------------------------------------------------------------------===//
+// Memory Management
+//===--------------------------------------------------------------------===//
+void ART::UpdateMemory() {
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	idx_t current_size = memory_size;
+	if (serialized_root.block_id != INVALID_BLOCK && current_size >= Storage::BLOCK_SIZE &&
+	    buffer_manager.GetUsedMemory() - reserved_memory + current_size > buffer_manager.GetMaxMemory()) {
+		// the memory limit is exceeded and the tree is unchanged since it was written to disk: unload all nodes,
+		// including the root. They are loaded again from disk when they are accessed.
+		tree = SwizzleablePointer(serialized_root);
+		index_blocks.clear();
+		current_size = memory_size;
+	}
+	if (current_size > reserved_memory) {
+		buffer_manager.ReserveMemory(current_size - reserved_memory);
+	} else if (current_size < reserved_memory) {
+		buffer_manager.FreeReservedMemory(reserved_memory - current_size);
+	}
+	reserved_memory = current_size;
+}
+
+void ART::SetModified() {
+	serialized_root.block_id = INVALID_BLOCK;
+	serialized_root.offset = 0;
+}
+
 } // namespace duckdb
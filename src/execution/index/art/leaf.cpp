@@ -1,5 +1,7 @@
 #include "duckdb/execution/index/art/node.hpp"
 #include "duckdb/execution/index/art/leaf.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
 
 #include <cstring>
 
@@ -11,6 +13,21 @@ Leaf::Leaf(ART &art, unique_ptr<Key> value, row_t row_id) : Node(art, NodeType::
 	this->row_ids = unique_ptr<row_t[]>(new row_t[this->capacity]);
 	this->row_ids[0] = row_id;
 	this->num_elements = 1;
+	IncreaseMemory(sizeof(Key) + this->value->len + this->capacity * sizeof(row_t));
+}
+
+Leaf::Leaf(ART &art, unique_ptr<Key> value, row_t *row_ids_p, idx_t count) : Node(art, NodeType::NLeaf, 0) {
+	D_ASSERT(count > 0);
+	this->value = move(value);
+	this->capacity = count;
+	this->row_ids = unique_ptr<row_t[]>(new row_t[count]);
+	memcpy(this->row_ids.get(), row_ids_p, count * sizeof(row_t));
+	this->num_elements = count;
+	IncreaseMemory(sizeof(Key) + this->value->len + this->capacity * sizeof(row_t));
+}
+
+Leaf::Leaf(ART &art, size_t compression_length)
+    : Node(art, NodeType::NLeaf, compression_length), capacity(0), num_elements(0) {
 }
 
 void Leaf::Insert(row_t row_id) {
@@ -18,6 +35,7 @@ void Leaf::Insert(row_t row_id) {
 	if (num_elements == capacity) {
 		auto new_row_id = unique_ptr<row_t[]>(new row_t[capacity * 2]);
 		memcpy(new_row_id.get(), row_ids.get(), capacity * sizeof(row_t));
+		IncreaseMemory(capacity * sizeof(row_t));
 		capacity *= 2;
 		row_ids = move(new_row_id);
 	}
@@ -43,6 +61,7 @@ void Leaf::Remove(row_t row_id) {
 		memcpy(new_row_id.get() + entry_offset, row_ids.get() + entry_offset + 1,
 		       (num_elements - entry_offset) * sizeof(row_t));
 		capacity /= 2;
+		DecreaseMemory(capacity * sizeof(row_t));
 		row_ids = move(new_row_id);
 	} else {
 		// Copy the rest
@@ -52,4 +71,26 @@ void Leaf::Remove(row_t row_id) {
 	}
 }
 
+BlockPointer Leaf::Serialize(ART &art, MetaBlockWriter &writer) {
+	auto pointer = SerializeHeader(writer);
+	writer.Write<uint32_t>(value->len);
+	writer.WriteData(value->data.get(), value->len);
+	writer.Write<uint64_t>(num_elements);
+	writer.WriteData((const_data_ptr_t)row_ids.get(), num_elements * sizeof(row_t));
+	return pointer;
+}
+
+void Leaf::DeserializeInternal(MetaBlockReader &reader) {
+	auto key_length = reader.Read<uint32_t>();
+	auto key_data = unique_ptr<data_t[]>(new data_t[key_length]);
+	reader.ReadData(key_data.get(), key_length);
+	value = make_unique<Key>(move(key_data), key_length);
+
+	num_elements = reader.Read<uint64_t>();
+	capacity = MaxValue<idx_t>(num_elements, 1);
+	row_ids = unique_ptr<row_t[]>(new row_t[capacity]);
+	reader.ReadData((data_ptr_t)row_ids.get(), num_elements * sizeof(row_t));
+	IncreaseMemory(sizeof(Key) + key_length + capacity * sizeof(row_t));
+}
+
 } // namespace duckdb
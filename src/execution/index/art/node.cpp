@@ -1,11 +1,47 @@
 #include "duckdb/execution/index/art/node.hpp"
 #include "duckdb/execution/index/art/art.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
 
 namespace duckdb {
 
-Node::Node(ART &art, NodeType type, size_t compressed_prefix_size) : prefix_length(0), count(0), type(type) {
+static idx_t GetNodeSize(NodeType type) {
+	switch (type) {
+	case NodeType::N4:
+		return sizeof(Node4);
+	case NodeType::N16:
+		return sizeof(Node16);
+	case NodeType::N48:
+		return sizeof(Node48);
+	case NodeType::N256:
+		return sizeof(Node256);
+	case NodeType::NLeaf:
+		return sizeof(Leaf);
+	default:
+		throw InternalException("Unrecognized node type for size");
+	}
+}
+
+Node::Node(ART &art, NodeType type, size_t compressed_prefix_size)
+    : prefix_length(0), count(0), type(type), owner(art), memory_size(0) {
 	this->prefix = unique_ptr<uint8_t[]>(new uint8_t[compressed_prefix_size]);
+	IncreaseMemory(GetNodeSize(type) + compressed_prefix_size);
+}
+
+Node::~Node() {
+	owner.DecreaseMemory(memory_size);
+}
+
+void Node::IncreaseMemory(idx_t size) {
+	memory_size += size;
+	owner.IncreaseMemory(size);
+}
+
+void Node::DecreaseMemory(idx_t size) {
+	D_ASSERT(size <= memory_size);
+	memory_size -= size;
+	owner.DecreaseMemory(size);
 }
 
 void Node::CopyPrefix(ART &art, Node *src, Node *dst) {
@@ -14,11 +50,19 @@ void Node::CopyPrefix(ART &art, Node *src, Node *dst) {
 }
 
 // LCOV_EXCL_START
-unique_ptr<Node> *Node::GetChild(idx_t pos) {
+SwizzleablePointer *Node::GetChild(ART &art, idx_t pos) {
 	D_ASSERT(0);
 	return nullptr;
 }
 
+BlockPointer Node::Serialize(ART &art, MetaBlockWriter &writer) {
+	throw InternalException("Unimplemented Serialize for ARTNode");
+}
+
+void Node::DeserializeInternal(MetaBlockReader &reader) {
+	throw InternalException("Unimplemented DeserializeInternal for ARTNode");
+}
+
 idx_t Node::GetMin() {
 	D_ASSERT(0);
 	return 0;
@@ -35,7 +79,7 @@ uint32_t Node::PrefixMismatch(ART &art, Node *node, Key &key, uint64_t depth) {
 	return pos;
 }
 
-void Node::InsertLeaf(ART &art, unique_ptr<Node> &node, uint8_t key, unique_ptr<Node> &new_node) {
+void Node::InsertLeaf(ART &art, SwizzleablePointer &node, uint8_t key, SwizzleablePointer &new_node) {
 	switch (node->type) {
 	case NodeType::N4:
 		Node4::Insert(art, node, key, new_node);
@@ -54,7 +98,7 @@ void Node::InsertLeaf(ART &art, unique_ptr<Node> &node, uint8_t key, unique_ptr<
 	}
 }
 
-void Node::Erase(ART &art, unique_ptr<Node> &node, idx_t pos) {
+void Node::Erase(ART &art, SwizzleablePointer &node, idx_t pos) {
 	switch (node->type) {
 	case NodeType::N4: {
 		Node4::Erase(art, node, pos);
@@ -76,4 +120,61 @@ void Node::Erase(ART &art, unique_ptr<Node> &node, idx_t pos) {
 	}
 }
 
+//===--------------------------------------------------------------------===//
+// Serialization
+//===--------------------------------------------------------------------===//
+BlockPointer Node::SerializeHeader(MetaBlockWriter &writer) {
+	auto pointer = writer.GetBlockPointer();
+	writer.Write<uint8_t>((uint8_t)type);
+	writer.Write<uint32_t>(prefix_length);
+	writer.WriteData(prefix.get(), prefix_length);
+	writer.Write<uint16_t>(count);
+	return pointer;
+}
+
+vector<BlockPointer> Node::SerializeChildren(ART &art, MetaBlockWriter &writer, SwizzleablePointer children[],
+                                             idx_t child_count) {
+	vector<BlockPointer> result;
+	result.reserve(child_count);
+	for (idx_t i = 0; i < child_count; i++) {
+		result.push_back(children[i].Serialize(art, writer));
+	}
+	return result;
+}
+
+unique_ptr<Node> Node::Deserialize(ART &art, block_id_t block_id, uint32_t offset) {
+	MetaBlockReader reader(art.db, block_id);
+	reader.offset = offset;
+	// the remaining nodes in this block are likely to be accessed soon as well
+	art.RegisterIndexBlock(reader.block);
+
+	auto type = (NodeType)reader.Read<uint8_t>();
+	auto prefix_length = reader.Read<uint32_t>();
+	unique_ptr<Node> result;
+	switch (type) {
+	case NodeType::NLeaf:
+		result = make_unique<Leaf>(art, prefix_length);
+		break;
+	case NodeType::N4:
+		result = make_unique<Node4>(art, prefix_length);
+		break;
+	case NodeType::N16:
+		result = make_unique<Node16>(art, prefix_length);
+		break;
+	case NodeType::N48:
+		result = make_unique<Node48>(art, prefix_length);
+		break;
+	case NodeType::N256:
+		result = make_unique<Node256>(art, prefix_length);
+		break;
+	default:
+		throw InternalException("Unrecognized node type for deserialization");
+	}
+	result->prefix_length = prefix_length;
+	reader.ReadData(result->prefix.get(), prefix_length);
+	result->count = reader.Read<uint16_t>();
+	result->DeserializeInternal(reader);
+	return result;
+}
+
 } // namespace duckdb
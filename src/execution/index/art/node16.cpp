@@ -1,6 +1,8 @@
 #include "duckdb/execution/index/art/node4.hpp"
 #include "duckdb/execution/index/art/node16.hpp"
 #include "duckdb/execution/index/art/node48.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
 
 #include <cstring>
 
@@ -31,7 +33,7 @@ idx_t Node16::GetChildGreaterEqual(uint8_t k, bool &equal) {
 			return pos;
 		}
 	}
-	return Node::GetChildGreaterEqual(k, equal);
+	return DConstants::INVALID_INDEX;
 }
 
 idx_t Node16::GetNextPos(idx_t pos) {
@@ -42,8 +44,9 @@ idx_t Node16::GetNextPos(idx_t pos) {
 	return pos < count ? pos : DConstants::INVALID_INDEX;
 }
 
-unique_ptr<Node> *Node16::GetChild(idx_t pos) {
+SwizzleablePointer *Node16::GetChild(ART &art, idx_t pos) {
 	D_ASSERT(pos < count);
+	child[pos].Unswizzle(art);
 	return &child[pos];
 }
 
@@ -51,7 +54,7 @@ idx_t Node16::GetMin() {
 	return 0;
 }
 
-void Node16::Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_ptr<Node> &child) {
+void Node16::Insert(ART &art, SwizzleablePointer &node, uint8_t key_byte, SwizzleablePointer &child) {
 	Node16 *n = static_cast<Node16 *>(node.get());
 
 	if (n->count < 16) {
@@ -60,7 +63,7 @@ void Node16::Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_p
 		while (pos < node->count && n->key[pos] < key_byte) {
 			pos++;
 		}
-		if (n->child[pos] != nullptr) {
+		if (n->child[pos]) {
 			for (idx_t i = n->count; i > pos; i--) {
 				n->key[i] = n->key[i - 1];
 				n->child[i] = move(n->child[i - 1]);
@@ -84,7 +87,7 @@ void Node16::Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_p
 	}
 }
 
-void Node16::Erase(ART &art, unique_ptr<Node> &node, int pos) {
+void Node16::Erase(ART &art, SwizzleablePointer &node, int pos) {
 	Node16 *n = static_cast<Node16 *>(node.get());
 	// erase the child and decrease the count
 	n->child[pos].reset();
@@ -106,4 +109,21 @@ void Node16::Erase(ART &art, unique_ptr<Node> &node, int pos) {
 	}
 }
 
+BlockPointer Node16::Serialize(ART &art, MetaBlockWriter &writer) {
+	auto child_pointers = SerializeChildren(art, writer, child, 16);
+	auto pointer = SerializeHeader(writer);
+	writer.WriteData(key, 16);
+	for (auto &child_pointer : child_pointers) {
+		SwizzleablePointer::WriteBlockPointer(writer, child_pointer);
+	}
+	return pointer;
+}
+
+void Node16::DeserializeInternal(MetaBlockReader &reader) {
+	reader.ReadData(key, 16);
+	for (idx_t i = 0; i < 16; i++) {
+		child[i] = SwizzleablePointer(reader);
+	}
+}
+
 } // namespace duckdb
@@ -1,5 +1,7 @@
 #include "duckdb/execution/index/art/node48.hpp"
 #include "duckdb/execution/index/art/node256.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
 
 namespace duckdb {
 
@@ -46,19 +48,20 @@ idx_t Node256::GetNextPos(idx_t pos) {
 	return Node::GetNextPos(pos);
 }
 
-unique_ptr<Node> *Node256::GetChild(idx_t pos) {
+SwizzleablePointer *Node256::GetChild(ART &art, idx_t pos) {
 	D_ASSERT(child[pos]);
+	child[pos].Unswizzle(art);
 	return &child[pos];
 }
 
-void Node256::Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_ptr<Node> &child) {
+void Node256::Insert(ART &art, SwizzleablePointer &node, uint8_t key_byte, SwizzleablePointer &child) {
 	Node256 *n = static_cast<Node256 *>(node.get());
 
 	n->count++;
 	n->child[key_byte] = move(child);
 }
 
-void Node256::Erase(ART &art, unique_ptr<Node> &node, int pos) {
+void Node256::Erase(ART &art, SwizzleablePointer &node, int pos) {
 	Node256 *n = static_cast<Node256 *>(node.get());
 
 	n->child[pos].reset();
@@ -77,4 +80,19 @@ void Node256::Erase(ART &art, unique_ptr<Node> &node, int pos) {
 	}
 }
 
+BlockPointer Node256::Serialize(ART &art, MetaBlockWriter &writer) {
+	auto child_pointers = SerializeChildren(art, writer, child, 256);
+	auto pointer = SerializeHeader(writer);
+	for (auto &child_pointer : child_pointers) {
+		SwizzleablePointer::WriteBlockPointer(writer, child_pointer);
+	}
+	return pointer;
+}
+
+void Node256::DeserializeInternal(MetaBlockReader &reader) {
+	for (idx_t i = 0; i < 256; i++) {
+		child[i] = SwizzleablePointer(reader);
+	}
+}
+
 } // namespace duckdb
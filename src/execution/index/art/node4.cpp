@@ -1,6 +1,8 @@
 #include "duckdb/execution/index/art/node4.hpp"
 #include "duckdb/execution/index/art/node16.hpp"
 #include "duckdb/execution/index/art/art.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
 
 namespace duckdb {
 
@@ -28,7 +30,7 @@ idx_t Node4::GetChildGreaterEqual(uint8_t k, bool &equal) {
 			return pos;
 		}
 	}
-	return Node::GetChildGreaterEqual(k, equal);
+	return DConstants::INVALID_INDEX;
 }
 
 idx_t Node4::GetMin() {
@@ -43,12 +45,13 @@ idx_t Node4::GetNextPos(idx_t pos) {
 	return pos < count ? pos : DConstants::INVALID_INDEX;
 }
 
-unique_ptr<Node> *Node4::GetChild(idx_t pos) {
+SwizzleablePointer *Node4::GetChild(ART &art, idx_t pos) {
 	D_ASSERT(pos < count);
+	child[pos].Unswizzle(art);
 	return &child[pos];
 }
 
-void Node4::Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_ptr<Node> &child) {
+void Node4::Insert(ART &art, SwizzleablePointer &node, uint8_t key_byte, SwizzleablePointer &child) {
 	Node4 *n = static_cast<Node4 *>(node.get());
 
 	// Insert leaf into inner node
@@ -58,7 +61,7 @@ void Node4::Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_pt
 		while ((pos < node->count) && (n->key[pos] < key_byte)) {
 			pos++;
 		}
-		if (n->child[pos] != nullptr) {
+		if (n->child[pos]) {
 			for (idx_t i = n->count; i > pos; i--) {
 				n->key[i] = n->key[i - 1];
 				n->child[i] = move(n->child[i - 1]);
@@ -81,7 +84,7 @@ void Node4::Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_pt
 	}
 }
 
-void Node4::Erase(ART &art, unique_ptr<Node> &node, int pos) {
+void Node4::Erase(ART &art, SwizzleablePointer &node, int pos) {
 	Node4 *n = static_cast<Node4 *>(node.get());
 	D_ASSERT(pos < n->count);
 
@@ -96,7 +99,7 @@ void Node4::Erase(ART &art, unique_ptr<Node> &node, int pos) {
 
 	// This is a one way node
 	if (n->count == 1) {
-		auto childref = n->child[0].get();
+		auto childref = n->child[0].Unswizzle(art);
 		//! concatenate prefixes
 		auto new_length = node->prefix_length + childref->prefix_length + 1;
 		//! have to allocate space in our prefix array
@@ -113,10 +116,28 @@ void Node4::Erase(ART &art, unique_ptr<Node> &node, int pos) {
 			new_prefix[i] = node->prefix[i];
 		}
 		//! set new prefix and move the child
+		childref->IncreaseMemory(node->prefix_length + 1);
 		childref->prefix = move(new_prefix);
 		childref->prefix_length = new_length;
 		node = move(n->child[0]);
 	}
 }
 
+BlockPointer Node4::Serialize(ART &art, MetaBlockWriter &writer) {
+	auto child_pointers = SerializeChildren(art, writer, child, 4);
+	auto pointer = SerializeHeader(writer);
+	writer.WriteData(key, 4);
+	for (auto &child_pointer : child_pointers) {
+		SwizzleablePointer::WriteBlockPointer(writer, child_pointer);
+	}
+	return pointer;
+}
+
+void Node4::DeserializeInternal(MetaBlockReader &reader) {
+	reader.ReadData(key, 4);
+	for (idx_t i = 0; i < 4; i++) {
+		child[i] = SwizzleablePointer(reader);
+	}
+}
+
 } // namespace duckdb
@@ -1,6 +1,8 @@
 #include "duckdb/execution/index/art/node16.hpp"
 #include "duckdb/execution/index/art/node48.hpp"
 #include "duckdb/execution/index/art/node256.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
 
 namespace duckdb {
 
@@ -29,7 +31,7 @@ idx_t Node48::GetChildGreaterEqual(uint8_t k, bool &equal) {
 			return pos;
 		}
 	}
-	return Node::GetChildGreaterEqual(k, equal);
+	return DConstants::INVALID_INDEX;
 }
 
 idx_t Node48::GetNextPos(idx_t pos) {
@@ -41,8 +43,9 @@ idx_t Node48::GetNextPos(idx_t pos) {
 	return Node::GetNextPos(pos);
 }
 
-unique_ptr<Node> *Node48::GetChild(idx_t pos) {
+SwizzleablePointer *Node48::GetChild(ART &art, idx_t pos) {
 	D_ASSERT(child_index[pos] != Node::EMPTY_MARKER);
+	child[child_index[pos]].Unswizzle(art);
 	return &child[child_index[pos]];
 }
 
@@ -55,7 +58,7 @@ idx_t Node48::GetMin() {
 	return DConstants::INVALID_INDEX;
 }
 
-void Node48::Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_ptr<Node> &child) {
+void Node48::Insert(ART &art, SwizzleablePointer &node, uint8_t key_byte, SwizzleablePointer &child) {
 	Node48 *n = static_cast<Node48 *>(node.get());
 
 	// Insert leaf into inner node
@@ -87,7 +90,7 @@ void Node48::Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_p
 	}
 }
 
-void Node48::Erase(ART &art, unique_ptr<Node> &node, int pos) {
+void Node48::Erase(ART &art, SwizzleablePointer &node, int pos) {
 	Node48 *n = static_cast<Node48 *>(node.get());
 
 	n->child[n->child_index[pos]].reset();
@@ -106,4 +109,21 @@ void Node48::Erase(ART &art, unique_ptr<Node> &node, int pos) {
 	}
 }
 
+BlockPointer Node48::Serialize(ART &art, MetaBlockWriter &writer) {
+	auto child_pointers = SerializeChildren(art, writer, child, 48);
+	auto pointer = SerializeHeader(writer);
+	writer.WriteData(child_index, 256);
+	for (auto &child_pointer : child_pointers) {
+		SwizzleablePointer::WriteBlockPointer(writer, child_pointer);
+	}
+	return pointer;
+}
+
+void Node48::DeserializeInternal(MetaBlockReader &reader) {
+	reader.ReadData(child_index, 256);
+	for (idx_t i = 0; i < 48; i++) {
+		child[i] = SwizzleablePointer(reader);
+	}
+}
+
 } // namespace duckdb
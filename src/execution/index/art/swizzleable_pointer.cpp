@@ -0,0 +1,92 @@
+#include "duckdb/execution/index/art/swizzleable_pointer.hpp"
+#include "duckdb/execution/index/art/art.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
+
+namespace duckdb {
+
+SwizzleablePointer::SwizzleablePointer(unique_ptr<Node> node) : pointer((uint64_t)(uintptr_t)node.release()) {
+}
+
+SwizzleablePointer::SwizzleablePointer(BlockPointer block_pointer) : pointer(0) {
+	if (block_pointer.block_id == INVALID_BLOCK) {
+		return;
+	}
+	if (block_pointer.block_id < 0 || (uint64_t)block_pointer.block_id >= (1ULL << 31)) {
+		throw InternalException("Block id of serialized ART node is out of range");
+	}
+	pointer = SWIZZLE_FLAG | ((uint64_t)block_pointer.block_id << 32) | block_pointer.offset;
+}
+
+static BlockPointer ReadBlockPointer(MetaBlockReader &reader) {
+	BlockPointer result;
+	result.block_id = reader.Read<block_id_t>();
+	result.offset = reader.Read<uint32_t>();
+	return result;
+}
+
+SwizzleablePointer::SwizzleablePointer(MetaBlockReader &reader) : SwizzleablePointer(ReadBlockPointer(reader)) {
+}
+
+SwizzleablePointer::SwizzleablePointer(SwizzleablePointer &&other) noexcept : pointer(other.pointer) {
+	other.pointer = 0;
+}
+
+SwizzleablePointer::~SwizzleablePointer() {
+	reset();
+}
+
+SwizzleablePointer &SwizzleablePointer::operator=(SwizzleablePointer &&other) noexcept {
+	// take the pointer before destroying the current node: the other pointer might be owned by it
+	auto new_pointer = other.pointer;
+	other.pointer = 0;
+	reset();
+	pointer = new_pointer;
+	return *this;
+}
+
+SwizzleablePointer &SwizzleablePointer::operator=(unique_ptr<Node> node) {
+	reset();
+	pointer = (uint64_t)(uintptr_t)node.release();
+	return *this;
+}
+
+BlockPointer SwizzleablePointer::GetSwizzledBlockInfo() const {
+	D_ASSERT(IsSwizzled());
+	BlockPointer result;
+	result.block_id = (block_id_t)((pointer & ~SWIZZLE_FLAG) >> 32);
+	result.offset = (uint32_t)(pointer & 0xFFFFFFFF);
+	return result;
+}
+
+Node *SwizzleablePointer::Unswizzle(ART &art) {
+	if (IsSwizzled()) {
+		auto block_info = GetSwizzledBlockInfo();
+		pointer = (uint64_t)(uintptr_t)Node::Deserialize(art, block_info.block_id, block_info.offset).release();
+	}
+	return get();
+}
+
+BlockPointer SwizzleablePointer::Serialize(ART &art, MetaBlockWriter &writer) {
+	if (!pointer) {
+		BlockPointer result;
+		result.block_id = INVALID_BLOCK;
+		result.offset = 0;
+		return result;
+	}
+	return Unswizzle(art)->Serialize(art, writer);
+}
+
+void SwizzleablePointer::WriteBlockPointer(MetaBlockWriter &writer, BlockPointer pointer) {
+	writer.Write<block_id_t>(pointer.block_id);
+	writer.Write<uint32_t>(pointer.offset);
+}
+
+void SwizzleablePointer::reset() {
+	if (pointer && !IsSwizzled()) {
+		delete (Node *)pointer;
+	}
+	pointer = 0;
+}
+
+} // namespace duckdb
@@ -1,5 +1,6 @@
 #include "duckdb/execution/join_hashtable.hpp"
 
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/operator/comparison_operators.hpp"
 #include "duckdb/common/row_operations/row_operations.hpp"
@@ -9,6 +10,10 @@
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace duckdb {
 
 using ValidityBytes = JoinHashTable::ValidityBytes;
@@ -17,7 +22,7 @@ using ScanStructure = JoinHashTable::ScanStructure;
 JoinHashTable::JoinHashTable(BufferManager &buffer_manager, const vector<JoinCondition> &conditions,
                              vector<LogicalType> btypes, JoinType type)
     : buffer_manager(buffer_manager), build_types(move(btypes)), entry_size(0), tuple_size(0),
-      vfound(Value::BOOLEAN(false)), join_type(type), finalized(false), has_null(false) {
+      vfound(Value::BOOLEAN(false)), join_type(type), finalized(false), has_null(false), tag_probing(false) {
 	for (auto &condition : conditions) {
 		D_ASSERT(condition.left->return_type == condition.right->return_type);
 		auto type = condition.left->return_type;
@@ -237,8 +242,113 @@ void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
 	                       added_count);
 }
 
-void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[]) {
+template <bool PARALLEL>
+static inline void InsertHashesLoop(atomic<data_ptr_t> pointers[], const hash_t indices[], const idx_t count,
+                                    const data_ptr_t key_locations[], const idx_t pointer_offset) {
+	for (idx_t i = 0; i < count; i++) {
+		auto index = indices[i];
+		if (PARALLEL) {
+			// set prev in the current key to the head of the chain, and try to make the current key the new head
+			data_ptr_t head;
+			do {
+				head = pointers[index].load();
+				Store<data_ptr_t>(head, key_locations[i] + pointer_offset);
+			} while (!pointers[index].compare_exchange_weak(head, key_locations[i]));
+		} else {
+			// set prev in current key to the value (NOTE: this will be nullptr if
+			// there is none)
+			Store<data_ptr_t>(pointers[index].load(std::memory_order_relaxed), key_locations[i] + pointer_offset);
+
+			// set pointer to current tuple
+			pointers[index].store(key_locations[i], std::memory_order_relaxed);
+		}
+	}
+}
+
+//! With tag probing, every slot of the hash map holds a row pointer in the lower 48 bits, and the tag of the row (the
+//! upper 16 bits of its hash) in the upper 16 bits. An empty slot is zero.
+static constexpr idx_t TAG_SHIFT = 48;
+static constexpr uint64_t TAG_POINTER_MASK = (uint64_t(1) << TAG_SHIFT) - 1;
+//! The amount of consecutive slots that are loaded at once when probing
+static constexpr idx_t TAG_WINDOW_SIZE = 4;
+
+static inline uint16_t HashTag(hash_t hash) {
+	return uint16_t(hash >> TAG_SHIFT);
+}
+
+//! Returns a mask in which bit w is set if slot w of the window holds the tag or is empty
+static inline uint32_t MatchTagWindow(const uint64_t window[], uint16_t tag) {
+#ifdef __SSE2__
+	static_assert(TAG_WINDOW_SIZE == 4, "the window is compared as two vectors of two slots");
+	auto tag_vector = _mm_set1_epi64x(int64_t(tag));
+	auto zero = _mm_setzero_si128();
+	uint32_t mask = 0;
+	for (idx_t w = 0; w < TAG_WINDOW_SIZE; w += 2) {
+		auto entries = _mm_loadu_si128((const __m128i *)(window + w));
+		// the lower halves of the shifted entries hold the tags, the upper halves are always zero
+		auto tag_matches = _mm_cmpeq_epi32(_mm_srli_epi64(entries, TAG_SHIFT), tag_vector);
+		// an entry is empty if both of its halves are zero
+		auto zero_halves = _mm_cmpeq_epi32(entries, zero);
+		auto empty = _mm_and_si128(zero_halves, _mm_shuffle_epi32(zero_halves, _MM_SHUFFLE(2, 3, 0, 1)));
+		// take the result of the lower half of both entries
+		auto halves = _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(tag_matches, empty)));
+		mask |= uint32_t((halves & 1) | ((halves >> 1) & 2)) << w;
+	}
+	return mask;
+#else
+	uint32_t mask = 0;
+	for (idx_t w = 0; w < TAG_WINDOW_SIZE; w++) {
+		if (window[w] == 0 || (window[w] >> TAG_SHIFT) == tag) {
+			mask |= 1 << w;
+		}
+	}
+	return mask;
+#endif
+}
+
+//! The position of the lowest set bit of every (non-empty) mask of a window
+static constexpr uint8_t FIRST_WINDOW_SLOT[1 << TAG_WINDOW_SIZE] = {0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0};
+
+template <bool PARALLEL>
+static inline void InsertTagsLoop(atomic<uint64_t> entries[], const hash_t hashes[], const idx_t count,
+                                  const data_ptr_t key_locations[], const uint64_t bitmask) {
+	for (idx_t i = 0; i < count; i++) {
+		auto slot = hashes[i] & bitmask;
+		uint64_t entry = uint64_t(key_locations[i]) | (uint64_t(HashTag(hashes[i])) << TAG_SHIFT);
+		if (PARALLEL) {
+			// claim the first empty slot with compare-and-swap
+			while (true) {
+				uint64_t empty = 0;
+				if (!entries[slot].load() && entries[slot].compare_exchange_strong(empty, entry)) {
+					break;
+				}
+				slot = (slot + 1) & bitmask;
+			}
+		} else {
+			while (entries[slot].load(std::memory_order_relaxed)) {
+				slot = (slot + 1) & bitmask;
+			}
+			entries[slot].store(entry, std::memory_order_relaxed);
+		}
+	}
+}
+
+void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[], bool parallel) {
 	D_ASSERT(hashes.GetType().id() == LogicalTypeId::HASH);
+	static_assert(sizeof(atomic<data_ptr_t>) == sizeof(data_ptr_t), "atomic pointers must be of the same size");
+	static_assert(sizeof(atomic<uint64_t>) == sizeof(data_ptr_t), "atomic entries must be of the same size");
+	if (tag_probing) {
+		// the tags are taken from the full hashes, so the bitmask is applied while inserting
+		hashes.Normalify(count);
+		auto entries = (atomic<uint64_t> *)hash_map->node->buffer;
+		auto hash_data = FlatVector::GetData<hash_t>(hashes);
+		if (parallel) {
+			InsertTagsLoop<true>(entries, hash_data, count, key_locations, bitmask);
+		} else {
+			InsertTagsLoop<false>(entries, hash_data, count, key_locations, bitmask);
+		}
+		return;
+	}
 
 	// use bitmask to get position in array
 	ApplyBitmask(hashes, count);
@@ -246,23 +356,71 @@ void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_loc
 	hashes.Normalify(count);
 
 	D_ASSERT(hashes.GetVectorType() == VectorType::FLAT_VECTOR);
-	auto pointers = (data_ptr_t *)hash_map->node->buffer;
+	// the pointer table is accessed as atomic pointers, which have the same layout as plain pointers
+	auto pointers = (atomic<data_ptr_t> *)hash_map->node->buffer;
 	auto indices = FlatVector::GetData<hash_t>(hashes);
-	for (idx_t i = 0; i < count; i++) {
-		auto index = indices[i];
-		// set prev in current key to the value (NOTE: this will be nullptr if
-		// there is none)
-		Store<data_ptr_t>(pointers[index], key_locations[i] + pointer_offset);
+	if (parallel) {
+		InsertHashesLoop<true>(pointers, indices, count, key_locations, pointer_offset);
+	} else {
+		InsertHashesLoop<false>(pointers, indices, count, key_locations, pointer_offset);
+	}
+}
+
+idx_t JoinHashTable::PointerTableCapacity(idx_t count) {
+	// select a HT that has at least 50% empty space
+	return NextPowerOfTwo(MaxValue<idx_t>(count * 2, (Storage::BLOCK_SIZE / sizeof(data_ptr_t)) + 1));
+}
+
+idx_t JoinHashTable::SizeInBytes() {
+	return block_collection->SizeInBytes() + string_heap->SizeInBytes() +
+	       PointerTableCapacity(Count()) * sizeof(data_ptr_t);
+}
 
-		// set pointer to current tuple
-		pointers[index] = key_locations[i];
+void JoinHashTable::Merge(JoinHashTable &other) {
+	D_ASSERT(!finalized && !other.finalized);
+	D_ASSERT(correlated_mark_join_info.correlated_types.empty());
+	block_collection->Merge(*other.block_collection);
+	string_heap->Merge(*other.string_heap);
+	if (other.has_null) {
+		has_null = true;
 	}
 }
 
-void JoinHashTable::Finalize() {
+void JoinHashTable::Partition(PartitionedRowData &partitions) {
+	D_ASSERT(!finalized);
+	partitions.Append(*block_collection);
+	block_collection = make_unique<RowDataCollection>(buffer_manager, block_collection->block_capacity, entry_size);
+	string_heap = make_unique<RowDataCollection>(buffer_manager, (idx_t)Storage::BLOCK_SIZE, 1, true);
+}
+
+void JoinHashTable::Merge(PartitionedRowData &partitions, idx_t partition) {
+	D_ASSERT(!finalized);
+	auto &data = *partitions.data[partition];
+	auto &heap = *partitions.heaps[partition];
+	for (idx_t block_idx = 0; block_idx < data.blocks.size(); block_idx++) {
+		auto &data_block = data.blocks[block_idx];
+		if (!layout.AllConstant()) {
+			// unswizzle the offsets back to pointers, the heap blocks stay pinned as long as the HT exists
+			auto &heap_block = heap.blocks[block_idx];
+			auto data_handle = buffer_manager.Pin(data_block.block);
+			auto heap_handle = buffer_manager.Pin(heap_block.block);
+			RowOperations::UnswizzlePointers(layout, data_handle->Ptr(), heap_handle->Ptr(), data_block.count);
+			string_heap->blocks.push_back(heap_block);
+			string_heap->count += heap_block.count;
+			string_heap->pinned_blocks.push_back(move(heap_handle));
+		}
+		block_collection->blocks.push_back(data_block);
+		block_collection->count += data_block.count;
+	}
+	data.blocks.clear();
+	data.count = 0;
+	heap.blocks.clear();
+	heap.count = 0;
+}
+
+void JoinHashTable::InitializePointerTable() {
 	// the build has finished, now iterate over all the nodes and construct the final hash table
-	// select a HT that has at least 50% empty space
-	idx_t capacity = NextPowerOfTwo(MaxValue<idx_t>(Count() * 2, (Storage::BLOCK_SIZE / sizeof(data_ptr_t)) + 1));
+	idx_t capacity = PointerTableCapacity(Count());
 	// size needs to be a power of 2
 	D_ASSERT((capacity & (capacity - 1)) == 0);
 	bitmask = capacity - 1;
@@ -271,16 +429,29 @@ void JoinHashTable::Finalize() {
 	hash_map = buffer_manager.Allocate(capacity * sizeof(data_ptr_t));
 	memset(hash_map->node->buffer, 0, capacity * sizeof(data_ptr_t));
 
-	Vector hashes(LogicalType::HASH);
-	auto hash_data = FlatVector::GetData<hash_t>(hashes);
-	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
-	// now construct the actual hash table; scan the nodes
-	// as we can the nodes we pin all the blocks of the HT and keep them pinned until the HT is destroyed
+	// we pin all the blocks of the HT and keep them pinned until the HT is destroyed
 	// this is so that we can keep pointers around to the blocks
 	// FIXME: if we cannot keep everything pinned in memory, we could switch to an out-of-memory merge join or so
+	D_ASSERT(pinned_handles.empty());
 	for (auto &block : block_collection->blocks) {
 		auto handle = buffer_manager.Pin(block.block);
-		data_ptr_t dataptr = handle->node->buffer;
+		if (tag_probing && (uint64_t(handle->Ptr() + handle->node->size) >> TAG_SHIFT) != 0) {
+			// the rows do not fit in 48-bit pointers: fall back to chained buckets
+			tag_probing = false;
+		}
+		pinned_handles.push_back(move(handle));
+	}
+}
+
+void JoinHashTable::Finalize(idx_t block_idx_start, idx_t block_idx_end, bool parallel) {
+	D_ASSERT(pinned_handles.size() == block_collection->blocks.size());
+	Vector hashes(LogicalType::HASH);
+	auto hash_data = FlatVector::GetData<hash_t>(hashes);
+	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
+	// now construct the actual hash table; scan the nodes
+	for (idx_t block_idx = block_idx_start; block_idx < block_idx_end; block_idx++) {
+		auto &block = block_collection->blocks[block_idx];
+		data_ptr_t dataptr = pinned_handles[block_idx]->node->buffer;
 		idx_t entry = 0;
 		while (entry < block.count) {
 			// fetch the next vector of entries from the blocks
@@ -291,25 +462,119 @@ void JoinHashTable::Finalize() {
 				dataptr += entry_size;
 			}
 			// now insert into the hash table
-			InsertHashes(hashes, next, key_locations);
+			InsertHashes(hashes, next, key_locations, parallel);
 
 			entry += next;
 		}
-		pinned_handles.push_back(move(handle));
 	}
+}
+
+void JoinHashTable::BuildBloomFilter(DynamicFilterData &filter) {
+	D_ASSERT(!finalized && pinned_handles.empty());
+	hash_t hashes[STANDARD_VECTOR_SIZE];
+	for (auto &block : block_collection->blocks) {
+		auto handle = buffer_manager.Pin(block.block);
+		data_ptr_t dataptr = handle->node->buffer;
+		idx_t entry = 0;
+		while (entry < block.count) {
+			idx_t next = MinValue<idx_t>(STANDARD_VECTOR_SIZE, block.count - entry);
+			for (idx_t i = 0; i < next; i++) {
+				hashes[i] = Load<hash_t>((data_ptr_t)(dataptr + pointer_offset));
+				dataptr += entry_size;
+			}
+			filter.InsertHashes(hashes, next);
+			entry += next;
+		}
+	}
+}
 
-	finalized = true;
+void JoinHashTable::Finalize() {
+	InitializePointerTable();
+	Finalize(0, BlockCount(), false);
+	FinishFinalize();
 }
 
-unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
-	D_ASSERT(Count() > 0); // should be handled before
+idx_t JoinHashTable::FindTag(uint16_t tag, idx_t slot) {
+	auto entries = (uint64_t *)hash_map->node->buffer;
+	while (true) {
+		auto entry = entries[slot];
+		if (entry == 0) {
+			return DConstants::INVALID_INDEX;
+		}
+		if ((entry >> TAG_SHIFT) == tag) {
+			return slot;
+		}
+		slot = (slot + 1) & bitmask;
+	}
+}
+
+idx_t JoinHashTable::FindTags(const SelectionVector &sel, idx_t count, idx_t slots[], const uint16_t tags[],
+                              data_ptr_t pointers[], SelectionVector &result) {
+	auto entries = (uint64_t *)hash_map->node->buffer;
+	// first load a window of consecutive slots for all tuples, without branching on their content, so the cache
+	// misses of the different tuples overlap (the slots of a window are mostly in the same cache line)
+	uint64_t window[STANDARD_VECTOR_SIZE][TAG_WINDOW_SIZE];
+	for (idx_t i = 0; i < count; i++) {
+		auto slot = slots[sel.get_index(i)];
+		for (idx_t w = 0; w < TAG_WINDOW_SIZE; w++) {
+			window[i][w] = entries[(slot + w) & bitmask];
+		}
+	}
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = sel.get_index(i);
+		auto tag = tags[idx];
+		// find the first slot of the window that has the tag, or that is empty
+		auto mask = MatchTagWindow(window[i], tag);
+		idx_t slot;
+		uint64_t entry;
+		if (mask) {
+			auto w = FIRST_WINDOW_SLOT[mask];
+			slot = (slots[idx] + w) & bitmask;
+			entry = window[i][w];
+		} else {
+			// the whole window is occupied by other tags: continue along the run of occupied slots
+			slot = FindTag(tag, (slots[idx] + TAG_WINDOW_SIZE) & bitmask);
+			entry = slot == DConstants::INVALID_INDEX ? 0 : entries[slot];
+		}
+		if (entry == 0) {
+			continue;
+		}
+		pointers[idx] = (data_ptr_t)(entry & TAG_POINTER_MASK);
+		result.set_index(result_count++, idx);
+		// look for the next match in the rest of the window, so tuples without a next match are done
+		if (!mask) {
+			slots[idx] = (slot + 1) & bitmask;
+			continue;
+		}
+		mask &= mask - 1;
+		if (!mask) {
+			// not decided by the window: continue scanning after the window
+			slots[idx] = (slots[idx] + TAG_WINDOW_SIZE) & bitmask;
+		} else if (window[i][FIRST_WINDOW_SLOT[mask]] == 0) {
+			slots[idx] = DConstants::INVALID_INDEX;
+		} else {
+			slots[idx] = (slots[idx] + FIRST_WINDOW_SLOT[mask]) & bitmask;
+		}
+	}
+	return result_count;
+}
+
+unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys, unique_ptr<ScanStructure> previous) {
 	D_ASSERT(finalized);
 
 	// set up the scan structure
 	auto ss = make_unique<ScanStructure>(*this);
+	if (previous) {
+		ss->found_match = move(previous->found_match);
+		ss->slots = move(previous->slots);
+		ss->tags = move(previous->tags);
+	}
 
 	if (join_type != JoinType::INNER) {
-		ss->found_match = unique_ptr<bool[]>(new bool[STANDARD_VECTOR_SIZE]);
+		if (!ss->found_match) {
+			ss->found_match = unique_ptr<bool[]>(new bool[STANDARD_VECTOR_SIZE]);
+		}
 		memset(ss->found_match.get(), 0, sizeof(bool) * STANDARD_VECTOR_SIZE);
 	}
 
@@ -324,12 +589,31 @@ unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
 	Vector hashes(LogicalType::HASH);
 	Hash(keys, *current_sel, ss->count, hashes);
 
+	idx_t count = 0;
+	auto pointers = FlatVector::GetData<data_ptr_t>(ss->pointers);
+	if (tag_probing) {
+		// find the first slot with a matching tag for every tuple
+		if (!ss->slots) {
+			ss->slots = unique_ptr<idx_t[]>(new idx_t[STANDARD_VECTOR_SIZE]);
+			ss->tags = unique_ptr<uint16_t[]>(new uint16_t[STANDARD_VECTOR_SIZE]);
+		}
+		VectorData hdata;
+		hashes.Orrify(ss->count, hdata);
+		auto hash_data = (hash_t *)hdata.data;
+		for (idx_t i = 0; i < ss->count; i++) {
+			auto idx = current_sel->get_index(i);
+			auto hash = hash_data[hdata.sel->get_index(idx)];
+			ss->slots[idx] = hash & bitmask;
+			ss->tags[idx] = HashTag(hash);
+		}
+		ss->count = FindTags(*current_sel, ss->count, ss->slots.get(), ss->tags.get(), pointers, ss->sel_vector);
+		return ss;
+	}
+
 	// now initialize the pointers of the scan structure based on the hashes
 	ApplyBitmask(hashes, *current_sel, ss->count, ss->pointers);
 
 	// create the selection vector linking to only non-empty entries
-	idx_t count = 0;
-	auto pointers = FlatVector::GetData<data_ptr_t>(ss->pointers);
 	for (idx_t i = 0; i < ss->count; i++) {
 		auto idx = current_sel->get_index(i);
 		pointers[idx] = Load<data_ptr_t>(pointers[idx]);
@@ -414,6 +698,19 @@ void ScanStructure::AdvancePointers(const SelectionVector &sel, idx_t sel_count)
 	// now for all the pointers, we move on to the next set of pointers
 	idx_t new_count = 0;
 	auto ptrs = FlatVector::GetData<data_ptr_t>(this->pointers);
+	if (ht.tag_probing) {
+		// continue from the slots that were left by the previous search, tuples without a next match are done
+		SelectionVector next_sel(STANDARD_VECTOR_SIZE);
+		idx_t next_count = 0;
+		for (idx_t i = 0; i < sel_count; i++) {
+			auto idx = sel.get_index(i);
+			if (slots[idx] != DConstants::INVALID_INDEX) {
+				next_sel.set_index(next_count++, idx);
+			}
+		}
+		this->count = ht.FindTags(next_sel, next_count, slots.get(), tags.get(), ptrs, this->sel_vector);
+		return;
+	}
 	for (idx_t i = 0; i < sel_count; i++) {
 		auto idx = sel.get_index(i);
 		ptrs[idx] = Load<data_ptr_t>(ptrs[idx] + ht.pointer_offset);
@@ -66,15 +66,4 @@ idx_t MergeJoinComplex::Perform(MergeInfo &l, MergeInfo &r, ExpressionType compa
 	return MergeJoinComparisonSwitch<MergeJoinComplex, ScalarMergeInfo, ScalarMergeInfo>(left, right, comparison_type);
 }
 
-idx_t MergeJoinSimple::Perform(MergeInfo &l, MergeInfo &r, ExpressionType comparison_type) {
-	D_ASSERT(l.info_type == MergeInfoType::SCALAR_MERGE_INFO && r.info_type == MergeInfoType::CHUNK_MERGE_INFO);
-	auto &left = (ScalarMergeInfo &)l;
-	auto &right = (ChunkMergeInfo &)r;
-	D_ASSERT(left.type == right.type);
-	if (left.order.count == 0 || right.data_chunks.Count() == 0) {
-		return 0;
-	}
-	return MergeJoinComparisonSwitch<MergeJoinSimple, ScalarMergeInfo, ChunkMergeInfo>(left, right, comparison_type);
-}
-
 } // namespace duckdb
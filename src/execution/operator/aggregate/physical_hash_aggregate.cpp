@@ -215,9 +215,51 @@ public:
 	}
 };
 
+class HashAggregateDistinctFinalizeEvent : public Event {
+public:
+	HashAggregateDistinctFinalizeEvent(const PhysicalHashAggregate &op_p, HashAggregateGlobalState &gstate_p,
+	                                   Pipeline *pipeline_p)
+	    : Event(pipeline_p->executor), op(op_p), gstate(gstate_p), pipeline(pipeline_p) {
+	}
+
+	const PhysicalHashAggregate &op;
+	HashAggregateGlobalState &gstate;
+	Pipeline *pipeline;
+
+public:
+	void Schedule() override {
+		vector<unique_ptr<Task>> tasks;
+		for (idx_t i = 0; i < op.radix_tables.size(); i++) {
+			op.radix_tables[i].ScheduleDistinctTasks(pipeline->executor, shared_from_this(), *gstate.radix_states[i],
+			                                         tasks);
+		}
+		D_ASSERT(!tasks.empty());
+		SetTasks(move(tasks));
+	}
+
+	void FinishEvent() override {
+		// the DISTINCT aggregates have been computed: finalize the aggregate as usual
+		op.FinalizeInternal(*pipeline, *this, pipeline->GetClientContext(), gstate);
+	}
+};
+
 SinkFinalizeType PhysicalHashAggregate::Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
                                                  GlobalSinkState &gstate_p) const {
 	auto &gstate = (HashAggregateGlobalState &)gstate_p;
+	for (idx_t i = 0; i < radix_tables.size(); i++) {
+		if (radix_tables[i].HasDistinctData(*gstate.radix_states[i])) {
+			// the thread-local distinct HTs have to be merged in parallel first
+			auto new_event = make_shared<HashAggregateDistinctFinalizeEvent>(*this, gstate, &pipeline);
+			event.InsertEvent(move(new_event));
+			return SinkFinalizeType::READY;
+		}
+	}
+	return FinalizeInternal(pipeline, event, context, gstate_p);
+}
+
+SinkFinalizeType PhysicalHashAggregate::FinalizeInternal(Pipeline &pipeline, Event &event, ClientContext &context,
+                                                         GlobalSinkState &gstate_p) const {
+	auto &gstate = (HashAggregateGlobalState &)gstate_p;
 	bool any_partitioned = false;
 	for (idx_t i = 0; i < gstate.radix_states.size(); i++) {
 		bool is_partitioned = radix_tables[i].Finalize(context, *gstate.radix_states[i]);
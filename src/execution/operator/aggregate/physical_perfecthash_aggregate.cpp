@@ -12,9 +12,9 @@ PhysicalPerfectHashAggregate::PhysicalPerfectHashAggregate(ClientContext &contex
                                                            vector<unique_ptr<Expression>> aggregates_p,
                                                            vector<unique_ptr<Expression>> groups_p,
                                                            vector<unique_ptr<BaseStatistics>> group_stats,
-                                                           vector<idx_t> required_bits_p, idx_t estimated_cardinality)
+                                                           vector<idx_t> group_ranges_p, idx_t estimated_cardinality)
     : PhysicalOperator(PhysicalOperatorType::PERFECT_HASH_GROUP_BY, move(types_p), estimated_cardinality),
-      groups(move(groups_p)), aggregates(move(aggregates_p)), required_bits(move(required_bits_p)) {
+      groups(move(groups_p)), aggregates(move(aggregates_p)), group_ranges(move(group_ranges_p)) {
 	D_ASSERT(groups.size() == group_stats.size());
 	group_minima.reserve(group_stats.size());
 	for (auto &stats : group_stats) {
@@ -72,7 +72,7 @@ PhysicalPerfectHashAggregate::PhysicalPerfectHashAggregate(ClientContext &contex
 
 unique_ptr<PerfectAggregateHashTable> PhysicalPerfectHashAggregate::CreateHT(ClientContext &context) const {
 	return make_unique<PerfectAggregateHashTable>(BufferManager::GetBufferManager(context), group_types, payload_types,
-	                                              aggregate_objects, group_minima, required_bits);
+	                                              aggregate_objects, group_minima, group_ranges);
 }
 
 //===--------------------------------------------------------------------===//
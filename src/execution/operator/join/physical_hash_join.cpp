@@ -1,11 +1,17 @@
 #include "duckdb/execution/operator/join/physical_hash_join.hpp"
+#include "duckdb/common/row_operations/row_operations.hpp"
+#include "duckdb/common/types/partitioned_row_data.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/function/aggregate/distributive_functions.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/query_profiler.hpp"
+#include "duckdb/parallel/event.hpp"
+#include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/parallel/thread_context.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/statistics/numeric_statistics.hpp"
 #include "duckdb/storage/storage_manager.hpp"
 
 namespace duckdb {
@@ -22,10 +28,14 @@ PhysicalHashJoin::PhysicalHashJoin(LogicalOperator &op, unique_ptr<PhysicalOpera
 	children.push_back(move(left));
 	children.push_back(move(right));
 
+	// the correlated MARK join aggregates into a single HT while building, so it cannot be partitioned
+	can_go_external = !(join_type == JoinType::MARK && !this->delim_types.empty());
+
 	D_ASSERT(left_projection_map.empty());
 	for (auto &condition : conditions) {
 		condition_types.push_back(condition.left->return_type);
 	}
+	dynamic_filters.resize(conditions.size());
 
 	// for ANTI, SEMI and MARK join, we only need to store the keys, so for these the build types are empty
 	if (join_type != JoinType::ANTI && join_type != JoinType::SEMI && join_type != JoinType::MARK) {
@@ -40,6 +50,113 @@ PhysicalHashJoin::PhysicalHashJoin(LogicalOperator &op, unique_ptr<PhysicalOpera
                        std::move(perfect_join_state)) {
 }
 
+void PhysicalHashJoin::InitializeExternal(ClientContext &context, bool in_recursive_cte) {
+	if (!can_go_external) {
+		return;
+	}
+	if (in_recursive_cte) {
+		// an out-of-core join requires a child pipeline, which is not supported in recursive CTEs
+		can_go_external = false;
+		return;
+	}
+	if (ClientConfig::GetConfig(context).force_external) {
+		return;
+	}
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	if (buffer_manager.GetTemporaryDirectory().empty()) {
+		// without a temporary directory the partitions cannot be evicted
+		can_go_external = false;
+		return;
+	}
+	// only a join of which the build side might not fit in memory can go out-of-core
+	idx_t row_width = sizeof(hash_t) + sizeof(data_ptr_t);
+	for (auto &type : condition_types) {
+		row_width += GetTypeIdSize(type.InternalType());
+	}
+	for (auto &type : build_types) {
+		row_width += GetTypeIdSize(type.InternalType());
+	}
+	auto estimated_size = children[1]->estimated_cardinality * row_width;
+	can_go_external = estimated_size > buffer_manager.GetMaxMemory() / EXTERNAL_ESTIMATE_FACTOR;
+}
+
+bool PhysicalHashJoin::CanCreateDynamicFilter(idx_t condition_idx) const {
+	// only for joins that discard the probe rows without a match
+	if (join_type != JoinType::INNER && join_type != JoinType::SEMI && join_type != JoinType::RIGHT) {
+		return false;
+	}
+	// only for equality conditions, NULL values never have a match
+	auto &condition = conditions[condition_idx];
+	return condition.comparison == ExpressionType::COMPARE_EQUAL && !condition.null_values_are_equal;
+}
+
+bool PhysicalHashJoin::DynamicFilterHasRange(const LogicalType &type) {
+	switch (type.InternalType()) {
+	case PhysicalType::INT8:
+	case PhysicalType::INT16:
+	case PhysicalType::INT32:
+	case PhysicalType::INT64:
+	case PhysicalType::INT128:
+	case PhysicalType::UINT8:
+	case PhysicalType::UINT16:
+	case PhysicalType::UINT32:
+	case PhysicalType::UINT64:
+		return true;
+	default:
+		return false;
+	}
+}
+
+template <class T>
+static void TemplatedUpdateKeyStatistics(Vector &keys, idx_t count, NumericStatistics &stats) {
+	VectorData vdata;
+	keys.Orrify(count, vdata);
+	auto data = (T *)vdata.data;
+	auto &min = stats.min.GetValueUnsafe<T>();
+	auto &max = stats.max.GetValueUnsafe<T>();
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if (vdata.validity.RowIsValid(idx)) {
+			NumericStatistics::UpdateValue<T>(data[idx], min, max);
+		}
+	}
+}
+
+//! Update the [min, max] of the build keys for the dynamic filter
+static void UpdateKeyStatistics(Vector &keys, idx_t count, NumericStatistics &stats) {
+	switch (keys.GetType().InternalType()) {
+	case PhysicalType::INT8:
+		TemplatedUpdateKeyStatistics<int8_t>(keys, count, stats);
+		break;
+	case PhysicalType::INT16:
+		TemplatedUpdateKeyStatistics<int16_t>(keys, count, stats);
+		break;
+	case PhysicalType::INT32:
+		TemplatedUpdateKeyStatistics<int32_t>(keys, count, stats);
+		break;
+	case PhysicalType::INT64:
+		TemplatedUpdateKeyStatistics<int64_t>(keys, count, stats);
+		break;
+	case PhysicalType::INT128:
+		TemplatedUpdateKeyStatistics<hugeint_t>(keys, count, stats);
+		break;
+	case PhysicalType::UINT8:
+		TemplatedUpdateKeyStatistics<uint8_t>(keys, count, stats);
+		break;
+	case PhysicalType::UINT16:
+		TemplatedUpdateKeyStatistics<uint16_t>(keys, count, stats);
+		break;
+	case PhysicalType::UINT32:
+		TemplatedUpdateKeyStatistics<uint32_t>(keys, count, stats);
+		break;
+	case PhysicalType::UINT64:
+		TemplatedUpdateKeyStatistics<uint64_t>(keys, count, stats);
+		break;
+	default:
+		throw InternalException("Unsupported type for dynamic join filter");
+	}
+}
+
 //===--------------------------------------------------------------------===//
 // Sink
 //===--------------------------------------------------------------------===//
@@ -48,6 +165,10 @@ public:
 	DataChunk build_chunk;
 	DataChunk join_keys;
 	ExpressionExecutor build_executor;
+	//! The thread-local HT (if the join can go out-of-core)
+	unique_ptr<JoinHashTable> hash_table;
+	//! The [min, max] of the keys of every condition with a dynamic filter (nullptr if none)
+	vector<unique_ptr<NumericStatistics>> key_statistics;
 };
 
 class HashJoinGlobalState : public GlobalSinkState {
@@ -61,12 +182,74 @@ public:
 	unique_ptr<PerfectHashJoinExecutor> perfect_join_executor;
 	//! Whether or not the hash table has been finalized
 	bool finalized = false;
+
+	//! Lock for merging the thread-local HTs into the global HT
+	mutex lock;
+	//! The maximum size (in bytes) of the HT, if the build side grows larger the join goes out-of-core
+	idx_t max_ht_size;
+	//! The maximum size (in bytes) of a thread-local HT or probe side buffer
+	idx_t max_local_size;
+	//! Whether or not the join has gone out-of-core
+	bool external = false;
+	//! The radix-partitioned build side (only used if external)
+	unique_ptr<PartitionedRowData> build_partitions;
+	//! The layout of the rows of the probe side, which includes the hash of the keys (only used if external)
+	RowLayout probe_layout;
+	//! The radix-partitioned probe side (only used if external)
+	unique_ptr<PartitionedRowData> probe_partitions;
+	//! The [min, max] of the keys of every condition with a dynamic filter (nullptr if none)
+	vector<unique_ptr<NumericStatistics>> key_statistics;
+
+public:
+	//! Move the data of the thread-local HT into the global HT. If the global HT grows larger than max_ht_size, the
+	//! join goes out-of-core and the data is partitioned instead.
+	void MergeLocal(JoinHashTable &local_ht) {
+		lock_guard<mutex> guard(lock);
+		if (!external && hash_table->SizeInBytes() + local_ht.SizeInBytes() > max_ht_size) {
+			external = true;
+		}
+		if (external && !build_partitions) {
+			build_partitions = make_unique<PartitionedRowData>(hash_table->buffer_manager, hash_table->layout,
+			                                                   PhysicalHashJoin::EXTERNAL_RADIX_BITS);
+			hash_table->Partition(*build_partitions);
+		}
+		if (external) {
+			local_ht.Partition(*build_partitions);
+			hash_table->has_null = hash_table->has_null || local_ht.has_null;
+		} else {
+			hash_table->Merge(local_ht);
+		}
+	}
+
+	void MergeKeyStatistics(vector<unique_ptr<NumericStatistics>> &local_statistics) {
+		lock_guard<mutex> guard(lock);
+		for (idx_t i = 0; i < local_statistics.size(); i++) {
+			if (local_statistics[i]) {
+				key_statistics[i]->Merge(*local_statistics[i]);
+			}
+		}
+	}
 };
 
 unique_ptr<GlobalSinkState> PhysicalHashJoin::GetGlobalSinkState(ClientContext &context) const {
 	auto state = make_unique<HashJoinGlobalState>();
-	state->hash_table =
-	    make_unique<JoinHashTable>(BufferManager::GetBufferManager(context), conditions, build_types, join_type);
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	state->hash_table = make_unique<JoinHashTable>(buffer_manager, conditions, build_types, join_type);
+	state->hash_table->tag_probing = ClientConfig::GetConfig(context).hash_join_tag_probing;
+	state->max_ht_size = buffer_manager.GetMaxMemory() / 2;
+	state->max_local_size = state->max_ht_size / TaskScheduler::GetScheduler(context).NumberOfThreads();
+	state->external = can_go_external && ClientConfig::GetConfig(context).force_external;
+	state->key_statistics.resize(conditions.size());
+	for (idx_t i = 0; i < conditions.size(); i++) {
+		if (!dynamic_filters[i]) {
+			continue;
+		}
+		// the filter is filled in again when the build side is complete
+		dynamic_filters[i]->Reset();
+		if (DynamicFilterHasRange(condition_types[i])) {
+			state->key_statistics[i] = make_unique<NumericStatistics>(condition_types[i]);
+		}
+	}
 	if (!delim_types.empty() && join_type == JoinType::MARK) {
 		// correlated MARK join
 		if (delim_types.size() + 1 == conditions.size()) {
@@ -115,6 +298,11 @@ unique_ptr<GlobalSinkState> PhysicalHashJoin::GetGlobalSinkState(ClientContext &
 
 unique_ptr<LocalSinkState> PhysicalHashJoin::GetLocalSinkState(ExecutionContext &context) const {
 	auto state = make_unique<HashJoinLocalState>();
+	if (can_go_external) {
+		// every thread builds its own HT, which is either merged into the global HT or partitioned if it gets large
+		state->hash_table = make_unique<JoinHashTable>(BufferManager::GetBufferManager(context.client), conditions,
+		                                               build_types, join_type);
+	}
 	if (!right_projection_map.empty()) {
 		state->build_chunk.Initialize(build_types);
 	}
@@ -122,6 +310,12 @@ unique_ptr<LocalSinkState> PhysicalHashJoin::GetLocalSinkState(ExecutionContext
 		state->build_executor.AddExpression(*cond.right);
 	}
 	state->join_keys.Initialize(condition_types);
+	state->key_statistics.resize(conditions.size());
+	for (idx_t i = 0; i < conditions.size(); i++) {
+		if (dynamic_filters[i] && DynamicFilterHasRange(condition_types[i])) {
+			state->key_statistics[i] = make_unique<NumericStatistics>(condition_types[i]);
+		}
+	}
 	return move(state);
 }
 
@@ -129,9 +323,15 @@ SinkResultType PhysicalHashJoin::Sink(ExecutionContext &context, GlobalSinkState
                                       DataChunk &input) const {
 	auto &sink = (HashJoinGlobalState &)state;
 	auto &lstate = (HashJoinLocalState &)lstate_p;
+	auto &hash_table = lstate.hash_table ? *lstate.hash_table : *sink.hash_table;
 	// resolve the join keys for the right chunk
 	lstate.join_keys.Reset();
 	lstate.build_executor.Execute(input, lstate.join_keys);
+	for (idx_t i = 0; i < lstate.key_statistics.size(); i++) {
+		if (lstate.key_statistics[i]) {
+			UpdateKeyStatistics(lstate.join_keys.data[i], lstate.join_keys.size(), *lstate.key_statistics[i]);
+		}
+	}
 	// TODO: add statement to check for possible per
 	// build the HT
 	if (!right_projection_map.empty()) {
@@ -141,20 +341,28 @@ SinkResultType PhysicalHashJoin::Sink(ExecutionContext &context, GlobalSinkState
 		for (idx_t i = 0; i < right_projection_map.size(); i++) {
 			lstate.build_chunk.data[i].Reference(input.data[right_projection_map[i]]);
 		}
-		sink.hash_table->Build(lstate.join_keys, lstate.build_chunk);
+		hash_table.Build(lstate.join_keys, lstate.build_chunk);
 	} else if (!build_types.empty()) {
 		// there is not a projected map: place the entire right chunk in the HT
-		sink.hash_table->Build(lstate.join_keys, input);
+		hash_table.Build(lstate.join_keys, input);
 	} else {
 		// there are only keys: place an empty chunk in the payload
 		lstate.build_chunk.SetCardinality(input.size());
-		sink.hash_table->Build(lstate.join_keys, lstate.build_chunk);
+		hash_table.Build(lstate.join_keys, lstate.build_chunk);
+	}
+	if (lstate.hash_table && lstate.hash_table->SizeInBytes() > sink.max_local_size) {
+		sink.MergeLocal(*lstate.hash_table);
 	}
 	return SinkResultType::NEED_MORE_INPUT;
 }
 
 void PhysicalHashJoin::Combine(ExecutionContext &context, GlobalSinkState &gstate, LocalSinkState &lstate) const {
+	auto &sink = (HashJoinGlobalState &)gstate;
 	auto &state = (HashJoinLocalState &)lstate;
+	if (state.hash_table) {
+		sink.MergeLocal(*state.hash_table);
+	}
+	sink.MergeKeyStatistics(state.key_statistics);
 	auto &client_profiler = QueryProfiler::Get(context.client);
 	context.thread.profiler.Flush(this, &state.build_executor, "build_executor", 1);
 	client_profiler.Flush(context.thread.profiler);
@@ -163,9 +371,109 @@ void PhysicalHashJoin::Combine(ExecutionContext &context, GlobalSinkState &gstat
 //===--------------------------------------------------------------------===//
 // Finalize
 //===--------------------------------------------------------------------===//
+class HashJoinFinalizeTask : public ExecutorTask {
+public:
+	HashJoinFinalizeTask(shared_ptr<Event> event_p, ClientContext &context, HashJoinGlobalState &sink,
+	                     idx_t block_idx_start, idx_t block_idx_end)
+	    : ExecutorTask(context), event(move(event_p)), sink(sink), block_idx_start(block_idx_start),
+	      block_idx_end(block_idx_end) {
+	}
+
+	TaskExecutionResult ExecuteTask(TaskExecutionMode mode) override {
+		sink.hash_table->Finalize(block_idx_start, block_idx_end, true);
+		event->FinishTask();
+		return TaskExecutionResult::TASK_FINISHED;
+	}
+
+private:
+	shared_ptr<Event> event;
+	HashJoinGlobalState &sink;
+	idx_t block_idx_start;
+	idx_t block_idx_end;
+};
+
+class HashJoinFinalizeEvent : public Event {
+public:
+	HashJoinFinalizeEvent(Pipeline &pipeline_p, HashJoinGlobalState &sink)
+	    : Event(pipeline_p.executor), pipeline(pipeline_p), sink(sink) {
+	}
+
+	Pipeline &pipeline;
+	HashJoinGlobalState &sink;
+
+public:
+	void Schedule() override {
+		auto &context = pipeline.GetClientContext();
+		idx_t num_threads = TaskScheduler::GetScheduler(context).NumberOfThreads();
+		idx_t block_count = sink.hash_table->BlockCount();
+		D_ASSERT(num_threads > 1 && block_count > 1);
+
+		// divide the blocks of the HT evenly over the threads, every task inserts a range of blocks
+		idx_t num_tasks = MinValue<idx_t>(num_threads, block_count);
+		idx_t blocks_per_task = (block_count + num_tasks - 1) / num_tasks;
+		vector<unique_ptr<Task>> finalize_tasks;
+		for (idx_t block_idx = 0; block_idx < block_count; block_idx += blocks_per_task) {
+			auto block_idx_end = MinValue<idx_t>(block_idx + blocks_per_task, block_count);
+			finalize_tasks.push_back(
+			    make_unique<HashJoinFinalizeTask>(shared_from_this(), context, sink, block_idx, block_idx_end));
+		}
+		SetTasks(move(finalize_tasks));
+	}
+
+	void FinishEvent() override {
+		sink.hash_table->FinishFinalize();
+		sink.finalized = true;
+	}
+};
+
+//! Fill in the dynamic filters on the probe side with the range and the Bloom filter of the build keys
+static void InitializeDynamicFilters(const PhysicalHashJoin &op, HashJoinGlobalState &sink) {
+	idx_t count = sink.external ? sink.build_partitions->Count() : sink.hash_table->Count();
+	if (count == 0) {
+		// the probe side is not scanned if the build side is empty
+		return;
+	}
+	for (idx_t i = 0; i < op.dynamic_filters.size(); i++) {
+		auto &filter = op.dynamic_filters[i];
+		if (!filter) {
+			continue;
+		}
+		if (sink.key_statistics[i]) {
+			auto &stats = *sink.key_statistics[i];
+			if (stats.min <= stats.max) {
+				filter->SetRange(stats);
+			}
+		}
+		// the HT only stores the hash of the keys of all conditions combined, so the Bloom filter requires a single
+		// condition, and the rows of an out-of-core HT are partitioned instead of kept in the HT
+		if (op.conditions.size() == 1 && !sink.external && count <= DynamicFilterData::MAX_BLOOM_FILTER_KEYS) {
+			filter->InitializeBloomFilter(count);
+			sink.hash_table->BuildBloomFilter(*filter);
+		}
+		filter->initialized = true;
+	}
+}
+
 SinkFinalizeType PhysicalHashJoin::Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
                                             GlobalSinkState &gstate) const {
 	auto &sink = (HashJoinGlobalState &)gstate;
+	if (sink.external && (!sink.build_partitions || sink.build_partitions->Count() == 0)) {
+		// the build side is empty: there is nothing to partition
+		sink.external = false;
+	}
+	InitializeDynamicFilters(*this, sink);
+	if (sink.external) {
+		// the build side is partitioned: the probe side is partitioned in the same way, after which the partitions
+		// are joined one after another (see GetData)
+		sink.perfect_join_executor.reset();
+		auto probe_types = children[0]->GetTypes();
+		probe_types.emplace_back(LogicalType::HASH);
+		sink.probe_layout.Initialize(probe_types, false);
+		sink.probe_partitions = make_unique<PartitionedRowData>(sink.hash_table->buffer_manager, sink.probe_layout,
+		                                                        EXTERNAL_RADIX_BITS);
+		sink.finalized = true;
+		return SinkFinalizeType::READY;
+	}
 	// check for possible perfect hash table
 	auto use_perfect_hash = sink.perfect_join_executor->CanDoPerfectHashJoin();
 	if (use_perfect_hash) {
@@ -176,9 +484,18 @@ SinkFinalizeType PhysicalHashJoin::Finalize(Pipeline &pipeline, Event &event, Cl
 	// In case of a large build side or duplicates, use regular hash join
 	if (!use_perfect_hash) {
 		sink.perfect_join_executor.reset();
-		sink.hash_table->Finalize();
+		auto &hash_table = *sink.hash_table;
+		if (TaskScheduler::GetScheduler(context).NumberOfThreads() > 1 && hash_table.BlockCount() > 1) {
+			// insert the blocks of the HT into the pointer table in parallel
+			hash_table.InitializePointerTable();
+			event.InsertEvent(make_shared<HashJoinFinalizeEvent>(pipeline, sink));
+		} else {
+			hash_table.Finalize();
+			sink.finalized = true;
+		}
+	} else {
+		sink.finalized = true;
 	}
-	sink.finalized = true;
 	if (sink.hash_table->Count() == 0 && EmptyResultIfRHSIsEmpty()) {
 		return SinkFinalizeType::NO_OUTPUT_POSSIBLE;
 	}
@@ -193,11 +510,30 @@ public:
 	DataChunk join_keys;
 	ExpressionExecutor probe_executor;
 	unique_ptr<JoinHashTable::ScanStructure> scan_structure;
+	//! The exhausted scan structure of the previous probe, the next probe reuses its buffers
+	unique_ptr<JoinHashTable::ScanStructure> previous_scan_structure;
 	unique_ptr<OperatorState> perfect_hash_join_state;
 
+	//! The probe side rows that are buffered before they are partitioned (only used if the join is external)
+	unique_ptr<RowDataCollection> spill_rows;
+	unique_ptr<RowDataCollection> spill_heap;
+	//! The probe side chunk with the hashes of the keys appended to it
+	DataChunk spill_chunk;
+
 public:
+	//! Partition the buffered probe side rows
+	void PartitionSpilledRows(HashJoinGlobalState &sink) {
+		auto &buffer_manager = spill_rows->buffer_manager;
+		sink.probe_partitions->Append(*spill_rows);
+		spill_rows = make_unique<RowDataCollection>(buffer_manager, spill_rows->block_capacity, spill_rows->entry_size);
+		spill_heap = make_unique<RowDataCollection>(buffer_manager, (idx_t)Storage::BLOCK_SIZE, 1, true);
+	}
+
 	void Finalize(PhysicalOperator *op, ExecutionContext &context) override {
 		context.thread.profiler.Flush(op, &probe_executor, "probe_executor", 0);
+		if (spill_rows) {
+			PartitionSpilledRows((HashJoinGlobalState &)*op->sink_state);
+		}
 	}
 };
 
@@ -212,15 +548,57 @@ unique_ptr<OperatorState> PhysicalHashJoin::GetOperatorState(ClientContext &cont
 			state->probe_executor.AddExpression(*cond.left);
 		}
 	}
+	if (sink.external) {
+		auto &buffer_manager = BufferManager::GetBufferManager(context);
+		auto row_width = sink.probe_layout.GetRowWidth();
+		state->spill_rows =
+		    make_unique<RowDataCollection>(buffer_manager, (Storage::BLOCK_SIZE / row_width) + 1, row_width);
+		state->spill_heap = make_unique<RowDataCollection>(buffer_manager, (idx_t)Storage::BLOCK_SIZE, 1, true);
+		state->spill_chunk.Initialize(sink.probe_layout.GetTypes());
+	}
 	return move(state);
 }
 
+void PhysicalHashJoin::SpillProbe(DataChunk &input, OperatorState &state_p) const {
+	auto &state = (PhysicalHashJoinState &)state_p;
+	auto &sink = (HashJoinGlobalState &)*sink_state;
+
+	// resolve the join keys for the left chunk, and hash them
+	state.join_keys.Reset();
+	state.probe_executor.Execute(input, state.join_keys);
+	auto &spill_chunk = state.spill_chunk;
+	spill_chunk.Reset();
+	for (idx_t i = 0; i < input.ColumnCount(); i++) {
+		spill_chunk.data[i].Reference(input.data[i]);
+	}
+	sink.hash_table->Hash(state.join_keys, *FlatVector::IncrementalSelectionVector(), input.size(),
+	                      spill_chunk.data[input.ColumnCount()]);
+	spill_chunk.SetCardinality(input);
+
+	// serialize the probe side rows, they are partitioned once enough of them have been buffered
+	Vector addresses(LogicalType::POINTER);
+	auto key_locations = FlatVector::GetData<data_ptr_t>(addresses);
+	auto handles = state.spill_rows->Build(spill_chunk.size(), key_locations, nullptr);
+	auto spill_data = spill_chunk.Orrify();
+	RowOperations::Scatter(spill_chunk, spill_data.get(), sink.probe_layout, addresses, *state.spill_heap,
+	                       *FlatVector::IncrementalSelectionVector(), spill_chunk.size());
+	handles.clear();
+	if (state.spill_rows->SizeInBytes() + state.spill_heap->SizeInBytes() > sink.max_local_size) {
+		state.PartitionSpilledRows(sink);
+	}
+}
+
 OperatorResultType PhysicalHashJoin::Execute(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
                                              OperatorState &state_p) const {
 	auto &state = (PhysicalHashJoinState &)state_p;
 	auto &sink = (HashJoinGlobalState &)*sink_state;
 	D_ASSERT(sink.finalized);
 
+	if (sink.external) {
+		// the join is out-of-core: the probe side is partitioned, and joined with the build side later on
+		SpillProbe(input, state);
+		return OperatorResultType::NEED_MORE_INPUT;
+	}
 	if (sink.hash_table->Count() == 0 && EmptyResultIfRHSIsEmpty()) {
 		return OperatorResultType::FINISHED;
 	}
@@ -235,7 +613,7 @@ OperatorResultType PhysicalHashJoin::Execute(ExecutionContext &context, DataChun
 		if (chunk.size() > 0) {
 			return OperatorResultType::HAVE_MORE_OUTPUT;
 		}
-		state.scan_structure = nullptr;
+		state.previous_scan_structure = move(state.scan_structure);
 		return OperatorResultType::NEED_MORE_INPUT;
 	}
 
@@ -249,7 +627,7 @@ OperatorResultType PhysicalHashJoin::Execute(ExecutionContext &context, DataChun
 	state.probe_executor.Execute(input, state.join_keys);
 
 	// perform the actual probe
-	state.scan_structure = sink.hash_table->Probe(state.join_keys);
+	state.scan_structure = sink.hash_table->Probe(state.join_keys, move(state.previous_scan_structure));
 	state.scan_structure->Next(state.join_keys, input, chunk);
 	return OperatorResultType::HAVE_MORE_OUTPUT;
 }
@@ -266,8 +644,31 @@ public:
 	//! Only used for FULL OUTER JOIN: scan state of the final scan to find unmatched tuples in the build-side
 	JoinHTScanState ht_scan_state;
 
+	//! The state of the out-of-core join, which joins the partitions one after another in a single thread
+	//! The HT holding the build side partitions [partition_start, partition_end) that are currently joined
+	unique_ptr<JoinHashTable> hash_table;
+	idx_t partition_start = 0;
+	idx_t partition_end = 0;
+	//! The position of the scan over the probe side partitions
+	idx_t probe_partition = 0;
+	idx_t probe_block = 0;
+	idx_t probe_entry = 0;
+	//! The pinned data and heap block of the probe side that is being scanned
+	unique_ptr<BufferHandle> probe_data_handle;
+	unique_ptr<BufferHandle> probe_heap_handle;
+	//! The probe side chunk that is currently being probed
+	DataChunk probe_chunk;
+	DataChunk join_keys;
+	ExpressionExecutor probe_executor;
+	unique_ptr<JoinHashTable::ScanStructure> scan_structure;
+	//! The exhausted scan structure of the previous probe, the next probe reuses its buffers
+	unique_ptr<JoinHashTable::ScanStructure> previous_scan_structure;
+
 	idx_t MaxThreads() override {
 		auto &sink = (HashJoinGlobalState &)*op.sink_state;
+		if (sink.external) {
+			return 1;
+		}
 		return sink.hash_table->Count() / (STANDARD_VECTOR_SIZE * 10);
 	}
 };
@@ -276,13 +677,150 @@ unique_ptr<GlobalSourceState> PhysicalHashJoin::GetGlobalSourceState(ClientConte
 	return make_unique<HashJoinScanState>(*this);
 }
 
+void PhysicalHashJoin::PrepareNextPartitions(HashJoinScanState &state) const {
+	auto &sink = (HashJoinGlobalState &)*sink_state;
+	auto &partitions = *sink.build_partitions;
+	if (state.probe_chunk.data.empty()) {
+		state.probe_chunk.Initialize(children[0]->GetTypes());
+		state.join_keys.Initialize(condition_types);
+		for (auto &cond : conditions) {
+			state.probe_executor.AddExpression(*cond.left);
+		}
+	}
+
+	// build a HT from as many of the next partitions as fit in memory (but at least one)
+	state.hash_table.reset();
+	state.hash_table =
+	    make_unique<JoinHashTable>(sink.hash_table->buffer_manager, conditions, build_types, join_type);
+	state.hash_table->has_null = sink.hash_table->has_null;
+	state.hash_table->tag_probing = sink.hash_table->tag_probing;
+	state.partition_start = state.partition_end;
+	idx_t count = 0;
+	idx_t size = 0;
+	for (; state.partition_end < partitions.PartitionCount(); state.partition_end++) {
+		auto partition_count = partitions.Count(state.partition_end);
+		auto partition_size = partitions.SizeInBytes(state.partition_end);
+		auto ht_size =
+		    size + partition_size + JoinHashTable::PointerTableCapacity(count + partition_count) * sizeof(data_ptr_t);
+		if (state.partition_end > state.partition_start && ht_size > sink.max_ht_size) {
+			break;
+		}
+		state.hash_table->Merge(partitions, state.partition_end);
+		count += partition_count;
+		size += partition_size;
+	}
+	state.hash_table->Finalize();
+
+	// scan the probe side rows of the same partitions
+	state.probe_partition = state.partition_start;
+	state.probe_block = 0;
+	state.probe_entry = 0;
+	state.ht_scan_state.position = 0;
+	state.ht_scan_state.block_position = 0;
+}
+
+bool PhysicalHashJoin::ScanProbePartitions(HashJoinScanState &state) const {
+	auto &sink = (HashJoinGlobalState &)*sink_state;
+	auto &partitions = *sink.probe_partitions;
+	auto &layout = sink.probe_layout;
+	const idx_t row_width = layout.GetRowWidth();
+	while (state.probe_partition < state.partition_end) {
+		auto &data = *partitions.data[state.probe_partition];
+		auto &heap = *partitions.heaps[state.probe_partition];
+		if (state.probe_block == data.blocks.size()) {
+			// done with this partition: the blocks can be destroyed
+			state.probe_data_handle.reset();
+			state.probe_heap_handle.reset();
+			data.blocks.clear();
+			heap.blocks.clear();
+			state.probe_partition++;
+			state.probe_block = 0;
+			continue;
+		}
+		auto &data_block = data.blocks[state.probe_block];
+		if (state.probe_entry == 0) {
+			// pin the next block and unswizzle the offsets back to pointers (if needed)
+			state.probe_data_handle = sink.hash_table->buffer_manager.Pin(data_block.block);
+			if (!layout.AllConstant()) {
+				state.probe_heap_handle = sink.hash_table->buffer_manager.Pin(heap.blocks[state.probe_block].block);
+				RowOperations::UnswizzlePointers(layout, state.probe_data_handle->Ptr(),
+				                                 state.probe_heap_handle->Ptr(), data_block.count);
+			}
+		}
+		// set up the pointers to the rows that are scanned next
+		idx_t next = MinValue<idx_t>(STANDARD_VECTOR_SIZE, data_block.count - state.probe_entry);
+		Vector addresses(LogicalType::POINTER);
+		auto data_pointers = FlatVector::GetData<data_ptr_t>(addresses);
+		data_ptr_t row_ptr = state.probe_data_handle->Ptr() + state.probe_entry * row_width;
+		for (idx_t i = 0; i < next; i++) {
+			data_pointers[i] = row_ptr;
+			row_ptr += row_width;
+		}
+		state.probe_entry += next;
+		if (state.probe_entry == data_block.count) {
+			state.probe_block++;
+			state.probe_entry = 0;
+		}
+		// gather the probe side columns, the last column of the rows (the hash) is not needed anymore
+		state.probe_chunk.Reset();
+		for (idx_t col_idx = 0; col_idx < state.probe_chunk.ColumnCount(); col_idx++) {
+			RowOperations::Gather(addresses, *FlatVector::IncrementalSelectionVector(), state.probe_chunk.data[col_idx],
+			                      *FlatVector::IncrementalSelectionVector(), next, layout.GetOffsets()[col_idx],
+			                      col_idx);
+		}
+		state.probe_chunk.SetCardinality(next);
+		return true;
+	}
+	return false;
+}
+
 void PhysicalHashJoin::GetData(ExecutionContext &context, DataChunk &chunk, GlobalSourceState &gstate,
                                LocalSourceState &lstate) const {
-	D_ASSERT(IsRightOuterJoin(join_type));
-	// check if we need to scan any unmatched tuples from the RHS for the full/right outer join
 	auto &sink = (HashJoinGlobalState &)*sink_state;
 	auto &state = (HashJoinScanState &)gstate;
-	sink.hash_table->ScanFullOuter(chunk, state.ht_scan_state);
+	if (!sink.external) {
+		if (IsRightOuterJoin(join_type)) {
+			// check if we need to scan any unmatched tuples from the RHS for the full/right outer join
+			sink.hash_table->ScanFullOuter(chunk, state.ht_scan_state);
+		}
+		return;
+	}
+
+	// the join is out-of-core: join the partitions of the build and probe side
+	// this happens in a single thread (MaxThreads returns 1), which joins the partitions one after another
+	while (true) {
+		if (state.hash_table) {
+			// probe the HT with the probe side rows of the same partitions
+			while (true) {
+				if (state.scan_structure) {
+					state.scan_structure->Next(state.join_keys, state.probe_chunk, chunk);
+					if (chunk.size() > 0) {
+						return;
+					}
+					state.previous_scan_structure = move(state.scan_structure);
+				}
+				if (!ScanProbePartitions(state)) {
+					break;
+				}
+				state.join_keys.Reset();
+				state.probe_executor.Execute(state.probe_chunk, state.join_keys);
+				state.scan_structure = state.hash_table->Probe(state.join_keys, move(state.previous_scan_structure));
+			}
+			if (IsRightOuterJoin(join_type)) {
+				// scan the unmatched tuples of the build side partitions
+				state.hash_table->ScanFullOuter(chunk, state.ht_scan_state);
+				if (chunk.size() > 0) {
+					return;
+				}
+			}
+		}
+		if (state.partition_end == sink.build_partitions->PartitionCount()) {
+			// all partitions have been joined
+			state.hash_table.reset();
+			return;
+		}
+		PrepareNextPartitions(state);
+	}
 }
 
 } // namespace duckdb
@@ -0,0 +1,658 @@
+#include "duckdb/execution/operator/join/physical_iejoin.hpp"
+
+#include "duckdb/common/row_operations/row_operations.hpp"
+#include "duckdb/common/sort/sort.hpp"
+#include "duckdb/common/types/row_data_collection.hpp"
+#include "duckdb/common/types/row_layout.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/parallel/thread_context.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+PhysicalIEJoin::PhysicalIEJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left,
+                               unique_ptr<PhysicalOperator> right, vector<JoinCondition> cond, JoinType join_type,
+                               idx_t estimated_cardinality)
+    : PhysicalComparisonJoin(op, PhysicalOperatorType::IE_JOIN, move(cond), join_type, estimated_cardinality) {
+	// the first two conditions are the ones that are sorted on, so we move the range comparisons to the front
+	std::stable_partition(conditions.begin(), conditions.end(),
+	                      [](const JoinCondition &cond) { return IsRangeComparison(cond.comparison); });
+	D_ASSERT(conditions.size() >= 2);
+	D_ASSERT(IsRangeComparison(conditions[0].comparison) && IsRangeComparison(conditions[1].comparison));
+	for (auto &cond : conditions) {
+		D_ASSERT(cond.left->return_type == cond.right->return_type);
+		join_key_types.push_back(cond.left->return_type);
+	}
+	children.push_back(move(left));
+	children.push_back(move(right));
+}
+
+bool PhysicalIEJoin::IsRangeComparison(ExpressionType comparison) {
+	switch (comparison) {
+	case ExpressionType::COMPARE_LESSTHAN:
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return true;
+	default:
+		return false;
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// IEJoinRows
+//===--------------------------------------------------------------------===//
+//! IEJoinRows holds the materialized rows of one side of the join: the join keys, followed by the payload columns
+class IEJoinRows {
+public:
+	IEJoinRows(BufferManager &buffer_manager, const RowLayout &layout) : layout(layout) {
+		auto row_width = layout.GetRowWidth();
+		// the rows are kept pinned, so we can refer to them by pointer
+		data = make_unique<RowDataCollection>(buffer_manager, (Storage::BLOCK_SIZE / row_width) + 1, row_width, true);
+		heap = make_unique<RowDataCollection>(buffer_manager, (idx_t)Storage::BLOCK_SIZE, 1, true);
+	}
+
+	const RowLayout &layout;
+	unique_ptr<RowDataCollection> data;
+	unique_ptr<RowDataCollection> heap;
+	//! The pointers to the rows, the index of a row in this vector is its row id
+	vector<data_ptr_t> rows;
+
+public:
+	idx_t Count() const {
+		return rows.size();
+	}
+
+	void Append(DataChunk &chunk) {
+		Vector addresses(LogicalType::POINTER);
+		auto key_locations = FlatVector::GetData<data_ptr_t>(addresses);
+		auto handles = data->Build(chunk.size(), key_locations, nullptr);
+		auto chunk_data = chunk.Orrify();
+		RowOperations::Scatter(chunk, chunk_data.get(), layout, addresses, *heap,
+		                       *FlatVector::IncrementalSelectionVector(), chunk.size());
+		rows.insert(rows.end(), key_locations, key_locations + chunk.size());
+	}
+
+	void Merge(IEJoinRows &other) {
+		data->Merge(*other.data);
+		heap->Merge(*other.heap);
+		rows.insert(rows.end(), other.rows.begin(), other.rows.end());
+		other.rows.clear();
+	}
+
+	//! Gather the given column of the given rows into the result vector
+	void Gather(const idx_t row_ids[], idx_t count, idx_t col_no, Vector &result) const {
+		Vector pointers(LogicalType::POINTER);
+		auto row_pointers = FlatVector::GetData<data_ptr_t>(pointers);
+		for (idx_t i = 0; i < count; i++) {
+			row_pointers[i] = rows[row_ids[i]];
+		}
+		RowOperations::Gather(pointers, *FlatVector::IncrementalSelectionVector(), result,
+		                      *FlatVector::IncrementalSelectionVector(), count, layout.GetOffsets()[col_no], col_no);
+	}
+};
+
+//! Initialize the layout of the rows of one side: the join keys, followed by the payload columns
+static void InitializeRowLayout(RowLayout &layout, const vector<LogicalType> &join_key_types,
+                                const vector<LogicalType> &payload_types) {
+	auto types = join_key_types;
+	types.insert(types.end(), payload_types.begin(), payload_types.end());
+	layout.Initialize(types);
+}
+
+//! Resolve the join keys of the input, and append them together with the input to the rows
+static void AppendRows(ExpressionExecutor &executor, DataChunk &join_keys, DataChunk &row_chunk, DataChunk &input,
+                       IEJoinRows &rows) {
+	join_keys.Reset();
+	executor.Execute(input, join_keys);
+	idx_t col_idx = 0;
+	for (auto &key : join_keys.data) {
+		row_chunk.data[col_idx++].Reference(key);
+	}
+	for (auto &col : input.data) {
+		row_chunk.data[col_idx++].Reference(col);
+	}
+	row_chunk.SetCardinality(input);
+	rows.Append(row_chunk);
+}
+
+//===--------------------------------------------------------------------===//
+// Sink
+//===--------------------------------------------------------------------===//
+class IEJoinGlobalState : public GlobalSinkState {
+public:
+	IEJoinGlobalState(BufferManager &buffer_manager, const PhysicalIEJoin &op) {
+		InitializeRowLayout(left_layout, op.join_key_types, op.children[0]->types);
+		InitializeRowLayout(right_layout, op.join_key_types, op.children[1]->types);
+		left_table = make_unique<IEJoinRows>(buffer_manager, left_layout);
+		right_table = make_unique<IEJoinRows>(buffer_manager, right_layout);
+	}
+
+	mutex lock;
+	RowLayout left_layout;
+	RowLayout right_layout;
+	//! The materialized rows of the LHS, which are appended by the operator
+	unique_ptr<IEJoinRows> left_table;
+	//! The materialized rows of the RHS
+	unique_ptr<IEJoinRows> right_table;
+};
+
+class IEJoinLocalState : public LocalSinkState {
+public:
+	IEJoinLocalState(BufferManager &buffer_manager, const PhysicalIEJoin &op, IEJoinGlobalState &gstate)
+	    : table(buffer_manager, gstate.right_layout) {
+		for (auto &cond : op.conditions) {
+			rhs_executor.AddExpression(*cond.right);
+		}
+		join_keys.Initialize(op.join_key_types);
+		row_chunk.InitializeEmpty(gstate.right_layout.GetTypes());
+	}
+
+	//! The executor of the RHS condition
+	ExpressionExecutor rhs_executor;
+	//! The chunk holding the right condition
+	DataChunk join_keys;
+	//! The chunk holding the join keys and the input
+	DataChunk row_chunk;
+	//! The thread-local rows of the RHS
+	IEJoinRows table;
+};
+
+unique_ptr<GlobalSinkState> PhysicalIEJoin::GetGlobalSinkState(ClientContext &context) const {
+	return make_unique<IEJoinGlobalState>(BufferManager::GetBufferManager(context), *this);
+}
+
+unique_ptr<LocalSinkState> PhysicalIEJoin::GetLocalSinkState(ExecutionContext &context) const {
+	auto &gstate = (IEJoinGlobalState &)*sink_state;
+	return make_unique<IEJoinLocalState>(BufferManager::GetBufferManager(context.client), *this, gstate);
+}
+
+SinkResultType PhysicalIEJoin::Sink(ExecutionContext &context, GlobalSinkState &state, LocalSinkState &lstate_p,
+                                    DataChunk &input) const {
+	auto &lstate = (IEJoinLocalState &)lstate_p;
+	AppendRows(lstate.rhs_executor, lstate.join_keys, lstate.row_chunk, input, lstate.table);
+	return SinkResultType::NEED_MORE_INPUT;
+}
+
+void PhysicalIEJoin::Combine(ExecutionContext &context, GlobalSinkState &gstate_p, LocalSinkState &lstate_p) const {
+	auto &gstate = (IEJoinGlobalState &)gstate_p;
+	auto &lstate = (IEJoinLocalState &)lstate_p;
+	{
+		lock_guard<mutex> guard(gstate.lock);
+		gstate.right_table->Merge(lstate.table);
+	}
+	auto &client_profiler = QueryProfiler::Get(context.client);
+	context.thread.profiler.Flush(this, &lstate.rhs_executor, "rhs_executor", 1);
+	client_profiler.Flush(context.thread.profiler);
+}
+
+//===--------------------------------------------------------------------===//
+// Finalize
+//===--------------------------------------------------------------------===//
+SinkFinalizeType PhysicalIEJoin::Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+                                          GlobalSinkState &gstate_p) const {
+	auto &gstate = (IEJoinGlobalState &)gstate_p;
+	if (gstate.right_table->Count() == 0 && EmptyResultIfRHSIsEmpty()) {
+		return SinkFinalizeType::NO_OUTPUT_POSSIBLE;
+	}
+	return SinkFinalizeType::READY;
+}
+
+//===--------------------------------------------------------------------===//
+// Operator
+//===--------------------------------------------------------------------===//
+class IEJoinOperatorState : public OperatorState {
+public:
+	IEJoinOperatorState(BufferManager &buffer_manager, const PhysicalIEJoin &op, IEJoinGlobalState &gstate)
+	    : table(buffer_manager, gstate.left_layout) {
+		for (auto &cond : op.conditions) {
+			lhs_executor.AddExpression(*cond.left);
+		}
+		join_keys.Initialize(op.join_key_types);
+		row_chunk.InitializeEmpty(gstate.left_layout.GetTypes());
+	}
+
+	//! The executor of the LHS condition
+	ExpressionExecutor lhs_executor;
+	//! The chunk holding the left condition
+	DataChunk join_keys;
+	//! The chunk holding the join keys and the input
+	DataChunk row_chunk;
+	//! The thread-local rows of the LHS
+	IEJoinRows table;
+
+public:
+	void Finalize(PhysicalOperator *op, ExecutionContext &context) override {
+		context.thread.profiler.Flush(op, &lhs_executor, "lhs_executor", 0);
+		auto &gstate = (IEJoinGlobalState &)*op->sink_state;
+		lock_guard<mutex> guard(gstate.lock);
+		gstate.left_table->Merge(table);
+	}
+};
+
+unique_ptr<OperatorState> PhysicalIEJoin::GetOperatorState(ClientContext &context) const {
+	auto &gstate = (IEJoinGlobalState &)*sink_state;
+	return make_unique<IEJoinOperatorState>(BufferManager::GetBufferManager(context), *this, gstate);
+}
+
+OperatorResultType PhysicalIEJoin::Execute(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+                                           OperatorState &state_p) const {
+	auto &state = (IEJoinOperatorState &)state_p;
+	// materialize the LHS: the join is performed once both sides are complete
+	AppendRows(state.lhs_executor, state.join_keys, state.row_chunk, input, state.table);
+	return OperatorResultType::NEED_MORE_INPUT;
+}
+
+//===--------------------------------------------------------------------===//
+// Source
+//===--------------------------------------------------------------------===//
+//! The id of a row in the sorted orders: left rows are positive, right rows are negative
+static inline int64_t LeftRowId(idx_t row) {
+	return int64_t(row) + 1;
+}
+
+static inline int64_t RightRowId(idx_t row) {
+	return -(int64_t(row) + 1);
+}
+
+static inline idx_t RowFromId(int64_t id) {
+	return id > 0 ? idx_t(id - 1) : idx_t(-id - 1);
+}
+
+static inline idx_t FirstSetBit(uint64_t word) {
+	D_ASSERT(word != 0);
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(word);
+#else
+	idx_t position = 0;
+	while ((word & 1) == 0) {
+		word >>= 1;
+		position++;
+	}
+	return position;
+#endif
+}
+
+//! Collect the rows of which the keys of the two sorted conditions are not NULL: these rows can never match
+static vector<idx_t> NonNullRows(IEJoinRows &table, const vector<LogicalType> &join_key_types) {
+	vector<idx_t> result;
+	result.reserve(table.Count());
+	idx_t row_ids[STANDARD_VECTOR_SIZE];
+	for (idx_t offset = 0; offset < table.Count(); offset += STANDARD_VECTOR_SIZE) {
+		auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, table.Count() - offset);
+		for (idx_t i = 0; i < count; i++) {
+			row_ids[i] = offset + i;
+		}
+		Vector first_key(join_key_types[0]);
+		Vector second_key(join_key_types[1]);
+		table.Gather(row_ids, count, 0, first_key);
+		table.Gather(row_ids, count, 1, second_key);
+		auto &first_validity = FlatVector::Validity(first_key);
+		auto &second_validity = FlatVector::Validity(second_key);
+		for (idx_t i = 0; i < count; i++) {
+			if (first_validity.RowIsValid(i) && second_validity.RowIsValid(i)) {
+				result.push_back(row_ids[i]);
+			}
+		}
+	}
+	return result;
+}
+
+//! Sink the keys of the given condition of the given rows into the sort
+static void SinkSortKeys(LocalSortState &local_sort_state, IEJoinRows &table, const vector<idx_t> &rows,
+                         idx_t cond_idx, bool is_left, DataChunk &sort_chunk, DataChunk &payload_chunk) {
+	for (idx_t offset = 0; offset < rows.size(); offset += STANDARD_VECTOR_SIZE) {
+		auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, rows.size() - offset);
+		sort_chunk.Reset();
+		payload_chunk.Reset();
+		table.Gather(rows.data() + offset, count, cond_idx, sort_chunk.data[0]);
+		sort_chunk.data[1].Reference(Value::BOOLEAN(is_left));
+		auto ids = FlatVector::GetData<int64_t>(payload_chunk.data[0]);
+		for (idx_t i = 0; i < count; i++) {
+			ids[i] = is_left ? LeftRowId(rows[offset + i]) : RightRowId(rows[offset + i]);
+		}
+		sort_chunk.SetCardinality(count);
+		payload_chunk.SetCardinality(count);
+		local_sort_state.SinkChunk(sort_chunk, payload_chunk);
+	}
+}
+
+//! Sort the rows of both sides together on the keys of the given condition, and return the ids of the rows in order.
+//! The order is chosen such that the condition holds for a left and a right row iff the right row comes after the
+//! left row.
+static vector<int64_t> SortRows(BufferManager &buffer_manager, IEJoinGlobalState &gstate,
+                                const vector<idx_t> &left_rows, const vector<idx_t> &right_rows,
+                                const JoinCondition &condition, idx_t cond_idx) {
+	auto &key_type = condition.left->return_type;
+	auto comparison = condition.comparison;
+	bool ascending = comparison == ExpressionType::COMPARE_LESSTHAN ||
+	                 comparison == ExpressionType::COMPARE_LESSTHANOREQUALTO;
+	bool strict =
+	    comparison == ExpressionType::COMPARE_LESSTHAN || comparison == ExpressionType::COMPARE_GREATERTHAN;
+
+	vector<BoundOrderByNode> orders;
+	orders.emplace_back(ascending ? OrderType::ASCENDING : OrderType::DESCENDING, OrderByNullType::NULLS_LAST,
+	                    make_unique<BoundReferenceExpression>(key_type, 0));
+	// for equal keys, the right rows come first if the comparison is strict, and last otherwise
+	orders.emplace_back(strict ? OrderType::ASCENDING : OrderType::DESCENDING, OrderByNullType::NULLS_LAST,
+	                    make_unique<BoundReferenceExpression>(LogicalType::BOOLEAN, 1));
+	RowLayout payload_layout;
+	payload_layout.Initialize({LogicalType::BIGINT});
+
+	GlobalSortState global_sort_state(buffer_manager, orders, payload_layout);
+	LocalSortState local_sort_state;
+	local_sort_state.Initialize(global_sort_state, buffer_manager);
+
+	DataChunk sort_chunk;
+	sort_chunk.Initialize({key_type, LogicalType::BOOLEAN});
+	DataChunk payload_chunk;
+	payload_chunk.Initialize({LogicalType::BIGINT});
+	SinkSortKeys(local_sort_state, *gstate.left_table, left_rows, cond_idx, true, sort_chunk, payload_chunk);
+	SinkSortKeys(local_sort_state, *gstate.right_table, right_rows, cond_idx, false, sort_chunk, payload_chunk);
+
+	global_sort_state.AddLocalState(local_sort_state);
+	global_sort_state.PrepareMergePhase();
+	while (global_sort_state.sorted_blocks.size() > 1) {
+		global_sort_state.InitializeMergeRound();
+		MergeSorter merge_sorter(global_sort_state, buffer_manager);
+		merge_sorter.PerformInMergeRound();
+		global_sort_state.CompleteMergeRound();
+	}
+
+	vector<int64_t> result;
+	result.reserve(left_rows.size() + right_rows.size());
+	PayloadScanner scanner(*global_sort_state.sorted_blocks[0]->payload_data, global_sort_state);
+	for (;;) {
+		payload_chunk.Reset();
+		scanner.Scan(payload_chunk);
+		if (payload_chunk.size() == 0) {
+			break;
+		}
+		auto ids = FlatVector::GetData<int64_t>(payload_chunk.data[0]);
+		result.insert(result.end(), ids, ids + payload_chunk.size());
+	}
+	D_ASSERT(result.size() == left_rows.size() + right_rows.size());
+	return result;
+}
+
+class IEJoinScanState : public GlobalSourceState {
+public:
+	explicit IEJoinScanState(const PhysicalIEJoin &op)
+	    : op(op), initialized(false), l2_position(0), scanning(false), left_row(0), bit_position(0),
+	      left_outer_position(0), right_outer_position(0) {
+	}
+
+	mutex lock;
+	const PhysicalIEJoin &op;
+	bool initialized;
+
+	//! The ids of the rows, sorted on the first condition (L1)
+	vector<int64_t> l1;
+	//! The ids of the rows, sorted on the second condition (L2)
+	vector<int64_t> l2;
+	//! The positions of the left and right rows in L1
+	vector<idx_t> left_positions;
+	vector<idx_t> right_positions;
+	//! The bit array over L1: the bit of a right row is set once it satisfies the second condition
+	vector<uint64_t> bits;
+	//! A bit is set for every non-zero word in the bit array, so empty regions can be skipped
+	vector<uint64_t> summary;
+
+	//! The position in L2, which is walked from back to front
+	idx_t l2_position;
+	//! Whether or not we are enumerating the matches of a left row
+	bool scanning;
+	//! The left row of which the matches are enumerated
+	idx_t left_row;
+	//! The position in the bit array from which the matches are enumerated
+	idx_t bit_position;
+
+	//! For every row of the LHS and the RHS, whether or not it found a match (only used in OUTER joins)
+	unique_ptr<bool[]> left_found_match;
+	unique_ptr<bool[]> right_found_match;
+	//! The position in the LHS and RHS in the final scans of OUTER joins
+	idx_t left_outer_position;
+	idx_t right_outer_position;
+
+public:
+	void Initialize(ClientContext &context) {
+		auto &gstate = (IEJoinGlobalState &)*op.sink_state;
+		auto &buffer_manager = BufferManager::GetBufferManager(context);
+		if (IsLeftOuterJoin(op.join_type)) {
+			left_found_match = unique_ptr<bool[]>(new bool[gstate.left_table->Count()]);
+			memset(left_found_match.get(), 0, sizeof(bool) * gstate.left_table->Count());
+		}
+		if (IsRightOuterJoin(op.join_type)) {
+			right_found_match = unique_ptr<bool[]>(new bool[gstate.right_table->Count()]);
+			memset(right_found_match.get(), 0, sizeof(bool) * gstate.right_table->Count());
+		}
+		auto left_rows = NonNullRows(*gstate.left_table, op.join_key_types);
+		auto right_rows = NonNullRows(*gstate.right_table, op.join_key_types);
+		if (left_rows.empty() || right_rows.empty()) {
+			// no matches possible
+			return;
+		}
+		l1 = SortRows(buffer_manager, gstate, left_rows, right_rows, op.conditions[0], 0);
+		l2 = SortRows(buffer_manager, gstate, left_rows, right_rows, op.conditions[1], 1);
+
+		left_positions.resize(gstate.left_table->Count());
+		right_positions.resize(gstate.right_table->Count());
+		for (idx_t i = 0; i < l1.size(); i++) {
+			if (l1[i] > 0) {
+				left_positions[RowFromId(l1[i])] = i;
+			} else {
+				right_positions[RowFromId(l1[i])] = i;
+			}
+		}
+		bits.resize((l1.size() + 63) / 64, 0);
+		summary.resize((bits.size() + 63) / 64, 0);
+		l2_position = l2.size();
+	}
+
+	void SetBit(idx_t position) {
+		auto word_idx = position / 64;
+		bits[word_idx] |= uint64_t(1) << (position % 64);
+		summary[word_idx / 64] |= uint64_t(1) << (word_idx % 64);
+	}
+
+	//! Returns the first set bit at or after the given position, or the amount of bits if there is none
+	idx_t NextSetBit(idx_t position) const {
+		auto word_idx = position / 64;
+		if (word_idx >= bits.size()) {
+			return l1.size();
+		}
+		auto word = bits[word_idx] & (~uint64_t(0) << (position % 64));
+		if (word != 0) {
+			return word_idx * 64 + FirstSetBit(word);
+		}
+		// use the summary to find the next non-zero word
+		for (idx_t next = word_idx + 1; next < bits.size();) {
+			auto summary_idx = next / 64;
+			auto summary_word = summary[summary_idx] & (~uint64_t(0) << (next % 64));
+			if (summary_word != 0) {
+				auto found_idx = summary_idx * 64 + FirstSetBit(summary_word);
+				return found_idx * 64 + FirstSetBit(bits[found_idx]);
+			}
+			next = (summary_idx + 1) * 64;
+		}
+		return l1.size();
+	}
+
+	//! Enumerate the next candidate pairs that satisfy the first two conditions, returns the amount of pairs
+	idx_t NextPairs(idx_t left_rows[], idx_t right_rows[]) {
+		idx_t count = 0;
+		while (count < STANDARD_VECTOR_SIZE) {
+			if (scanning) {
+				// the set bits after the position of the left row in L1 are the right rows that satisfy both
+				auto position = NextSetBit(bit_position);
+				if (position >= l1.size()) {
+					scanning = false;
+					continue;
+				}
+				left_rows[count] = left_row;
+				right_rows[count] = RowFromId(l1[position]);
+				count++;
+				bit_position = position + 1;
+				continue;
+			}
+			if (l2_position == 0) {
+				break;
+			}
+			auto id = l2[--l2_position];
+			if (id < 0) {
+				// right row: the left rows that come before it in L2 satisfy the second condition
+				SetBit(right_positions[RowFromId(id)]);
+			} else {
+				left_row = RowFromId(id);
+				bit_position = left_positions[left_row] + 1;
+				scanning = true;
+			}
+		}
+		return count;
+	}
+};
+
+unique_ptr<GlobalSourceState> PhysicalIEJoin::GetGlobalSourceState(ClientContext &context) const {
+	return make_unique<IEJoinScanState>(*this);
+}
+
+//! Select the pairs for which the given comparison holds between the keys
+static idx_t SelectComparison(ExpressionType comparison, Vector &left, Vector &right, const SelectionVector *sel,
+                              idx_t count, SelectionVector *true_sel) {
+	switch (comparison) {
+	case ExpressionType::COMPARE_EQUAL:
+		return VectorOperations::Equals(left, right, sel, count, true_sel, nullptr);
+	case ExpressionType::COMPARE_NOTEQUAL:
+		return VectorOperations::NotEquals(left, right, sel, count, true_sel, nullptr);
+	case ExpressionType::COMPARE_LESSTHAN:
+		return VectorOperations::LessThan(left, right, sel, count, true_sel, nullptr);
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return VectorOperations::GreaterThan(left, right, sel, count, true_sel, nullptr);
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return VectorOperations::LessThanEquals(left, right, sel, count, true_sel, nullptr);
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return VectorOperations::GreaterThanEquals(left, right, sel, count, true_sel, nullptr);
+	case ExpressionType::COMPARE_DISTINCT_FROM:
+		return VectorOperations::DistinctFrom(left, right, sel, count, true_sel, nullptr);
+	case ExpressionType::COMPARE_NOT_DISTINCT_FROM:
+		return VectorOperations::NotDistinctFrom(left, right, sel, count, true_sel, nullptr);
+	default:
+		throw NotImplementedException("Unimplemented comparison type for IEJoin");
+	}
+}
+
+void PhysicalIEJoin::GetData(ExecutionContext &context, DataChunk &chunk, GlobalSourceState &gstate_p,
+                             LocalSourceState &lstate) const {
+	auto &state = (IEJoinScanState &)gstate_p;
+	auto &gstate = (IEJoinGlobalState &)*sink_state;
+	auto &left_table = *gstate.left_table;
+	auto &right_table = *gstate.right_table;
+	const idx_t left_cols = children[0]->types.size();
+	const idx_t right_cols = children[1]->types.size();
+
+	lock_guard<mutex> l(state.lock);
+	if (!state.initialized) {
+		state.Initialize(context.client);
+		state.initialized = true;
+	}
+
+	// enumerate the pairs that satisfy the first two conditions, and filter them on the remaining conditions
+	idx_t left_rows[STANDARD_VECTOR_SIZE];
+	idx_t right_rows[STANDARD_VECTOR_SIZE];
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	SelectionVector true_sel(STANDARD_VECTOR_SIZE);
+	for (;;) {
+		auto count = state.NextPairs(left_rows, right_rows);
+		if (count == 0) {
+			break;
+		}
+		const SelectionVector *current_sel = FlatVector::IncrementalSelectionVector();
+		for (idx_t cond_idx = 2; cond_idx < conditions.size() && count > 0; cond_idx++) {
+			Vector left_key(join_key_types[cond_idx]);
+			Vector right_key(join_key_types[cond_idx]);
+			left_table.Gather(left_rows, count, cond_idx, left_key);
+			right_table.Gather(right_rows, count, cond_idx, right_key);
+			auto match_count =
+			    SelectComparison(conditions[cond_idx].comparison, left_key, right_key, current_sel, count, &true_sel);
+			// compact the pairs that matched
+			for (idx_t i = 0; i < match_count; i++) {
+				auto idx = true_sel.get_index(i);
+				left_rows[i] = left_rows[idx];
+				right_rows[i] = right_rows[idx];
+			}
+			count = match_count;
+		}
+		if (count == 0) {
+			continue;
+		}
+		// found matches: mark the found matches if required
+		if (state.left_found_match) {
+			for (idx_t i = 0; i < count; i++) {
+				state.left_found_match[left_rows[i]] = true;
+			}
+		}
+		if (state.right_found_match) {
+			for (idx_t i = 0; i < count; i++) {
+				state.right_found_match[right_rows[i]] = true;
+			}
+		}
+		// found matches: output them
+		for (idx_t i = 0; i < left_cols; i++) {
+			left_table.Gather(left_rows, count, conditions.size() + i, chunk.data[i]);
+		}
+		for (idx_t i = 0; i < right_cols; i++) {
+			right_table.Gather(right_rows, count, conditions.size() + i, chunk.data[left_cols + i]);
+		}
+		chunk.SetCardinality(count);
+		return;
+	}
+
+	// finally, output the rows of the LHS and RHS that did not find a match (if required)
+	if (state.left_found_match) {
+		idx_t count = 0;
+		for (; state.left_outer_position < left_table.Count() && count < STANDARD_VECTOR_SIZE;
+		     state.left_outer_position++) {
+			if (!state.left_found_match[state.left_outer_position]) {
+				left_rows[count++] = state.left_outer_position;
+			}
+		}
+		if (count > 0) {
+			for (idx_t i = 0; i < left_cols; i++) {
+				left_table.Gather(left_rows, count, conditions.size() + i, chunk.data[i]);
+			}
+			for (idx_t i = 0; i < right_cols; i++) {
+				chunk.data[left_cols + i].SetVectorType(VectorType::CONSTANT_VECTOR);
+				ConstantVector::SetNull(chunk.data[left_cols + i], true);
+			}
+			chunk.SetCardinality(count);
+			return;
+		}
+	}
+	if (state.right_found_match) {
+		idx_t count = 0;
+		for (; state.right_outer_position < right_table.Count() && count < STANDARD_VECTOR_SIZE;
+		     state.right_outer_position++) {
+			if (!state.right_found_match[state.right_outer_position]) {
+				right_rows[count++] = state.right_outer_position;
+			}
+		}
+		if (count > 0) {
+			for (idx_t i = 0; i < left_cols; i++) {
+				chunk.data[i].SetVectorType(VectorType::CONSTANT_VECTOR);
+				ConstantVector::SetNull(chunk.data[i], true);
+			}
+			for (idx_t i = 0; i < right_cols; i++) {
+				right_table.Gather(right_rows, count, conditions.size() + i, chunk.data[left_cols + i]);
+			}
+			chunk.SetCardinality(count);
+			return;
+		}
+	}
+}
+
+} // namespace duckdb
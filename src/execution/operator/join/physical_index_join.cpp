@@ -15,7 +15,7 @@ namespace duckdb {
 class IndexJoinOperatorState : public OperatorState {
 public:
 	explicit IndexJoinOperatorState(const PhysicalIndexJoin &op) {
-		rhs_rows.resize(STANDARD_VECTOR_SIZE);
+		result_offsets.resize(STANDARD_VECTOR_SIZE);
 		result_sizes.resize(STANDARD_VECTOR_SIZE);
 
 		join_keys.Initialize(op.condition_types);
@@ -36,8 +36,10 @@ public:
 	DataChunk join_keys;
 	DataChunk rhs_chunk;
 	SelectionVector rhs_sel;
-	//! Vector of rows that mush be fetched for every LHS key
-	vector<vector<row_t>> rhs_rows;
+	//! The offset of the rows that must be fetched for every LHS key in rhs_rows
+	vector<idx_t> result_offsets;
+	//! The rows that must be fetched for the LHS keys
+	vector<row_t> rhs_rows;
 	ExpressionExecutor probe_executor;
 
 public:
@@ -103,7 +105,7 @@ void PhysicalIndexJoin::Output(ExecutionContext &context, DataChunk &input, Data
 			state.rhs_sel.set_index(output_sel_idx++, state.lhs_idx);
 			if (!fetch_types.empty()) {
 				//! We need to collect the rows we want to fetch
-				fetch_rows.push_back(state.rhs_rows[state.lhs_idx][state.rhs_idx]);
+				fetch_rows.push_back(state.rhs_rows[state.result_offsets[state.lhs_idx] + state.rhs_idx]);
 			}
 			state.rhs_idx++;
 		} else {
@@ -146,26 +148,13 @@ void PhysicalIndexJoin::Output(ExecutionContext &context, DataChunk &input, Data
 void PhysicalIndexJoin::GetRHSMatches(ExecutionContext &context, DataChunk &input, OperatorState &state_p) const {
 	auto &state = (IndexJoinOperatorState &)state_p;
 	auto &art = (ART &)*index;
-	auto &transaction = Transaction::GetTransaction(context.client);
-	for (idx_t i = 0; i < input.size(); i++) {
-		auto equal_value = state.join_keys.GetValue(0, i);
-		auto index_state = art.InitializeScanSinglePredicate(transaction, equal_value, ExpressionType::COMPARE_EQUAL);
-		state.rhs_rows[i].clear();
-		if (!equal_value.is_null) {
-			if (fetch_types.empty()) {
-				IndexLock lock;
-				index->InitializeLock(lock);
-				art.SearchEqualJoinNoFetch(equal_value, state.result_sizes[i]);
-			} else {
-				IndexLock lock;
-				index->InitializeLock(lock);
-				art.SearchEqual((ARTIndexScanState *)index_state.get(), (idx_t)-1, state.rhs_rows[i]);
-				state.result_sizes[i] = state.rhs_rows[i].size();
-			}
-		} else {
-			//! This is null so no matches
-			state.result_sizes[i] = 0;
-		}
+	//! Look up all keys of the LHS chunk at once
+	state.rhs_rows.clear();
+	{
+		IndexLock lock;
+		index->InitializeLock(lock);
+		art.SearchEqualJoin(state.join_keys.data[0], input.size(), !fetch_types.empty(), state.result_offsets.data(),
+		                    state.result_sizes.data(), state.rhs_rows);
 	}
 	for (idx_t i = input.size(); i < STANDARD_VECTOR_SIZE; i++) {
 		//! No LHS chunk value so result size is empty
@@ -1,10 +1,16 @@
 #include "duckdb/execution/operator/join/physical_piecewise_merge_join.hpp"
-#include "duckdb/parallel/thread_context.hpp"
+
+#include "duckdb/common/operator/comparison_operators.hpp"
+#include "duckdb/common/row_operations/row_operations.hpp"
+#include "duckdb/common/sort/sort.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/execution/merge_join.hpp"
-#include "duckdb/common/operator/comparison_operators.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/parallel/event.hpp"
+#include "duckdb/parallel/thread_context.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 
 namespace duckdb {
 
@@ -28,9 +34,56 @@ PhysicalPiecewiseMergeJoin::PhysicalPiecewiseMergeJoin(LogicalOperator &op, uniq
 //===--------------------------------------------------------------------===//
 // Sink
 //===--------------------------------------------------------------------===//
+class MergeJoinGlobalState : public GlobalSinkState {
+public:
+	MergeJoinGlobalState(BufferManager &buffer_manager, const vector<BoundOrderByNode> &orders, RowLayout &rhs_layout)
+	    : global_sort_state(buffer_manager, orders, rhs_layout), memory_per_thread(0), right_count(0),
+	      right_null_count(0) {
+	}
+
+	mutex mj_lock;
+	//! The sorted RHS: the join key followed by the RHS columns, sorted on the join key (with the NULLs last)
+	GlobalSortState global_sort_state;
+	//! Memory usage per thread
+	idx_t memory_per_thread;
+	//! The number of rows in the RHS, and the number of rows of which the join key is NULL
+	idx_t right_count;
+	idx_t right_null_count;
+	//! The (sorted) index of the first row of every block of the sorted RHS
+	vector<idx_t> block_starts;
+	//! The smallest and largest join key of every chunk of STANDARD_VECTOR_SIZE rows of the sorted RHS
+	vector<Value> chunk_min;
+	vector<Value> chunk_max;
+	//! A bool indicating for each tuple in the sorted RHS if they found a match (only used in FULL OUTER JOIN)
+	unique_ptr<bool[]> right_found_match;
+
+public:
+	//! Whether or not the RHS of the join has NULL values
+	bool HasNull() const {
+		return right_null_count > 0;
+	}
+	idx_t NonNullCount() const {
+		return right_count - right_null_count;
+	}
+	idx_t ChunkCount() const {
+		return (right_count + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+	}
+	//! The number of rows with a non-NULL join key in the given chunk of the sorted RHS
+	idx_t NonNullCount(idx_t chunk_idx) const {
+		auto chunk_start = chunk_idx * STANDARD_VECTOR_SIZE;
+		auto non_null_count = NonNullCount();
+		return non_null_count > chunk_start ? MinValue<idx_t>(non_null_count - chunk_start, STANDARD_VECTOR_SIZE) : 0;
+	}
+	SortedData &SortedRHS() {
+		return *global_sort_state.sorted_blocks[0]->payload_data;
+	}
+	//! Initialize the block offsets and the key ranges of the chunks once the RHS has been sorted
+	void InitializeSortedRHS();
+};
+
 class MergeJoinLocalState : public LocalSinkState {
 public:
-	explicit MergeJoinLocalState(const vector<JoinCondition> &conditions) {
+	explicit MergeJoinLocalState(const vector<JoinCondition> &conditions) : right_count(0), right_null_count(0) {
 		vector<LogicalType> condition_types;
 		for (auto &cond : conditions) {
 			rhs_executor.AddExpression(*cond.right);
@@ -39,34 +92,37 @@ public:
 		join_keys.Initialize(condition_types);
 	}
 
+	//! The local sort state of the RHS
+	LocalSortState local_sort_state;
 	//! The chunk holding the right condition
 	DataChunk join_keys;
+	//! The chunk holding the right condition followed by the RHS columns
+	DataChunk payload;
 	//! The executor of the RHS condition
 	ExpressionExecutor rhs_executor;
-};
-
-class MergeJoinGlobalState : public GlobalSinkState {
-public:
-	MergeJoinGlobalState() : has_null(false), right_outer_position(0) {
-	}
-
-	mutex mj_lock;
-	//! The materialized data of the RHS
-	ChunkCollection right_chunks;
-	//! The materialized join keys of the RHS
-	ChunkCollection right_conditions;
-	//! The join orders of the RHS
-	vector<MergeOrder> right_orders;
-	//! Whether or not the RHS of the nested loop join has NULL values
-	bool has_null;
-	//! A bool indicating for each tuple in the RHS if they found a match (only used in FULL OUTER JOIN)
-	unique_ptr<bool[]> right_found_match;
-	//! The position in the RHS in the final scan of the FULL OUTER JOIN
-	idx_t right_outer_position;
+	//! The number of rows sunk by this thread, and the number of rows of which the join key is NULL
+	idx_t right_count;
+	idx_t right_null_count;
 };
 
 unique_ptr<GlobalSinkState> PhysicalPiecewiseMergeJoin::GetGlobalSinkState(ClientContext &context) const {
-	return make_unique<MergeJoinGlobalState>();
+	// the RHS is sorted on the join key, and the join key is stored in the payload as well so it can be compared
+	vector<BoundOrderByNode> orders;
+	orders.emplace_back(OrderType::ASCENDING, OrderByNullType::NULLS_LAST,
+	                    make_unique<BoundReferenceExpression>(join_key_types[0], 0));
+	vector<LogicalType> rhs_types;
+	rhs_types.push_back(join_key_types[0]);
+	rhs_types.insert(rhs_types.end(), children[1]->types.begin(), children[1]->types.end());
+	RowLayout rhs_layout;
+	rhs_layout.Initialize(rhs_types);
+
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	auto state = make_unique<MergeJoinGlobalState>(buffer_manager, orders, rhs_layout);
+	state->global_sort_state.external = ClientConfig::GetConfig(context).force_external;
+	// memory usage per thread should scale with max mem / num threads, we take 1/4th of this to be conservative
+	idx_t num_threads = TaskScheduler::GetScheduler(context).NumberOfThreads();
+	state->memory_per_thread = (buffer_manager.GetMaxMemory() / num_threads) / 4;
+	return move(state);
 }
 
 unique_ptr<LocalSinkState> PhysicalPiecewiseMergeJoin::GetLocalSinkState(ExecutionContext &context) const {
@@ -77,64 +133,255 @@ SinkResultType PhysicalPiecewiseMergeJoin::Sink(ExecutionContext &context, Globa
                                                 LocalSinkState &lstate, DataChunk &input) const {
 	auto &gstate = (MergeJoinGlobalState &)state;
 	auto &mj_state = (MergeJoinLocalState &)lstate;
+	auto &global_sort_state = gstate.global_sort_state;
+	auto &local_sort_state = mj_state.local_sort_state;
 
-	// resolve the join keys for this chunk
-	mj_state.rhs_executor.SetChunk(input);
+	if (!local_sort_state.initialized) {
+		local_sort_state.Initialize(global_sort_state, BufferManager::GetBufferManager(context.client));
+		mj_state.payload.InitializeEmpty(global_sort_state.payload_layout.GetTypes());
+	}
 
+	// resolve the join keys for this chunk
 	mj_state.join_keys.Reset();
-	mj_state.join_keys.SetCardinality(input);
-	for (idx_t k = 0; k < conditions.size(); k++) {
-		// resolve the join key
-		mj_state.rhs_executor.ExecuteExpression(k, mj_state.join_keys.data[k]);
-	}
-	// append the join keys and the chunk to the chunk collection
-	lock_guard<mutex> mj_guard(gstate.mj_lock);
-	gstate.right_chunks.Append(input);
-	gstate.right_conditions.Append(mj_state.join_keys);
+	mj_state.rhs_executor.Execute(input, mj_state.join_keys);
+
+	// count the NULL values in the join keys: these never find a match
+	VectorData key_data;
+	mj_state.join_keys.data[0].Orrify(input.size(), key_data);
+	if (!key_data.validity.AllValid()) {
+		for (idx_t i = 0; i < input.size(); i++) {
+			if (!key_data.validity.RowIsValid(key_data.sel->get_index(i))) {
+				mj_state.right_null_count++;
+			}
+		}
+	}
+	mj_state.right_count += input.size();
+
+	// sink the join keys and the chunk into the local sort state
+	mj_state.payload.data[0].Reference(mj_state.join_keys.data[0]);
+	for (idx_t i = 0; i < input.ColumnCount(); i++) {
+		mj_state.payload.data[i + 1].Reference(input.data[i]);
+	}
+	mj_state.payload.SetCardinality(input);
+	local_sort_state.SinkChunk(mj_state.join_keys, mj_state.payload);
+
+	// when the sorting data reaches a certain size, we sort it
+	if (local_sort_state.SizeInBytes() >= gstate.memory_per_thread) {
+		local_sort_state.Sort(global_sort_state, true);
+	}
 	return SinkResultType::NEED_MORE_INPUT;
 }
 
-void PhysicalPiecewiseMergeJoin::Combine(ExecutionContext &context, GlobalSinkState &gstate,
+void PhysicalPiecewiseMergeJoin::Combine(ExecutionContext &context, GlobalSinkState &gstate_p,
                                          LocalSinkState &lstate) const {
+	auto &gstate = (MergeJoinGlobalState &)gstate_p;
 	auto &state = (MergeJoinLocalState &)lstate;
-	auto &client_profiler = QueryProfiler::Get(context.client);
+	gstate.global_sort_state.AddLocalState(state.local_sort_state);
+	{
+		lock_guard<mutex> mj_guard(gstate.mj_lock);
+		gstate.right_count += state.right_count;
+		gstate.right_null_count += state.right_null_count;
+	}
 
+	auto &client_profiler = QueryProfiler::Get(context.client);
 	context.thread.profiler.Flush(this, &state.rhs_executor, "rhs_executor", 1);
 	client_profiler.Flush(context.thread.profiler);
 }
 
+//===--------------------------------------------------------------------===//
+// Sorted RHS
+//===--------------------------------------------------------------------===//
+//! SortedRHSReader reads a range of rows of the sorted RHS. The rows stay pinned until the next range is read.
+class SortedRHSReader {
+public:
+	SortedRHSReader() : count(0), addresses(LogicalType::POINTER) {
+	}
+
+	//! The number of rows that were read
+	idx_t count;
+
+public:
+	//! Read the rows [start, start + count) of the sorted RHS
+	void Read(MergeJoinGlobalState &gstate, idx_t start, idx_t count_p) {
+		auto &buffer_manager = gstate.global_sort_state.buffer_manager;
+		auto &sorted_data = gstate.SortedRHS();
+		auto &layout = sorted_data.layout;
+		const idx_t row_width = layout.GetRowWidth();
+		// the heap pointers of external data are swizzled: we unswizzle a copy of the rows, so the blocks stay intact
+		const bool swizzled = !layout.AllConstant() && gstate.global_sort_state.external;
+		D_ASSERT(count_p <= STANDARD_VECTOR_SIZE);
+		handles.clear();
+		if (swizzled && !unswizzled_rows) {
+			unswizzled_rows = unique_ptr<data_t[]>(new data_t[STANDARD_VECTOR_SIZE * row_width]);
+		}
+
+		auto block_idx = std::upper_bound(gstate.block_starts.begin(), gstate.block_starts.end(), start) -
+		                 gstate.block_starts.begin() - 1;
+		auto row_pointers = FlatVector::GetData<data_ptr_t>(addresses);
+		idx_t read = 0;
+		while (read < count_p) {
+			auto &data_block = sorted_data.data_blocks[block_idx];
+			auto entry_idx = start + read - gstate.block_starts[block_idx];
+			auto next = MinValue<idx_t>(data_block.count - entry_idx, count_p - read);
+			auto data_handle = buffer_manager.Pin(data_block.block);
+			data_ptr_t row_ptr = data_handle->Ptr() + entry_idx * row_width;
+			if (swizzled) {
+				auto heap_handle = buffer_manager.Pin(sorted_data.heap_blocks[block_idx].block);
+				auto copy_ptr = unswizzled_rows.get() + read * row_width;
+				memcpy(copy_ptr, row_ptr, next * row_width);
+				RowOperations::UnswizzlePointers(layout, copy_ptr, heap_handle->Ptr(), next);
+				row_ptr = copy_ptr;
+				handles.push_back(move(heap_handle));
+			} else {
+				handles.push_back(move(data_handle));
+			}
+			for (idx_t i = 0; i < next; i++) {
+				row_pointers[read + i] = row_ptr;
+				row_ptr += row_width;
+			}
+			read += next;
+			block_idx++;
+		}
+		count = count_p;
+	}
+
+	//! Gather a column of the rows that were read
+	void Gather(const RowLayout &layout, idx_t col_idx, Vector &result) {
+		RowOperations::Gather(addresses, *FlatVector::IncrementalSelectionVector(), result,
+		                      *FlatVector::IncrementalSelectionVector(), count, layout.GetOffsets()[col_idx], col_idx);
+	}
+
+private:
+	//! The addresses of the rows that were read
+	Vector addresses;
+	//! The pinned blocks the rows refer to
+	vector<unique_ptr<BufferHandle>> handles;
+	//! A copy of the rows that were read, with unswizzled pointers (only used if the sorted RHS is external)
+	unique_ptr<data_t[]> unswizzled_rows;
+};
+
+void MergeJoinGlobalState::InitializeSortedRHS() {
+	if (global_sort_state.sorted_blocks.empty()) {
+		return;
+	}
+	D_ASSERT(global_sort_state.sorted_blocks.size() == 1);
+	auto &sorted_data = SortedRHS();
+	D_ASSERT(sorted_data.Count() == right_count);
+	idx_t block_start = 0;
+	for (auto &block : sorted_data.data_blocks) {
+		block_starts.push_back(block_start);
+		block_start += block.count;
+	}
+
+	// the keys are sorted, so the first and last non-NULL key of every chunk determine its range
+	auto &layout = sorted_data.layout;
+	SortedRHSReader reader;
+	Vector key(layout.GetTypes()[0]);
+	for (idx_t chunk_idx = 0; chunk_idx < ChunkCount(); chunk_idx++) {
+		auto non_null_count = NonNullCount(chunk_idx);
+		if (non_null_count == 0) {
+			break;
+		}
+		auto chunk_start = chunk_idx * STANDARD_VECTOR_SIZE;
+		reader.Read(*this, chunk_start, 1);
+		reader.Gather(layout, 0, key);
+		chunk_min.push_back(key.GetValue(0));
+		reader.Read(*this, chunk_start + non_null_count - 1, 1);
+		reader.Gather(layout, 0, key);
+		chunk_max.push_back(key.GetValue(0));
+	}
+}
+
 //===--------------------------------------------------------------------===//
 // Finalize
 //===--------------------------------------------------------------------===//
-static void OrderVector(Vector &vector, idx_t count, MergeOrder &order);
+class MergeJoinMergeTask : public ExecutorTask {
+public:
+	MergeJoinMergeTask(shared_ptr<Event> event_p, ClientContext &context, MergeJoinGlobalState &state)
+	    : ExecutorTask(context), event(move(event_p)), context(context), state(state) {
+	}
+
+	TaskExecutionResult ExecuteTask(TaskExecutionMode mode) override {
+		// Initialize merge sorted and iterate until done
+		auto &global_sort_state = state.global_sort_state;
+		MergeSorter merge_sorter(global_sort_state, BufferManager::GetBufferManager(context));
+		merge_sorter.PerformInMergeRound();
+		event->FinishTask();
+		return TaskExecutionResult::TASK_FINISHED;
+	}
+
+private:
+	shared_ptr<Event> event;
+	ClientContext &context;
+	MergeJoinGlobalState &state;
+};
+
+static void ScheduleMergeTasks(Pipeline &pipeline, Event &event, MergeJoinGlobalState &state);
+
+class MergeJoinMergeEvent : public Event {
+public:
+	MergeJoinMergeEvent(MergeJoinGlobalState &gstate_p, Pipeline &pipeline_p)
+	    : Event(pipeline_p.executor), gstate(gstate_p), pipeline(pipeline_p) {
+	}
+
+	MergeJoinGlobalState &gstate;
+	Pipeline &pipeline;
+
+public:
+	void Schedule() override {
+		auto &context = pipeline.GetClientContext();
+
+		// Schedule tasks equal to the number of threads, which will each merge multiple partitions
+		auto &ts = TaskScheduler::GetScheduler(context);
+		idx_t num_threads = ts.NumberOfThreads();
+
+		vector<unique_ptr<Task>> merge_tasks;
+		for (idx_t tnum = 0; tnum < num_threads; tnum++) {
+			merge_tasks.push_back(make_unique<MergeJoinMergeTask>(shared_from_this(), context, gstate));
+		}
+		SetTasks(move(merge_tasks));
+	}
+
+	void FinishEvent() override {
+		auto &global_sort_state = gstate.global_sort_state;
+
+		global_sort_state.CompleteMergeRound();
+		if (global_sort_state.sorted_blocks.size() > 1) {
+			// Multiple blocks remaining: Schedule the next round
+			ScheduleMergeTasks(pipeline, *this, gstate);
+		} else {
+			gstate.InitializeSortedRHS();
+		}
+	}
+};
+
+static void ScheduleMergeTasks(Pipeline &pipeline, Event &event, MergeJoinGlobalState &state) {
+	// Initialize global sort state for a round of merging
+	state.global_sort_state.InitializeMergeRound();
+	auto new_event = make_shared<MergeJoinMergeEvent>(state, pipeline);
+	event.InsertEvent(move(new_event));
+}
 
 SinkFinalizeType PhysicalPiecewiseMergeJoin::Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
                                                       GlobalSinkState &gstate_p) const {
 	auto &gstate = (MergeJoinGlobalState &)gstate_p;
-	if (gstate.right_conditions.ChunkCount() > 0) {
-		// now order all the chunks
-		gstate.right_orders.resize(gstate.right_conditions.ChunkCount());
-		for (idx_t i = 0; i < gstate.right_conditions.ChunkCount(); i++) {
-			auto &chunk_to_order = gstate.right_conditions.GetChunk(i);
-			D_ASSERT(chunk_to_order.ColumnCount() == 1);
-			for (idx_t col_idx = 0; col_idx < chunk_to_order.ColumnCount(); col_idx++) {
-				OrderVector(chunk_to_order.data[col_idx], chunk_to_order.size(), gstate.right_orders[i]);
-				if (gstate.right_orders[i].count < chunk_to_order.size()) {
-					// the amount of entries in the order vector is smaller than the amount of entries in the vector
-					// this only happens if there are NULL values in the right-hand side
-					// hence we set the has_null to true (this is required for the MARK join)
-					gstate.has_null = true;
-				}
-			}
-		}
-	}
+	auto &global_sort_state = gstate.global_sort_state;
 	if (IsRightOuterJoin(join_type)) {
 		// for FULL/RIGHT OUTER JOIN, initialize found_match to false for every tuple
-		gstate.right_found_match = unique_ptr<bool[]>(new bool[gstate.right_chunks.Count()]);
-		memset(gstate.right_found_match.get(), 0, sizeof(bool) * gstate.right_chunks.Count());
+		gstate.right_found_match = unique_ptr<bool[]>(new bool[gstate.right_count]);
+		memset(gstate.right_found_match.get(), 0, sizeof(bool) * gstate.right_count);
 	}
-	if (gstate.right_chunks.Count() == 0 && EmptyResultIfRHSIsEmpty()) {
-		return SinkFinalizeType::NO_OUTPUT_POSSIBLE;
+	if (global_sort_state.sorted_blocks.empty()) {
+		// empty RHS
+		return EmptyResultIfRHSIsEmpty() ? SinkFinalizeType::NO_OUTPUT_POSSIBLE : SinkFinalizeType::READY;
+	}
+
+	// prepare for the merge sort phase, and merge the sorted runs of the threads in parallel (if necessary)
+	global_sort_state.PrepareMergePhase();
+	if (global_sort_state.sorted_blocks.size() > 1) {
+		ScheduleMergeTasks(pipeline, event, gstate);
+	} else {
+		gstate.InitializeSortedRHS();
 	}
 	return SinkFinalizeType::READY;
 }
@@ -142,16 +389,21 @@ SinkFinalizeType PhysicalPiecewiseMergeJoin::Finalize(Pipeline &pipeline, Event
 //===--------------------------------------------------------------------===//
 // Operator
 //===--------------------------------------------------------------------===//
+static void OrderVector(Vector &vector, idx_t count, MergeOrder &order);
+
 class PiecewiseMergeJoinState : public OperatorState {
 public:
 	explicit PiecewiseMergeJoinState(const PhysicalPiecewiseMergeJoin &op)
-	    : op(op), first_fetch(true), finished(true), left_position(0), right_position(0), right_chunk_index(0) {
+	    : op(op), first_fetch(true), finished(true), left_position(0), right_position(0), right_chunk_index(0),
+	      loaded_chunk_index(DConstants::INVALID_INDEX), right_payload_loaded(false) {
 		vector<LogicalType> condition_types;
 		for (auto &cond : op.conditions) {
 			lhs_executor.AddExpression(*cond.left);
 			condition_types.push_back(cond.left->return_type);
 		}
 		join_keys.Initialize(condition_types);
+		auto &gstate = (MergeJoinGlobalState &)*op.sink_state;
+		right_chunk.Initialize(gstate.global_sort_state.payload_layout.GetTypes());
 		if (IsLeftOuterJoin(op.join_type)) {
 			left_found_match = unique_ptr<bool[]>(new bool[STANDARD_VECTOR_SIZE]);
 			memset(left_found_match.get(), 0, sizeof(bool) * STANDARD_VECTOR_SIZE);
@@ -170,6 +422,17 @@ public:
 	//! The executor of the RHS condition
 	ExpressionExecutor lhs_executor;
 	unique_ptr<bool[]> left_found_match;
+	//! The smallest and largest join key of the LHS chunk
+	Value left_min;
+	Value left_max;
+
+	//! The reader of the sorted RHS, and the chunk of the sorted RHS that is currently loaded
+	SortedRHSReader right_reader;
+	DataChunk right_chunk;
+	MergeOrder right_orders;
+	idx_t loaded_chunk_index;
+	//! Whether or not the RHS columns of the loaded chunk have been gathered (the join key is always gathered)
+	bool right_payload_loaded;
 
 public:
 	void ResolveJoinKeys(DataChunk &input) {
@@ -182,6 +445,42 @@ public:
 			// sort by join key
 			OrderVector(join_keys.data[k], join_keys.size(), left_orders);
 		}
+		if (left_orders.count > 0) {
+			left_min = join_keys.data[0].GetValue(left_orders.order.get_index(0));
+			left_max = join_keys.data[0].GetValue(left_orders.order.get_index(left_orders.count - 1));
+		}
+	}
+
+	//! Load the join keys of the given chunk of the sorted RHS
+	void LoadRightChunk(MergeJoinGlobalState &gstate, idx_t chunk_idx) {
+		if (loaded_chunk_index == chunk_idx) {
+			return;
+		}
+		auto &layout = gstate.SortedRHS().layout;
+		auto chunk_start = chunk_idx * STANDARD_VECTOR_SIZE;
+		auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, gstate.right_count - chunk_start);
+		right_chunk.Reset();
+		right_reader.Read(gstate, chunk_start, count);
+		right_reader.Gather(layout, 0, right_chunk.data[0]);
+		right_chunk.SetCardinality(count);
+		// the chunk is sorted and the NULLs come last: the order is the identity on the non-NULL keys
+		right_orders.count = gstate.NonNullCount(chunk_idx);
+		right_orders.order.Initialize(*FlatVector::IncrementalSelectionVector());
+		right_chunk.data[0].Orrify(count, right_orders.vdata);
+		loaded_chunk_index = chunk_idx;
+		right_payload_loaded = false;
+	}
+
+	//! Gather the RHS columns of the loaded chunk
+	void LoadRightPayload(MergeJoinGlobalState &gstate) {
+		if (right_payload_loaded) {
+			return;
+		}
+		auto &layout = gstate.SortedRHS().layout;
+		for (idx_t col_idx = 1; col_idx < right_chunk.ColumnCount(); col_idx++) {
+			right_reader.Gather(layout, col_idx, right_chunk.data[col_idx]);
+		}
+		right_payload_loaded = true;
 	}
 
 	void Finalize(PhysicalOperator *op, ExecutionContext &context) override {
@@ -193,29 +492,78 @@ unique_ptr<OperatorState> PhysicalPiecewiseMergeJoin::GetOperatorState(ClientCon
 	return make_unique<PiecewiseMergeJoinState>(*this);
 }
 
+//! Whether or not any key of the given chunk of the sorted RHS can match with a key of the LHS chunk
+static bool RightChunkCanMatch(ExpressionType comparison, MergeJoinGlobalState &gstate, idx_t chunk_idx,
+                               PiecewiseMergeJoinState &state) {
+	if (chunk_idx >= gstate.chunk_min.size()) {
+		// only NULL keys
+		return false;
+	}
+	switch (comparison) {
+	case ExpressionType::COMPARE_LESSTHAN:
+		return state.left_min < gstate.chunk_max[chunk_idx];
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return state.left_min <= gstate.chunk_max[chunk_idx];
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return state.left_max > gstate.chunk_min[chunk_idx];
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return state.left_max >= gstate.chunk_min[chunk_idx];
+	default:
+		throw NotImplementedException("Unimplemented comparison type for merge join!");
+	}
+}
+
 void PhysicalPiecewiseMergeJoin::ResolveSimpleJoin(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
                                                    OperatorState &state_p) const {
 	auto &state = (PiecewiseMergeJoinState &)state_p;
 	auto &gstate = (MergeJoinGlobalState &)*sink_state;
 
-	state.ResolveJoinKeys(input);
-
-	ScalarMergeInfo left_info(state.left_orders, state.join_keys.data[0].GetType(), state.left_position);
-	ChunkMergeInfo right_info(gstate.right_conditions, gstate.right_orders);
-
-	// perform the actual join
-	MergeJoinSimple::Perform(left_info, right_info, conditions[0].comparison);
+	state.join_keys.Reset();
+	state.lhs_executor.Execute(input, state.join_keys);
+
+	// the RHS is sorted: a key has a match iff it matches the largest (for < and <=) or smallest (for > and >=) key
+	bool found_match[STANDARD_VECTOR_SIZE];
+	memset(found_match, 0, sizeof(found_match));
+	if (gstate.NonNullCount() > 0) {
+		auto comparison = conditions[0].comparison;
+		bool use_max = comparison == ExpressionType::COMPARE_LESSTHAN ||
+		               comparison == ExpressionType::COMPARE_LESSTHANOREQUALTO;
+		Vector extreme(use_max ? gstate.chunk_max.back() : gstate.chunk_min.front());
+		SelectionVector true_sel(STANDARD_VECTOR_SIZE);
+		idx_t match_count;
+		auto &keys = state.join_keys.data[0];
+		switch (comparison) {
+		case ExpressionType::COMPARE_LESSTHAN:
+			match_count = VectorOperations::LessThan(keys, extreme, nullptr, input.size(), &true_sel, nullptr);
+			break;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			match_count = VectorOperations::LessThanEquals(keys, extreme, nullptr, input.size(), &true_sel, nullptr);
+			break;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			match_count = VectorOperations::GreaterThan(keys, extreme, nullptr, input.size(), &true_sel, nullptr);
+			break;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			match_count =
+			    VectorOperations::GreaterThanEquals(keys, extreme, nullptr, input.size(), &true_sel, nullptr);
+			break;
+		default:
+			throw NotImplementedException("Unimplemented comparison type for merge join!");
+		}
+		for (idx_t i = 0; i < match_count; i++) {
+			found_match[true_sel.get_index(i)] = true;
+		}
+	}
 
 	// now construct the result based ont he join result
 	switch (join_type) {
 	case JoinType::MARK:
-		PhysicalJoin::ConstructMarkJoinResult(state.join_keys, input, chunk, right_info.found_match, gstate.has_null);
+		PhysicalJoin::ConstructMarkJoinResult(state.join_keys, input, chunk, found_match, gstate.HasNull());
 		break;
 	case JoinType::SEMI:
-		PhysicalJoin::ConstructSemiJoinResult(input, chunk, right_info.found_match);
+		PhysicalJoin::ConstructSemiJoinResult(input, chunk, found_match);
 		break;
 	case JoinType::ANTI:
-		PhysicalJoin::ConstructAntiJoinResult(input, chunk, right_info.found_match);
+		PhysicalJoin::ConstructAntiJoinResult(input, chunk, found_match);
 		break;
 	default:
 		throw NotImplementedException("Unimplemented join type for merge join");
@@ -226,6 +574,7 @@ OperatorResultType PhysicalPiecewiseMergeJoin::ResolveComplexJoin(ExecutionConte
                                                                   DataChunk &chunk, OperatorState &state_p) const {
 	auto &state = (PiecewiseMergeJoinState &)state_p;
 	auto &gstate = (MergeJoinGlobalState &)*sink_state;
+	auto comparison = conditions[0].comparison;
 	do {
 		if (state.first_fetch) {
 			state.ResolveJoinKeys(input);
@@ -234,7 +583,14 @@ OperatorResultType PhysicalPiecewiseMergeJoin::ResolveComplexJoin(ExecutionConte
 			state.left_position = 0;
 			state.right_position = 0;
 			state.first_fetch = false;
-			state.finished = false;
+			state.finished = state.left_orders.count == 0;
+		}
+		// skip the chunks of the sorted RHS that cannot match
+		while (!state.finished && !RightChunkCanMatch(comparison, gstate, state.right_chunk_index, state)) {
+			state.right_chunk_index++;
+			if (state.right_chunk_index >= gstate.chunk_min.size()) {
+				state.finished = true;
+			}
 		}
 		if (state.finished) {
 			if (IsLeftOuterJoin(join_type)) {
@@ -248,21 +604,20 @@ OperatorResultType PhysicalPiecewiseMergeJoin::ResolveComplexJoin(ExecutionConte
 			return OperatorResultType::NEED_MORE_INPUT;
 		}
 
-		auto &right_chunk = gstate.right_chunks.GetChunk(state.right_chunk_index);
-		auto &right_condition_chunk = gstate.right_conditions.GetChunk(state.right_chunk_index);
-		auto &right_orders = gstate.right_orders[state.right_chunk_index];
+		state.LoadRightChunk(gstate, state.right_chunk_index);
+		auto &right_chunk = state.right_chunk;
 
 		ScalarMergeInfo left_info(state.left_orders, state.join_keys.data[0].GetType(), state.left_position);
-		ScalarMergeInfo right_info(right_orders, right_condition_chunk.data[0].GetType(), state.right_position);
+		ScalarMergeInfo right_info(state.right_orders, right_chunk.data[0].GetType(), state.right_position);
 
-		idx_t result_count = MergeJoinComplex::Perform(left_info, right_info, conditions[0].comparison);
+		idx_t result_count = MergeJoinComplex::Perform(left_info, right_info, comparison);
 		if (result_count == 0) {
 			// exhausted this chunk on the right side
 			// move to the next right chunk
 			state.left_position = 0;
 			state.right_position = 0;
 			state.right_chunk_index++;
-			if (state.right_chunk_index >= gstate.right_chunks.ChunkCount()) {
+			if (state.right_chunk_index >= gstate.chunk_min.size()) {
 				state.finished = true;
 			}
 		} else {
@@ -279,8 +634,12 @@ OperatorResultType PhysicalPiecewiseMergeJoin::ResolveComplexJoin(ExecutionConte
 				}
 			}
 			// found matches: output them
+			state.LoadRightPayload(gstate);
 			chunk.Slice(input, left_info.result, result_count);
-			chunk.Slice(right_chunk, right_info.result, result_count, input.ColumnCount());
+			for (idx_t col_idx = 1; col_idx < right_chunk.ColumnCount(); col_idx++) {
+				chunk.data[input.ColumnCount() + col_idx - 1].Slice(right_chunk.data[col_idx], right_info.result,
+				                                                     result_count);
+			}
 		}
 	} while (chunk.size() == 0);
 	return OperatorResultType::HAVE_MORE_OUTPUT;
@@ -290,10 +649,10 @@ OperatorResultType PhysicalPiecewiseMergeJoin::Execute(ExecutionContext &context
                                                        OperatorState &state) const {
 	auto &gstate = (MergeJoinGlobalState &)*sink_state;
 
-	if (gstate.right_chunks.Count() == 0) {
+	if (gstate.right_count == 0) {
 		// empty RHS
 		if (!EmptyResultIfRHSIsEmpty()) {
-			ConstructEmptyJoinResult(join_type, gstate.has_null, input, chunk);
+			ConstructEmptyJoinResult(join_type, gstate.HasNull(), input, chunk);
 			return OperatorResultType::NEED_MORE_INPUT;
 		} else {
 			return OperatorResultType::FINISHED;
@@ -480,6 +839,7 @@ void OrderVector(Vector &vector, idx_t count, MergeOrder &order) {
 	}
 }
 
+
 //===--------------------------------------------------------------------===//
 // Source
 //===--------------------------------------------------------------------===//
@@ -490,12 +850,15 @@ public:
 
 	mutex lock;
 	const PhysicalPiecewiseMergeJoin &op;
+	//! The reader of the sorted RHS
+	SortedRHSReader right_reader;
+	//! The position in the sorted RHS in the final scan of the FULL OUTER JOIN
 	idx_t right_outer_position;
 
 public:
 	idx_t MaxThreads() override {
 		auto &sink = (MergeJoinGlobalState &)*op.sink_state;
-		return sink.right_chunks.Count() / (STANDARD_VECTOR_SIZE * 10);
+		return sink.right_count / (STANDARD_VECTOR_SIZE * 10);
 	}
 };
 
@@ -513,7 +876,40 @@ void PhysicalPiecewiseMergeJoin::GetData(ExecutionContext &context, DataChunk &c
 	// if the LHS is exhausted in a FULL/RIGHT OUTER JOIN, we scan the found_match for any chunks we
 	// still need to output
 	lock_guard<mutex> l(state.lock);
-	ConstructFullOuterJoinResult(sink.right_found_match.get(), sink.right_chunks, chunk, state.right_outer_position);
+	auto &layout = sink.global_sort_state.payload_layout;
+	const idx_t left_column_count = children[0]->types.size();
+	SelectionVector rsel(STANDARD_VECTOR_SIZE);
+	while (state.right_outer_position < sink.right_count) {
+		// read the next chunk of the sorted RHS and find the tuples that did not find a match
+		auto chunk_start = state.right_outer_position;
+		auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, sink.right_count - chunk_start);
+		state.right_outer_position += count;
+
+		idx_t result_count = 0;
+		for (idx_t i = 0; i < count; i++) {
+			if (!sink.right_found_match[chunk_start + i]) {
+				rsel.set_index(result_count++, i);
+			}
+		}
+		if (result_count == 0) {
+			continue;
+		}
+		// set the left side as a constant NULL
+		for (idx_t col_idx = 0; col_idx < left_column_count; col_idx++) {
+			Vector &vec = chunk.data[col_idx];
+			vec.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(vec, true);
+		}
+		// gather the unmatched tuples of the right side
+		state.right_reader.Read(sink, chunk_start, count);
+		for (idx_t col_idx = left_column_count; col_idx < chunk.ColumnCount(); col_idx++) {
+			Vector gathered(chunk.data[col_idx].GetType());
+			state.right_reader.Gather(layout, col_idx - left_column_count + 1, gathered);
+			chunk.data[col_idx].Slice(gathered, rsel, result_count);
+		}
+		chunk.SetCardinality(result_count);
+		return;
+	}
 }
 
 } // namespace duckdb
@@ -20,6 +20,10 @@
 #include <cstring>
 #include <fstream>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace duckdb {
 
 void BufferedCSVReaderOptions::SetDelimiter(const string &input) {
@@ -40,11 +44,22 @@ std::string BufferedCSVReaderOptions::ToString() const {
 	       ", ALL_VARCHAR=" + std::to_string(all_varchar);
 }
 
-static string GetLineNumberStr(idx_t linenr, bool linenr_estimated) {
+string BufferedCSVReader::GetLineNumberStr() {
+	if (range_linenr_unknown) {
+		// the rows before the byte range have not been read, so the line number is unknown
+		return StringUtil::Format("unknown (at byte offset %llu)", buffer_offset + position);
+	}
 	string estimated = (linenr_estimated ? string(" (estimated)") : string(""));
 	return to_string(linenr + 1) + estimated;
 }
 
+string BufferedCSVReader::GetLineRangeStr(idx_t first_line, idx_t last_line) {
+	if (range_linenr_unknown) {
+		return StringUtil::Format("between byte offset %llu and %llu", range_begin, buffer_offset + position);
+	}
+	return StringUtil::Format("between line %llu and %llu", first_line, last_line);
+}
+
 static bool StartsWithNumericDate(string &separator, const string_t &value) {
 	auto begin = value.GetDataUnsafe();
 	auto end = begin + value.GetSize();
@@ -299,6 +314,7 @@ void BufferedCSVReader::ResetStream() {
 }
 
 void BufferedCSVReader::InitParseChunk(idx_t num_cols) {
+	ascii_rows = 0;
 	// adapt not null info
 	if (options.force_not_null.size() != num_cols) {
 		options.force_not_null.resize(num_cols, false);
@@ -1104,7 +1120,7 @@ in_quotes:
 	} while (ReadBuffer(start));
 	// still in quoted state at the end of the file, error:
 	error_message = StringUtil::Format("Error in file \"%s\" on line %s: unterminated quotes. (%s)", options.file_path,
-	                                   GetLineNumberStr(linenr, linenr_estimated).c_str(), options.ToString());
+	                                   GetLineNumberStr().c_str(), options.ToString());
 	return false;
 unquote:
 	/* state: unquote */
@@ -1134,7 +1150,7 @@ unquote:
 				error_message = StringUtil::Format(
 				    "Error in file \"%s\" on line %s: quote should be followed by end of value, end "
 				    "of row or another quote. (%s)",
-				    options.file_path, GetLineNumberStr(linenr, linenr_estimated).c_str(), options.ToString());
+				    options.file_path, GetLineNumberStr().c_str(), options.ToString());
 				return false;
 			}
 			if (delimiter_pos == options.delimiter.size()) {
@@ -1151,7 +1167,7 @@ unquote:
 	} while (ReadBuffer(start));
 	error_message = StringUtil::Format(
 	    "Error in file \"%s\" on line %s: quote should be followed by end of value, end of row or another quote. (%s)",
-	    options.file_path, GetLineNumberStr(linenr, linenr_estimated).c_str(), options.ToString());
+	    options.file_path, GetLineNumberStr().c_str(), options.ToString());
 	return false;
 handle_escape:
 	escape_pos = 0;
@@ -1166,7 +1182,7 @@ handle_escape:
 			if (count > escape_pos && count > quote_pos) {
 				error_message = StringUtil::Format(
 				    "Error in file \"%s\" on line %s: neither QUOTE nor ESCAPE is proceeded by ESCAPE. (%s)",
-				    options.file_path, GetLineNumberStr(linenr, linenr_estimated).c_str(), options.ToString());
+				    options.file_path, GetLineNumberStr().c_str(), options.ToString());
 				return false;
 			}
 			if (quote_pos == options.quote.size() || escape_pos == options.escape.size()) {
@@ -1177,7 +1193,7 @@ handle_escape:
 	} while (ReadBuffer(start));
 	error_message =
 	    StringUtil::Format("Error in file \"%s\" on line %s: neither QUOTE nor ESCAPE is proceeded by ESCAPE. (%s)",
-	                       options.file_path, GetLineNumberStr(linenr, linenr_estimated).c_str(), options.ToString());
+	                       options.file_path, GetLineNumberStr().c_str(), options.ToString());
 	return false;
 carriage_return:
 	/* state: carriage_return */
@@ -1213,20 +1229,281 @@ final_state:
 	return true;
 }
 
+static constexpr uint64_t CSV_WORD_LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+
+//! Broadcasts a character to every byte of a 64-bit word
+static inline uint64_t BroadcastCharacter(char c) {
+	return 0x0101010101010101ULL * uint8_t(c);
+}
+
+//! Returns a non-zero value if any byte of the word equals the character broadcast in the pattern
+static inline uint64_t WordContainsCharacter(uint64_t word, uint64_t pattern) {
+	auto x = word ^ pattern;
+	// the high bit of a byte is set only if the byte of x is zero, without carries between the bytes
+	return ~(((x & CSV_WORD_LOW_BITS) + CSV_WORD_LOW_BITS) | x | CSV_WORD_LOW_BITS);
+}
+
+//! Skips ahead eight bytes at a time until the word at the position contains one of the three characters
+static inline idx_t SkipToCharacters(const char *buffer, idx_t position, idx_t buffer_size, uint64_t a, uint64_t b,
+                                     uint64_t c) {
+	for (; position + sizeof(uint64_t) <= buffer_size; position += sizeof(uint64_t)) {
+		auto word = Load<uint64_t>((const_data_ptr_t)buffer + position);
+		if (WordContainsCharacter(word, a) | WordContainsCharacter(word, b) | WordContainsCharacter(word, c)) {
+			break;
+		}
+	}
+	return position;
+}
+
+//! The tokenizer finds the delimiters, quotes and newlines of 64 bytes of the buffer at a time
+static constexpr idx_t CSV_TOKENIZER_BLOCK_SIZE = 64;
+//! The amount of rows that are read by the per-character states after a row that the tokenizer cannot read
+static constexpr idx_t CSV_TOKENIZER_SKIP_ROWS = 16;
+
+#ifndef __SSE2__
+//! Returns a mask in which bit i is set if byte i of the word has its high bit set (i.e. it matched a character)
+static inline uint64_t GatherMatchedBytes(uint64_t matches) {
+	// the high bits of the bytes are at bit 8i + 7: the multiplication gathers them in bits [49, 56]
+	return (((matches >> 7) * 0x0002040810204081ULL) >> 49) & 0xFF;
+}
+#endif
+
+//! The special characters in a block of the buffer: bit i of a mask is set if byte i of the block is such a character
+struct CSVBlockMasks {
+	//! The delimiters and newlines
+	uint64_t structural = 0;
+	uint64_t quote = 0;
+	uint64_t escape = 0;
+	//! The bytes that are not ASCII
+	uint64_t non_ascii = 0;
+};
+
+static inline void FindSpecialCharacters(const char *block, char delimiter, char quote, char escape,
+                                         CSVBlockMasks &masks) {
+#ifdef __SSE2__
+	auto delimiter_vector = _mm_set1_epi8(delimiter);
+	auto newline_vector = _mm_set1_epi8('\n');
+	auto carriage_return_vector = _mm_set1_epi8('\r');
+	auto quote_vector = _mm_set1_epi8(quote);
+	auto escape_vector = _mm_set1_epi8(escape);
+	for (idx_t i = 0; i < CSV_TOKENIZER_BLOCK_SIZE; i += sizeof(__m128i)) {
+		auto bytes = _mm_loadu_si128((const __m128i *)(block + i));
+		auto structural = _mm_or_si128(_mm_cmpeq_epi8(bytes, delimiter_vector),
+		                               _mm_or_si128(_mm_cmpeq_epi8(bytes, newline_vector),
+		                                            _mm_cmpeq_epi8(bytes, carriage_return_vector)));
+		masks.structural |= uint64_t(uint16_t(_mm_movemask_epi8(structural))) << i;
+		masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote_vector)))) << i;
+		masks.escape |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, escape_vector)))) << i;
+		masks.non_ascii |= uint64_t(uint16_t(_mm_movemask_epi8(bytes))) << i;
+	}
+#else
+	auto delimiter_word = BroadcastCharacter(delimiter);
+	auto newline_word = BroadcastCharacter('\n');
+	auto carriage_return_word = BroadcastCharacter('\r');
+	auto quote_word = BroadcastCharacter(quote);
+	auto escape_word = BroadcastCharacter(escape);
+	for (idx_t i = 0; i < CSV_TOKENIZER_BLOCK_SIZE; i += sizeof(uint64_t)) {
+		auto word = Load<uint64_t>((const_data_ptr_t)block + i);
+		auto structural = WordContainsCharacter(word, delimiter_word) | WordContainsCharacter(word, newline_word) |
+		                  WordContainsCharacter(word, carriage_return_word);
+		masks.structural |= GatherMatchedBytes(structural) << i;
+		masks.quote |= GatherMatchedBytes(WordContainsCharacter(word, quote_word)) << i;
+		masks.escape |= GatherMatchedBytes(WordContainsCharacter(word, escape_word)) << i;
+		masks.non_ascii |= GatherMatchedBytes(word & ~CSV_WORD_LOW_BITS) << i;
+	}
+#endif
+}
+
+//! Returns a mask in which every bit is the XOR of the bit and all lower bits: given the quotes, the bits from an
+//! opening quote up to (but not including) the matching closing quote are set
+static inline uint64_t PrefixXor(uint64_t mask) {
+	mask ^= mask << 1;
+	mask ^= mask << 2;
+	mask ^= mask << 4;
+	mask ^= mask << 8;
+	mask ^= mask << 16;
+	mask ^= mask << 32;
+	return mask;
+}
+
+static inline idx_t FirstSetBit(uint64_t mask) {
+	D_ASSERT(mask != 0);
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(mask);
+#else
+	idx_t position = 0;
+	while ((mask & 1) == 0) {
+		mask >>= 1;
+		position++;
+	}
+	return position;
+#endif
+}
+
+CSVTokenizerResult BufferedCSVReader::TokenizeRows(DataChunk &insert_chunk, idx_t &column) {
+	D_ASSERT(mode == ParserMode::PARSING && column == 0);
+	const char delimiter = options.delimiter[0];
+	const char quote = options.quote[0];
+	const char escape = options.escape[0];
+	// an escape that differs from the quote is left to the per-character states
+	const bool quote_escapes_quote = options.escape.empty() || escape == quote;
+
+	// the values are added to the chunk as soon as they end: when the tokenizer stops, the per-character states
+	// continue with the value at the position
+	start = position;
+	bool value_quoted = false;
+	// the last quote of a quoted value, which is either its closing quote or the first quote of an escaped quote
+	idx_t closing_quote = DConstants::INVALID_INDEX;
+	// all bits set if the end of the previous block is inside a quoted value
+	uint64_t in_quotes = 0;
+	// whether or not the blocks that the current row was read from are ASCII
+	bool row_ascii = true;
+	for (idx_t block = position; block + CSV_TOKENIZER_BLOCK_SIZE <= buffer_size; block += CSV_TOKENIZER_BLOCK_SIZE) {
+		CSVBlockMasks masks;
+		FindSpecialCharacters(buffer.get() + block, delimiter, quote, escape, masks);
+		if (!quote_escapes_quote && masks.escape != 0) {
+			value_escapes.clear();
+			return CSVTokenizerResult::UNSUPPORTED_VALUE;
+		}
+		bool block_ascii = masks.non_ascii == 0;
+		row_ascii = row_ascii && block_ascii;
+		// delimiters and newlines inside quoted values do not end the value
+		auto quoted_mask = PrefixXor(masks.quote) ^ in_quotes;
+		in_quotes = 0 - (quoted_mask >> 63);
+		auto special_mask = masks.quote | (masks.structural & ~quoted_mask);
+		for (; special_mask != 0; special_mask &= special_mask - 1) {
+			idx_t special_position = block + FirstSetBit(special_mask);
+			if (special_position < start) {
+				// the \n of a \r\n that has already been handled
+				continue;
+			}
+			char c = buffer[special_position];
+			if (c == quote) {
+				if (special_position == start) {
+					value_quoted = true;
+				} else if (!value_quoted) {
+					// a quote inside an unquoted value
+					value_escapes.clear();
+					return CSVTokenizerResult::UNSUPPORTED_VALUE;
+				} else if (closing_quote == DConstants::INVALID_INDEX) {
+					closing_quote = special_position;
+				} else if (closing_quote + 1 == special_position && quote_escapes_quote) {
+					// an escaped quote: the second quote is removed from the value
+					value_escapes.push_back(special_position - start - 1);
+					closing_quote = DConstants::INVALID_INDEX;
+				} else {
+					// characters after the closing quote
+					value_escapes.clear();
+					return CSVTokenizerResult::UNSUPPORTED_VALUE;
+				}
+				continue;
+			}
+			// a delimiter or newline ends the value
+			if (value_quoted && closing_quote + 1 != special_position) {
+				// characters after the closing quote
+				value_escapes.clear();
+				return CSVTokenizerResult::UNSUPPORTED_VALUE;
+			}
+			idx_t next_start = special_position + 1;
+			if (c == '\r') {
+				// \r\n is a single newline
+				if (next_start >= buffer_size) {
+					value_escapes.clear();
+					return CSVTokenizerResult::NEEDS_DATA;
+				}
+				if (buffer[next_start] == '\n') {
+					next_start++;
+				}
+			}
+			if (value_quoted) {
+				AddValue(buffer.get() + start + 1, closing_quote - start - 1, column, value_escapes);
+			} else {
+				AddValue(buffer.get() + start, special_position - start, column, value_escapes);
+			}
+			value_escapes.clear();
+			value_quoted = false;
+			closing_quote = DConstants::INVALID_INDEX;
+			start = position = next_start;
+			if (c == delimiter) {
+				continue;
+			}
+			// the row is complete
+			idx_t previous_size = parse_chunk.size();
+			if (row_ascii) {
+				// the values of the row do not have to be checked for valid UTF8 when the chunk is flushed
+				ascii_rows++;
+			}
+			bool finished_chunk = AddRow(insert_chunk, column);
+			if (row_ascii && !finished_chunk && parse_chunk.size() == previous_size) {
+				// the row was empty and skipped
+				ascii_rows--;
+			}
+			column = 0;
+			row_ascii = block_ascii;
+			if (buffer_offset + position >= range_end) {
+				// the next row starts after the byte range of this reader
+				Flush(insert_chunk);
+				end_of_file_reached = true;
+				return CSVTokenizerResult::FINISHED_CHUNK;
+			}
+			if (finished_chunk) {
+				return CSVTokenizerResult::FINISHED_CHUNK;
+			}
+		}
+	}
+	// the current value continues after the last complete block
+	value_escapes.clear();
+	return CSVTokenizerResult::NEEDS_DATA;
+}
+
 bool BufferedCSVReader::TryParseSimpleCSV(DataChunk &insert_chunk, string &error_message) {
 	// used for parsing algorithm
 	bool finished_chunk = false;
 	idx_t column = 0;
 	idx_t offset = 0;
 	vector<idx_t> escape_positions;
-
+	// the amount of rows that are read by the per-character states before the tokenizer is used again
+	idx_t skipped_rows = 0;
+	// the characters that end a value, broadcast to every byte of a word
+	auto delimiter_word = BroadcastCharacter(options.delimiter[0]);
+	auto newline_word = BroadcastCharacter('\n');
+	auto carriage_return_word = BroadcastCharacter('\r');
+	auto quote_word = BroadcastCharacter(options.quote[0]);
+	auto escape_word = BroadcastCharacter(options.escape[0]);
+
+	if (buffer_offset + position >= range_end) {
+		// all rows of the byte range of this reader have been read
+		end_of_file_reached = true;
+		return true;
+	}
 	// read values into the buffer (if any)
 	if (position >= buffer_size) {
 		if (!ReadBuffer(start)) {
 			return true;
 		}
 	}
-	// start parsing the first value
+	// start parsing the first row
+	goto row_start;
+row_start:
+	/* state: row_start */
+	// this state reads as many rows as possible with the tokenizer, which leaves the rows it cannot read to the
+	// per-character states below
+	if (mode == ParserMode::PARSING) {
+		if (skipped_rows > 0) {
+			skipped_rows--;
+		} else {
+			auto result = TokenizeRows(insert_chunk, column);
+			if (result == CSVTokenizerResult::FINISHED_CHUNK) {
+				return true;
+			}
+			if (result == CSVTokenizerResult::UNSUPPORTED_VALUE) {
+				skipped_rows = CSV_TOKENIZER_SKIP_ROWS;
+			}
+			if (position >= buffer_size && !ReadBuffer(start)) {
+				goto final_state;
+			}
+		}
+	}
 	goto value_start;
 value_start:
 	offset = 0;
@@ -1246,6 +1523,8 @@ normal:
 	/* state: normal parsing state */
 	// this state parses the remainder of a non-quoted value until we reach a delimiter or newline
 	do {
+		position = SkipToCharacters(buffer.get(), position, buffer_size, delimiter_word, newline_word,
+		                            carriage_return_word);
 		for (; position < buffer_size; position++) {
 			if (buffer[position] == options.delimiter[0]) {
 				// delimiter: end the value and add it to the chunk
@@ -1285,10 +1564,13 @@ add_row : {
 		goto carriage_return;
 	} else {
 		// \n newline, move to value start
+		if (buffer_offset + position >= range_end) {
+			goto end_of_range;
+		}
 		if (finished_chunk) {
 			return true;
 		}
-		goto value_start;
+		goto row_start;
 	}
 }
 in_quotes:
@@ -1296,6 +1578,8 @@ in_quotes:
 	// this state parses the remainder of a quoted value
 	position++;
 	do {
+		// the quote and escape are usually the same character, in which case the word is checked for it twice
+		position = SkipToCharacters(buffer.get(), position, buffer_size, quote_word, escape_word, quote_word);
 		for (; position < buffer_size; position++) {
 			if (buffer[position] == options.quote[0]) {
 				// quote: move to unquoted state
@@ -1309,7 +1593,7 @@ in_quotes:
 	} while (ReadBuffer(start));
 	// still in quoted state at the end of the file, error:
 	throw InvalidInputException("Error in file \"%s\" on line %s: unterminated quotes. (%s)", options.file_path,
-	                            GetLineNumberStr(linenr, linenr_estimated).c_str(), options.ToString());
+	                            GetLineNumberStr().c_str(), options.ToString());
 unquote:
 	/* state: unquote */
 	// this state handles the state directly after we unquote
@@ -1336,7 +1620,7 @@ unquote:
 		error_message = StringUtil::Format(
 		    "Error in file \"%s\" on line %s: quote should be followed by end of value, end of "
 		    "row or another quote. (%s)",
-		    options.file_path, GetLineNumberStr(linenr, linenr_estimated).c_str(), options.ToString());
+		    options.file_path, GetLineNumberStr().c_str(), options.ToString());
 		return false;
 	}
 handle_escape:
@@ -1346,13 +1630,13 @@ handle_escape:
 	if (position >= buffer_size && !ReadBuffer(start)) {
 		error_message = StringUtil::Format(
 		    "Error in file \"%s\" on line %s: neither QUOTE nor ESCAPE is proceeded by ESCAPE. (%s)", options.file_path,
-		    GetLineNumberStr(linenr, linenr_estimated).c_str(), options.ToString());
+		    GetLineNumberStr().c_str(), options.ToString());
 		return false;
 	}
 	if (buffer[position] != options.quote[0] && buffer[position] != options.escape[0]) {
 		error_message = StringUtil::Format(
 		    "Error in file \"%s\" on line %s: neither QUOTE nor ESCAPE is proceeded by ESCAPE. (%s)", options.file_path,
-		    GetLineNumberStr(linenr, linenr_estimated).c_str(), options.ToString());
+		    GetLineNumberStr().c_str(), options.ToString());
 		return false;
 	}
 	// escape was followed by quote or escape, go back to quoted state
@@ -1369,10 +1653,20 @@ carriage_return:
 			goto final_state;
 		}
 	}
+	if (buffer_offset + position >= range_end) {
+		goto end_of_range;
+	}
 	if (finished_chunk) {
 		return true;
 	}
-	goto value_start;
+	goto row_start;
+end_of_range:
+	// the next row starts after the byte range of this reader: it is read by the reader of the next byte range
+	if (mode == ParserMode::PARSING) {
+		Flush(insert_chunk);
+	}
+	end_of_file_reached = true;
+	return true;
 final_state:
 	if (finished_chunk) {
 		return true;
@@ -1412,6 +1706,9 @@ bool BufferedCSVReader::ReadBuffer(idx_t &start) {
 		// remaining from last buffer: copy it here
 		memcpy(buffer.get(), old_buffer.get() + start, remaining);
 	}
+	if (plain_file_source) {
+		buffer_offset = file_handle->SeekPosition() - remaining;
+	}
 	idx_t read_count = file_handle->Read(buffer.get() + remaining, buffer_read_size);
 
 	bytes_in_chunk += read_count;
@@ -1432,6 +1729,170 @@ bool BufferedCSVReader::ReadBuffer(idx_t &start) {
 	return read_count > 0;
 }
 
+bool BufferedCSVReader::CanReadByteRanges() const {
+	return plain_file_source && options.quote.size() <= 1 && options.escape.size() <= 1 &&
+	       options.delimiter.size() == 1;
+}
+
+idx_t BufferedCSVReader::GetFileOffset() {
+	if (!buffer) {
+		return file_handle->SeekPosition();
+	}
+	return buffer_offset + position;
+}
+
+//! The states of the simple CSV parser, see TryParseSimpleCSV. ROW_START is the value_start state at the beginning
+//! of a row.
+enum class CSVParserState : uint8_t {
+	ROW_START = 0,
+	VALUE_START = 1,
+	NORMAL = 2,
+	IN_QUOTES = 3,
+	UNQUOTE = 4,
+	HANDLE_ESCAPE = 5,
+	CARRIAGE_RETURN = 6,
+	INVALID = 7
+};
+
+//! Returns the state of the simple CSV parser after it consumes the byte c in the given state
+static CSVParserState NextParserState(CSVParserState state, char c, char delimiter, char quote, char escape,
+                                      bool quote_escapes_quote) {
+	switch (state) {
+	case CSVParserState::IN_QUOTES:
+		if (c == quote) {
+			return CSVParserState::UNQUOTE;
+		}
+		return c == escape ? CSVParserState::HANDLE_ESCAPE : CSVParserState::IN_QUOTES;
+	case CSVParserState::UNQUOTE:
+		if (c == quote && quote_escapes_quote) {
+			return CSVParserState::IN_QUOTES;
+		} else if (c == delimiter) {
+			return CSVParserState::VALUE_START;
+		} else if (c == '\n') {
+			return CSVParserState::ROW_START;
+		} else if (c == '\r') {
+			return CSVParserState::CARRIAGE_RETURN;
+		}
+		return CSVParserState::INVALID;
+	case CSVParserState::HANDLE_ESCAPE:
+		return c == quote || c == escape ? CSVParserState::IN_QUOTES : CSVParserState::INVALID;
+	case CSVParserState::CARRIAGE_RETURN:
+		if (c == '\n') {
+			return CSVParserState::ROW_START;
+		}
+		// a new row starts at c
+		return NextParserState(CSVParserState::VALUE_START, c, delimiter, quote, escape, quote_escapes_quote);
+	case CSVParserState::ROW_START:
+	case CSVParserState::VALUE_START:
+	case CSVParserState::NORMAL:
+		if (state != CSVParserState::NORMAL && c == quote) {
+			return CSVParserState::IN_QUOTES;
+		} else if (c == delimiter) {
+			return CSVParserState::VALUE_START;
+		} else if (c == '\n') {
+			return CSVParserState::ROW_START;
+		} else if (c == '\r') {
+			return CSVParserState::CARRIAGE_RETURN;
+		}
+		return CSVParserState::NORMAL;
+	default:
+		return CSVParserState::INVALID;
+	}
+}
+
+//! The parser states (as a bitmask) in which the parser is in between two values
+static constexpr uint8_t CSV_VALUE_BOUNDARY_STATES = (1 << (uint8_t)CSVParserState::ROW_START) |
+                                                     (1 << (uint8_t)CSVParserState::VALUE_START) |
+                                                     (1 << (uint8_t)CSVParserState::CARRIAGE_RETURN);
+
+idx_t BufferedCSVReader::FindRowStart(idx_t offset) {
+	D_ASSERT(CanReadByteRanges());
+	// the characters are read exactly as TryParseSimpleCSV reads them (an empty quote or escape is '\0')
+	const char delimiter = options.delimiter[0];
+	const char quote = options.quote[0];
+	const char escape = options.escape[0];
+	const bool quote_escapes_quote = options.escape.empty() || options.escape[0] == options.quote[0];
+
+	// we do not know in which state the parser is at the offset (e.g. we might be inside a quoted value that contains
+	// newlines), so we follow the parser from every state at once. Most of these candidate states quickly end up in
+	// the same state: from that point on the state of the parser is known regardless of what precedes the offset, and
+	// the first row that starts afterwards is a row boundary of the file.
+	// The candidates are kept as a bitmask of states, for which we precompute the transitions of every byte.
+	const idx_t state_count = (idx_t)CSVParserState::INVALID;
+	const idx_t set_count = (idx_t)1 << state_count;
+	auto transitions = unique_ptr<uint8_t[]>(new uint8_t[set_count * 256]);
+	memset(transitions.get(), 0, 256);
+	for (idx_t set = 1; set < set_count; set++) {
+		// the transitions of a set are those of the set without its lowest state, combined with that state
+		idx_t rest = set & (set - 1);
+		idx_t state = 0;
+		while (!(set & ((idx_t)1 << state))) {
+			state++;
+		}
+		for (idx_t c = 0; c < 256; c++) {
+			auto next = NextParserState((CSVParserState)state, (char)c, delimiter, quote, escape, quote_escapes_quote);
+			uint8_t next_set = next == CSVParserState::INVALID ? 0 : 1 << (uint8_t)next;
+			transitions[set * 256 + c] = transitions[rest * 256 + c] | next_set;
+		}
+	}
+
+	// a candidate that is still inside the value it started in after MAXIMUM_CSV_LINE_SIZE bytes is discarded, as the
+	// parser does not accept values of that size (e.g. the quoted state in a file that contains no quotes at all)
+	uint8_t first_value = (set_count - 1) & ~CSV_VALUE_BOUNDARY_STATES;
+	uint8_t other = CSV_VALUE_BOUNDARY_STATES;
+	const idx_t first_value_end = offset + MAXIMUM_CSV_LINE_SIZE;
+	auto read_buffer = unique_ptr<uint8_t[]>(new uint8_t[INITIAL_BUFFER_SIZE]);
+
+	// in particular, we cannot be inside a quoted value if no quote or escape follows within that many bytes: check
+	// this upfront, so we do not have to follow the quoted states through the entire window
+	bool quote_follows = false;
+	idx_t window_end = MinValue<idx_t>(first_value_end, file_size);
+	for (idx_t window_offset = offset; window_offset < window_end && !quote_follows;) {
+		idx_t read_count = MinValue<idx_t>(INITIAL_BUFFER_SIZE, window_end - window_offset);
+		file_handle->Read(read_buffer.get(), read_count, window_offset);
+		quote_follows = memchr(read_buffer.get(), quote, read_count) || memchr(read_buffer.get(), escape, read_count);
+		window_offset += read_count;
+	}
+	if (!quote_follows) {
+		first_value &= ~((1 << (uint8_t)CSVParserState::IN_QUOTES) | (1 << (uint8_t)CSVParserState::HANDLE_ESCAPE));
+	}
+	while (offset < file_size) {
+		idx_t read_count = MinValue<idx_t>(INITIAL_BUFFER_SIZE, file_size - offset);
+		file_handle->Read(read_buffer.get(), read_count, offset);
+		for (idx_t i = 0; i < read_count; i++) {
+			uint8_t c = read_buffer[i];
+			uint8_t candidates = first_value | other;
+			if (candidates == 1 << (uint8_t)CSVParserState::ROW_START ||
+			    (candidates == 1 << (uint8_t)CSVParserState::CARRIAGE_RETURN && c != '\n')) {
+				// the state of the parser is known, and a row starts here
+				return offset + i;
+			}
+			uint8_t first_value_next = transitions[first_value * 256 + c];
+			other = transitions[other * 256 + c] | (first_value_next & CSV_VALUE_BOUNDARY_STATES);
+			first_value = offset + i < first_value_end ? first_value_next & ~CSV_VALUE_BOUNDARY_STATES & ~other : 0;
+			if ((first_value | other) == 0) {
+				// the file is malformed here: the reader of the preceding range reports the error
+				return offset + i;
+			}
+		}
+		offset += read_count;
+	}
+	return file_size;
+}
+
+void BufferedCSVReader::SetByteRange(idx_t begin, idx_t end) {
+	if (begin != GetFileOffset()) {
+		// continue reading at the row that starts at the beginning of the range
+		ResetBuffer();
+		file_handle->Seek(begin);
+		buffer_offset = begin;
+		bom_checked = true;
+		range_begin = begin;
+		range_linenr_unknown = true;
+	}
+	range_end = end;
+}
+
 void BufferedCSVReader::ParseCSV(DataChunk &insert_chunk) {
 	// if no auto-detect or auto-detect with jumping samples, we have nothing cached and start from the beginning
 	if (cached_chunks.empty()) {
@@ -1439,6 +1900,7 @@ void BufferedCSVReader::ParseCSV(DataChunk &insert_chunk) {
 	} else {
 		auto &chunk = cached_chunks.front();
 		parse_chunk.Move(*chunk);
+		ascii_rows = 0;
 		cached_chunks.pop();
 		Flush(insert_chunk);
 		return;
@@ -1491,7 +1953,7 @@ void BufferedCSVReader::AddValue(char *str_val, idx_t length, idx_t &column, vec
 	}
 	if (column >= sql_types.size()) {
 		throw InvalidInputException("Error on line %s: expected %lld values per row, but got more. (%s)",
-		                            GetLineNumberStr(linenr, linenr_estimated).c_str(), sql_types.size(),
+		                            GetLineNumberStr().c_str(), sql_types.size(),
 		                            options.ToString());
 	}
 
@@ -1539,6 +2001,10 @@ bool BufferedCSVReader::AddRow(DataChunk &insert_chunk, idx_t &column) {
 	if (row_empty) {
 		row_empty = false;
 		if (sql_types.size() != 1) {
+			if (mode != ParserMode::SNIFFING_DIALECT) {
+				// the empty value of the skipped row was added as NULL: the next row is written to the same entry
+				FlatVector::SetNull(parse_chunk.data[0], parse_chunk.size(), false);
+			}
 			column = 0;
 			return false;
 		}
@@ -1546,7 +2012,7 @@ bool BufferedCSVReader::AddRow(DataChunk &insert_chunk, idx_t &column) {
 
 	if (column < sql_types.size() && mode != ParserMode::SNIFFING_DIALECT) {
 		throw InvalidInputException("Error on line %s: expected %lld values per row, but got %d. (%s)",
-		                            GetLineNumberStr(linenr, linenr_estimated).c_str(), sql_types.size(), column,
+		                            GetLineNumberStr().c_str(), sql_types.size(), column,
 		                            options.ToString());
 	}
 
@@ -1581,6 +2047,9 @@ void BufferedCSVReader::Flush(DataChunk &insert_chunk) {
 	if (parse_chunk.size() == 0) {
 		return;
 	}
+	// the rows that the tokenizer read from ASCII blocks do not have to be checked for valid UTF8
+	bool check_utf8 = ascii_rows != parse_chunk.size();
+	ascii_rows = 0;
 	// convert the columns in the parsed chunk to the types of the table
 	insert_chunk.SetCardinality(parse_chunk);
 	for (idx_t col_idx = 0; col_idx < sql_types.size(); col_idx++) {
@@ -1588,7 +2057,7 @@ void BufferedCSVReader::Flush(DataChunk &insert_chunk) {
 			// target type is varchar: no need to convert
 			// just test that all strings are valid utf-8 strings
 			auto parse_data = FlatVector::GetData<string_t>(parse_chunk.data[col_idx]);
-			for (idx_t i = 0; i < parse_chunk.size(); i++) {
+			for (idx_t i = 0; check_utf8 && i < parse_chunk.size(); i++) {
 				if (!FlatVector::IsNull(parse_chunk.data[col_idx], i)) {
 					auto s = parse_data[i];
 					auto utf_type = Utf8Proc::Analyze(s.GetDataUnsafe(), s.GetSize());
@@ -1597,10 +2066,10 @@ void BufferedCSVReader::Flush(DataChunk &insert_chunk) {
 						if (col_idx < col_names.size()) {
 							col_name = "\"" + col_names[col_idx] + "\"";
 						}
-						throw InvalidInputException("Error in file \"%s\" between line %llu and %llu in column \"%s\": "
-						                            "file is not valid UTF8. Parser options: %s",
-						                            options.file_path, linenr - parse_chunk.size(), linenr, col_name,
-						                            options.ToString());
+						throw InvalidInputException(
+						    "Error in file \"%s\" %s in column \"%s\": file is not valid UTF8. Parser options: %s",
+						    options.file_path, GetLineRangeStr(linenr - parse_chunk.size(), linenr), col_name,
+						    options.ToString());
 					}
 				}
 			}
@@ -1629,15 +2098,16 @@ void BufferedCSVReader::Flush(DataChunk &insert_chunk) {
 				}
 
 				if (options.auto_detect) {
-					throw InvalidInputException("%s in column %s, between line %llu and %llu. Parser "
+					throw InvalidInputException("%s in column %s, %s. Parser "
 					                            "options: %s. Consider either increasing the sample size "
 					                            "(SAMPLE_SIZE=X [X rows] or SAMPLE_SIZE=-1 [all rows]), "
 					                            "or skipping column conversion (ALL_VARCHAR=1)",
-					                            error_message, col_name, linenr - parse_chunk.size() + 1, linenr,
+					                            error_message, col_name,
+					                            GetLineRangeStr(linenr - parse_chunk.size() + 1, linenr),
 					                            options.ToString());
 				} else {
-					throw InvalidInputException("%s between line %llu and %llu in column %s. Parser options: %s ",
-					                            error_message, linenr - parse_chunk.size(), linenr, col_name,
+					throw InvalidInputException("%s %s in column %s. Parser options: %s ", error_message,
+					                            GetLineRangeStr(linenr - parse_chunk.size(), linenr), col_name,
 					                            options.ToString());
 				}
 			}
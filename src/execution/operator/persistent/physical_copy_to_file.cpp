@@ -1,25 +1,65 @@
 #include "duckdb/execution/operator/persistent/physical_copy_to_file.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/deque.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/unordered_set.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 
 #include <algorithm>
+#include <cstring>
 
 namespace duckdb {
 
+//! The number of rows that a thread buffers before they are written to the partition files, the rows of a partition
+//! that are buffered together are always written to the same file
+static constexpr idx_t PARTITION_BUFFER_SIZE = 262144;
+
+//! A file of a single partition that is written by one thread
+struct CopyToPartitionFile {
+	unique_ptr<GlobalFunctionData> global_state;
+	unique_ptr<LocalFunctionData> local_state;
+};
+
 class CopyToFunctionGlobalState : public GlobalSinkState {
 public:
 	explicit CopyToFunctionGlobalState(unique_ptr<GlobalFunctionData> global_state)
-	    : rows_copied(0), global_state(move(global_state)) {
+	    : rows_copied(0), next_file_index(0), global_state(move(global_state)) {
 	}
 
-	idx_t rows_copied;
+	atomic<idx_t> rows_copied;
+	//! The index of the next file that is created in a partition directory
+	atomic<idx_t> next_file_index;
+	//! The state of the copy function, if the copy is not partitioned
 	unique_ptr<GlobalFunctionData> global_state;
+	//! The lock for creating the partition directories
+	mutex lock;
+	//! The partition directories that have been created
+	unordered_set<string> created_directories;
 };
 
 class CopyToFunctionLocalState : public LocalSinkState {
 public:
 	explicit CopyToFunctionLocalState(unique_ptr<LocalFunctionData> local_state) : local_state(move(local_state)) {
 	}
+	//! The local state of the copy function, if the copy is not partitioned
 	unique_ptr<LocalFunctionData> local_state;
+	//! The partition files that this thread has open, by partition directory
+	unordered_map<string, CopyToPartitionFile> partition_files;
+	//! The partition directories of the open files, from the least to the most recently used file
+	deque<string> open_order;
+	//! The columns of the input that are written to the partition files
+	vector<column_t> write_columns;
+	//! The chunk that holds the rows of a single partition
+	DataChunk write_chunk;
+	//! The rows that have not been written yet, by partition directory
+	unordered_map<string, unique_ptr<ChunkCollection>> partition_buffers;
+	//! The partition directories of the buffered rows, in the order in which they were first buffered
+	vector<string> buffered_partitions;
+	//! The number of buffered rows
+	idx_t buffered_count = 0;
 };
 
 //===--------------------------------------------------------------------===//
@@ -28,7 +68,182 @@ public:
 PhysicalCopyToFile::PhysicalCopyToFile(vector<LogicalType> types, CopyFunction function_p,
                                        unique_ptr<FunctionData> bind_data, idx_t estimated_cardinality)
     : PhysicalOperator(PhysicalOperatorType::COPY_TO_FILE, move(types), estimated_cardinality),
-      function(move(function_p)), bind_data(move(bind_data)) {
+      function(move(function_p)), bind_data(move(bind_data)), max_open_files(1), parallel(false) {
+}
+
+//! Escapes the characters of a partition directory name that are not allowed in a path, in the same way as Hive
+static string EscapePartitionName(const string &name) {
+	static const char *ESCAPED_CHARACTERS = "\"#%'*/:=?\\{[]^";
+	static const char *HEX_DIGITS = "0123456789ABCDEF";
+	string result;
+	for (auto c : name) {
+		auto byte = uint8_t(c);
+		if (byte < 0x20 || byte == 0x7F || strchr(ESCAPED_CHARACTERS, c)) {
+			result += '%';
+			result += HEX_DIGITS[byte >> 4];
+			result += HEX_DIGITS[byte & 0x0F];
+		} else {
+			result += c;
+		}
+	}
+	return result;
+}
+
+static void CreatePartitionDirectories(ClientContext &context, const PhysicalCopyToFile &op,
+                                       CopyToFunctionGlobalState &g, const string &directory) {
+	lock_guard<mutex> glock(g.lock);
+	if (g.created_directories.find(directory) != g.created_directories.end()) {
+		return;
+	}
+	auto &fs = FileSystem::GetFileSystem(context);
+	// create the directory of every partition level, starting from the root directory
+	string path = op.file_path;
+	string partition;
+	for (auto &name : StringUtil::Split(directory, fs.PathSeparator())) {
+		path = fs.JoinPath(path, name);
+		partition = partition.empty() ? name : fs.JoinPath(partition, name);
+		if (g.created_directories.find(partition) != g.created_directories.end()) {
+			continue;
+		}
+		if (!fs.DirectoryExists(path)) {
+			fs.CreateDirectory(path);
+		}
+		g.created_directories.insert(partition);
+	}
+}
+
+static void ClosePartitionFile(ClientContext &context, const PhysicalCopyToFile &op, CopyToPartitionFile &file) {
+	auto &function = op.function;
+	if (function.copy_to_combine) {
+		function.copy_to_combine(context, *op.bind_data, *file.global_state, *file.local_state);
+	}
+	if (function.copy_to_finalize) {
+		function.copy_to_finalize(context, *op.bind_data, *file.global_state);
+	}
+}
+
+static CopyToPartitionFile &GetPartitionFile(ClientContext &context, const PhysicalCopyToFile &op,
+                                             CopyToFunctionGlobalState &g, CopyToFunctionLocalState &l,
+                                             const string &directory) {
+	auto entry = l.partition_files.find(directory);
+	if (entry != l.partition_files.end()) {
+		// move the file to the back, so the files that are written to often are not closed
+		auto order_entry = std::find(l.open_order.begin(), l.open_order.end(), directory);
+		D_ASSERT(order_entry != l.open_order.end());
+		l.open_order.erase(order_entry);
+		l.open_order.push_back(directory);
+		return entry->second;
+	}
+	if (l.partition_files.size() >= op.max_open_files) {
+		// too many open files: finish the least recently used file
+		// later rows of its partition are written to a new file in the same directory
+		auto oldest = l.partition_files.find(l.open_order.front());
+		ClosePartitionFile(context, op, oldest->second);
+		l.partition_files.erase(oldest);
+		l.open_order.pop_front();
+	}
+	CreatePartitionDirectories(context, op, g, directory);
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto file_name = "data_" + to_string(g.next_file_index++) + "." + op.function.extension;
+	auto file_path = fs.JoinPath(fs.JoinPath(op.file_path, directory), file_name);
+
+	CopyToPartitionFile file;
+	file.global_state = op.function.copy_to_initialize_global(context, *op.bind_data, file_path);
+	file.local_state = op.function.copy_to_initialize_local(context, *op.bind_data);
+	l.open_order.push_back(directory);
+	return l.partition_files[directory] = move(file);
+}
+
+static void SinkPartitioned(ExecutionContext &context, const PhysicalCopyToFile &op, CopyToFunctionGlobalState &g,
+                            CopyToFunctionLocalState &l, DataChunk &input) {
+	auto &fs = FileSystem::GetFileSystem(context.client);
+	auto count = input.size();
+
+	// convert the values of the partition columns to strings
+	vector<Vector> partition_values;
+	vector<VectorData> partition_data(op.partition_columns.size());
+	for (idx_t i = 0; i < op.partition_columns.size(); i++) {
+		auto &column = input.data[op.partition_columns[i]];
+		partition_values.emplace_back(LogicalType::VARCHAR);
+		if (column.GetType().id() == LogicalTypeId::VARCHAR) {
+			partition_values[i].Reference(column);
+		} else {
+			VectorOperations::Cast(column, partition_values[i], count);
+		}
+		partition_values[i].Orrify(count, partition_data[i]);
+	}
+
+	// group the rows by the directory of their partition
+	unordered_map<string, idx_t> partition_indices;
+	vector<string> directories;
+	vector<SelectionVector> selections;
+	vector<idx_t> selection_counts;
+	for (idx_t row = 0; row < count; row++) {
+		string directory;
+		for (idx_t i = 0; i < op.partition_columns.size(); i++) {
+			auto &data = partition_data[i];
+			auto idx = data.sel->get_index(row);
+			string value;
+			if (data.validity.RowIsValid(idx)) {
+				value = EscapePartitionName(((string_t *)data.data)[idx].GetString());
+			} else {
+				value = "__HIVE_DEFAULT_PARTITION__";
+			}
+			auto name = EscapePartitionName(op.names[op.partition_columns[i]]) + "=" + value;
+			directory = directory.empty() ? name : fs.JoinPath(directory, name);
+		}
+		auto entry = partition_indices.find(directory);
+		idx_t partition_idx;
+		if (entry == partition_indices.end()) {
+			partition_idx = directories.size();
+			partition_indices[directory] = partition_idx;
+			directories.push_back(move(directory));
+			selections.emplace_back(STANDARD_VECTOR_SIZE);
+			selection_counts.push_back(0);
+		} else {
+			partition_idx = entry->second;
+		}
+		selections[partition_idx].set_index(selection_counts[partition_idx]++, row);
+	}
+
+	// buffer the rows of every partition
+	for (idx_t partition_idx = 0; partition_idx < directories.size(); partition_idx++) {
+		auto &buffer = l.partition_buffers[directories[partition_idx]];
+		if (!buffer) {
+			buffer = make_unique<ChunkCollection>();
+			l.buffered_partitions.push_back(directories[partition_idx]);
+		}
+		auto &write_chunk = l.write_chunk;
+		write_chunk.Reset();
+		for (idx_t i = 0; i < l.write_columns.size(); i++) {
+			write_chunk.data[i].Slice(input.data[l.write_columns[i]], selections[partition_idx],
+			                          selection_counts[partition_idx]);
+		}
+		write_chunk.SetCardinality(selection_counts[partition_idx]);
+		buffer->Append(write_chunk);
+	}
+	l.buffered_count += count;
+}
+
+//! Writes the buffered rows to the partition files, the rows of a partition all go to the same file
+static void FlushPartitions(ClientContext &context, const PhysicalCopyToFile &op, CopyToFunctionGlobalState &g,
+                            CopyToFunctionLocalState &l) {
+	// write to the files that are still open first, so they are not closed before their rows are written
+	std::stable_partition(l.buffered_partitions.begin(), l.buffered_partitions.end(), [&](const string &directory) {
+		return l.partition_files.find(directory) != l.partition_files.end();
+	});
+	for (auto &directory : l.buffered_partitions) {
+		auto &buffer = *l.partition_buffers[directory];
+		auto &file = GetPartitionFile(context, op, g, l, directory);
+		for (idx_t chunk_idx = 0; chunk_idx < buffer.ChunkCount(); chunk_idx++) {
+			op.function.copy_to_sink(context, *op.bind_data, *file.global_state, *file.local_state,
+			                         buffer.GetChunk(chunk_idx));
+		}
+	}
+	l.partition_buffers.clear();
+	l.buffered_partitions.clear();
+	l.buffered_count = 0;
 }
 
 SinkResultType PhysicalCopyToFile::Sink(ExecutionContext &context, GlobalSinkState &gstate, LocalSinkState &lstate,
@@ -37,6 +252,13 @@ SinkResultType PhysicalCopyToFile::Sink(ExecutionContext &context, GlobalSinkSta
 	auto &l = (CopyToFunctionLocalState &)lstate;
 
 	g.rows_copied += input.size();
+	if (!partition_columns.empty()) {
+		SinkPartitioned(context, *this, g, l, input);
+		if (l.buffered_count >= PARTITION_BUFFER_SIZE) {
+			FlushPartitions(context.client, *this, g, l);
+		}
+		return SinkResultType::NEED_MORE_INPUT;
+	}
 	function.copy_to_sink(context.client, *bind_data, *g.global_state, *l.local_state, input);
 	return SinkResultType::NEED_MORE_INPUT;
 }
@@ -45,6 +267,16 @@ void PhysicalCopyToFile::Combine(ExecutionContext &context, GlobalSinkState &gst
 	auto &g = (CopyToFunctionGlobalState &)gstate;
 	auto &l = (CopyToFunctionLocalState &)lstate;
 
+	if (!partition_columns.empty()) {
+		// the partition files are only written by this thread: write the remaining rows and finish all of them
+		FlushPartitions(context.client, *this, g, l);
+		for (auto &directory : l.open_order) {
+			ClosePartitionFile(context.client, *this, l.partition_files[directory]);
+		}
+		l.partition_files.clear();
+		l.open_order.clear();
+		return;
+	}
 	if (function.copy_to_combine) {
 		function.copy_to_combine(context.client, *bind_data, *g.global_state, *l.local_state);
 	}
@@ -53,17 +285,49 @@ void PhysicalCopyToFile::Combine(ExecutionContext &context, GlobalSinkState &gst
 SinkFinalizeType PhysicalCopyToFile::Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
                                               GlobalSinkState &gstate_p) const {
 	auto &gstate = (CopyToFunctionGlobalState &)gstate_p;
-	if (function.copy_to_finalize) {
+	if (partition_columns.empty() && function.copy_to_finalize) {
 		function.copy_to_finalize(context, *bind_data, *gstate.global_state);
 	}
 	return SinkFinalizeType::READY;
 }
 
 unique_ptr<LocalSinkState> PhysicalCopyToFile::GetLocalSinkState(ExecutionContext &context) const {
-	return make_unique<CopyToFunctionLocalState>(function.copy_to_initialize_local(context.client, *bind_data));
+	if (partition_columns.empty()) {
+		return make_unique<CopyToFunctionLocalState>(function.copy_to_initialize_local(context.client, *bind_data));
+	}
+	// the files of the partitions are opened when the first row of a partition is written
+	auto state = make_unique<CopyToFunctionLocalState>(nullptr);
+	vector<LogicalType> write_types;
+	for (idx_t i = 0; i < children[0]->types.size(); i++) {
+		if (std::find(partition_columns.begin(), partition_columns.end(), i) == partition_columns.end()) {
+			state->write_columns.push_back(i);
+			write_types.push_back(children[0]->types[i]);
+		}
+	}
+	state->write_chunk.Initialize(write_types);
+	return move(state);
 }
+
 unique_ptr<GlobalSinkState> PhysicalCopyToFile::GetGlobalSinkState(ClientContext &context) const {
-	return make_unique<CopyToFunctionGlobalState>(function.copy_to_initialize_global(context, *bind_data));
+	if (partition_columns.empty()) {
+		return make_unique<CopyToFunctionGlobalState>(
+		    function.copy_to_initialize_global(context, *bind_data, file_path));
+	}
+	// the partitions are written as directories in the root directory
+	auto &fs = FileSystem::GetFileSystem(context);
+	if (!fs.DirectoryExists(file_path)) {
+		fs.CreateDirectory(file_path);
+	} else {
+		// files of a previous write would be mixed up with the new partitions
+		bool is_empty = true;
+		fs.ListFiles(file_path, [&](const string &path, bool is_directory) { is_empty = false; });
+		if (!is_empty) {
+			throw IOException("Directory \"%s\" is not empty: a partitioned COPY can only write to a new or empty "
+			                  "directory",
+			                  file_path);
+		}
+	}
+	return make_unique<CopyToFunctionGlobalState>(nullptr);
 }
 
 //===--------------------------------------------------------------------===//
@@ -90,7 +354,7 @@ void PhysicalCopyToFile::GetData(ExecutionContext &context, DataChunk &chunk, Gl
 	}
 
 	chunk.SetCardinality(1);
-	chunk.SetValue(0, 0, Value::BIGINT(g.rows_copied));
+	chunk.SetValue(0, 0, Value::BIGINT(g.rows_copied.load()));
 	state.finished = true;
 }
 
@@ -64,7 +64,7 @@ PartitionableHashTable::PartitionableHashTable(BufferManager &buffer_manager_p,
 }
 
 idx_t PartitionableHashTable::ListAddChunk(HashTableList &list, DataChunk &groups, Vector &group_hashes,
-                                           DataChunk &payload) {
+                                           DataChunk &payload, const vector<idx_t> &filter, bool append) {
 	if (list.empty() || list.back()->Size() + groups.size() > list.back()->MaxCapacity()) {
 		if (!list.empty()) {
 			// early release first part of ht and prevent adding of more data
@@ -73,10 +73,14 @@ idx_t PartitionableHashTable::ListAddChunk(HashTableList &list, DataChunk &group
 		list.push_back(make_unique<GroupedAggregateHashTable>(buffer_manager, group_types, payload_types, bindings,
 		                                                      HtEntryType::HT_WIDTH_32));
 	}
-	return list.back()->AddChunk(groups, group_hashes, payload);
+	if (append) {
+		return list.back()->AppendChunk(groups, group_hashes, payload, filter);
+	}
+	return list.back()->AddChunk(groups, group_hashes, payload, filter);
 }
 
-idx_t PartitionableHashTable::AddChunk(DataChunk &groups, DataChunk &payload, bool do_partition) {
+idx_t PartitionableHashTable::AddChunk(DataChunk &groups, DataChunk &payload, bool do_partition,
+                                       const vector<idx_t> &filter) {
 	groups.Hash(hashes);
 
 	// we partition when we are asked to or when the unpartitioned ht runs out of space
@@ -85,9 +89,24 @@ idx_t PartitionableHashTable::AddChunk(DataChunk &groups, DataChunk &payload, bo
 	}
 
 	if (!IsPartitioned()) {
-		return ListAddChunk(unpartitioned_hts, groups, hashes, payload);
+		return ListAddChunk(unpartitioned_hts, groups, hashes, payload, filter, false);
 	}
+	return PartitionedAddChunk(groups, payload, filter, false);
+}
+
+idx_t PartitionableHashTable::AppendChunk(DataChunk &groups, DataChunk &payload, const vector<idx_t> &filter) {
+	groups.Hash(hashes);
+
+	// the appended groups are only merged when the partitions are combined, so we always partition them
+	if (!IsPartitioned()) {
+		Partition();
+	}
+	return PartitionedAddChunk(groups, payload, filter, true);
+}
 
+idx_t PartitionableHashTable::PartitionedAddChunk(DataChunk &groups, DataChunk &payload, const vector<idx_t> &filter,
+                                                  bool append) {
+	D_ASSERT(IsPartitioned());
 	// makes no sense to do this with 1 partition
 	D_ASSERT(partition_info.n_partitions > 0);
 
@@ -118,7 +137,8 @@ idx_t PartitionableHashTable::AddChunk(DataChunk &groups, DataChunk &payload, bo
 		payload_subset.Slice(payload, sel_vectors[r], sel_vector_sizes[r]);
 		hashes_subset.Slice(hashes, sel_vectors[r], sel_vector_sizes[r]);
 
-		group_count += ListAddChunk(radix_partitioned_hts[r], group_subset, hashes_subset, payload_subset);
+		group_count +=
+		    ListAddChunk(radix_partitioned_hts[r], group_subset, hashes_subset, payload_subset, filter, append);
 	}
 	return group_count;
 }
@@ -157,6 +177,27 @@ HashTableList PartitionableHashTable::GetUnpartitioned() {
 	return move(unpartitioned_hts);
 }
 
+vector<GroupedAggregateHashTable *> PartitionableHashTable::GetAll() {
+	vector<GroupedAggregateHashTable *> result;
+	for (auto &ht : unpartitioned_hts) {
+		result.push_back(ht.get());
+	}
+	for (auto &ht_list : radix_partitioned_hts) {
+		for (auto &ht : ht_list.second) {
+			result.push_back(ht.get());
+		}
+	}
+	return result;
+}
+
+idx_t PartitionableHashTable::SizeInBytes() {
+	idx_t size = 0;
+	for (auto &ht : GetAll()) {
+		size += ht->SizeInBytes();
+	}
+	return size;
+}
+
 void PartitionableHashTable::Finalize() {
 	if (IsPartitioned()) {
 		for (auto &ht_list : radix_partitioned_hts) {
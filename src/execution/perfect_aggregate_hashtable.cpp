@@ -9,15 +9,14 @@ PerfectAggregateHashTable::PerfectAggregateHashTable(BufferManager &buffer_manag
                                                      const vector<LogicalType> &group_types_p,
                                                      vector<LogicalType> payload_types_p,
                                                      vector<AggregateObject> aggregate_objects_p,
-                                                     vector<Value> group_minima_p, vector<idx_t> required_bits_p)
+                                                     vector<Value> group_minima_p, vector<idx_t> group_ranges_p)
     : BaseAggregateHashTable(buffer_manager, move(payload_types_p)), addresses(LogicalType::POINTER),
-      required_bits(move(required_bits_p)), total_required_bits(0), group_minima(move(group_minima_p)),
+      group_ranges(move(group_ranges_p)), total_groups(1), group_minima(move(group_minima_p)),
       sel(STANDARD_VECTOR_SIZE) {
-	for (auto &group_bits : required_bits) {
-		total_required_bits += group_bits;
+	// the total amount of groups we allocate space for is the product of the ranges of the groups
+	for (auto &group_range : group_ranges) {
+		total_groups *= group_range;
 	}
-	// the total amount of groups we allocate space for is 2^required_bits
-	total_groups = 1 << total_required_bits;
 	// we don't need to store the groups in a perfect hash table, since the group keys can be deduced by their location
 	grouping_columns = group_types_p.size();
 	layout.Initialize(move(aggregate_objects_p));
@@ -38,20 +37,22 @@ PerfectAggregateHashTable::~PerfectAggregateHashTable() {
 
 template <class T>
 static void ComputeGroupLocationTemplated(VectorData &group_data, Value &min, uintptr_t *address_data,
-                                          idx_t current_shift, idx_t count) {
+                                          idx_t group_range, idx_t count) {
 	auto data = (T *)group_data.data;
 	auto min_val = min.GetValueUnsafe<T>();
+	// the group index is a mixed-radix number with one digit per group: make room for the digit of this group
 	if (!group_data.validity.AllValid()) {
 		for (idx_t i = 0; i < count; i++) {
 			auto index = group_data.sel->get_index(i);
 			// check if the value is NULL
 			// NULL groups are considered as "0" in the hash table
-			// that is to say, they have no effect on the position of the element (because 0 << shift is 0)
-			// we only need to handle non-null values here
+			// that is to say, they only shift the digits of the previous groups
+			address_data[i] *= group_range;
 			if (group_data.validity.RowIsValid(index)) {
 				D_ASSERT(data[index] >= min_val);
 				uintptr_t adjusted_value = (data[index] - min_val) + 1;
-				address_data[i] += adjusted_value << current_shift;
+				D_ASSERT(adjusted_value < group_range);
+				address_data[i] += adjusted_value;
 			}
 		}
 	} else {
@@ -59,27 +60,39 @@ static void ComputeGroupLocationTemplated(VectorData &group_data, Value &min, ui
 		for (idx_t i = 0; i < count; i++) {
 			auto index = group_data.sel->get_index(i);
 			uintptr_t adjusted_value = (data[index] - min_val) + 1;
-			address_data[i] += adjusted_value << current_shift;
+			address_data[i] = address_data[i] * group_range + adjusted_value;
 		}
 	}
 }
 
-static void ComputeGroupLocation(Vector &group, Value &min, uintptr_t *address_data, idx_t current_shift, idx_t count) {
+static void ComputeGroupLocation(Vector &group, Value &min, uintptr_t *address_data, idx_t group_range, idx_t count) {
 	VectorData vdata;
 	group.Orrify(count, vdata);
 
 	switch (group.GetType().InternalType()) {
 	case PhysicalType::INT8:
-		ComputeGroupLocationTemplated<int8_t>(vdata, min, address_data, current_shift, count);
+		ComputeGroupLocationTemplated<int8_t>(vdata, min, address_data, group_range, count);
 		break;
 	case PhysicalType::INT16:
-		ComputeGroupLocationTemplated<int16_t>(vdata, min, address_data, current_shift, count);
+		ComputeGroupLocationTemplated<int16_t>(vdata, min, address_data, group_range, count);
 		break;
 	case PhysicalType::INT32:
-		ComputeGroupLocationTemplated<int32_t>(vdata, min, address_data, current_shift, count);
+		ComputeGroupLocationTemplated<int32_t>(vdata, min, address_data, group_range, count);
 		break;
 	case PhysicalType::INT64:
-		ComputeGroupLocationTemplated<int64_t>(vdata, min, address_data, current_shift, count);
+		ComputeGroupLocationTemplated<int64_t>(vdata, min, address_data, group_range, count);
+		break;
+	case PhysicalType::UINT8:
+		ComputeGroupLocationTemplated<uint8_t>(vdata, min, address_data, group_range, count);
+		break;
+	case PhysicalType::UINT16:
+		ComputeGroupLocationTemplated<uint16_t>(vdata, min, address_data, group_range, count);
+		break;
+	case PhysicalType::UINT32:
+		ComputeGroupLocationTemplated<uint32_t>(vdata, min, address_data, group_range, count);
+		break;
+	case PhysicalType::UINT64:
+		ComputeGroupLocationTemplated<uint64_t>(vdata, min, address_data, group_range, count);
 		break;
 	default:
 		throw InternalException("Unsupported group type for perfect aggregate hash table");
@@ -94,10 +107,8 @@ void PerfectAggregateHashTable::AddChunk(DataChunk &groups, DataChunk &payload)
 	D_ASSERT(groups.ColumnCount() == group_minima.size());
 
 	// then compute the actual group location by iterating over each of the groups
-	idx_t current_shift = total_required_bits;
 	for (idx_t i = 0; i < groups.ColumnCount(); i++) {
-		current_shift -= required_bits[i];
-		ComputeGroupLocation(groups.data[i], group_minima[i], address_data, current_shift, groups.size());
+		ComputeGroupLocation(groups.data[i], group_minima[i], address_data, group_ranges[i], groups.size());
 	}
 	// now we have the HT entry number for every tuple
 	// compute the actual pointer to the data by adding it to the base HT pointer and multiplying by the tuple size
@@ -178,14 +189,15 @@ void PerfectAggregateHashTable::Combine(PerfectAggregateHashTable &other) {
 }
 
 template <class T>
-static void ReconstructGroupVectorTemplated(uint32_t group_values[], Value &min, idx_t mask, idx_t shift,
-                                            idx_t entry_count, Vector &result) {
+static void ReconstructGroupVectorTemplated(uint32_t group_values[], Value &min, idx_t group_range, idx_t entry_count,
+                                            Vector &result) {
 	auto data = FlatVector::GetData<T>(result);
 	auto &validity_mask = FlatVector::Validity(result);
 	auto min_data = min.GetValueUnsafe<T>();
 	for (idx_t i = 0; i < entry_count; i++) {
-		// extract the value of this group from the total group index
-		auto group_index = (group_values[i] >> shift) & mask;
+		// extract the value of this group from the last digit of the remaining group index
+		auto group_index = group_values[i] % group_range;
+		group_values[i] /= group_range;
 		if (group_index == 0) {
 			// if it is 0, the value is NULL
 			validity_mask.SetInvalid(i);
@@ -196,22 +208,32 @@ static void ReconstructGroupVectorTemplated(uint32_t group_values[], Value &min,
 	}
 }
 
-static void ReconstructGroupVector(uint32_t group_values[], Value &min, idx_t required_bits, idx_t shift,
-                                   idx_t entry_count, Vector &result) {
-	// construct the mask for this entry
-	idx_t mask = (1 << required_bits) - 1;
+static void ReconstructGroupVector(uint32_t group_values[], Value &min, idx_t group_range, idx_t entry_count,
+                                   Vector &result) {
 	switch (result.GetType().InternalType()) {
 	case PhysicalType::INT8:
-		ReconstructGroupVectorTemplated<int8_t>(group_values, min, mask, shift, entry_count, result);
+		ReconstructGroupVectorTemplated<int8_t>(group_values, min, group_range, entry_count, result);
 		break;
 	case PhysicalType::INT16:
-		ReconstructGroupVectorTemplated<int16_t>(group_values, min, mask, shift, entry_count, result);
+		ReconstructGroupVectorTemplated<int16_t>(group_values, min, group_range, entry_count, result);
 		break;
 	case PhysicalType::INT32:
-		ReconstructGroupVectorTemplated<int32_t>(group_values, min, mask, shift, entry_count, result);
+		ReconstructGroupVectorTemplated<int32_t>(group_values, min, group_range, entry_count, result);
 		break;
 	case PhysicalType::INT64:
-		ReconstructGroupVectorTemplated<int64_t>(group_values, min, mask, shift, entry_count, result);
+		ReconstructGroupVectorTemplated<int64_t>(group_values, min, group_range, entry_count, result);
+		break;
+	case PhysicalType::UINT8:
+		ReconstructGroupVectorTemplated<uint8_t>(group_values, min, group_range, entry_count, result);
+		break;
+	case PhysicalType::UINT16:
+		ReconstructGroupVectorTemplated<uint16_t>(group_values, min, group_range, entry_count, result);
+		break;
+	case PhysicalType::UINT32:
+		ReconstructGroupVectorTemplated<uint32_t>(group_values, min, group_range, entry_count, result);
+		break;
+	case PhysicalType::UINT64:
+		ReconstructGroupVectorTemplated<uint64_t>(group_values, min, group_range, entry_count, result);
 		break;
 	default:
 		throw InternalException("Invalid type for perfect aggregate HT group");
@@ -240,11 +262,9 @@ void PerfectAggregateHashTable::Scan(idx_t &scan_position, DataChunk &result) {
 		// no entries found
 		return;
 	}
-	// first reconstruct the groups from the group index
-	idx_t shift = total_required_bits;
-	for (idx_t i = 0; i < grouping_columns; i++) {
-		shift -= required_bits[i];
-		ReconstructGroupVector(group_values, group_minima[i], required_bits[i], shift, entry_count, result.data[i]);
+	// first reconstruct the groups from the group index, starting with the group of the last digit
+	for (idx_t i = grouping_columns; i > 0; i--) {
+		ReconstructGroupVector(group_values, group_minima[i - 1], group_ranges[i - 1], entry_count, result.data[i - 1]);
 	}
 	// then construct the payloads
 	result.SetCardinality(entry_count);
@@ -12,20 +12,18 @@
 #include "duckdb/storage/statistics/numeric_statistics.hpp"
 namespace duckdb {
 
-static uint32_t RequiredBitsForValue(uint32_t n) {
-	idx_t required_bits = 0;
-	while (n > 0) {
-		n >>= 1;
-		required_bits++;
-	}
-	return required_bits;
+template <class T>
+static int64_t GetGroupRange(NumericStatistics &nstats) {
+	return int64_t(nstats.max.GetValueUnsafe<T>()) - int64_t(nstats.min.GetValueUnsafe<T>());
 }
 
-static bool CanUsePerfectHashAggregate(ClientContext &context, LogicalAggregate &op, vector<idx_t> &bits_per_group) {
+static bool CanUsePerfectHashAggregate(ClientContext &context, LogicalAggregate &op, vector<idx_t> &group_ranges) {
 	if (op.grouping_sets.size() > 1 || !op.grouping_functions.empty()) {
 		return false;
 	}
-	idx_t perfect_hash_bits = 0;
+	// the perfect HT has one entry for every combination of the group values
+	idx_t total_groups = 1;
+	const idx_t max_groups = idx_t(1) << ClientConfig::GetConfig(context).perfect_ht_threshold;
 	if (op.group_stats.empty()) {
 		op.group_stats.resize(op.groups.size());
 	}
@@ -38,22 +36,33 @@ static bool CanUsePerfectHashAggregate(ClientContext &context, LogicalAggregate
 		case PhysicalType::INT16:
 		case PhysicalType::INT32:
 		case PhysicalType::INT64:
+		case PhysicalType::UINT8:
+		case PhysicalType::UINT16:
+		case PhysicalType::UINT32:
+		case PhysicalType::UINT64:
 			break;
 		default:
-			// we only support simple integer types for perfect hashing
+			// we only support simple integer types (and ENUMs, which are stored as unsigned integers) for perfect hashing
 			return false;
 		}
 		// check if the group has stats available
 		auto &group_type = group->return_type;
+		if (group_type.id() == LogicalTypeId::ENUM &&
+		    (!stats || ((NumericStatistics &)*stats).min.is_null || ((NumericStatistics &)*stats).max.is_null)) {
+			// the domain of an ENUM is given by its type: we can use it if we do not know anything better
+			bool can_have_null = !stats || stats->CanHaveNull();
+			stats = make_unique<NumericStatistics>(group_type, Value::MinimumValue(group_type),
+			                                       Value::MaximumValue(group_type));
+			stats->validity_stats = make_unique<ValidityStatistics>(can_have_null);
+		}
 		if (!stats) {
 			// no stats, but we might still be able to use perfect hashing if the type is small enough
 			// for small types we can just set the stats to [type_min, type_max]
 			switch (group_type.InternalType()) {
 			case PhysicalType::INT8:
-				stats = make_unique<NumericStatistics>(group_type, Value::MinimumValue(group_type),
-				                                       Value::MaximumValue(group_type));
-				break;
 			case PhysicalType::INT16:
+			case PhysicalType::UINT8:
+			case PhysicalType::UINT16:
 				stats = make_unique<NumericStatistics>(group_type, Value::MinimumValue(group_type),
 				                                       Value::MaximumValue(group_type));
 				break;
@@ -69,19 +78,17 @@ static bool CanUsePerfectHashAggregate(ClientContext &context, LogicalAggregate
 		if (nstats.min.is_null || nstats.max.is_null) {
 			return false;
 		}
-		// we have a min and a max value for the stats: use that to figure out how many bits we have
-		// we add two here, one for the NULL value, and one to make the computation one-indexed
-		// (e.g. if min and max are the same, we still need one entry in total)
+		// we have a min and a max value for the stats: use that to figure out how many entries we need
 		int64_t range;
 		switch (group_type.InternalType()) {
 		case PhysicalType::INT8:
-			range = int64_t(nstats.max.GetValueUnsafe<int8_t>()) - int64_t(nstats.min.GetValueUnsafe<int8_t>());
+			range = GetGroupRange<int8_t>(nstats);
 			break;
 		case PhysicalType::INT16:
-			range = int64_t(nstats.max.GetValueUnsafe<int16_t>()) - int64_t(nstats.min.GetValueUnsafe<int16_t>());
+			range = GetGroupRange<int16_t>(nstats);
 			break;
 		case PhysicalType::INT32:
-			range = int64_t(nstats.max.GetValueUnsafe<int32_t>()) - int64_t(nstats.min.GetValueUnsafe<int32_t>());
+			range = GetGroupRange<int32_t>(nstats);
 			break;
 		case PhysicalType::INT64:
 			if (!TrySubtractOperator::Operation(nstats.max.GetValueUnsafe<int64_t>(),
@@ -89,6 +96,23 @@ static bool CanUsePerfectHashAggregate(ClientContext &context, LogicalAggregate
 				return false;
 			}
 			break;
+		case PhysicalType::UINT8:
+			range = GetGroupRange<uint8_t>(nstats);
+			break;
+		case PhysicalType::UINT16:
+			range = GetGroupRange<uint16_t>(nstats);
+			break;
+		case PhysicalType::UINT32:
+			range = GetGroupRange<uint32_t>(nstats);
+			break;
+		case PhysicalType::UINT64: {
+			auto unsigned_range = nstats.max.GetValueUnsafe<uint64_t>() - nstats.min.GetValueUnsafe<uint64_t>();
+			if (unsigned_range >= uint64_t(NumericLimits<int32_t>::Maximum())) {
+				return false;
+			}
+			range = int64_t(unsigned_range);
+			break;
+		}
 		default:
 			throw InternalException("Unsupported type for perfect hash (should be caught before)");
 		}
@@ -96,14 +120,14 @@ static bool CanUsePerfectHashAggregate(ClientContext &context, LogicalAggregate
 		if (range >= NumericLimits<int32_t>::Maximum()) {
 			return false;
 		}
+		// we add two here, one for the NULL value, and one to make the computation one-indexed
+		// (e.g. if min and max are the same, we still need one entry in total)
 		range += 2;
-		// figure out how many bits we need
-		idx_t required_bits = RequiredBitsForValue(range);
-		bits_per_group.push_back(required_bits);
-		perfect_hash_bits += required_bits;
-		// check if we have exceeded the bits for the hash
-		if (perfect_hash_bits > ClientConfig::GetConfig(context).perfect_ht_threshold) {
-			// too many bits for perfect hash
+		group_ranges.push_back(range);
+		// the groups are combined into a single index, so what matters is the product of the ranges of all groups
+		total_groups *= range;
+		if (total_groups > max_groups) {
+			// too many groups for perfect hash
 			return false;
 		}
 	}
@@ -157,10 +181,10 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalAggregate
 	} else {
 		// groups! create a GROUP BY aggregator
 		// use a perfect hash aggregate if possible
-		vector<idx_t> required_bits;
-		if (CanUsePerfectHashAggregate(context, op, required_bits)) {
+		vector<idx_t> group_ranges;
+		if (CanUsePerfectHashAggregate(context, op, group_ranges)) {
 			groupby = make_unique_base<PhysicalOperator, PhysicalPerfectHashAggregate>(
-			    context, op.types, move(op.expressions), move(op.groups), move(op.group_stats), move(required_bits),
+			    context, op.types, move(op.expressions), move(op.groups), move(op.group_stats), move(group_ranges),
 			    op.estimated_cardinality);
 		} else {
 			groupby = make_unique_base<PhysicalOperator, PhysicalHashAggregate>(
@@ -1,13 +1,17 @@
 #include "duckdb/execution/operator/join/perfect_hash_join_executor.hpp"
 #include "duckdb/execution/operator/join/physical_cross_product.hpp"
 #include "duckdb/execution/operator/join/physical_hash_join.hpp"
+#include "duckdb/execution/operator/join/physical_iejoin.hpp"
 #include "duckdb/execution/operator/join/physical_index_join.hpp"
 #include "duckdb/execution/operator/join/physical_nested_loop_join.hpp"
 #include "duckdb/execution/operator/join/physical_piecewise_merge_join.hpp"
+#include "duckdb/execution/operator/projection/physical_projection.hpp"
 #include "duckdb/execution/operator/scan/physical_table_scan.hpp"
 #include "duckdb/execution/physical_plan_generator.hpp"
 #include "duckdb/function/table/table_scan.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/filter/dynamic_filter.hpp"
 #include "duckdb/planner/operator/logical_comparison_join.hpp"
 #include "duckdb/storage/statistics/numeric_statistics.hpp"
 #include "duckdb/transaction/transaction.hpp"
@@ -156,6 +160,91 @@ void TransformIndexJoin(ClientContext &context, LogicalComparisonJoin &op, Index
 	}
 }
 
+//! Find the table scan that produces the given column of the probe side of a hash join, following the column through
+//! filters, projections and the probe side of other hash joins. Returns nullptr if there is no such table scan.
+static PhysicalTableScan *FindProbeTableScan(PhysicalOperator *op, idx_t &column_index) {
+	while (true) {
+		switch (op->type) {
+		case PhysicalOperatorType::TABLE_SCAN: {
+			auto &scan = (PhysicalTableScan &)*op;
+			auto bind_data = dynamic_cast<TableScanBindData *>(scan.bind_data.get());
+			if (!scan.function.filter_pushdown || !bind_data || bind_data->is_index_scan ||
+			    scan.column_ids[column_index] == COLUMN_IDENTIFIER_ROW_ID) {
+				return nullptr;
+			}
+			return &scan;
+		}
+		case PhysicalOperatorType::FILTER:
+			break;
+		case PhysicalOperatorType::PROJECTION: {
+			auto &expr = *((PhysicalProjection &)*op).select_list[column_index];
+			if (expr.type != ExpressionType::BOUND_REF) {
+				return nullptr;
+			}
+			column_index = ((BoundReferenceExpression &)expr).index;
+			break;
+		}
+		case PhysicalOperatorType::HASH_JOIN:
+			// the columns of the probe side come first in the result of a hash join
+			if (column_index >= op->children[0]->types.size()) {
+				return nullptr;
+			}
+			break;
+		default:
+			return nullptr;
+		}
+		op = op->children[0].get();
+	}
+}
+
+//! Push dynamic filters on the keys of the hash join into the table scan of its probe side, these filters remove the
+//! rows that cannot find a match once the build side of the join is complete
+static void PushDynamicFilters(PhysicalHashJoin &join) {
+	for (idx_t i = 0; i < join.conditions.size(); i++) {
+		if (!join.CanCreateDynamicFilter(i)) {
+			continue;
+		}
+		auto &probe_key = *join.conditions[i].left;
+		if (probe_key.type != ExpressionType::BOUND_REF) {
+			continue;
+		}
+		idx_t column_index = ((BoundReferenceExpression &)probe_key).index;
+		auto scan = FindProbeTableScan(join.children[0].get(), column_index);
+		if (!scan || scan->types[column_index] != probe_key.return_type) {
+			continue;
+		}
+		join.dynamic_filters[i] = make_shared<DynamicFilterData>();
+		if (!scan->table_filters) {
+			scan->table_filters = make_unique<TableFilterSet>();
+		}
+		scan->table_filters->PushFilter(column_index, make_unique<DynamicFilter>(join.dynamic_filters[i]));
+	}
+}
+
+static bool CanPlanIEJoin(LogicalComparisonJoin &op) {
+	switch (op.join_type) {
+	case JoinType::INNER:
+	case JoinType::LEFT:
+	case JoinType::RIGHT:
+	case JoinType::OUTER:
+		break;
+	default:
+		return false;
+	}
+	for (auto &cond : op.conditions) {
+		switch (cond.left->return_type.InternalType()) {
+		case PhysicalType::LIST:
+		case PhysicalType::STRUCT:
+		case PhysicalType::MAP:
+			// nested comparisons are not supported
+			return false;
+		default:
+			break;
+		}
+	}
+	return true;
+}
+
 unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalComparisonJoin &op) {
 	// now visit the children
 	D_ASSERT(op.children.size() == 2);
@@ -173,7 +262,11 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalComparison
 	bool has_equality = false;
 	bool has_inequality = false;
 	bool has_null_equal_conditions = false;
+	idx_t range_count = 0;
 	for (auto &cond : op.conditions) {
+		if (PhysicalIEJoin::IsRangeComparison(cond.comparison)) {
+			range_count++;
+		}
 		if (cond.comparison == ExpressionType::COMPARE_EQUAL ||
 		    cond.comparison == ExpressionType::COMPARE_NOT_DISTINCT_FROM) {
 			has_equality = true;
@@ -212,9 +305,12 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalComparison
 		// Equality join with small number of keys : possible perfect join optimization
 		PerfectHashJoinStats perfect_join_stats;
 		CheckForPerfectJoinOpt(op, perfect_join_stats);
-		plan = make_unique<PhysicalHashJoin>(op, move(left), move(right), move(op.conditions), op.join_type,
-		                                     op.left_projection_map, op.right_projection_map, move(op.delim_types),
-		                                     op.estimated_cardinality, perfect_join_stats);
+		auto hash_join = make_unique<PhysicalHashJoin>(
+		    op, move(left), move(right), move(op.conditions), op.join_type, op.left_projection_map,
+		    op.right_projection_map, move(op.delim_types), op.estimated_cardinality, perfect_join_stats);
+		hash_join->InitializeExternal(context, in_recursive_cte);
+		PushDynamicFilters(*hash_join);
+		plan = move(hash_join);
 
 	} else {
 		if (op.conditions.size() == 1 && !has_inequality) {
@@ -222,6 +318,11 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalComparison
 			// range join: use piecewise merge join
 			plan = make_unique<PhysicalPiecewiseMergeJoin>(op, move(left), move(right), move(op.conditions),
 			                                               op.join_type, op.estimated_cardinality);
+		} else if (range_count >= 2 && !in_recursive_cte && CanPlanIEJoin(op)) {
+			// multiple range conditions: use IEJoin
+			// (the IEJoin performs the join in a child pipeline, which is not supported in recursive CTEs)
+			plan = make_unique<PhysicalIEJoin>(op, move(left), move(right), move(op.conditions), op.join_type,
+			                                   op.estimated_cardinality);
 		} else {
 			// inequality join: use nested loop
 			plan = make_unique<PhysicalNestedLoopJoin>(op, move(left), move(right), move(op.conditions), op.join_type,
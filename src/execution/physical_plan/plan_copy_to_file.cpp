@@ -1,5 +1,6 @@
 #include "duckdb/execution/physical_plan_generator.hpp"
 #include "duckdb/execution/operator/persistent/physical_copy_to_file.hpp"
+#include "duckdb/main/client_config.hpp"
 #include "duckdb/planner/operator/logical_copy_to_file.hpp"
 
 namespace duckdb {
@@ -8,6 +9,12 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalCopyToFile
 	auto plan = CreatePlan(*op.children[0]);
 	// COPY from select statement to file
 	auto copy = make_unique<PhysicalCopyToFile>(op.types, op.function, move(op.bind_data), op.estimated_cardinality);
+	copy->file_path = op.file_path;
+	copy->names = op.names;
+	copy->partition_columns = op.partition_columns;
+	// if the order of the rows does not need to be preserved, all threads can sink into the file at once
+	copy->parallel = !ClientConfig::GetConfig(context).preserve_insertion_order;
+	copy->max_open_files = ClientConfig::GetConfig(context).partitioned_write_max_open_files;
 
 	copy->children.push_back(move(plan));
 	return move(copy);
@@ -17,7 +17,9 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalRecursiveC
 	rec_ctes[op.table_index] = working_table;
 
 	auto left = CreatePlan(*op.children[0]);
+	in_recursive_cte = true;
 	auto right = CreatePlan(*op.children[1]);
+	in_recursive_cte = false;
 
 	auto cte =
 	    make_unique<PhysicalRecursiveCTE>(op.types, op.union_all, move(left), move(right), op.estimated_cardinality);
@@ -1,7 +1,11 @@
 #include "duckdb/execution/radix_partitioned_hashtable.hpp"
 #include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/execution/operator/aggregate/physical_hash_aggregate.hpp"
+#include "duckdb/main/client_context.hpp"
 #include "duckdb/parallel/event.hpp"
+#include "duckdb/parallel/thread_context.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 
 namespace duckdb {
 
@@ -39,6 +43,32 @@ RadixPartitionedHashTable::RadixPartitionedHashTable(GroupingSet &grouping_set_p
 		}
 		grouping_values.push_back(Value::BIGINT(grouping_value));
 	}
+
+	idx_t payload_idx = 0;
+	for (idx_t aggr_idx = 0; aggr_idx < op.bindings.size(); aggr_idx++) {
+		auto &aggr = *op.bindings[aggr_idx];
+		if (!aggr.distinct) {
+			non_distinct_indices.push_back(aggr_idx);
+			parallel_bindings.push_back(&aggr);
+			payload_idx += aggr.children.size();
+			continue;
+		}
+		distinct_indices.push_back(aggr_idx);
+		distinct_payload_offsets.push_back(payload_idx);
+		vector<LogicalType> types(group_types);
+		for (auto &child : aggr.children) {
+			types.push_back(child->return_type);
+		}
+		distinct_types.push_back(move(types));
+
+		auto copy = aggr.Copy();
+		auto &parallel_aggr = (BoundAggregateExpression &)*copy;
+		parallel_aggr.distinct = false;
+		parallel_aggr.filter = nullptr;
+		parallel_bindings.push_back(&parallel_aggr);
+		parallel_aggregates.push_back(move(copy));
+		payload_idx += aggr.children.size();
+	}
 }
 
 //===--------------------------------------------------------------------===//
@@ -47,8 +77,18 @@ RadixPartitionedHashTable::RadixPartitionedHashTable(GroupingSet &grouping_set_p
 class RadixHTGlobalState : public GlobalSinkState {
 public:
 	explicit RadixHTGlobalState(ClientContext &context)
-	    : is_empty(true), multi_scan(true), total_groups(0),
-	      partition_info((idx_t)TaskScheduler::GetScheduler(context).NumberOfThreads()) {
+	    : is_empty(true), multi_scan(false), total_groups(0),
+	      partition_info((idx_t)TaskScheduler::GetScheduler(context).NumberOfThreads()),
+	      buffer_manager(BufferManager::GetBufferManager(context)), intermediate_size(0) {
+		if (buffer_manager.GetTemporaryDirectory().empty()) {
+			// without a temporary directory the partitions cannot be evicted, spilling would only copy the groups
+			max_ht_size = NumericLimits<idx_t>::Maximum();
+			max_local_size = NumericLimits<idx_t>::Maximum();
+		} else {
+			max_ht_size = buffer_manager.GetMaxMemory() / 2;
+			max_local_size = max_ht_size / TaskScheduler::GetScheduler(context).NumberOfThreads();
+		}
+		force_external = ClientConfig::GetConfig(context).force_external;
 	}
 
 	vector<unique_ptr<PartitionableHashTable>> intermediate_hts;
@@ -67,6 +107,46 @@ public:
 	bool is_partitioned = false;
 
 	RadixPartitionInfo partition_info;
+
+	BufferManager &buffer_manager;
+	//! The maximum size (in bytes) of the HTs, if the groups take up more space the aggregate goes out-of-core
+	idx_t max_ht_size;
+	//! The maximum size (in bytes) of a thread-local HT
+	idx_t max_local_size;
+	//! The size (in bytes) of the thread-local HTs that were combined into intermediate_hts
+	idx_t intermediate_size;
+	//! Whether or not the aggregate goes out-of-core as soon as possible (PRAGMA debug_force_external)
+	bool force_external;
+	//! Whether or not the aggregate has gone out-of-core
+	bool external = false;
+	//! The radix-partitioned groups (only used if external). Each partition is aggregated separately while scanning.
+	unique_ptr<PartitionedRowData> partitions;
+	//! For every DISTINCT aggregate, the thread-local distinct HTs
+	vector<vector<unique_ptr<PartitionableHashTable>>> distinct_intermediate_hts;
+
+public:
+	//! Write the groups of the given HT to the partitions. The lock must be held.
+	void Spill(GroupedAggregateHashTable &ht) {
+		if (!partitions) {
+			partitions = make_unique<PartitionedRowData>(buffer_manager, ht.GetLayout(),
+			                                             RadixPartitionedHashTable::EXTERNAL_RADIX_BITS);
+		}
+		external = true;
+		ht.Partition(*partitions);
+	}
+	void Spill(PartitionableHashTable &pht) {
+		for (auto &ht : pht.GetAll()) {
+			Spill(*ht);
+		}
+	}
+	//! Write the groups of all intermediate HTs to the partitions. The lock must be held.
+	void SpillIntermediates() {
+		for (auto &pht : intermediate_hts) {
+			Spill(*pht);
+		}
+		intermediate_hts.clear();
+		intermediate_size = 0;
+	}
 };
 
 class RadixHTLocalState : public LocalSinkState {
@@ -82,9 +162,18 @@ public:
 	DataChunk group_chunk;
 	//! The aggregate HT
 	unique_ptr<PartitionableHashTable> ht;
+	//! For every DISTINCT aggregate, the HT that holds the distinct (groups, arguments) combinations
+	vector<unique_ptr<PartitionableHashTable>> distinct_hts;
 
 	//! Whether or not any tuples were added to the HT
 	bool is_empty;
+	//! The amount of rows that were pre-aggregated, and the amount of new groups they created
+	idx_t preaggregated_rows = 0;
+	idx_t preaggregated_groups = 0;
+	//! Whether or not pre-aggregation has been switched off because it did not reduce the amount of groups enough
+	bool passthrough = false;
+	//! The amount of rows that were appended to the partitions without being pre-aggregated
+	idx_t passthrough_rows = 0;
 };
 
 void RadixPartitionedHashTable::SetMultiScan(GlobalSinkState &state) {
@@ -100,6 +189,44 @@ unique_ptr<LocalSinkState> RadixPartitionedHashTable::GetLocalSinkState(Executio
 	return make_unique<RadixHTLocalState>(*this);
 }
 
+static void SinkDistinct(const RadixPartitionedHashTable &rht, ClientContext &context, RadixHTGlobalState &gstate,
+                         RadixHTLocalState &llstate, DataChunk &group_chunk, DataChunk &aggregate_input_chunk) {
+	if (llstate.distinct_hts.empty()) {
+		for (auto &types : rht.distinct_types) {
+			llstate.distinct_hts.push_back(make_unique<PartitionableHashTable>(
+			    BufferManager::GetBufferManager(context), gstate.partition_info, types, vector<LogicalType>(),
+			    vector<BoundAggregateExpression *>()));
+		}
+	}
+	// the distinct HTs have no aggregates, they only keep track of the distinct (groups, arguments) combinations
+	DataChunk payload;
+	const vector<idx_t> filter;
+	for (idx_t distinct_idx = 0; distinct_idx < rht.distinct_indices.size(); distinct_idx++) {
+		auto &aggr = *rht.op.bindings[rht.distinct_indices[distinct_idx]];
+		DataChunk distinct_chunk;
+		distinct_chunk.InitializeEmpty(rht.distinct_types[distinct_idx]);
+		idx_t chunk_index = 0;
+		for (idx_t i = 0; i < group_chunk.ColumnCount(); i++) {
+			distinct_chunk.data[chunk_index++].Reference(group_chunk.data[i]);
+		}
+		for (idx_t i = 0; i < aggr.children.size(); i++) {
+			auto payload_idx = rht.distinct_payload_offsets[distinct_idx] + i;
+			distinct_chunk.data[chunk_index++].Reference(aggregate_input_chunk.data[payload_idx]);
+		}
+		distinct_chunk.SetCardinality(group_chunk);
+		if (aggr.filter) {
+			// only the rows that pass the FILTER of the aggregate are counted
+			ExpressionExecutor filter_execution(*aggr.filter);
+			SelectionVector true_sel(STANDARD_VECTOR_SIZE);
+			auto count = filter_execution.SelectExpression(aggregate_input_chunk, true_sel);
+			distinct_chunk.Slice(true_sel, count);
+		}
+		payload.SetCardinality(distinct_chunk);
+		// the distinct HTs are always partitioned, so they can be merged in parallel
+		llstate.distinct_hts[distinct_idx]->AddChunk(distinct_chunk, payload, true, filter);
+	}
+}
+
 void RadixPartitionedHashTable::Sink(ExecutionContext &context, GlobalSinkState &state, LocalSinkState &lstate,
                                      DataChunk &input, DataChunk &aggregate_input_chunk) const {
 	auto &llstate = (RadixHTLocalState &)lstate;
@@ -117,8 +244,8 @@ void RadixPartitionedHashTable::Sink(ExecutionContext &context, GlobalSinkState
 	group_chunk.SetCardinality(input.size());
 	group_chunk.Verify();
 
-	// if we have non-combinable aggregates (e.g. string_agg) or any distinct aggregates we cannot keep parallel hash
-	// tables
+	// if we have non-combinable aggregates (e.g. string_agg) we cannot keep parallel hash tables
+	// distinct aggregates are computed in the single HT as well when we are running single-threaded
 	if (ForceSingleHT(state)) {
 		lock_guard<mutex> glock(gstate.lock);
 		gstate.is_empty = gstate.is_empty && group_chunk.size() == 0;
@@ -130,11 +257,16 @@ void RadixPartitionedHashTable::Sink(ExecutionContext &context, GlobalSinkState
 		D_ASSERT(gstate.finalized_hts.size() == 1);
 		D_ASSERT(gstate.finalized_hts[0]);
 		gstate.total_groups += gstate.finalized_hts[0]->AddChunk(group_chunk, aggregate_input_chunk);
+		if (CanGoExternal() &&
+		    (gstate.force_external || gstate.finalized_hts[0]->SizeInBytes() > gstate.max_ht_size)) {
+			// the groups do not fit in memory: write them to the partitions and start over with an empty HT
+			gstate.Spill(*gstate.finalized_hts[0]);
+			gstate.finalized_hts.clear();
+		}
 		return;
 	}
 
 	D_ASSERT(op.all_combinable);
-	D_ASSERT(!op.any_distinct);
 
 	if (group_chunk.size() > 0) {
 		llstate.is_empty = false;
@@ -143,12 +275,42 @@ void RadixPartitionedHashTable::Sink(ExecutionContext &context, GlobalSinkState
 	if (!llstate.ht) {
 		llstate.ht =
 		    make_unique<PartitionableHashTable>(BufferManager::GetBufferManager(context.client), gstate.partition_info,
-		                                        group_types, op.payload_types, op.bindings);
+		                                        group_types, op.payload_types, parallel_bindings);
+	}
+
+	// the DISTINCT aggregates are not updated here, they are computed from the distinct HTs after the sink
+	if (llstate.passthrough) {
+		// pre-aggregation does not pay off: the groups of these rows are only looked up when combining the partitions
+		gstate.total_groups += llstate.ht->AppendChunk(group_chunk, aggregate_input_chunk, non_distinct_indices);
+		llstate.passthrough_rows += group_chunk.size();
+	} else {
+		auto new_groups =
+		    llstate.ht->AddChunk(group_chunk, aggregate_input_chunk,
+		                         gstate.total_groups > radix_limit && gstate.partition_info.n_partitions > 1,
+		                         non_distinct_indices);
+		gstate.total_groups += new_groups;
+		llstate.preaggregated_rows += group_chunk.size();
+		llstate.preaggregated_groups += new_groups;
+		// (almost) every row creates a new group: pre-aggregating only copies the rows before they are partitioned
+		if (llstate.preaggregated_rows >= ADAPTIVE_SAMPLE_SIZE &&
+		    llstate.preaggregated_groups > llstate.preaggregated_rows * ADAPTIVE_MAX_GROUP_RATIO) {
+			llstate.passthrough = true;
+		}
+	}
+	if (!distinct_indices.empty()) {
+		SinkDistinct(*this, context.client, gstate, llstate, group_chunk, aggregate_input_chunk);
 	}
 
-	gstate.total_groups +=
-	    llstate.ht->AddChunk(group_chunk, aggregate_input_chunk,
-	                         gstate.total_groups > radix_limit && gstate.partition_info.n_partitions > 1);
+	if (CanGoExternal() && (gstate.force_external || llstate.ht->SizeInBytes() > gstate.max_local_size)) {
+		// the thread-local groups do not fit in memory: write them to the partitions and start over with an empty HT
+		lock_guard<mutex> glock(gstate.lock);
+		if (!llstate.is_empty) {
+			gstate.is_empty = false;
+		}
+		gstate.Spill(*llstate.ht);
+		gstate.SpillIntermediates();
+		llstate.ht.reset();
+	}
 }
 
 void RadixPartitionedHashTable::Combine(ExecutionContext &context, GlobalSinkState &state,
@@ -165,6 +327,15 @@ void RadixPartitionedHashTable::Combine(ExecutionContext &context, GlobalSinkSta
 		return;
 	}
 
+	// report which rows were pre-aggregated and which were passed through to the partitions
+	auto &profiler = context.thread.profiler;
+	if (llstate.preaggregated_rows > 0) {
+		profiler.AddCounter(&op, "preaggregated_rows", llstate.preaggregated_rows);
+	}
+	if (llstate.passthrough_rows > 0) {
+		profiler.AddCounter(&op, "passthrough_rows", llstate.passthrough_rows);
+	}
+
 	if (!llstate.ht) {
 		return; // no data
 	}
@@ -175,7 +346,6 @@ void RadixPartitionedHashTable::Combine(ExecutionContext &context, GlobalSinkSta
 
 	lock_guard<mutex> glock(gstate.lock);
 	D_ASSERT(op.all_combinable);
-	D_ASSERT(!op.any_distinct);
 
 	if (!llstate.is_empty) {
 		gstate.is_empty = false;
@@ -184,6 +354,22 @@ void RadixPartitionedHashTable::Combine(ExecutionContext &context, GlobalSinkSta
 	// we will never add new values to these HTs so we can drop the first part of the HT
 	llstate.ht->Finalize();
 
+	if (!llstate.distinct_hts.empty()) {
+		gstate.distinct_intermediate_hts.resize(distinct_indices.size());
+		for (idx_t distinct_idx = 0; distinct_idx < distinct_indices.size(); distinct_idx++) {
+			llstate.distinct_hts[distinct_idx]->Finalize();
+			gstate.distinct_intermediate_hts[distinct_idx].push_back(move(llstate.distinct_hts[distinct_idx]));
+		}
+	}
+
+	gstate.intermediate_size += llstate.ht->SizeInBytes();
+	if (CanGoExternal() && (gstate.external || gstate.intermediate_size > gstate.max_ht_size)) {
+		// the groups do not fit in memory: write them to the partitions
+		gstate.Spill(*llstate.ht);
+		gstate.SpillIntermediates();
+		return;
+	}
+
 	// at this point we just collect them the PhysicalHashAggregateFinalizeTask (below) will merge them in parallel
 	gstate.intermediate_hts.push_back(move(llstate.ht));
 }
@@ -193,6 +379,18 @@ bool RadixPartitionedHashTable::Finalize(ClientContext &context, GlobalSinkState
 	D_ASSERT(!gstate.is_finalized);
 	gstate.is_finalized = true;
 
+	if (gstate.external) {
+		// the aggregate has gone out-of-core: write the remaining groups to the partitions
+		// the partitions are aggregated one at a time while scanning, so only one of them is in memory at a time
+		for (auto &ht : gstate.finalized_hts) {
+			gstate.Spill(*ht);
+		}
+		gstate.SpillIntermediates();
+		gstate.finalized_hts.clear();
+		gstate.finalized_hts.resize(gstate.partitions->PartitionCount());
+		return false;
+	}
+
 	// special case if we have non-combinable aggregates
 	// we have already aggreagted into a global shared HT that does not require any additional finalization steps
 	if (ForceSingleHT(gstate)) {
@@ -225,7 +423,7 @@ bool RadixPartitionedHashTable::Finalize(ClientContext &context, GlobalSinkState
 		for (idx_t r = 0; r < gstate.partition_info.n_partitions; r++) {
 			gstate.finalized_hts[r] =
 			    make_unique<GroupedAggregateHashTable>(BufferManager::GetBufferManager(context), group_types,
-			                                           op.payload_types, op.bindings, HtEntryType::HT_WIDTH_64);
+			                                           op.payload_types, parallel_bindings, HtEntryType::HT_WIDTH_64);
 		}
 		gstate.is_partitioned = true;
 		return true;
@@ -235,7 +433,7 @@ bool RadixPartitionedHashTable::Finalize(ClientContext &context, GlobalSinkState
 
 		gstate.finalized_hts.push_back(make_unique<GroupedAggregateHashTable>(BufferManager::GetBufferManager(context),
 		                                                                      group_types, op.payload_types,
-		                                                                      op.bindings, HtEntryType::HT_WIDTH_64));
+		                                                                      parallel_bindings, HtEntryType::HT_WIDTH_64));
 		for (auto &pht : gstate.intermediate_hts) {
 			auto unpartitioned = pht->GetUnpartitioned();
 			for (auto &unpartitioned_ht : unpartitioned) {
@@ -297,9 +495,112 @@ void RadixPartitionedHashTable::ScheduleTasks(Executor &executor, const shared_p
 	}
 }
 
+// this task is run in multiple threads, it merges one radix partition of the thread-local distinct HTs of a DISTINCT
+// aggregate and aggregates the distinct (groups, arguments) combinations into an intermediate HT
+class RadixDistinctFinalizeTask : public ExecutorTask {
+public:
+	RadixDistinctFinalizeTask(Executor &executor, shared_ptr<Event> event_p, const RadixPartitionedHashTable &ht_p,
+	                          RadixHTGlobalState &state_p, idx_t distinct_idx_p, idx_t radix_p)
+	    : ExecutorTask(executor), event(move(event_p)), ht(ht_p), state(state_p), distinct_idx(distinct_idx_p),
+	      radix(radix_p) {
+	}
+
+	static void FinalizeDistinct(const RadixPartitionedHashTable &rht, RadixHTGlobalState &gstate, idx_t distinct_idx,
+	                             idx_t radix) {
+		auto &op = rht.op;
+		const vector<idx_t> filter {rht.distinct_indices[distinct_idx]};
+		auto &aggr = *op.bindings[filter[0]];
+		const auto group_count = rht.group_types.size();
+
+		// the (groups, arguments) combinations have only been deduplicated per thread, so we deduplicate them again
+		GroupedAggregateHashTable distinct_ht(gstate.buffer_manager, rht.distinct_types[distinct_idx]);
+		auto result = make_unique<PartitionableHashTable>(gstate.buffer_manager, gstate.partition_info,
+		                                                  rht.group_types, op.payload_types, rht.parallel_bindings);
+
+		DataChunk scan_chunk;
+		scan_chunk.Initialize(rht.distinct_types[distinct_idx]);
+		DataChunk group_chunk;
+		group_chunk.InitializeEmpty(rht.group_types);
+		// only the arguments of this aggregate are used, the other payload columns are set to NULL
+		DataChunk payload;
+		payload.InitializeEmpty(op.payload_types);
+		for (idx_t i = 0; i < payload.ColumnCount(); i++) {
+			payload.data[i].Reference(Value(op.payload_types[i]));
+		}
+		Vector addresses(LogicalType::POINTER);
+		SelectionVector new_groups(STANDARD_VECTOR_SIZE);
+
+		for (auto &pht : gstate.distinct_intermediate_hts[distinct_idx]) {
+			for (auto &ht : pht->GetPartition(radix)) {
+				idx_t scan_position = 0;
+				while (true) {
+					scan_chunk.Reset();
+					if (ht->Scan(scan_position, scan_chunk) == 0) {
+						break;
+					}
+					auto new_count = distinct_ht.FindOrCreateGroups(scan_chunk, addresses, new_groups);
+					if (new_count == 0) {
+						continue;
+					}
+					scan_chunk.Slice(new_groups, new_count);
+					for (idx_t i = 0; i < group_count; i++) {
+						group_chunk.data[i].Reference(scan_chunk.data[i]);
+					}
+					for (idx_t i = 0; i < aggr.children.size(); i++) {
+						payload.data[rht.distinct_payload_offsets[distinct_idx] + i].Reference(
+						    scan_chunk.data[group_count + i]);
+					}
+					group_chunk.SetCardinality(new_count);
+					payload.SetCardinality(new_count);
+					result->AddChunk(group_chunk, payload, gstate.total_groups > rht.radix_limit, filter);
+				}
+				ht.reset();
+			}
+		}
+		result->Finalize();
+
+		// the result is combined with the other intermediate HTs in Finalize
+		lock_guard<mutex> glock(gstate.lock);
+		gstate.intermediate_hts.push_back(move(result));
+	}
+
+	TaskExecutionResult ExecuteTask(TaskExecutionMode mode) override {
+		FinalizeDistinct(ht, state, distinct_idx, radix);
+		event->FinishTask();
+		return TaskExecutionResult::TASK_FINISHED;
+	}
+
+private:
+	shared_ptr<Event> event;
+	const RadixPartitionedHashTable &ht;
+	RadixHTGlobalState &state;
+	idx_t distinct_idx;
+	idx_t radix;
+};
+
+bool RadixPartitionedHashTable::HasDistinctData(GlobalSinkState &state) const {
+	auto &gstate = (RadixHTGlobalState &)state;
+	return !gstate.distinct_intermediate_hts.empty();
+}
+
+void RadixPartitionedHashTable::ScheduleDistinctTasks(Executor &executor, const shared_ptr<Event> &event,
+                                                      GlobalSinkState &state, vector<unique_ptr<Task>> &tasks) const {
+	auto &gstate = (RadixHTGlobalState &)state;
+	for (idx_t distinct_idx = 0; distinct_idx < gstate.distinct_intermediate_hts.size(); distinct_idx++) {
+		for (idx_t r = 0; r < gstate.partition_info.n_partitions; r++) {
+			tasks.push_back(make_unique<RadixDistinctFinalizeTask>(executor, event, *this, gstate, distinct_idx, r));
+		}
+	}
+}
+
 bool RadixPartitionedHashTable::ForceSingleHT(GlobalSinkState &state) const {
 	auto &gstate = (RadixHTGlobalState &)state;
-	return !op.all_combinable || op.any_distinct || gstate.partition_info.n_partitions < 2;
+	return !op.all_combinable || gstate.partition_info.n_partitions < 2;
+}
+
+bool RadixPartitionedHashTable::CanGoExternal() const {
+	// the partitions are aggregated separately, which requires the aggregate states to be combinable
+	return op.all_combinable && !op.any_distinct;
 }
 
 //===--------------------------------------------------------------------===//
@@ -370,6 +671,15 @@ void RadixPartitionedHashTable::GetData(ExecutionContext &context, DataChunk &ch
 			state.finished = true;
 			return;
 		}
+		if (gstate.external && !gstate.finalized_hts[state.ht_index]) {
+			// aggregate the groups of the next partition
+			auto ht = make_unique<GroupedAggregateHashTable>(BufferManager::GetBufferManager(context.client),
+			                                                 group_types, op.payload_types, op.bindings,
+			                                                 HtEntryType::HT_WIDTH_64);
+			ht->Combine(*gstate.partitions, state.ht_index);
+			ht->Finalize();
+			gstate.finalized_hts[state.ht_index] = move(ht);
+		}
 		D_ASSERT(gstate.finalized_hts[state.ht_index]);
 		elements_found = gstate.finalized_hts[state.ht_index]->Scan(state.ht_scan_position, state.scan_chunk);
 
@@ -19,6 +19,11 @@ static DefaultCompressionMethod internal_compression_methods[] = {
     {CompressionType::COMPRESSION_UNCOMPRESSED, UncompressedFun::GetFunction, UncompressedFun::TypeIsSupported},
     {CompressionType::COMPRESSION_RLE, RLEFun::GetFunction, RLEFun::TypeIsSupported},
     {CompressionType::COMPRESSION_BITPACKING, BitpackingFun::GetFunction, BitpackingFun::TypeIsSupported},
+    {CompressionType::COMPRESSION_PFOR_DELTA, PFORDeltaFun::GetFunction, PFORDeltaFun::TypeIsSupported},
+    {CompressionType::COMPRESSION_DICTIONARY, DictionaryCompressionFun::GetFunction,
+     DictionaryCompressionFun::TypeIsSupported},
+    {CompressionType::COMPRESSION_FSST, FSSTFun::GetFunction, FSSTFun::TypeIsSupported},
+    {CompressionType::COMPRESSION_CHIMP, ChimpCompressionFun::GetFunction, ChimpCompressionFun::TypeIsSupported},
     {CompressionType::COMPRESSION_AUTO, nullptr, nullptr}};
 
 static CompressionFunction *FindCompressionFunction(CompressionFunctionSet &set, CompressionType type,
@@ -68,6 +73,10 @@ vector<CompressionFunction *> DBConfig::GetCompressionFunctions(PhysicalType dat
 	TryLoadCompression(*this, result, CompressionType::COMPRESSION_UNCOMPRESSED, data_type);
 	TryLoadCompression(*this, result, CompressionType::COMPRESSION_RLE, data_type);
 	TryLoadCompression(*this, result, CompressionType::COMPRESSION_BITPACKING, data_type);
+	TryLoadCompression(*this, result, CompressionType::COMPRESSION_PFOR_DELTA, data_type);
+	TryLoadCompression(*this, result, CompressionType::COMPRESSION_DICTIONARY, data_type);
+	TryLoadCompression(*this, result, CompressionType::COMPRESSION_FSST, data_type);
+	TryLoadCompression(*this, result, CompressionType::COMPRESSION_CHIMP, data_type);
 	return result;
 }
 
@@ -2,14 +2,18 @@
 #include "duckdb/execution/operator/persistent/buffered_csv_reader.hpp"
 #include "duckdb/function/function_set.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_config.hpp"
 #include "duckdb/main/database.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/main/config.hpp"
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/parser/expression/function_expression.hpp"
 #include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/parallel/parallel_state.hpp"
+#include "duckdb/common/deque.hpp"
 #include "duckdb/common/windows_undefs.hpp"
 
+#include <condition_variable>
 #include <limits>
 
 namespace duckdb {
@@ -138,10 +142,18 @@ static unique_ptr<FunctionData> ReadCSVBind(ClientContext &context, vector<Value
 		} else {
 			D_ASSERT(return_types.size() == names.size());
 		}
+		if (initial_reader->plain_file_source) {
+			result->first_file_size = initial_reader->file_size;
+		}
 		result->initial_reader = move(initial_reader);
 	} else {
 		result->sql_types = return_types;
 		D_ASSERT(return_types.size() == names.size());
+		auto file_handle = fs.OpenFile(result->files[0], FileFlags::FILE_FLAGS_READ, FileLockType::NO_LOCK,
+		                               options.compression, FileSystem::GetFileOpener(context));
+		if (file_handle->OnDiskFile() && file_handle->CanSeek()) {
+			result->first_file_size = file_handle->GetFileSize();
+		}
 	}
 	if (result->include_file_name) {
 		return_types.emplace_back(LogicalType::VARCHAR);
@@ -155,6 +167,8 @@ struct ReadCSVOperatorData : public FunctionOperatorData {
 	unique_ptr<BufferedCSVReader> csv_reader;
 	//! The index of the next file to read (i.e. current file + 1)
 	idx_t file_index;
+	//! Whether or not the reader only reads a byte range of the file handed out by the parallel state
+	bool is_parallel = false;
 };
 
 static unique_ptr<FunctionOperatorData> ReadCSVInit(ClientContext &context, const FunctionData *bind_data_p,
@@ -185,21 +199,32 @@ static unique_ptr<FunctionData> ReadCSVAutoBind(ClientContext &context, vector<V
 
 static void ReadCSVFunction(ClientContext &context, const FunctionData *bind_data_p,
                             FunctionOperatorData *operator_state, DataChunk *input, DataChunk &output) {
+	if (!operator_state) {
+		return;
+	}
 	auto &bind_data = (ReadCSVData &)*bind_data_p;
 	auto &data = (ReadCSVOperatorData &)*operator_state;
-	do {
+	if (data.is_parallel) {
+		// the parallel state hands out the next byte range once this one is exhausted
+		idx_t previous_bytes = data.csv_reader->bytes_in_chunk;
 		data.csv_reader->ParseCSV(output);
-		bind_data.bytes_read = data.csv_reader->bytes_in_chunk;
-		if (output.size() == 0 && data.file_index < bind_data.files.size()) {
-			// exhausted this file, but we have more files we can read
-			// open the next file and increment the counter
-			bind_data.options.file_path = bind_data.files[data.file_index];
-			data.csv_reader = make_unique<BufferedCSVReader>(context, bind_data.options, data.csv_reader->sql_types);
-			data.file_index++;
-		} else {
-			break;
-		}
-	} while (true);
+		bind_data.bytes_read += data.csv_reader->bytes_in_chunk - previous_bytes;
+	} else {
+		do {
+			data.csv_reader->ParseCSV(output);
+			bind_data.bytes_read = data.csv_reader->bytes_in_chunk;
+			if (output.size() == 0 && data.file_index < bind_data.files.size()) {
+				// exhausted this file, but we have more files we can read
+				// open the next file and increment the counter
+				bind_data.options.file_path = bind_data.files[data.file_index];
+				data.csv_reader =
+				    make_unique<BufferedCSVReader>(context, bind_data.options, data.csv_reader->sql_types);
+				data.file_index++;
+			} else {
+				break;
+			}
+		} while (true);
+	}
 	if (bind_data.include_file_name) {
 		auto &col = output.data.back();
 		col.SetValue(0, Value(data.csv_reader->options.file_path));
@@ -207,6 +232,186 @@ static void ReadCSVFunction(ClientContext &context, const FunctionData *bind_dat
 	}
 }
 
+//! The size of the byte ranges that CSV files are split into when they are read in parallel
+static constexpr idx_t CSV_BYTE_RANGE_SIZE = 8 * 1024 * 1024;
+//! The size of the byte ranges when parallelism is forced for testing
+static constexpr idx_t CSV_VERIFY_BYTE_RANGE_SIZE = 1024;
+
+static idx_t ReadCSVByteRangeSize(ClientContext &context) {
+	return ClientConfig::GetConfig(context).verify_parallelism ? CSV_VERIFY_BYTE_RANGE_SIZE : CSV_BYTE_RANGE_SIZE;
+}
+
+//! A file of a parallel scan that has been opened, and whose byte ranges are being handed out
+struct ReadCSVParallelFile {
+	//! The options to read the file with (after auto-detection)
+	BufferedCSVReaderOptions options;
+	//! The file offset at which the next byte range begins
+	idx_t next_offset;
+	//! The size of the file
+	idx_t file_size;
+};
+
+struct ReadCSVParallelState : public ParallelState {
+	mutex lock;
+	//! Signalled whenever a file has been opened
+	std::condition_variable file_opened;
+	//! The types of the columns to read
+	vector<LogicalType> sql_types;
+	//! The size of the byte ranges that the files are split into
+	idx_t range_size;
+	//! The index of the next file to open
+	idx_t file_index = 0;
+	//! The amount of files that are currently being opened
+	idx_t files_opening = 0;
+	//! The opened files that have byte ranges left to hand out
+	deque<ReadCSVParallelFile> files;
+};
+
+static idx_t ReadCSVMaxThreads(ClientContext &context, const FunctionData *bind_data_p) {
+	auto &bind_data = (const ReadCSVData &)*bind_data_p;
+	// estimate the amount of byte ranges from the size of the first file, which is determined during binding
+	idx_t ranges_per_file = 1 + bind_data.first_file_size / ReadCSVByteRangeSize(context);
+	return bind_data.files.size() * ranges_per_file;
+}
+
+static unique_ptr<ParallelState> ReadCSVInitParallelState(ClientContext &context, const FunctionData *bind_data_p,
+                                                          const vector<column_t> &column_ids,
+                                                          TableFilterCollection *filters) {
+	auto &bind_data = (ReadCSVData &)*bind_data_p;
+	auto result = make_unique<ReadCSVParallelState>();
+	if (bind_data.options.auto_detect && !bind_data.initial_reader) {
+		// the initial reader has been consumed by an earlier scan: detect the first file again
+		bind_data.options.file_path = bind_data.files[0];
+		bind_data.initial_reader = make_unique<BufferedCSVReader>(context, bind_data.options);
+	}
+	// the other files are read with the types of the first file
+	result->sql_types = bind_data.options.auto_detect ? bind_data.initial_reader->sql_types : bind_data.sql_types;
+	result->range_size = ReadCSVByteRangeSize(context);
+	bind_data.bytes_read = 0;
+	bind_data.file_size = 0;
+	return move(result);
+}
+
+//! Opens a file of a parallel scan and sets up the reader of its first byte range, which reads past the header.
+//! This detects the dialect of the file, so it is called without holding the lock of the parallel state.
+static unique_ptr<BufferedCSVReader> ReadCSVOpenFile(ClientContext &context, ReadCSVData &bind_data,
+                                                     ReadCSVParallelState &state, idx_t file_index,
+                                                     ReadCSVParallelFile &file) {
+	auto options = bind_data.options;
+	options.file_path = bind_data.files[file_index];
+	if (options.auto_detect) {
+		// detect the dialect of every file, as the sequential scan does
+		unique_ptr<BufferedCSVReader> detect_reader;
+		if (file_index == 0 && bind_data.initial_reader) {
+			detect_reader = move(bind_data.initial_reader);
+		} else {
+			detect_reader = make_unique<BufferedCSVReader>(context, options, state.sql_types);
+		}
+		options = detect_reader->options;
+		options.auto_detect = false;
+	}
+	auto reader = make_unique<BufferedCSVReader>(context, options, state.sql_types);
+	file.file_size = reader->file_size;
+	// a file that cannot be split is read as a whole by this reader
+	file.next_offset = reader->CanReadByteRanges() ? reader->GetFileOffset() : file.file_size;
+	file.options = move(options);
+	return reader;
+}
+
+static bool ReadCSVParallelStateNext(ClientContext &context, const FunctionData *bind_data_p,
+                                     FunctionOperatorData *operator_state, ParallelState *parallel_state_p) {
+	if (!operator_state) {
+		return false;
+	}
+	auto &bind_data = (ReadCSVData &)*bind_data_p;
+	auto &data = (ReadCSVOperatorData &)*operator_state;
+	auto &parallel_state = (ReadCSVParallelState &)*parallel_state_p;
+
+	ReadCSVParallelFile file;
+	unique_ptr<BufferedCSVReader> first_reader;
+	idx_t range_begin;
+	{
+		unique_lock<mutex> parallel_lock(parallel_state.lock);
+		while (parallel_state.files.empty()) {
+			if (parallel_state.file_index < bind_data.files.size()) {
+				// open the next file ourselves, and read its first byte range
+				idx_t file_index = parallel_state.file_index++;
+				parallel_state.files_opening++;
+				parallel_lock.unlock();
+				try {
+					first_reader = ReadCSVOpenFile(context, bind_data, parallel_state, file_index, file);
+				} catch (...) {
+					parallel_lock.lock();
+					parallel_state.files_opening--;
+					parallel_state.file_opened.notify_all();
+					throw;
+				}
+				parallel_lock.lock();
+				parallel_state.files_opening--;
+				bind_data.file_size += file.file_size;
+				break;
+			}
+			if (parallel_state.files_opening == 0) {
+				// all files have been opened and all their byte ranges have been handed out
+				return false;
+			}
+			// wait for the files that are being opened by other threads, as they may be split into more byte ranges
+			parallel_state.file_opened.wait(parallel_lock);
+		}
+		if (!first_reader) {
+			file = parallel_state.files.front();
+			parallel_state.files.pop_front();
+		}
+		range_begin = file.next_offset;
+		file.next_offset = MinValue<idx_t>(range_begin + parallel_state.range_size, file.file_size);
+		if (file.next_offset < file.file_size) {
+			// hand out the remaining byte ranges of this file to the other threads
+			parallel_state.files.push_back(file);
+		}
+		if (first_reader) {
+			parallel_state.file_opened.notify_all();
+		}
+	}
+	if (first_reader && !first_reader->CanReadByteRanges()) {
+		// the file is read as a whole by the reader that opened it
+		data.csv_reader = move(first_reader);
+		return true;
+	}
+	// the byte range is read from the first row that starts in it, up to the first row that starts in the next range
+	idx_t range_end = file.next_offset;
+	if (first_reader) {
+		data.csv_reader = move(first_reader);
+	} else {
+		// the header and the skipped rows are only read by the reader of the first byte range
+		auto range_options = file.options;
+		range_options.skip_rows = 0;
+		range_options.header = false;
+		data.csv_reader = make_unique<BufferedCSVReader>(context, move(range_options), parallel_state.sql_types);
+		data.csv_reader->options.skip_rows = file.options.skip_rows;
+		data.csv_reader->options.header = file.options.header;
+		range_begin = data.csv_reader->FindRowStart(range_begin);
+	}
+	if (range_end < file.file_size) {
+		range_end = data.csv_reader->FindRowStart(range_end);
+	} else {
+		range_end = NumericLimits<idx_t>::Maximum();
+	}
+	data.csv_reader->SetByteRange(range_begin, range_end);
+	return true;
+}
+
+static unique_ptr<FunctionOperatorData> ReadCSVParallelInit(ClientContext &context, const FunctionData *bind_data_p,
+                                                            ParallelState *parallel_state_p,
+                                                            const vector<column_t> &column_ids,
+                                                            TableFilterCollection *filters) {
+	auto result = make_unique<ReadCSVOperatorData>();
+	result->is_parallel = true;
+	if (!ReadCSVParallelStateNext(context, bind_data_p, result.get(), parallel_state_p)) {
+		return nullptr;
+	}
+	return move(result);
+}
+
 static void ReadCSVAddNamedParameters(TableFunction &table_function) {
 	table_function.named_parameters["sep"] = LogicalType::VARCHAR;
 	table_function.named_parameters["delim"] = LogicalType::VARCHAR;
@@ -240,6 +445,10 @@ double CSVReaderProgress(ClientContext &context, const FunctionData *bind_data_p
 TableFunction ReadCSVTableFunction::GetFunction() {
 	TableFunction read_csv("read_csv", {LogicalType::VARCHAR}, ReadCSVFunction, ReadCSVBind, ReadCSVInit);
 	read_csv.table_scan_progress = CSVReaderProgress;
+	read_csv.max_threads = ReadCSVMaxThreads;
+	read_csv.init_parallel_state = ReadCSVInitParallelState;
+	read_csv.parallel_init = ReadCSVParallelInit;
+	read_csv.parallel_state_next = ReadCSVParallelStateNext;
 	ReadCSVAddNamedParameters(read_csv);
 	return read_csv;
 }
@@ -249,6 +458,10 @@ void ReadCSVTableFunction::RegisterFunction(BuiltinFunctions &set) {
 
 	TableFunction read_csv_auto("read_csv_auto", {LogicalType::VARCHAR}, ReadCSVFunction, ReadCSVAutoBind, ReadCSVInit);
 	read_csv_auto.table_scan_progress = CSVReaderProgress;
+	read_csv_auto.max_threads = ReadCSVMaxThreads;
+	read_csv_auto.init_parallel_state = ReadCSVInitParallelState;
+	read_csv_auto.parallel_init = ReadCSVParallelInit;
+	read_csv_auto.parallel_state_next = ReadCSVParallelStateNext;
 	ReadCSVAddNamedParameters(read_csv_auto);
 	set.AddFunction(read_csv_auto);
 }
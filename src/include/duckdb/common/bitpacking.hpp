@@ -0,0 +1,234 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/bitpacking.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "bitpackinghelpers.h"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/limits.hpp"
+
+namespace duckdb {
+
+using bitpacking_width_t = uint8_t;
+
+class BitpackingPrimitives {
+public:
+	static constexpr const idx_t BITPACKING_ALGORITHM_GROUP_SIZE = 32;
+	static constexpr const idx_t BITPACKING_HEADER_SIZE = sizeof(uint64_t);
+	static constexpr const bool BYTE_ALIGNED = false;
+
+	// To ensure enough data is available, use GetRequiredSize() to determine the correct size for dst buffer
+	// Note: input should be aligned to BITPACKING_ALGORITHM_GROUP_SIZE for good performance.
+	template <class T>
+	inline static void PackBuffer(data_ptr_t dst, T *src, idx_t count, bitpacking_width_t width) {
+		idx_t misaligned_count = count % BITPACKING_ALGORITHM_GROUP_SIZE;
+		T tmp_buffer[BITPACKING_ALGORITHM_GROUP_SIZE];
+
+		count -= misaligned_count;
+
+		for (idx_t i = 0; i < count; i += BITPACKING_ALGORITHM_GROUP_SIZE) {
+			PackGroup<T>(dst + (i * width) / 8, src + i, width);
+		}
+
+		// The input is not aligned to BITPACKING_ALGORITHM_GROUP_SIZE, copy the remainder to a zeroed tmp buffer
+		if (misaligned_count) {
+			memset(tmp_buffer, 0, sizeof(tmp_buffer));
+			memcpy(tmp_buffer, src + count, misaligned_count * sizeof(T));
+			PackGroup<T>(dst + (count * width) / 8, tmp_buffer, width);
+		}
+	}
+
+	// Unpacks a buffer of BITPACKING_ALGORITHM_GROUP_SIZE aligned values
+	// Note: the dst buffer needs to be large enough to hold RoundUpToAlgorithmGroupSize(count) values
+	template <class T>
+	inline static void UnPackBuffer(data_ptr_t dst, data_ptr_t src, idx_t count, bitpacking_width_t width,
+	                                bool skip_sign_extension = false) {
+		for (idx_t i = 0; i < count; i += BITPACKING_ALGORITHM_GROUP_SIZE) {
+			UnPackGroup<T>(dst + i * sizeof(T), src + (i * width) / 8, width, skip_sign_extension);
+		}
+	}
+
+	// Packs a block of BITPACKING_ALGORITHM_GROUP_SIZE values
+	template <class T>
+	inline static void PackBlock(data_ptr_t dst, T *src, bitpacking_width_t width) {
+		return PackGroup<T>(dst, src, width);
+	}
+
+	// Unpacks a block of BITPACKING_ALGORITHM_GROUP_SIZE values
+	template <class T>
+	inline static void UnPackBlock(data_ptr_t dst, data_ptr_t src, bitpacking_width_t width,
+	                               bool skip_sign_extension = false) {
+		return UnPackGroup<T>(dst, src, width, skip_sign_extension);
+	}
+
+	// Calculates the minimum required number of bits per value that can store all values
+	template <class T>
+	inline static bitpacking_width_t MinimumBitWidth(T *values, idx_t count) {
+		return FindMinimumBitWidth<T, BYTE_ALIGNED>(values, count);
+	}
+
+	// Calculates the minimum required number of bits per value that can store a single (non-negative) value
+	template <class T>
+	inline static bitpacking_width_t MinimumBitWidth(T value) {
+		return MinimumBitWidth<T>((T)0, value);
+	}
+
+	// Calculates the minimum required number of bits per value that can store all values in the range [min, max]
+	template <class T>
+	inline static bitpacking_width_t MinimumBitWidth(T min_value, T max_value) {
+		bitpacking_width_t required_bits;
+
+		if (std::is_signed<T>::value) {
+			if (min_value == NumericLimits<T>::Minimum()) {
+				// handle special case of the minimal value, as it cannot be negated like all other values.
+				return sizeof(T) * 8;
+			} else {
+				max_value = MaxValue((T)-min_value, max_value);
+			}
+		}
+
+		if (max_value == 0) {
+			return 0;
+		}
+
+		if (std::is_signed<T>::value) {
+			required_bits = 1;
+		} else {
+			required_bits = 0;
+		}
+
+		while (max_value) {
+			required_bits++;
+			max_value >>= 1;
+		}
+
+		return GetEffectiveWidth<T>(required_bits);
+	}
+
+	// Calculates the number of bytes required to store "count" values packed at "width" bits per value
+	inline static idx_t GetRequiredSize(idx_t count, bitpacking_width_t width) {
+		count = RoundUpToAlgorithmGroupSize(count);
+		return ((count * width) / 8);
+	}
+
+	template <class T>
+	inline static T RoundUpToAlgorithmGroupSize(T num_to_round) {
+		auto remainder = num_to_round % BITPACKING_ALGORITHM_GROUP_SIZE;
+		if (remainder == 0) {
+			return num_to_round;
+		}
+		return num_to_round + BITPACKING_ALGORITHM_GROUP_SIZE - remainder;
+	}
+
+private:
+	template <class T, bool round_to_next_byte = false>
+	static bitpacking_width_t FindMinimumBitWidth(T *values, idx_t count) {
+		T min_value = values[0];
+		T max_value = values[0];
+
+		for (idx_t i = 1; i < count; i++) {
+			if (values[i] > max_value) {
+				max_value = values[i];
+			}
+
+			if (std::is_signed<T>::value) {
+				if (values[i] < min_value) {
+					min_value = values[i];
+				}
+			}
+		}
+
+		bitpacking_width_t calc_width = MinimumBitWidth<T>(std::is_signed<T>::value ? min_value : 0, max_value);
+
+		// Assert results are correct
+#ifdef DEBUG
+		if (calc_width < sizeof(T) * 8 && calc_width != 0) {
+			if (std::is_signed<T>::value) {
+				D_ASSERT((int64_t)max_value <= (int64_t)(1L << (calc_width - 1)) - 1);
+				D_ASSERT((int64_t)min_value >= (int64_t)(-1 * ((1L << (calc_width - 1)) - 1) - 1));
+			} else {
+				D_ASSERT((uint64_t)max_value <= (uint64_t)(1L << (calc_width)) - 1);
+			}
+		}
+#endif
+		if (round_to_next_byte) {
+			return (calc_width / 8 + (calc_width % 8 != 0)) * 8;
+		} else {
+			return calc_width;
+		}
+	}
+
+	template <class T>
+	static void UnPackGroup(data_ptr_t dst, data_ptr_t src, bitpacking_width_t width,
+	                        bool skip_sign_extension = false) {
+		if (std::is_same<T, uint8_t>::value || std::is_same<T, int8_t>::value) {
+			duckdb_fastpforlib::fastunpack((const uint8_t *)src, (uint8_t *)dst, (uint32_t)width);
+		} else if (std::is_same<T, uint16_t>::value || std::is_same<T, int16_t>::value) {
+			duckdb_fastpforlib::fastunpack((const uint16_t *)src, (uint16_t *)dst, (uint32_t)width);
+		} else if (std::is_same<T, uint32_t>::value || std::is_same<T, int32_t>::value) {
+			duckdb_fastpforlib::fastunpack((const uint32_t *)src, (uint32_t *)dst, (uint32_t)width);
+		} else if (std::is_same<T, uint64_t>::value || std::is_same<T, int64_t>::value) {
+			duckdb_fastpforlib::fastunpack((const uint32_t *)src, (uint64_t *)dst, (uint32_t)width);
+		} else {
+			throw InternalException("Unsupported type found in bitpacking.");
+		}
+
+		if (NumericLimits<T>::IsSigned() && !skip_sign_extension && width > 0 && width < sizeof(T) * 8) {
+			SignExtend<T>(dst, width);
+		}
+	}
+
+	// Prevent compression at widths that are ineffective
+	template <class T>
+	static bitpacking_width_t GetEffectiveWidth(bitpacking_width_t width) {
+		if (width > 56) {
+			return 64;
+		}
+
+		if (width > 28 && (std::is_same<T, uint32_t>::value || std::is_same<T, int32_t>::value)) {
+			return 32;
+		}
+
+		else if (width > 14 && (std::is_same<T, uint16_t>::value || std::is_same<T, int16_t>::value)) {
+			return 16;
+		}
+
+		return width;
+	}
+
+	// Sign bit extension
+	template <class T, class T_U = typename std::make_unsigned<T>::type>
+	static void SignExtend(data_ptr_t dst, bitpacking_width_t width) {
+		T const mask = ((T_U)1) << (width - 1);
+		for (idx_t i = 0; i < BitpackingPrimitives::BITPACKING_ALGORITHM_GROUP_SIZE; ++i) {
+			T value = Load<T>(dst + i * sizeof(T));
+			value = value & ((((T_U)1) << width) - ((T_U)1));
+			T result = (value ^ mask) - mask;
+			Store(result, dst + i * sizeof(T));
+		}
+	}
+
+	template <class T>
+	static void PackGroup(data_ptr_t dst, T *values, bitpacking_width_t width) {
+		if (std::is_same<T, uint8_t>::value || std::is_same<T, int8_t>::value) {
+			duckdb_fastpforlib::fastpack((const uint8_t *)values, (uint8_t *)dst, (uint32_t)width);
+		} else if (std::is_same<T, uint16_t>::value || std::is_same<T, int16_t>::value) {
+			duckdb_fastpforlib::fastpack((const uint16_t *)values, (uint16_t *)dst, (uint32_t)width);
+		} else if (std::is_same<T, uint32_t>::value || std::is_same<T, int32_t>::value) {
+			duckdb_fastpforlib::fastpack((const uint32_t *)values, (uint32_t *)dst, (uint32_t)width);
+		} else if (std::is_same<T, uint64_t>::value || std::is_same<T, int64_t>::value) {
+			duckdb_fastpforlib::fastpack((const uint64_t *)values, (uint32_t *)dst, (uint32_t)width);
+		} else {
+			throw InternalException("Unsupported type found in bitpacking.");
+		}
+	}
+};
+
+} // namespace duckdb
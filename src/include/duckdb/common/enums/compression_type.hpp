@@ -20,7 +20,8 @@ enum class CompressionType : uint8_t {
 	COMPRESSION_DICTIONARY = 4,
 	COMPRESSION_PFOR_DELTA = 5,
 	COMPRESSION_BITPACKING = 6,
-	COMPRESSION_FSST = 7
+	COMPRESSION_FSST = 7,
+	COMPRESSION_CHIMP = 8
 };
 
 CompressionType CompressionTypeFromString(const string &str);
@@ -51,6 +51,7 @@ enum class PhysicalOperatorType : uint8_t {
 	PIECEWISE_MERGE_JOIN,
 	DELIM_JOIN,
 	INDEX_JOIN,
+	IE_JOIN,
 	// -----------------------------
 	// SetOps
 	// -----------------------------
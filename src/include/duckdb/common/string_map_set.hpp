@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/string_map_set.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/operator/comparison_operators.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/types/string_type.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/unordered_set.hpp"
+
+namespace duckdb {
+
+struct StringHash {
+	std::size_t operator()(const string_t &k) const {
+		return Hash(k);
+	}
+};
+
+struct StringCompare {
+	bool operator()(const string_t &lhs, const string_t &rhs) const {
+		return Equals::Operation(lhs, rhs);
+	}
+};
+
+//! Note: the map/set only stores the string_t, the caller is responsible for keeping the string data alive
+template <typename T>
+using string_map_t = unordered_map<string_t, T, StringHash, StringCompare>;
+
+using string_set_t = unordered_set<string_t, StringHash, StringCompare>;
+
+} // namespace duckdb
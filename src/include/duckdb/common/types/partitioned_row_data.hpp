@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/types/partitioned_row_data.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/types/row_data_collection.hpp"
+#include "duckdb/common/types/row_layout.hpp"
+
+namespace duckdb {
+
+//! PartitionedRowData holds rows that are radix-partitioned on the hash that is stored in their last column.
+/*!
+    The rows of every partition are stored in swizzled format, with one heap block per data block, so that the
+    blocks do not have to stay pinned and can be written to temporary storage by the buffer manager.
+*/
+class PartitionedRowData {
+public:
+	PartitionedRowData(BufferManager &buffer_manager, const RowLayout &layout, idx_t radix_bits);
+
+	//! The BufferManager
+	BufferManager &buffer_manager;
+	//! The layout of the rows, the last column holds the hash
+	const RowLayout layout;
+	//! The number of bits of the hash that are used to determine the partition
+	const idx_t radix_bits;
+	//! The swizzled rows of every partition
+	vector<unique_ptr<RowDataCollection>> data;
+	//! The heap blocks of every partition, the i-th heap block holds the variable size data of the i-th data block
+	vector<unique_ptr<RowDataCollection>> heaps;
+
+public:
+	idx_t PartitionCount() const {
+		return data.size();
+	}
+	//! The partition of a row with the given hash
+	static inline idx_t PartitionIndex(hash_t hash, idx_t radix_bits) {
+		// use the upper bits: the lower bits determine the position of the row in a hash table
+		return hash >> (sizeof(hash_t) * 8 - radix_bits);
+	}
+	//! Radix-partition the rows in the given collection, swizzle them and append them to the partitions. The heap
+	//! pointers of the rows must be valid, i.e. the heap must be pinned. Multiple threads can append at the same time.
+	void Append(RowDataCollection &rows);
+	//! Radix-partition the rows in the given (pinned) blocks, see Append(RowDataCollection &)
+	void Append(const vector<BlockAppendEntry> &row_blocks);
+	//! The number of rows in all partitions
+	idx_t Count() const;
+	//! The number of rows in the given partition
+	idx_t Count(idx_t partition) const;
+	//! The size (in bytes) of the given partition
+	idx_t SizeInBytes(idx_t partition) const;
+
+private:
+	mutex lock;
+
+	//! Swizzle the rows of the given data block and append the block and its heap block to the given collections
+	void SwizzleBlock(RowDataCollection &partition_data, RowDataCollection &partition_heap, RowDataBlock &data_block,
+	                  BufferHandle &data_handle, RowDataBlock *heap_block, BufferHandle *heap_handle);
+};
+
+} // namespace duckdb
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "duckdb/common/types/partitioned_row_data.hpp"
 #include "duckdb/execution/base_aggregate_hashtable.hpp"
 
 namespace duckdb {
@@ -70,6 +71,12 @@ public:
 	//! computed but instead just assigned.
 	idx_t AddChunk(DataChunk &groups, DataChunk &payload);
 	idx_t AddChunk(DataChunk &groups, Vector &group_hashes, DataChunk &payload);
+	//! Add the given data to the HT, only updating the aggregates with the given (sorted) indices
+	idx_t AddChunk(DataChunk &groups, Vector &group_hashes, DataChunk &payload, const vector<idx_t> &filter);
+	//! Append every row of the given data as a new group without looking up the existing groups, only updating the
+	//! aggregates with the given (sorted) indices. Duplicate groups are merged once the HT is combined into another
+	//! HT, so the HT is finalized and can only be partitioned or combined afterwards.
+	idx_t AppendChunk(DataChunk &groups, Vector &group_hashes, DataChunk &payload, const vector<idx_t> &filter);
 
 	//! Scan the HT starting from the scan_position until the result and group
 	//! chunks are filled. scan_position will be updated by this function.
@@ -97,6 +104,17 @@ public:
 	idx_t MaxCapacity();
 
 	void Partition(vector<GroupedAggregateHashTable *> &partition_hts, hash_t mask, idx_t shift);
+	//! Radix-partition the groups of this HT into the given partitions, which take over the aggregate states. This HT
+	//! is finalized and empty afterwards.
+	void Partition(PartitionedRowData &partitions);
+	//! Combine the groups of the given partition into this HT, after which the partition is empty
+	void Combine(PartitionedRowData &partitions, idx_t partition);
+
+	//! The size (in bytes) of the HT
+	idx_t SizeInBytes();
+	const RowLayout &GetLayout() const {
+		return layout;
+	}
 
 	void Finalize();
 
@@ -157,6 +175,8 @@ private:
 	void Verify();
 
 	void FlushMove(Vector &source_addresses, Vector &source_hashes, idx_t count);
+	//! Update the aggregates with the given (sorted) indices of the groups at the given addresses
+	void UpdateAggregates(DataChunk &groups, DataChunk &payload, Vector &addresses, const vector<idx_t> &filter);
 	void NewBlock();
 
 	template <class ENTRY>
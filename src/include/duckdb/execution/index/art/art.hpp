@@ -8,10 +8,13 @@
 
 #pragma once
 
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/common.hpp"
+#include "duckdb/common/unordered_map.hpp"
 #include "duckdb/common/types/data_chunk.hpp"
 #include "duckdb/common/types/vector.hpp"
 #include "duckdb/parser/parsed_expression.hpp"
+#include "duckdb/storage/data_pointer.hpp"
 #include "duckdb/storage/data_table.hpp"
 #include "duckdb/storage/index.hpp"
 
@@ -24,6 +27,9 @@
 #include "duckdb/execution/index/art/node256.hpp"
 
 namespace duckdb {
+class BlockHandle;
+class MetaBlockWriter;
+
 struct IteratorEntry {
 	IteratorEntry() {
 	}
@@ -63,13 +69,22 @@ struct ARTIndexScanState : public IndexScanState {
 };
 
 class ART : public Index {
+	friend class ARTConstructTask;
+
 public:
 	ART(const vector<column_t> &column_ids, const vector<unique_ptr<Expression>> &unbound_expressions,
-	    bool is_unique = false, bool is_primary = false);
+	    DatabaseInstance &db, bool is_unique = false, bool is_primary = false);
+	//! Load a serialized ART, the nodes are loaded lazily when they are first accessed
+	ART(const vector<column_t> &column_ids, const vector<unique_ptr<Expression>> &unbound_expressions,
+	    DatabaseInstance &db, bool is_unique, bool is_primary, const IndexPointer &pointer);
 	~ART() override;
 
+	//! The database the (serialized) index is stored in
+	DatabaseInstance &db;
+	//! The memory allocated by the nodes of the tree that are loaded
+	atomic<idx_t> memory_size;
 	//! Root of the tree
-	unique_ptr<Node> tree;
+	SwizzleablePointer tree;
 	//! True if machine is little endian
 	bool is_little_endian;
 
@@ -97,30 +112,74 @@ public:
 	//! Insert data into the index.
 	bool Insert(IndexLock &lock, DataChunk &data, Vector &row_ids) override;
 
+	//! Initialize the construction of the index from the existing rows of a table: the keys are sorted, and the tree
+	//! is built from the sorted keys in a single pass
+	unique_ptr<IndexConstructState> InitializeConstruct() override;
+	//! Add existing rows to the keys that are sorted
+	bool ConstructAppend(IndexLock &lock, IndexConstructState &state, DataChunk &input, Vector &row_ids) override;
+	//! Sort the keys and build the tree bottom-up
+	bool ConstructFinalize(IndexLock &lock, IndexConstructState &state) override;
+
 	bool SearchEqual(ARTIndexScanState *state, idx_t max_count, vector<row_t> &result_ids);
-	//! Search Equal used for Joins that do not need to fetch data
-	void SearchEqualJoinNoFetch(Value &equal_value, idx_t &result_size);
+	//! Search Equal used for Joins, for all keys of the input vector at once. The keys are looked up in sorted order,
+	//! so the lookup of a key resumes at the deepest node it shares with the previous key. For every row the number
+	//! of matches is written to result_sizes, and (if fetch_ids is set) the offset of its row ids in result_ids is
+	//! written to result_offsets. Rows with equal keys share their row ids.
+	void SearchEqualJoin(Vector &input, idx_t count, bool fetch_ids, idx_t result_offsets[], idx_t result_sizes[],
+	                     vector<row_t> &result_ids);
+
+	//! Serialize the index to the writer, returns the location of the root node and the blocks used by the index
+	IndexPointer Serialize(MetaBlockWriter &writer);
+	//! Keeps a block that contains serialized nodes registered in the buffer manager, so loading the other nodes in
+	//! the block does not require reading it from disk again
+	void RegisterIndexBlock(shared_ptr<BlockHandle> block);
+
+	//! Account for memory allocated (or freed) by a node of the tree
+	void IncreaseMemory(idx_t size) {
+		memory_size += size;
+	}
+	void DecreaseMemory(idx_t size) {
+		memory_size -= size;
+	}
 
 private:
 	DataChunk expression_result;
+	//! The blocks that nodes have been loaded from
+	unordered_map<block_id_t, shared_ptr<BlockHandle>> index_blocks;
+	//! The memory of the nodes that is accounted for in the buffer manager
+	idx_t reserved_memory;
+	//! The location of the root node if the tree was not modified since it was last written to disk, or an invalid
+	//! block pointer otherwise. The loaded nodes of an unmodified tree can be unloaded, as they can be read again.
+	BlockPointer serialized_root;
 
 private:
+	//! Account for the memory of the loaded nodes in the buffer manager. If the memory limit is exceeded and the tree
+	//! was not modified since it was written to disk, the nodes are unloaded. The lock must be held.
+	void UpdateMemory();
+	//! Mark the tree as modified since it was last written to disk
+	void SetModified();
+
 	//! Insert a row id into a leaf node
 	bool InsertToLeaf(Leaf &leaf, row_t row_id);
 	//! Insert the leaf value into the tree
-	bool Insert(unique_ptr<Node> &node, unique_ptr<Key> key, unsigned depth, row_t row_id);
+	bool Insert(SwizzleablePointer &node, unique_ptr<Key> key, unsigned depth, row_t row_id);
+	//! Build the subtree of the sorted keys in the range [start, end), which share their first depth bytes
+	bool Construct(vector<unique_ptr<Key>> &keys, row_t *row_ids, idx_t start, idx_t end, idx_t depth,
+	               SwizzleablePointer &node);
 
 	//! Erase element from leaf (if leaf has more than one value) or eliminate the leaf itself
-	void Erase(unique_ptr<Node> &node, Key &key, unsigned depth, row_t row_id);
+	void Erase(SwizzleablePointer &node, Key &key, unsigned depth, row_t row_id);
+	//! Erase the entries of the first "count" rows of the input that were inserted into the tree
+	void EraseKeys(DataChunk &input, row_t row_identifiers[], idx_t count);
 
 	//! Check if the key of the leaf is equal to the searched key
 	bool LeafMatches(Node *node, Key &key, unsigned depth);
 
 	//! Find the node with a matching key, optimistic version
-	Node *Lookup(unique_ptr<Node> &node, Key &key, unsigned depth);
+	Node *Lookup(SwizzleablePointer &node, Key &key, unsigned depth);
 
 	//! Find the first node that is bigger (or equal to) a specific key
-	bool Bound(unique_ptr<Node> &node, Key &key, Iterator &iterator, bool inclusive);
+	bool Bound(SwizzleablePointer &node, Key &key, Iterator &iterator, bool inclusive);
 
 	//! Gets next node for range queries
 	bool IteratorNext(Iterator &iter);
@@ -15,6 +15,10 @@ namespace duckdb {
 class Leaf : public Node {
 public:
 	Leaf(ART &art, unique_ptr<Key> value, row_t row_id);
+	//! Creates a leaf that contains the given row ids
+	Leaf(ART &art, unique_ptr<Key> value, row_t *row_ids, idx_t count);
+	//! Creates an empty leaf, its contents are read by DeserializeInternal
+	Leaf(ART &art, size_t compression_length);
 
 	unique_ptr<Key> value;
 	idx_t capacity;
@@ -28,6 +32,12 @@ public:
 	void Insert(row_t row_id);
 	void Remove(row_t row_id);
 
+	//! Serialize the leaf, which stores its key and row ids
+	BlockPointer Serialize(ART &art, MetaBlockWriter &writer) override;
+
+protected:
+	void DeserializeInternal(MetaBlockReader &reader) override;
+
 private:
 	unique_ptr<row_t[]> row_ids;
 };
@@ -9,12 +9,15 @@
 #pragma once
 
 #include "duckdb/execution/index/art/art_key.hpp"
+#include "duckdb/execution/index/art/swizzleable_pointer.hpp"
 #include "duckdb/common/common.hpp"
 
 namespace duckdb {
 enum class NodeType : uint8_t { N4 = 0, N16 = 1, N48 = 2, N256 = 3, NLeaf = 4 };
 
 class ART;
+class MetaBlockReader;
+class MetaBlockWriter;
 
 class Node {
 public:
@@ -22,8 +25,7 @@ public:
 
 public:
 	Node(ART &art, NodeType type, size_t compressed_prefix_size);
-	virtual ~Node() {
-	}
+	virtual ~Node();
 
 	//! length of the compressed path (prefix)
 	uint32_t prefix_length;
@@ -53,19 +55,42 @@ public:
 		return DConstants::INVALID_INDEX;
 	}
 	//! Get the child at the specified position in the node. pos should be between [0, count). Throws an assertion if
-	//! the element is not found.
-	virtual unique_ptr<Node> *GetChild(idx_t pos);
+	//! the element is not found. The child is loaded from disk if it was not accessed before.
+	virtual SwizzleablePointer *GetChild(ART &art, idx_t pos);
 
 	//! Compare the key with the prefix of the node, return the number matching bytes
 	static uint32_t PrefixMismatch(ART &art, Node *node, Key &key, uint64_t depth);
 	//! Insert leaf into inner node
-	static void InsertLeaf(ART &art, unique_ptr<Node> &node, uint8_t key, unique_ptr<Node> &new_node);
+	static void InsertLeaf(ART &art, SwizzleablePointer &node, uint8_t key, SwizzleablePointer &new_node);
 	//! Erase entry from node
-	static void Erase(ART &art, unique_ptr<Node> &node, idx_t pos);
+	static void Erase(ART &art, SwizzleablePointer &node, idx_t pos);
+
+	//! Serialize the node and all of its children, returns the location of the serialized node. Children are written
+	//! before their parent, so the parent can store their locations.
+	virtual BlockPointer Serialize(ART &art, MetaBlockWriter &writer);
+	//! Deserialize the node stored at the specified location. The children of the node are not loaded yet.
+	static unique_ptr<Node> Deserialize(ART &art, block_id_t block_id, uint32_t offset);
+
+	//! Account for memory allocated (or freed) by the node in the memory used by the index
+	void IncreaseMemory(idx_t size);
+	void DecreaseMemory(idx_t size);
 
 protected:
 	//! Copies the prefix from the source to the destination node
 	static void CopyPrefix(ART &art, Node *src, Node *dst);
+	//! Serialize the type, prefix and child count of the node, returns the location of the node
+	BlockPointer SerializeHeader(MetaBlockWriter &writer);
+	//! Serialize the given children, returns their locations
+	static vector<BlockPointer> SerializeChildren(ART &art, MetaBlockWriter &writer, SwizzleablePointer children[],
+	                                              idx_t child_count);
+	//! Deserialize the node-specific data, which follows the header
+	virtual void DeserializeInternal(MetaBlockReader &reader);
+
+private:
+	//! The index the node belongs to
+	ART &owner;
+	//! The memory allocated by the node, which is accounted for in the memory used by the index
+	idx_t memory_size;
 };
 
 } // namespace duckdb
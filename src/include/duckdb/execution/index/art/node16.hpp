@@ -16,7 +16,7 @@ public:
 	Node16(ART &art, size_t compression_lengthh);
 
 	uint8_t key[16];
-	unique_ptr<Node> child[16];
+	SwizzleablePointer child[16];
 
 public:
 	//! Get position of a byte, returns -1 if not exists
@@ -27,13 +27,19 @@ public:
 	//! Get the next position in the node, or DConstants::INVALID_INDEX if there is no next position
 	idx_t GetNextPos(idx_t pos) override;
 	//! Get Node16 Child
-	unique_ptr<Node> *GetChild(idx_t pos) override;
+	SwizzleablePointer *GetChild(ART &art, idx_t pos) override;
 
 	idx_t GetMin() override;
 
 	//! Insert node into Node16
-	static void Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_ptr<Node> &child);
+	static void Insert(ART &art, SwizzleablePointer &node, uint8_t key_byte, SwizzleablePointer &child);
 	//! Shrink to node 4
-	static void Erase(ART &art, unique_ptr<Node> &node, int pos);
+	static void Erase(ART &art, SwizzleablePointer &node, int pos);
+
+	//! Serialize the node and its children
+	BlockPointer Serialize(ART &art, MetaBlockWriter &writer) override;
+
+protected:
+	void DeserializeInternal(MetaBlockReader &reader) override;
 };
 } // namespace duckdb
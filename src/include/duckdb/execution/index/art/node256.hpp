@@ -15,7 +15,7 @@ class Node256 : public Node {
 public:
 	Node256(ART &art, size_t compression_length);
 
-	unique_ptr<Node> child[256];
+	SwizzleablePointer child[256];
 
 public:
 	//! Get position of a specific byte, returns DConstants::INVALID_INDEX if not exists
@@ -26,14 +26,20 @@ public:
 	//! Get the next position in the node, or DConstants::INVALID_INDEX if there is no next position
 	idx_t GetNextPos(idx_t pos) override;
 	//! Get Node256 Child
-	unique_ptr<Node> *GetChild(idx_t pos) override;
+	SwizzleablePointer *GetChild(ART &art, idx_t pos) override;
 
 	idx_t GetMin() override;
 
 	//! Insert node From Node256
-	static void Insert(ART &art, unique_ptr<Node> &node, uint8_t key_byte, unique_ptr<Node> &child);
+	static void Insert(ART &art, SwizzleablePointer &node, uint8_t key_byte, SwizzleablePointer &child);
 
 	//! Shrink to node 48
-	static void Erase(ART &art, unique_ptr<Node> &node, int pos);
+	static void Erase(ART &art, SwizzleablePointer &node, int pos);
+
+	//! Serialize the node and its children
+	BlockPointer Serialize(ART &art, MetaBlockWriter &writer) override;
+
+protected:
+	void DeserializeInternal(MetaBlockReader &reader) override;
 };
 } // namespace duckdb
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/execution/index/art/swizzleable_pointer.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/common.hpp"
+#include "duckdb/storage/block.hpp"
+
+namespace duckdb {
+class ART;
+class Node;
+class MetaBlockReader;
+class MetaBlockWriter;
+
+//! An owning pointer to a node of the ART. The node is either loaded in memory, or the pointer is "swizzled": it then
+//! holds the on-disk location of the serialized node, which is only deserialized on first access (see Unswizzle).
+//! A swizzled pointer has its most significant bit set, followed by the block id (31 bits) and the offset within the
+//! block (32 bits).
+class SwizzleablePointer {
+public:
+	SwizzleablePointer() : pointer(0) {
+	}
+	explicit SwizzleablePointer(unique_ptr<Node> node);
+	//! Points to the serialized node at the given location, the node itself is loaded on first access
+	explicit SwizzleablePointer(BlockPointer pointer);
+	//! Reads the location of a serialized node, the node itself is loaded on first access
+	explicit SwizzleablePointer(MetaBlockReader &reader);
+	SwizzleablePointer(SwizzleablePointer &&other) noexcept;
+	SwizzleablePointer(const SwizzleablePointer &other) = delete;
+	~SwizzleablePointer();
+
+	SwizzleablePointer &operator=(SwizzleablePointer &&other) noexcept;
+	SwizzleablePointer &operator=(unique_ptr<Node> node);
+
+public:
+	//! Whether or not the node is still on disk
+	bool IsSwizzled() const {
+		return (pointer & SWIZZLE_FLAG) != 0;
+	}
+	//! Returns the on-disk location of the node, only valid if the pointer is swizzled
+	BlockPointer GetSwizzledBlockInfo() const;
+	//! Loads the node from disk if the pointer is swizzled, and returns the (in-memory) node
+	Node *Unswizzle(ART &art);
+	//! Serializes the node (loading it first if required) and returns its location, or an invalid block pointer if
+	//! the pointer is empty
+	BlockPointer Serialize(ART &art, MetaBlockWriter &writer);
+	//! Writes the location of a serialized node to the writer
+	static void WriteBlockPointer(MetaBlockWriter &writer, BlockPointer pointer);
+
+	//! Returns the in-memory node, the pointer must not be swizzled
+	Node *get() const {
+		D_ASSERT(!IsSwizzled());
+		return (Node *)pointer;
+	}
+	Node *operator->() const {
+		return get();
+	}
+	Node &operator*() const {
+		return *get();
+	}
+	explicit operator bool() const {
+		return pointer != 0;
+	}
+	//! Destroys the node (if it is loaded) and empties the pointer
+	void reset();
+
+private:
+	static constexpr const uint64_t SWIZZLE_FLAG = 1ULL << 63;
+
+	uint64_t pointer;
+};
+
+} // namespace duckdb
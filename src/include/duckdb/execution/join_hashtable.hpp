@@ -11,10 +11,12 @@
 #include "duckdb/common/common.hpp"
 #include "duckdb/common/types/data_chunk.hpp"
 #include "duckdb/common/types/null_value.hpp"
+#include "duckdb/common/types/partitioned_row_data.hpp"
 #include "duckdb/common/types/row_data_collection.hpp"
 #include "duckdb/common/types/row_layout.hpp"
 #include "duckdb/common/types/vector.hpp"
 #include "duckdb/execution/aggregate_hashtable.hpp"
+#include "duckdb/planner/filter/dynamic_filter.hpp"
 #include "duckdb/planner/operator/logical_comparison_join.hpp"
 #include "duckdb/storage/storage_info.hpp"
 
@@ -43,6 +45,11 @@ struct JoinHTScanState {
    [POINTER]
    [POINTER]
    The pointers are either NULL
+   Alternatively (if tag_probing is set), the hash map is a linear probing table in which every row has its own
+   slot. Every slot stores a 16-bit tag taken from the upper bits of the hash next to the (48-bit) pointer:
+   [TAG|POINTER]
+   [TAG|POINTER]
+   Probing compares the tags first, so rows whose tag does not match are never touched.
 */
 class JoinHashTable {
 public:
@@ -59,6 +66,10 @@ public:
 		SelectionVector sel_vector;
 		// whether or not the given tuple has found a match
 		unique_ptr<bool[]> found_match;
+		//! The slot where the search for the next match of every tuple continues (only used with tag probing)
+		unique_ptr<idx_t[]> slots;
+		//! The hash tag of every tuple (only used with tag probing)
+		unique_ptr<uint16_t[]> tags;
 		JoinHashTable &ht;
 		bool finished;
 
@@ -114,8 +125,21 @@ public:
 	//! Finalize must be called before any call to Probe, and after Finalize is called Build should no longer be
 	//! ever called.
 	void Finalize();
-	//! Probe the HT with the given input chunk, resulting in the given result
-	unique_ptr<ScanStructure> Probe(DataChunk &keys);
+	//! Allocate the pointer table and pin the blocks of the HT, the first step of a (parallel) finalize
+	void InitializePointerTable();
+	//! Insert the entries of the blocks in the range [block_idx_start, block_idx_end) into the pointer table. Multiple
+	//! threads can insert different ranges at the same time if parallel is set.
+	void Finalize(idx_t block_idx_start, idx_t block_idx_end, bool parallel);
+	//! Mark the HT as finalized, after all blocks have been inserted into the pointer table
+	void FinishFinalize() {
+		finalized = true;
+	}
+	//! Insert the hashes of the keys in the HT into the Bloom filter of the given dynamic filter. This must happen
+	//! before the HT is finalized, since finalizing replaces the hashes with the pointers of the chains.
+	void BuildBloomFilter(DynamicFilterData &filter);
+	//! Probe the HT with the given input chunk, resulting in the given result. The buffers of the previous (exhausted)
+	//! scan structure of the same thread are reused, so they are not allocated for every chunk.
+	unique_ptr<ScanStructure> Probe(DataChunk &keys, unique_ptr<ScanStructure> previous = nullptr);
 	//! Scan the HT to construct the final full outer join result after
 	void ScanFullOuter(DataChunk &result, JoinHTScanState &state);
 	//! Fill the pointer with all the addresses from the hashtable for full scan
@@ -124,6 +148,22 @@ public:
 	idx_t Count() {
 		return block_collection->count;
 	}
+	idx_t BlockCount() {
+		return block_collection->blocks.size();
+	}
+	//! The size (in bytes) of the HT, including the pointer table that is allocated when it is finalized
+	idx_t SizeInBytes();
+	//! The capacity of the pointer table of a HT with the given amount of entries
+	static idx_t PointerTableCapacity(idx_t count);
+
+	//! Move the data of the other HT into this HT. Neither HT can be finalized.
+	void Merge(JoinHashTable &other);
+	//! Radix-partition the data of this HT into the given partitions, after which this HT is empty
+	void Partition(PartitionedRowData &partitions);
+	//! Move the data of the given partition into this HT, after which the partition is empty
+	void Merge(PartitionedRowData &partitions, idx_t partition);
+	//! Compute the hashes of the equality keys
+	void Hash(DataChunk &keys, const SelectionVector &sel, idx_t count, Vector &hashes);
 
 	//! BufferManager
 	BufferManager &buffer_manager;
@@ -153,6 +193,8 @@ public:
 	bool has_null;
 	//! Bitmask for getting relevant bits from the hashes to determine the position
 	uint64_t bitmask;
+	//! Whether or not the hash map is an open-addressing table with hash tags instead of chained buckets
+	bool tag_probing;
 
 	struct {
 		mutex mj_lock;
@@ -172,16 +214,22 @@ public:
 	} correlated_mark_join_info;
 
 private:
-	void Hash(DataChunk &keys, const SelectionVector &sel, idx_t count, Vector &hashes);
-
 	//! Apply a bitmask to the hashes
 	void ApplyBitmask(Vector &hashes, idx_t count);
 	void ApplyBitmask(Vector &hashes, const SelectionVector &sel, idx_t count, Vector &pointers);
 
 private:
-	//! Insert the given set of locations into the HT with the given set of
-	//! hashes. Caller should hold lock in parallel HT.
-	void InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[]);
+	//! Insert the given set of locations into the HT with the given set of hashes. If parallel is set, the pointers are
+	//! inserted with compare-and-swap, so multiple threads can insert at the same time.
+	void InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[], bool parallel);
+	//! Find the first slot starting from the given slot that holds the given tag, returns INVALID_INDEX if an empty
+	//! slot is found first. Only used with tag probing.
+	idx_t FindTag(uint16_t tag, idx_t slot);
+	//! Find the pointers with matching tags of the given tuples, starting from their current slot. Afterwards the slots
+	//! are where the search for the next match continues (or INVALID_INDEX if there is none). Returns the number of
+	//! tuples for which a pointer was found, and writes them to the result selection vector.
+	idx_t FindTags(const SelectionVector &sel, idx_t count, idx_t slots[], const uint16_t tags[],
+	               data_ptr_t pointers[], SelectionVector &result);
 
 	idx_t PrepareKeys(DataChunk &keys, unique_ptr<VectorData[]> &key_data, const SelectionVector *&current_sel,
 	                  SelectionVector &sel, bool build_side);
@@ -190,7 +238,7 @@ private:
 	unique_ptr<RowDataCollection> block_collection;
 	//! The stringheap of the JoinHashTable
 	unique_ptr<RowDataCollection> string_heap;
-	//! Pinned handles, these are pinned during finalization only
+	//! Pinned handles of the blocks of the HT, these are pinned from finalization until the HT is destroyed
 	vector<unique_ptr<BufferHandle>> pinned_handles;
 	//! The hash map of the HT, created after finalization
 	unique_ptr<BufferHandle> hash_map;
@@ -10,7 +10,6 @@
 
 #include "duckdb/common/common.hpp"
 #include "duckdb/common/enums/expression_type.hpp"
-#include "duckdb/common/types/chunk_collection.hpp"
 #include "duckdb/common/types/vector.hpp"
 
 namespace duckdb {
@@ -21,7 +20,7 @@ struct MergeOrder {
 	VectorData vdata;
 };
 
-enum MergeInfoType : uint8_t { SCALAR_MERGE_INFO = 1, CHUNK_MERGE_INFO = 2 };
+enum MergeInfoType : uint8_t { SCALAR_MERGE_INFO = 1 };
 
 struct MergeInfo {
 	MergeInfo(MergeInfoType info_type, LogicalType type) : info_type(info_type), type(type) {
@@ -40,18 +39,6 @@ struct ScalarMergeInfo : public MergeInfo {
 	}
 };
 
-struct ChunkMergeInfo : public MergeInfo {
-	ChunkCollection &data_chunks;
-	vector<MergeOrder> &order_info;
-	bool found_match[STANDARD_VECTOR_SIZE];
-
-	ChunkMergeInfo(ChunkCollection &data_chunks, vector<MergeOrder> &order_info)
-	    : MergeInfo(MergeInfoType::CHUNK_MERGE_INFO, data_chunks.Types()[0]), data_chunks(data_chunks),
-	      order_info(order_info) {
-		memset(found_match, 0, sizeof(found_match));
-	}
-};
-
 struct MergeJoinComplex {
 	struct LessThan {
 		template <class T>
@@ -77,27 +64,6 @@ struct MergeJoinComplex {
 	static idx_t Perform(MergeInfo &l, MergeInfo &r, ExpressionType comparison_type);
 };
 
-struct MergeJoinSimple {
-	struct LessThan {
-		template <class T>
-		static idx_t Operation(ScalarMergeInfo &l, ChunkMergeInfo &r);
-	};
-	struct LessThanEquals {
-		template <class T>
-		static idx_t Operation(ScalarMergeInfo &l, ChunkMergeInfo &r);
-	};
-	struct GreaterThan {
-		template <class T>
-		static idx_t Operation(ScalarMergeInfo &l, ChunkMergeInfo &r);
-	};
-	struct GreaterThanEquals {
-		template <class T>
-		static idx_t Operation(ScalarMergeInfo &l, ChunkMergeInfo &r);
-	};
-
-	static idx_t Perform(MergeInfo &l, MergeInfo &r, ExpressionType comparison);
-};
-
 #define INSTANTIATE_MERGEJOIN_TEMPLATES(MJCLASS, OPNAME, L, R)                                                         \
 	template idx_t MJCLASS::OPNAME::Operation<int8_t>(L & l, R & r);                                                   \
 	template idx_t MJCLASS::OPNAME::Operation<int16_t>(L & l, R & r);                                                  \
@@ -86,6 +86,10 @@ public:
 		return all_combinable;
 	}
 
+	//! Finalize the radix HTs, after the DISTINCT aggregates have been computed
+	SinkFinalizeType FinalizeInternal(Pipeline &pipeline, Event &event, ClientContext &context,
+	                                  GlobalSinkState &gstate) const;
+
 public:
 	string ParamsToString() const override;
 	//! Toggle multi-scan capability on a hash table, which prevents the scan of the aggregate from being destructive
@@ -20,7 +20,7 @@ class PhysicalPerfectHashAggregate : public PhysicalOperator {
 public:
 	PhysicalPerfectHashAggregate(ClientContext &context, vector<LogicalType> types,
 	                             vector<unique_ptr<Expression>> aggregates, vector<unique_ptr<Expression>> groups,
-	                             vector<unique_ptr<BaseStatistics>> group_stats, vector<idx_t> required_bits,
+	                             vector<unique_ptr<BaseStatistics>> group_stats, vector<idx_t> group_ranges,
 	                             idx_t estimated_cardinality);
 
 	//! The groups
@@ -65,8 +65,8 @@ public:
 	vector<AggregateObject> aggregate_objects;
 	//! The minimum value of each of the groups
 	vector<Value> group_minima;
-	//! The number of bits we need to completely cover each of the groups
-	vector<idx_t> required_bits;
+	//! The number of entries we need to completely cover each of the groups (the range of its values plus NULL)
+	vector<idx_t> group_ranges;
 
 	unordered_map<Expression *, size_t> filter_indexes;
 };
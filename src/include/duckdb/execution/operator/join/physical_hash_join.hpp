@@ -17,6 +17,7 @@
 #include "duckdb/planner/operator/logical_join.hpp"
 
 namespace duckdb {
+class HashJoinScanState;
 
 //! PhysicalHashJoin represents a hash loop join between two tables
 class PhysicalHashJoin : public PhysicalComparisonJoin {
@@ -38,6 +39,28 @@ public:
 	vector<LogicalType> delim_types;
 	// used in perfect hash join
 	PerfectHashJoinStats perfect_join_statistics;
+	//! Whether or not the join can go out-of-core, i.e. partition the build and probe side to temporary storage when
+	//! the build side does not fit in memory. This is decided when planning (see InitializeExternal).
+	bool can_go_external;
+
+	//! The dynamic filters that are pushed into the probe-side table scan, one per condition (nullptr if none)
+	vector<shared_ptr<DynamicFilterData>> dynamic_filters;
+
+	//! The number of bits of the hash used to partition the build and probe side of an out-of-core join
+	static constexpr const idx_t EXTERNAL_RADIX_BITS = 6;
+	//! Joins only go out-of-core if their build side is estimated to take up more than 1/EXTERNAL_ESTIMATE_FACTOR of
+	//! the memory limit, the estimate is rough so this leaves some margin
+	static constexpr const idx_t EXTERNAL_ESTIMATE_FACTOR = 8;
+
+public:
+	//! Decides whether or not the join can go out-of-core in the given context. Only an out-of-core join (or a
+	//! RIGHT/FULL OUTER join) needs a source pipeline, so joins that will not spill do not get one.
+	void InitializeExternal(ClientContext &context, bool in_recursive_cte);
+	//! Whether or not a dynamic filter on the probe keys can be created for the given condition, i.e. whether rows
+	//! of the probe side that do not have a matching build key can be removed before the join
+	bool CanCreateDynamicFilter(idx_t condition_idx) const;
+	//! Whether or not the range of the build keys is kept for the dynamic filter on a key of the given type
+	static bool DynamicFilterHasRange(const LogicalType &type);
 
 public:
 	// Operator Interface
@@ -60,9 +83,11 @@ public:
 	             LocalSourceState &lstate) const override;
 
 	bool IsSource() const override {
-		return IsRightOuterJoin(join_type);
+		// the partitions of an out-of-core join are joined after the probe side has been partitioned
+		return IsRightOuterJoin(join_type) || can_go_external;
 	}
 	bool ParallelSource() const override {
+		// note that the partitions of an out-of-core join are joined by a single thread (see MaxThreads)
 		return true;
 	}
 
@@ -83,6 +108,14 @@ public:
 	bool ParallelSink() const override {
 		return true;
 	}
+
+private:
+	//! Add the probe side chunk to the partitions of an out-of-core join
+	void SpillProbe(DataChunk &input, OperatorState &state) const;
+	//! Load the next partitions of the build side into a HT, and start scanning the probe side of those partitions
+	void PrepareNextPartitions(HashJoinScanState &state) const;
+	//! Scan the next chunk of probe side rows of the partitions that are currently being joined
+	bool ScanProbePartitions(HashJoinScanState &state) const;
 };
 
 } // namespace duckdb
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/execution/operator/join/physical_iejoin.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/execution/operator/join/physical_comparison_join.hpp"
+
+namespace duckdb {
+
+//! PhysicalIEJoin represents an inequality join (IEJoin) between two tables on at least two range conditions
+/*!
+    Both sides are materialized, and the rows of both sides are sorted together on the keys of the first and second
+    condition. The matches are then enumerated by walking the second order while setting the positions of the right
+    rows in the first order in a bit array. The remaining conditions are evaluated on the enumerated pairs.
+*/
+class PhysicalIEJoin : public PhysicalComparisonJoin {
+public:
+	PhysicalIEJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left, unique_ptr<PhysicalOperator> right,
+	               vector<JoinCondition> cond, JoinType join_type, idx_t estimated_cardinality);
+
+	vector<LogicalType> join_key_types;
+
+public:
+	//! Whether or not the given comparison can be one of the first two (sorted) conditions of an IEJoin
+	static bool IsRangeComparison(ExpressionType comparison);
+
+public:
+	// Operator Interface
+	unique_ptr<OperatorState> GetOperatorState(ClientContext &context) const override;
+	OperatorResultType Execute(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+	                           OperatorState &state) const override;
+
+	bool ParallelOperator() const override {
+		return true;
+	}
+
+public:
+	// Source interface
+	unique_ptr<GlobalSourceState> GetGlobalSourceState(ClientContext &context) const override;
+	void GetData(ExecutionContext &context, DataChunk &chunk, GlobalSourceState &gstate,
+	             LocalSourceState &lstate) const override;
+
+	bool IsSource() const override {
+		// the LHS is materialized in the operator, the join itself is performed in the source
+		return true;
+	}
+
+public:
+	// Sink Interface
+	unique_ptr<GlobalSinkState> GetGlobalSinkState(ClientContext &context) const override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) const override;
+	SinkResultType Sink(ExecutionContext &context, GlobalSinkState &state, LocalSinkState &lstate,
+	                    DataChunk &input) const override;
+	void Combine(ExecutionContext &context, GlobalSinkState &gstate, LocalSinkState &lstate) const override;
+	SinkFinalizeType Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+	                          GlobalSinkState &gstate) const override;
+
+	bool IsSink() const override {
+		return true;
+	}
+	bool ParallelSink() const override {
+		return true;
+	}
+};
+
+} // namespace duckdb
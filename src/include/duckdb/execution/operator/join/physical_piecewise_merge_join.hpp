@@ -15,6 +15,10 @@ namespace duckdb {
 
 //! PhysicalPiecewiseMergeJoin represents a piecewise merge loop join between
 //! two tables
+/*!
+    The RHS is sorted in parallel (and out-of-core if required) using the row-format sorter. Every chunk of the LHS is
+    sorted separately and merged with the chunks of the sorted RHS that can contain matches.
+*/
 class PhysicalPiecewiseMergeJoin : public PhysicalComparisonJoin {
 public:
 	PhysicalPiecewiseMergeJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left,
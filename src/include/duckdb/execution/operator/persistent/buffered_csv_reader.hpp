@@ -14,6 +14,7 @@
 #include "duckdb/common/types/chunk_collection.hpp"
 #include "duckdb/common/enums/file_compression_type.hpp"
 #include "duckdb/common/map.hpp"
+#include "duckdb/common/limits.hpp"
 
 #include <sstream>
 #include <queue>
@@ -106,6 +107,15 @@ struct BufferedCSVReaderOptions {
 
 enum class ParserMode : uint8_t { PARSING = 0, SNIFFING_DIALECT = 1, SNIFFING_DATATYPES = 2, PARSING_HEADER = 3 };
 
+enum class CSVTokenizerResult : uint8_t {
+	//! The chunk is finished, or the end of the byte range of the reader was reached
+	FINISHED_CHUNK = 0,
+	//! The value at the position continues after the end of the buffer
+	NEEDS_DATA = 1,
+	//! The value at the position is left to the per-character parser (e.g. it has a quote inside an unquoted value)
+	UNSUPPORTED_VALUE = 2
+};
+
 //! Buffered CSV reader is a class that reads values from a stream and parses them as a CSV file
 class BufferedCSVReader {
 	//! Initial buffer read size; can be extended for long lines
@@ -134,6 +144,15 @@ public:
 	idx_t buffer_size;
 	idx_t position;
 	idx_t start = 0;
+	//! The file offset of the first byte in the buffer (only tracked for plain files)
+	idx_t buffer_offset = 0;
+	//! The file offset at which reading stops: rows that start at or after this offset are not read
+	idx_t range_end = NumericLimits<idx_t>::Maximum();
+	//! The file offset at which the byte range begins (only set if the reader was moved to the byte range)
+	idx_t range_begin = 0;
+	//! Whether or not the reader was moved to a byte range, in which case the line numbers are unknown and errors
+	//! report byte offsets instead
+	bool range_linenr_unknown = false;
 
 	idx_t linenr = 0;
 	bool linenr_estimated = false;
@@ -153,6 +172,10 @@ public:
 	TextSearchShiftArray delimiter_search, escape_search, quote_search;
 
 	DataChunk parse_chunk;
+	//! The escape positions of the value that is being read by the tokenizer
+	vector<idx_t> value_escapes;
+	//! The amount of rows in the parse_chunk that the tokenizer read from ASCII blocks of the buffer
+	idx_t ascii_rows = 0;
 
 	std::queue<unique_ptr<DataChunk>> cached_chunks;
 
@@ -160,7 +183,22 @@ public:
 	//! Extract a single DataChunk from the CSV file and stores it in insert_chunk
 	void ParseCSV(DataChunk &insert_chunk);
 
+	//! Whether or not the file can be split into byte ranges that are read independently (i.e. it is a plain file
+	//! and the delimiter, quote and escape are one byte in length)
+	bool CanReadByteRanges() const;
+	//! Returns the file offset of the next row that will be read
+	idx_t GetFileOffset();
+	//! Returns the file offset of the first row that starts at or after the given offset, without reading the file
+	//! before the offset
+	idx_t FindRowStart(idx_t offset);
+	//! Restricts the reader to the rows that start in [begin, end), begin has to be the start of a row
+	void SetByteRange(idx_t begin, idx_t end);
+
 private:
+	//! Describes the line that is currently being read for error messages
+	string GetLineNumberStr();
+	//! Describes the lines [first_line, last_line] for error messages
+	string GetLineRangeStr(idx_t first_line, idx_t last_line);
 	//! Initialize Parser
 	void Initialize(const vector<LogicalType> &requested_types);
 	//! Initializes the parse_chunk with varchar columns and aligns info with new number of cols
@@ -192,6 +230,10 @@ private:
 	//! Resets the steam
 	void ResetStream();
 
+	//! Reads the rows that start at the current position with the tokenizer, which finds the delimiters, quotes and
+	//! newlines of 64 bytes at a time. Stops at the first value that it cannot read, which is left to the
+	//! per-character states of TryParseSimpleCSV (column is set to the column of that value).
+	CSVTokenizerResult TokenizeRows(DataChunk &insert_chunk, idx_t &column);
 	//! Parses a CSV file with a one-byte delimiter, escape and quote character
 	bool TryParseSimpleCSV(DataChunk &insert_chunk, string &error_message);
 	//! Parses more complex CSV files with multi-byte delimiters, escapes or quotes
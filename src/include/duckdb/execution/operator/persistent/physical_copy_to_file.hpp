@@ -22,6 +22,16 @@ public:
 
 	CopyFunction function;
 	unique_ptr<FunctionData> bind_data;
+	//! The file to write to, or the root directory of the partitions if the copy is partitioned
+	string file_path;
+	//! The names of the columns of the child
+	vector<string> names;
+	//! The columns by which the rows are partitioned into hive-style directories (col=value/), if any
+	vector<idx_t> partition_columns;
+	//! The maximum number of partition files that a thread keeps open at once
+	idx_t max_open_files;
+	//! Whether or not the rows can be written to the file from multiple threads (in any order)
+	bool parallel;
 
 public:
 	// Source interface
@@ -42,5 +52,8 @@ public:
 	bool IsSink() const override {
 		return true;
 	}
+	bool ParallelSink() const override {
+		return parallel;
+	}
 };
 } // namespace duckdb
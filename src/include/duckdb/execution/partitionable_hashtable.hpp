@@ -28,12 +28,19 @@ public:
 	                       vector<LogicalType> group_types_p, vector<LogicalType> payload_types_p,
 	                       vector<BoundAggregateExpression *> bindings_p);
 
-	idx_t AddChunk(DataChunk &groups, DataChunk &payload, bool do_partition);
+	//! Add the given data to the HTs, only updating the aggregates with the given (sorted) indices
+	idx_t AddChunk(DataChunk &groups, DataChunk &payload, bool do_partition, const vector<idx_t> &filter);
+	//! Partition the given data and append every row as a new group, without looking up the existing groups
+	idx_t AppendChunk(DataChunk &groups, DataChunk &payload, const vector<idx_t> &filter);
 	void Partition();
 	bool IsPartitioned();
 
 	HashTableList GetPartition(idx_t partition);
 	HashTableList GetUnpartitioned();
+	//! All HTs, partitioned or not
+	vector<GroupedAggregateHashTable *> GetAll();
+	//! The size (in bytes) of all HTs
+	idx_t SizeInBytes();
 
 	void Finalize();
 
@@ -54,6 +61,8 @@ private:
 	unordered_map<hash_t, HashTableList> radix_partitioned_hts;
 
 private:
-	idx_t ListAddChunk(HashTableList &list, DataChunk &groups, Vector &group_hashes, DataChunk &payload);
+	idx_t ListAddChunk(HashTableList &list, DataChunk &groups, Vector &group_hashes, DataChunk &payload,
+	                   const vector<idx_t> &filter, bool append);
+	idx_t PartitionedAddChunk(DataChunk &groups, DataChunk &payload, const vector<idx_t> &filter, bool append);
 };
 } // namespace duckdb
@@ -16,7 +16,7 @@ class PerfectAggregateHashTable : public BaseAggregateHashTable {
 public:
 	PerfectAggregateHashTable(BufferManager &buffer_manager, const vector<LogicalType> &group_types,
 	                          vector<LogicalType> payload_types_p, vector<AggregateObject> aggregate_objects,
-	                          vector<Value> group_minima, vector<idx_t> required_bits);
+	                          vector<Value> group_minima, vector<idx_t> group_ranges);
 	~PerfectAggregateHashTable() override;
 
 public:
@@ -31,11 +31,10 @@ public:
 
 protected:
 	Vector addresses;
-	//! The required bits per group
-	vector<idx_t> required_bits;
-	//! The total required bits for the HT (this determines the max capacity)
-	idx_t total_required_bits;
-	//! The total amount of groups
+	//! The amount of entries per group: the range of its values plus one for NULL. The index of a group in the HT is a
+	//! mixed-radix number with one digit per group.
+	vector<idx_t> group_ranges;
+	//! The total amount of groups (the product of the group ranges)
 	idx_t total_groups;
 	//! The tuple size
 	idx_t tuple_size;
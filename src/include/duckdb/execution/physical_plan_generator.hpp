@@ -24,13 +24,16 @@ class ClientContext;
 //! logical query plan
 class PhysicalPlanGenerator {
 public:
-	explicit PhysicalPlanGenerator(ClientContext &context) : context(context) {
+	explicit PhysicalPlanGenerator(ClientContext &context) : context(context), in_recursive_cte(false) {
 	}
 
 	unordered_set<CatalogEntry *> dependencies;
 	//! Recursive CTEs require at least one ChunkScan, referencing the working_table.
 	//! This data structure is used to establish it.
 	unordered_map<idx_t, std::shared_ptr<ChunkCollection>> rec_ctes;
+	//! Whether or not the recursive part of a recursive CTE is being planned: operators that require a child
+	//! pipeline cannot be used there
+	bool in_recursive_cte;
 
 public:
 	//! Creates a plan from the logical operator. This involves resolving column bindings and generating physical
@@ -34,6 +34,26 @@ public:
 	//! The GROUPING values that belong to this hash table
 	vector<Value> grouping_values;
 
+	//! The amount of radix bits used to partition the groups if the aggregate goes out-of-core
+	static constexpr const idx_t EXTERNAL_RADIX_BITS = 6;
+	//! The amount of rows a thread pre-aggregates before it decides whether or not pre-aggregation pays off
+	static constexpr const idx_t ADAPTIVE_SAMPLE_SIZE = 100000;
+	//! If more than this fraction of the pre-aggregated rows of a thread create a new group, the thread stops
+	//! pre-aggregating and appends its rows to the partitions without looking up their groups
+	static constexpr const double ADAPTIVE_MAX_GROUP_RATIO = 0.9;
+
+	//! The indices of the DISTINCT aggregates, and of the other aggregates
+	vector<idx_t> distinct_indices;
+	vector<idx_t> non_distinct_indices;
+	//! For every DISTINCT aggregate, the types of its distinct HT: the groups followed by the aggregate arguments
+	vector<vector<LogicalType>> distinct_types;
+	//! For every DISTINCT aggregate, the offset of its arguments in the payload
+	vector<idx_t> distinct_payload_offsets;
+	//! The aggregates of the parallel HTs. The DISTINCT aggregates are copied without DISTINCT and FILTER, as their
+	//! input is filtered and deduplicated in separate HTs before it is aggregated.
+	vector<unique_ptr<Expression>> parallel_aggregates;
+	vector<BoundAggregateExpression *> parallel_bindings;
+
 public:
 	//! Sink Interface
 	unique_ptr<GlobalSinkState> GetGlobalSinkState(ClientContext &context) const;
@@ -46,6 +66,10 @@ public:
 
 	void ScheduleTasks(Executor &executor, const shared_ptr<Event> &event, GlobalSinkState &state,
 	                   vector<unique_ptr<Task>> &tasks) const;
+	//! Whether or not the thread-local distinct HTs have to be merged (using ScheduleDistinctTasks) before Finalize
+	bool HasDistinctData(GlobalSinkState &state) const;
+	void ScheduleDistinctTasks(Executor &executor, const shared_ptr<Event> &event, GlobalSinkState &state,
+	                           vector<unique_ptr<Task>> &tasks) const;
 
 	//! Source interface
 	unique_ptr<GlobalSourceState> GetGlobalSourceState() const;
@@ -54,6 +78,8 @@ public:
 
 	static void SetMultiScan(GlobalSinkState &state);
 	bool ForceSingleHT(GlobalSinkState &state) const;
+	//! Whether or not the groups can be written to temporary storage if they do not fit in memory
+	bool CanGoExternal() const;
 };
 
 } // namespace duckdb
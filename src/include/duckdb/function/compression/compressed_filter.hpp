@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/function/compression/compressed_filter.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/enums/expression_type.hpp"
+#include "duckdb/common/enums/filter_propagate_result.hpp"
+#include "duckdb/common/operator/comparison_operators.hpp"
+#include "duckdb/common/types/selection_vector.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+
+namespace duckdb {
+
+//! Helper functions used by compression methods to evaluate constant comparisons on compressed data
+struct CompressedFilter {
+	//! Whether or not a filter can be evaluated on compressed data
+	static bool IsSupported(const TableFilter &filter) {
+		if (filter.filter_type != TableFilterType::CONSTANT_COMPARISON) {
+			return false;
+		}
+		switch (((ConstantFilter &)filter).comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+		case ExpressionType::COMPARE_LESSTHAN:
+		case ExpressionType::COMPARE_GREATERTHAN:
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	//! Returns the constant of the filter as the physical type of the segment
+	template <class T>
+	static T GetConstant(const ConstantFilter &filter) {
+		Vector predicate_vector(filter.constant);
+		return FlatVector::GetData<T>(predicate_vector)[0];
+	}
+
+	//! Evaluate the comparison for a single value
+	template <class T>
+	static bool Compare(T value, T constant, ExpressionType comparison_type) {
+		switch (comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+			return Equals::Operation(value, constant);
+		case ExpressionType::COMPARE_LESSTHAN:
+			return LessThan::Operation(value, constant);
+		case ExpressionType::COMPARE_GREATERTHAN:
+			return GreaterThan::Operation(value, constant);
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			return LessThanEquals::Operation(value, constant);
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			return GreaterThanEquals::Operation(value, constant);
+		default:
+			throw InternalException("Unsupported comparison type for compressed filter");
+		}
+	}
+
+	//! Check whether the comparison holds for all, none or some of the values in the range [min, max]
+	template <class T>
+	static FilterPropagateResult CheckRange(T min, T max, T constant, ExpressionType comparison_type) {
+		switch (comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+			if (LessThan::Operation(constant, min) || GreaterThan::Operation(constant, max)) {
+				return FilterPropagateResult::FILTER_ALWAYS_FALSE;
+			}
+			if (Equals::Operation(min, max)) {
+				return FilterPropagateResult::FILTER_ALWAYS_TRUE;
+			}
+			return FilterPropagateResult::NO_PRUNING_POSSIBLE;
+		case ExpressionType::COMPARE_LESSTHAN:
+			if (LessThan::Operation(max, constant)) {
+				return FilterPropagateResult::FILTER_ALWAYS_TRUE;
+			}
+			if (GreaterThanEquals::Operation(min, constant)) {
+				return FilterPropagateResult::FILTER_ALWAYS_FALSE;
+			}
+			return FilterPropagateResult::NO_PRUNING_POSSIBLE;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			if (LessThanEquals::Operation(max, constant)) {
+				return FilterPropagateResult::FILTER_ALWAYS_TRUE;
+			}
+			if (GreaterThan::Operation(min, constant)) {
+				return FilterPropagateResult::FILTER_ALWAYS_FALSE;
+			}
+			return FilterPropagateResult::NO_PRUNING_POSSIBLE;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			if (GreaterThan::Operation(min, constant)) {
+				return FilterPropagateResult::FILTER_ALWAYS_TRUE;
+			}
+			if (LessThanEquals::Operation(max, constant)) {
+				return FilterPropagateResult::FILTER_ALWAYS_FALSE;
+			}
+			return FilterPropagateResult::NO_PRUNING_POSSIBLE;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			if (GreaterThanEquals::Operation(min, constant)) {
+				return FilterPropagateResult::FILTER_ALWAYS_TRUE;
+			}
+			if (LessThan::Operation(max, constant)) {
+				return FilterPropagateResult::FILTER_ALWAYS_FALSE;
+			}
+			return FilterPropagateResult::NO_PRUNING_POSSIBLE;
+		default:
+			throw InternalException("Unsupported comparison type for compressed filter");
+		}
+	}
+};
+
+//! Builds the refined selection vector of a compressed filter
+//! The (sorted) input selection is consumed front-to-back, one range of rows at a time
+class CompressedFilterSelection {
+public:
+	CompressedFilterSelection(SelectionVector &sel, idx_t approved_tuple_count)
+	    : sel(sel), approved_tuple_count(approved_tuple_count), new_sel(approved_tuple_count), sel_idx(0),
+	      result_count(0) {
+	}
+
+	//! Whether or not any of the remaining selected rows lie before "end"
+	bool HasRowsBefore(idx_t end) const {
+		return sel_idx < approved_tuple_count && sel.get_index(sel_idx) < end;
+	}
+
+	//! Approve or reject all remaining selected rows before "end"
+	void SelectRange(idx_t end, bool approve) {
+		for (; sel_idx < approved_tuple_count; sel_idx++) {
+			auto idx = sel.get_index(sel_idx);
+			if (idx >= end) {
+				break;
+			}
+			if (approve) {
+				new_sel.set_index(result_count++, idx);
+			}
+		}
+	}
+
+	//! Approve the remaining selected rows before "end" for which "data[idx] <comparison> constant" holds
+	template <class T>
+	void SelectRange(T *data, idx_t end, T constant, ExpressionType comparison_type) {
+		switch (comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+			TemplatedSelectRange<T, Equals>(data, end, constant);
+			break;
+		case ExpressionType::COMPARE_LESSTHAN:
+			TemplatedSelectRange<T, LessThan>(data, end, constant);
+			break;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			TemplatedSelectRange<T, GreaterThan>(data, end, constant);
+			break;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			TemplatedSelectRange<T, LessThanEquals>(data, end, constant);
+			break;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			TemplatedSelectRange<T, GreaterThanEquals>(data, end, constant);
+			break;
+		default:
+			throw InternalException("Unsupported comparison type for compressed filter");
+		}
+	}
+
+	//! Replace the input selection vector with the approved rows
+	void Finalize(idx_t &count) {
+		sel.Initialize(new_sel);
+		count = result_count;
+	}
+
+private:
+	template <class T, class OP>
+	void TemplatedSelectRange(T *data, idx_t end, T constant) {
+		for (; sel_idx < approved_tuple_count; sel_idx++) {
+			auto idx = sel.get_index(sel_idx);
+			if (idx >= end) {
+				break;
+			}
+			if (OP::Operation(data[idx], constant)) {
+				new_sel.set_index(result_count++, idx);
+			}
+		}
+	}
+
+private:
+	SelectionVector &sel;
+	idx_t approved_tuple_count;
+	SelectionVector new_sel;
+	idx_t sel_idx;
+	idx_t result_count;
+};
+
+} // namespace duckdb
@@ -24,6 +24,8 @@ class SegmentStatistics;
 struct ColumnFetchState;
 struct ColumnScanState;
 struct SegmentScanState;
+struct SelectionVector;
+class TableFilter;
 
 struct AnalyzeState {
 	virtual ~AnalyzeState() {
@@ -85,6 +87,12 @@ typedef idx_t (*compression_append_t)(ColumnSegment &segment, SegmentStatistics
 typedef idx_t (*compression_finalize_append_t)(ColumnSegment &segment, SegmentStatistics &stats);
 typedef void (*compression_revert_append_t)(ColumnSegment &segment, idx_t start_row);
 
+//===--------------------------------------------------------------------===//
+// Filter (optional)
+//===--------------------------------------------------------------------===//
+typedef void (*compression_filter_t)(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result,
+                                     SelectionVector &sel, idx_t &approved_tuple_count, const TableFilter &filter);
+
 class CompressionFunction {
 public:
 	CompressionFunction(CompressionType type, PhysicalType data_type, compression_init_analyze_t init_analyze,
@@ -95,11 +103,12 @@ public:
 	                    compression_fetch_row_t fetch_row, compression_skip_t skip,
 	                    compression_init_segment_t init_segment = nullptr, compression_append_t append = nullptr,
 	                    compression_finalize_append_t finalize_append = nullptr,
-	                    compression_revert_append_t revert_append = nullptr)
+	                    compression_revert_append_t revert_append = nullptr, compression_filter_t filter = nullptr)
 	    : type(type), data_type(data_type), init_analyze(init_analyze), analyze(analyze), final_analyze(final_analyze),
 	      init_compression(init_compression), compress(compress), compress_finalize(compress_finalize),
 	      init_scan(init_scan), scan_vector(scan_vector), scan_partial(scan_partial), fetch_row(fetch_row), skip(skip),
-	      init_segment(init_segment), append(append), finalize_append(finalize_append), revert_append(revert_append) {
+	      init_segment(init_segment), append(append), finalize_append(finalize_append), revert_append(revert_append),
+	      filter(filter) {
 	}
 
 	//! Compression type
@@ -152,6 +161,12 @@ public:
 	compression_finalize_append_t finalize_append;
 	//! Revert append (optional)
 	compression_revert_append_t revert_append;
+
+	//! Filter a vector directly on the compressed data (optional)
+	//! This is used for constant comparisons pushed down into the scan, and is only called for an entire vector that
+	//! lies within a single segment. The filter refines the selection vector and advances the scan state by
+	//! scan_count rows. The result only needs to hold the correct values for the rows that pass the filter
+	compression_filter_t filter;
 };
 
 //! The set of compression functions
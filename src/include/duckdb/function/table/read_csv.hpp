@@ -51,6 +51,8 @@ struct ReadCSVData : public BaseCSVData {
 	//! The initial reader (if any): this is used when automatic detection is used during binding.
 	//! In this case, the CSV reader is already created and might as well be re-used.
 	unique_ptr<BufferedCSVReader> initial_reader;
+	//! The size of the first file if it is a plain file on disk (zero otherwise), used to estimate the parallelism
+	idx_t first_file_size = 0;
 	//! Total File Size
 	atomic<idx_t> file_size;
 	//! How many bytes were read up to this point
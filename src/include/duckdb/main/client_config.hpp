@@ -48,6 +48,15 @@ struct ClientConfig {
 	//! Maximum bits allowed for using a perfect hash table (i.e. the perfect HT can hold up to 2^perfect_ht_threshold
 	//! elements)
 	idx_t perfect_ht_threshold = 12;
+	//! Whether or not hash joins use an open-addressing hash table with hash tags instead of chained buckets. This pays
+	//! off for selective joins on keys that are expensive to compare (e.g. strings), as rows whose tag does not match
+	//! are never touched.
+	bool hash_join_tag_probing = false;
+	//! Whether or not COPY TO writes the rows to the file in the order in which the query produces them. Without
+	//! this, COPY TO writes the file from multiple threads.
+	bool preserve_insertion_order = true;
+	//! The maximum number of files that a thread keeps open at once when COPY TO writes a partitioned dataset
+	idx_t partitioned_write_max_open_files = 100;
 
 	//! The explain output type used when none is specified (default: PHYSICAL_ONLY)
 	ExplainOutputType explain_output_type = ExplainOutputType::PHYSICAL_ONLY;
@@ -20,6 +20,7 @@
 #include <stack>
 #include "duckdb/common/pair.hpp"
 #include "duckdb/common/deque.hpp"
+#include "duckdb/common/map.hpp"
 
 namespace duckdb {
 class ClientContext;
@@ -91,6 +92,8 @@ struct OperatorInformation {
 	string name;
 	//! A vector of Expression Executor Info
 	vector<unique_ptr<ExpressionExecutorInfo>> executors_info;
+	//! Operator-specific counters, e.g. how often an operator chose a specific strategy
+	map<string, idx_t> counters;
 };
 
 //! The OperatorProfiler measures timings of individual operators
@@ -104,6 +107,8 @@ public:
 	DUCKDB_API void EndOperator(DataChunk *chunk);
 	DUCKDB_API void Flush(const PhysicalOperator *phys_op, ExpressionExecutor *expression_executor, const string &name,
 	                      int id);
+	//! Add the given value to an operator-specific counter
+	DUCKDB_API void AddCounter(const PhysicalOperator *phys_op, const string &name, idx_t value);
 
 	~OperatorProfiler() {
 	}
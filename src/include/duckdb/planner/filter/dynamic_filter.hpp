@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/planner/filter/dynamic_filter.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/types/selection_vector.hpp"
+#include "duckdb/common/types/validity_mask.hpp"
+#include "duckdb/planner/table_filter.hpp"
+
+namespace duckdb {
+class NumericStatistics;
+class Vector;
+
+//! DynamicFilterData holds the filter on the join keys that a hash join publishes once its build side is complete
+class DynamicFilterData {
+public:
+	//! The maximum amount of build keys for which a Bloom filter is created
+	static constexpr const idx_t MAX_BLOOM_FILTER_KEYS = 1 << 22;
+	//! After this amount of keys have been checked against the Bloom filter, it is disabled if it is not selective
+	static constexpr const idx_t BLOOM_FILTER_SAMPLE_SIZE = 64 * STANDARD_VECTOR_SIZE;
+
+	//! Whether or not the filter has been initialized, if not all rows pass the filter
+	atomic<bool> initialized;
+	//! The range of the build keys, i.e. (>= min AND <= max) (if any)
+	unique_ptr<TableFilter> range_filter;
+	//! A blocked Bloom filter on the hashes of the build keys (if any): every key sets three bits in a single word
+	vector<uint64_t> bloom_filter;
+
+public:
+	DynamicFilterData();
+
+	//! Clear the filter, after which all rows pass it
+	void Reset();
+	//! Set the range of the filter to the [min, max] of the given statistics
+	void SetRange(NumericStatistics &stats);
+	//! Allocate a Bloom filter for the given amount of keys
+	void InitializeBloomFilter(idx_t key_count);
+	//! Insert the hashes of build keys into the Bloom filter
+	void InsertHashes(hash_t *hashes, idx_t count);
+
+	bool HasBloomFilter() const {
+		return !bloom_filter.empty() && bloom_filter_enabled;
+	}
+	//! Filter the selected rows of the given vector with the Bloom filter
+	void FilterBloom(Vector &keys, SelectionVector &sel, idx_t &approved_tuple_count, ValidityMask &mask);
+
+private:
+	idx_t bloom_mask;
+	atomic<bool> bloom_filter_enabled;
+	atomic<idx_t> bloom_checked_count;
+	atomic<idx_t> bloom_passed_count;
+
+	inline idx_t BloomFilterWord(hash_t hash) const {
+		return (hash >> 32) & bloom_mask;
+	}
+	static inline uint64_t BloomFilterBits(hash_t hash) {
+		return (uint64_t(1) << (hash & 63)) | (uint64_t(1) << ((hash >> 6) & 63)) |
+		       (uint64_t(1) << ((hash >> 12) & 63));
+	}
+};
+
+//! DynamicFilter is a filter on the probe side of a hash join that is pushed into the table scan at planning time,
+//! but only filters rows once the hash join has finished its build side and filled in the filter data
+class DynamicFilter : public TableFilter {
+public:
+	explicit DynamicFilter(shared_ptr<DynamicFilterData> data);
+
+	//! The filter data, which is shared with the hash join
+	shared_ptr<DynamicFilterData> data;
+
+public:
+	FilterPropagateResult CheckStatistics(BaseStatistics &stats) override;
+	string ToString(const string &column_name) override;
+	bool Equals(const TableFilter &other) const override;
+};
+
+} // namespace duckdb
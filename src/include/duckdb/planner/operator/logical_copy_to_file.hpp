@@ -20,6 +20,12 @@ public:
 	}
 	CopyFunction function;
 	unique_ptr<FunctionData> bind_data;
+	//! The file to write to, or the root directory of the partitions if the copy is partitioned
+	string file_path;
+	//! The names of the columns of the child
+	vector<string> names;
+	//! The columns (of the child) by which the rows are partitioned into directories, if any
+	vector<idx_t> partition_columns;
 
 protected:
 	void ResolveTypes() override {
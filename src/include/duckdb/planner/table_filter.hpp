@@ -21,7 +21,8 @@ enum class TableFilterType : uint8_t {
 	IS_NULL = 1,
 	IS_NOT_NULL = 2,
 	CONJUNCTION_OR = 3,
-	CONJUNCTION_AND = 4
+	CONJUNCTION_AND = 4,
+	DYNAMIC_FILTER = 5 // filter on the keys of a hash join, which is filled in after the build side is complete
 };
 
 //! TableFilter represents a filter pushed down into the table scan.
@@ -56,6 +56,12 @@ public:
 
 	void UnregisterBlock(block_id_t block_id, bool can_destroy);
 
+	//! Account for memory that is allocated outside of the buffer manager (e.g. the nodes of an index). Blocks are
+	//! evicted to make room for it, throws an OutOfMemoryException if that is not possible.
+	void ReserveMemory(idx_t size);
+	//! Release memory that was accounted for with ReserveMemory
+	void FreeReservedMemory(idx_t size);
+
 	//! Set a new memory limit to the buffer manager, throws an exception if the new limit is too low and not enough
 	//! blocks can be evicted
 	void SetLimit(idx_t limit = (idx_t)-1);
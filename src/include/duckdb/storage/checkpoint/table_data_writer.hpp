@@ -39,6 +39,10 @@ public:
 
 	CompressionType GetColumnCompressionType(idx_t i);
 
+private:
+	//! Write the indexes of the UNIQUE and PRIMARY KEY constraints of the table
+	vector<IndexPointer> WriteIndexes();
+
 private:
 	CheckpointManager &checkpoint_manager;
 	TableCatalogEntry &table;
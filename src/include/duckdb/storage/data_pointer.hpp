@@ -37,4 +37,11 @@ struct RowGroupPointer {
 	shared_ptr<VersionNode> versions;
 };
 
+struct IndexPointer {
+	//! The location of the root node of the index
+	BlockPointer root;
+	//! The blocks the nodes of the index are stored in
+	vector<block_id_t> blocks;
+};
+
 } // namespace duckdb
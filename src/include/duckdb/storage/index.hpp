@@ -77,6 +77,16 @@ public:
 	//! Insert data into the index. Does not lock the index.
 	virtual bool Insert(IndexLock &lock, DataChunk &input, Vector &row_identifiers) = 0;
 
+	//! Initialize the construction of the index from the existing rows of a table
+	virtual unique_ptr<IndexConstructState> InitializeConstruct();
+	//! Add existing rows to the index under construction, by default they are inserted directly. Does not lock the
+	//! index.
+	virtual bool ConstructAppend(IndexLock &lock, IndexConstructState &state, DataChunk &input,
+	                             Vector &row_identifiers);
+	//! Finish the construction of the index, after all existing rows have been added. Returns false if a constraint
+	//! was violated. Does not lock the index.
+	virtual bool ConstructFinalize(IndexLock &lock, IndexConstructState &state);
+
 	//! Returns true if the index is affected by updates on the specified column ids, and false otherwise
 	bool IndexIsUpdated(const vector<column_t> &column_ids) const;
 
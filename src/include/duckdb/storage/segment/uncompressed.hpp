@@ -35,6 +35,19 @@ public:
 	static const validity_t UPPER_MASKS[65];
 };
 
+struct StringDictionaryContainer {
+	//! The size of the dictionary
+	uint32_t size;
+	//! The end of the dictionary (typically Storage::BLOCK_SIZE)
+	uint32_t end;
+
+	void Verify() {
+		D_ASSERT(size <= Storage::BLOCK_SIZE);
+		D_ASSERT(end <= Storage::BLOCK_SIZE);
+		D_ASSERT(size <= end);
+	}
+};
+
 struct StringUncompressed {
 public:
 	static CompressionFunction GetFunction(PhysicalType data_type);
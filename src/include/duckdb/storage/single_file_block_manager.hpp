@@ -14,6 +14,7 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/unordered_set.hpp"
 #include "duckdb/common/set.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/common/vector.hpp"
 
 namespace duckdb {
@@ -61,7 +62,9 @@ public:
 private:
 	void Initialize(DatabaseHeader &header);
 
-	//! Return the blocks to which we will write the free list and modified blocks
+	//! Return the next free block id, the block lock must be held
+	block_id_t GetFreeBlockIdInternal();
+	//! Return the blocks to which we will write the free list and modified blocks, the block lock must be held
 	vector<block_id_t> GetFreeListBlocks();
 
 private:
@@ -82,6 +85,9 @@ private:
 	unordered_map<block_id_t, uint32_t> multi_use_blocks;
 	//! The list of blocks that will be added to the free list
 	unordered_set<block_id_t> modified_blocks;
+	//! Lock for the free list, the multi-use blocks and the modified blocks, as blocks can be marked as modified while
+	//! an index is loaded from another thread
+	mutex block_lock;
 	//! The current meta block id
 	block_id_t meta_block;
 	//! The current maximum block id, this id will be given away first after the free_list runs out
@@ -132,6 +132,10 @@ protected:
 	//! If ALLOW_UPDATES is set to false, the function will instead throw an exception if any updates are found
 	template <bool SCAN_COMMITTED, bool ALLOW_UPDATES>
 	idx_t ScanVector(Transaction *transaction, idx_t vector_index, ColumnScanState &state, Vector &result);
+	//! Scans a base vector from the column while evaluating the filter directly on the compressed data
+	//! Returns false (without scanning anything) if the filter cannot be pushed into the current segment
+	bool FilterCompressedVector(ColumnScanState &state, Vector &result, SelectionVector &sel, idx_t &count,
+	                            const TableFilter &filter);
 
 protected:
 	//! The segments holding the data of this column segment
@@ -69,6 +69,11 @@ public:
 
 	static void FilterSelection(SelectionVector &sel, Vector &result, const TableFilter &filter,
 	                            idx_t &approved_tuple_count, ValidityMask &mask);
+	//! Whether or not the filter can be evaluated directly on the compressed data of this segment
+	bool SupportsFilter(const TableFilter &filter);
+	//! Scan one entire vector from this segment, evaluating the filter on the compressed data
+	void Filter(ColumnScanState &state, idx_t scan_count, Vector &result, SelectionVector &sel,
+	            idx_t &approved_tuple_count, const TableFilter &filter);
 
 	//! Skip a scan forward to the row_index specified in the scan state
 	void Skip(ColumnScanState &state);
@@ -23,6 +23,8 @@ public:
 
 	vector<RowGroupPointer> row_groups;
 	vector<unique_ptr<BaseStatistics>> column_stats;
+	//! The serialized indexes of the UNIQUE and PRIMARY KEY constraints of the table
+	vector<IndexPointer> indexes;
 };
 
 } // namespace duckdb
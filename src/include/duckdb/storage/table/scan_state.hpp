@@ -35,6 +35,11 @@ struct IndexScanState {
 	}
 };
 
+struct IndexConstructState {
+	virtual ~IndexConstructState() {
+	}
+};
+
 typedef unordered_map<block_id_t, unique_ptr<BufferHandle>> buffer_handle_set_t;
 
 struct ColumnScanState {
@@ -65,6 +70,9 @@ public:
 struct ColumnFetchState {
 	//! The set of pinned block handles for this set of fetches
 	buffer_handle_set_t handles;
+	//! The decoding states of compressed segments, so consecutive fetches from the same segment do not have to set
+	//! up the decoding again
+	unordered_map<ColumnSegment *, unique_ptr<SegmentScanState>> segment_states;
 	//! Any child states of the fetch
 	vector<unique_ptr<ColumnFetchState>> child_states;
 };
@@ -83,6 +83,7 @@ bool QueryProfiler::OperatorRequiresProfiling(PhysicalOperatorType op_type) {
 	case PhysicalOperatorType::HASH_JOIN:
 	case PhysicalOperatorType::CROSS_PRODUCT:
 	case PhysicalOperatorType::PIECEWISE_MERGE_JOIN:
+	case PhysicalOperatorType::IE_JOIN:
 	case PhysicalOperatorType::DELIM_JOIN:
 	case PhysicalOperatorType::UNION:
 	case PhysicalOperatorType::RECURSIVE_CTE:
@@ -264,6 +265,13 @@ void OperatorProfiler::Flush(const PhysicalOperator *phys_op, ExpressionExecutor
 	operator_timing.name = phys_op->GetName();
 }
 
+void OperatorProfiler::AddCounter(const PhysicalOperator *phys_op, const string &name, idx_t value) {
+	if (!enabled) {
+		return;
+	}
+	timings[phys_op].counters[name] += value;
+}
+
 void QueryProfiler::Flush(OperatorProfiler &profiler) {
 	if (!IsEnabled() || !running) {
 		return;
@@ -275,6 +283,9 @@ void QueryProfiler::Flush(OperatorProfiler &profiler) {
 
 		entry->second->info.time += node.second.time;
 		entry->second->info.elements += node.second.elements;
+		for (auto &counter : node.second.counters) {
+			entry->second->info.counters[counter.first] += counter.second;
+		}
 		if (!IsDetailedEnabled()) {
 			continue;
 		}
@@ -470,6 +481,15 @@ static void ToJSONRecursive(QueryProfiler::TreeNode &node, std::ostream &ss, int
 	ss << string(depth * 3, ' ') << "   \"timing\":" + to_string(node.info.time) + ",\n";
 	ss << string(depth * 3, ' ') << "   \"cardinality\":" + to_string(node.info.elements) + ",\n";
 	ss << string(depth * 3, ' ') << "   \"extra_info\": \"" + JSONSanitize(node.extra_info) + "\",\n";
+	if (!node.info.counters.empty()) {
+		ss << string(depth * 3, ' ') << "   \"counters\": {";
+		bool first = true;
+		for (auto &counter : node.info.counters) {
+			ss << (first ? "" : ", ") << "\"" + JSONSanitize(counter.first) + "\": " + to_string(counter.second);
+			first = false;
+		}
+		ss << "},\n";
+	}
 	ss << string(depth * 3, ' ') << "   \"timings\": [";
 	int32_t function_counter = 1;
 	int32_t expression_counter = 1;
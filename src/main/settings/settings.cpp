@@ -347,7 +347,7 @@ void ForceCompressionSetting::SetGlobal(DatabaseInstance *db, DBConfig &config,
 		auto compression_type = CompressionTypeFromString(compression);
 		if (compression_type == CompressionType::COMPRESSION_AUTO) {
 			throw ParserException("Unrecognized option for PRAGMA force_compression, expected none, uncompressed, rle, "
-			                      "dictionary, pfor, bitpacking or fsst");
+			                      "dictionary, pfor, bitpacking, fsst or chimp");
 		}
 		config.force_compression = compression_type;
 	}
@@ -357,6 +357,17 @@ Value ForceCompressionSetting::GetSetting(ClientContext &context) {
 	return Value();
 }
 
+//===--------------------------------------------------------------------===//
+// Hash Join Tag Probing
+//===--------------------------------------------------------------------===//
+void HashJoinTagProbingSetting::SetLocal(ClientContext &context, const Value &input) {
+	ClientConfig::GetConfig(context).hash_join_tag_probing = input.GetValue<bool>();
+}
+
+Value HashJoinTagProbingSetting::GetSetting(ClientContext &context) {
+	return Value::BOOLEAN(ClientConfig::GetConfig(context).hash_join_tag_probing);
+}
+
 //===--------------------------------------------------------------------===//
 // Log Query Path
 //===--------------------------------------------------------------------===//
@@ -391,6 +402,21 @@ Value MaximumMemorySetting::GetSetting(ClientContext &context) {
 	return Value(StringUtil::BytesToHumanReadableString(config.maximum_memory));
 }
 
+//===--------------------------------------------------------------------===//
+// Partitioned Write Max Open Files
+//===--------------------------------------------------------------------===//
+void PartitionedWriteMaxOpenFilesSetting::SetLocal(ClientContext &context, const Value &input) {
+	auto max_open_files = input.GetValue<int64_t>();
+	if (max_open_files < 1) {
+		throw ParserException("The maximum number of open files of a partitioned write must be at least 1");
+	}
+	ClientConfig::GetConfig(context).partitioned_write_max_open_files = max_open_files;
+}
+
+Value PartitionedWriteMaxOpenFilesSetting::GetSetting(ClientContext &context) {
+	return Value::BIGINT(ClientConfig::GetConfig(context).partitioned_write_max_open_files);
+}
+
 //===--------------------------------------------------------------------===//
 // Perfect Hash Threshold
 //===--------------------------------------------------------------------===//
@@ -406,6 +432,17 @@ Value PerfectHashThresholdSetting::GetSetting(ClientContext &context) {
 	return Value::BIGINT(ClientConfig::GetConfig(context).perfect_ht_threshold);
 }
 
+//===--------------------------------------------------------------------===//
+// Preserve Insertion Order
+//===--------------------------------------------------------------------===//
+void PreserveInsertionOrderSetting::SetLocal(ClientContext &context, const Value &input) {
+	ClientConfig::GetConfig(context).preserve_insertion_order = input.GetValue<bool>();
+}
+
+Value PreserveInsertionOrderSetting::GetSetting(ClientContext &context) {
+	return Value::BOOLEAN(ClientConfig::GetConfig(context).preserve_insertion_order);
+}
+
 //===--------------------------------------------------------------------===//
 // Profiler History Size
 //===--------------------------------------------------------------------===//
@@ -209,8 +209,9 @@ void Executor::ExtractPipelines(shared_ptr<Pipeline> &pipeline, vector<shared_pt
 	}
 	auto child_entry = child_pipelines.find(pipeline_ptr);
 	if (child_entry != child_pipelines.end()) {
-		for (auto &entry : child_entry->second) {
-			ExtractPipelines(entry, result);
+		// child entries are added from top to bottom, but the bottom ones have to run first
+		for (idx_t i = child_entry->second.size(); i > 0; i--) {
+			ExtractPipelines(child_entry->second[i - 1], result);
 		}
 		child_pipelines.erase(pipeline_ptr);
 	}
@@ -467,6 +468,7 @@ void Executor::BuildPipelines(PhysicalOperator *op, Pipeline *current) {
 		case PhysicalOperatorType::BLOCKWISE_NL_JOIN:
 		case PhysicalOperatorType::HASH_JOIN:
 		case PhysicalOperatorType::PIECEWISE_MERGE_JOIN:
+		case PhysicalOperatorType::IE_JOIN:
 		case PhysicalOperatorType::CROSS_PRODUCT:
 			// regular join, create a pipeline with RHS source that sinks into this pipeline
 			pipeline_child = op->children[1].get();
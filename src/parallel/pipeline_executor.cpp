@@ -218,6 +218,9 @@ void PipelineExecutor::PullFinalize() {
 		throw InternalException("Calling PullFinalize on a pipeline that has been finalized already");
 	}
 	finalized = true;
+	for (idx_t i = 0; i < intermediate_states.size(); i++) {
+		intermediate_states[i]->Finalize(pipeline.operators[i], context);
+	}
 	pipeline.executor.Flush(thread);
 }
 
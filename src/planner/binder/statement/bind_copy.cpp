@@ -1,4 +1,5 @@
 #include "duckdb/catalog/catalog.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/parser/statement/copy_statement.hpp"
 #include "duckdb/planner/binder.hpp"
 #include "duckdb/parser/statement/insert_statement.hpp"
@@ -38,10 +39,56 @@ BoundStatement Binder::BindCopyTo(CopyStatement &stmt) {
 		throw NotImplementedException("COPY TO is not supported for FORMAT \"%s\"", stmt.info->format);
 	}
 
-	auto function_data =
-	    copy_function->function.copy_to_bind(context, *stmt.info, select_node.names, select_node.types);
+	// PARTITION_BY is handled by the COPY itself: the partition columns are written as directories, not to the files
+	vector<idx_t> partition_columns;
+	for (auto &option : stmt.info->options) {
+		if (StringUtil::Lower(option.first) != "partition_by") {
+			continue;
+		}
+		for (auto &column : option.second) {
+			// column names are matched case insensitively, like everywhere else
+			auto column_name = column.ToString();
+			auto lower_name = StringUtil::Lower(column_name);
+			idx_t column_idx;
+			for (column_idx = 0; column_idx < select_node.names.size(); column_idx++) {
+				if (StringUtil::Lower(select_node.names[column_idx]) == lower_name) {
+					break;
+				}
+			}
+			if (column_idx == select_node.names.size()) {
+				throw BinderException("PARTITION_BY column \"%s\" not found in the COPY source", column_name);
+			}
+			if (std::find(partition_columns.begin(), partition_columns.end(), column_idx) ==
+			    partition_columns.end()) {
+				partition_columns.push_back(column_idx);
+			}
+		}
+		if (partition_columns.empty()) {
+			throw BinderException("PARTITION_BY requires at least one column");
+		}
+		// copy the key, since erasing the option destroys it
+		auto option_name = option.first;
+		stmt.info->options.erase(option_name);
+		break;
+	}
+	vector<string> names;
+	vector<LogicalType> types;
+	for (idx_t i = 0; i < select_node.names.size(); i++) {
+		if (std::find(partition_columns.begin(), partition_columns.end(), i) == partition_columns.end()) {
+			names.push_back(select_node.names[i]);
+			types.push_back(select_node.types[i]);
+		}
+	}
+	if (names.empty()) {
+		throw BinderException("PARTITION_BY cannot partition by all columns of the COPY source");
+	}
+
+	auto function_data = copy_function->function.copy_to_bind(context, *stmt.info, names, types);
 	// now create the copy information
 	auto copy = make_unique<LogicalCopyToFile>(copy_function->function, move(function_data));
+	copy->file_path = stmt.info->file_path;
+	copy->names = select_node.names;
+	copy->partition_columns = move(partition_columns);
 	copy->AddChild(move(select_node.plan));
 
 	result.plan = move(copy);
@@ -0,0 +1,107 @@
+#include "duckdb/planner/filter/dynamic_filter.hpp"
+
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/storage/statistics/numeric_statistics.hpp"
+
+namespace duckdb {
+
+DynamicFilterData::DynamicFilterData()
+    : initialized(false), bloom_mask(0), bloom_filter_enabled(false), bloom_checked_count(0), bloom_passed_count(0) {
+}
+
+void DynamicFilterData::Reset() {
+	initialized = false;
+	range_filter.reset();
+	bloom_filter.clear();
+	bloom_mask = 0;
+	bloom_filter_enabled = false;
+	bloom_checked_count = 0;
+	bloom_passed_count = 0;
+}
+
+void DynamicFilterData::SetRange(NumericStatistics &stats) {
+	D_ASSERT(!initialized);
+	auto and_filter = make_unique<ConjunctionAndFilter>();
+	and_filter->child_filters.push_back(
+	    make_unique<ConstantFilter>(ExpressionType::COMPARE_GREATERTHANOREQUALTO, stats.min));
+	and_filter->child_filters.push_back(
+	    make_unique<ConstantFilter>(ExpressionType::COMPARE_LESSTHANOREQUALTO, stats.max));
+	range_filter = move(and_filter);
+}
+
+void DynamicFilterData::InitializeBloomFilter(idx_t key_count) {
+	D_ASSERT(!initialized);
+	D_ASSERT(key_count > 0 && key_count <= MAX_BLOOM_FILTER_KEYS);
+	// use between 8 and 16 bits per key
+	idx_t word_count = NextPowerOfTwo((key_count + 7) / 8);
+	bloom_filter.resize(word_count, 0);
+	bloom_mask = word_count - 1;
+	bloom_filter_enabled = true;
+}
+
+void DynamicFilterData::InsertHashes(hash_t *hashes, idx_t count) {
+	D_ASSERT(!bloom_filter.empty());
+	for (idx_t i = 0; i < count; i++) {
+		bloom_filter[BloomFilterWord(hashes[i])] |= BloomFilterBits(hashes[i]);
+	}
+}
+
+void DynamicFilterData::FilterBloom(Vector &keys, SelectionVector &sel, idx_t &approved_tuple_count,
+                                    ValidityMask &mask) {
+	D_ASSERT(HasBloomFilter());
+	if (approved_tuple_count == 0) {
+		return;
+	}
+	Vector hashes(LogicalType::HASH);
+	VectorOperations::Hash(keys, hashes, sel, approved_tuple_count);
+	auto hash_data = FlatVector::GetData<hash_t>(hashes);
+
+	SelectionVector result_sel(approved_tuple_count);
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < approved_tuple_count; i++) {
+		auto idx = sel.get_index(i);
+		auto bits = BloomFilterBits(hash_data[idx]);
+		if (mask.RowIsValid(idx) && (bloom_filter[BloomFilterWord(hash_data[idx])] & bits) == bits) {
+			result_sel.set_index(result_count++, idx);
+		}
+	}
+
+	// disable the Bloom filter if almost all keys pass it: hashing the keys is not worth it in that case
+	auto checked_count = bloom_checked_count.fetch_add(approved_tuple_count) + approved_tuple_count;
+	auto passed_count = bloom_passed_count.fetch_add(result_count) + result_count;
+	if (checked_count >= BLOOM_FILTER_SAMPLE_SIZE && checked_count - approved_tuple_count < BLOOM_FILTER_SAMPLE_SIZE &&
+	    passed_count * 10 > checked_count * 9) {
+		bloom_filter_enabled = false;
+	}
+
+	sel.Initialize(result_sel);
+	approved_tuple_count = result_count;
+}
+
+DynamicFilter::DynamicFilter(shared_ptr<DynamicFilterData> data_p)
+    : TableFilter(TableFilterType::DYNAMIC_FILTER), data(move(data_p)) {
+}
+
+FilterPropagateResult DynamicFilter::CheckStatistics(BaseStatistics &stats) {
+	if (!data->initialized || !data->range_filter) {
+		return FilterPropagateResult::NO_PRUNING_POSSIBLE;
+	}
+	return data->range_filter->CheckStatistics(stats);
+}
+
+string DynamicFilter::ToString(const string &column_name) {
+	return column_name + " IN DYNAMIC_FILTER";
+}
+
+bool DynamicFilter::Equals(const TableFilter &other_p) const {
+	if (!TableFilter::Equals(other_p)) {
+		return false;
+	}
+	auto &other = (DynamicFilter &)other_p;
+	return data == other.data;
+}
+
+} // namespace duckdb
@@ -373,6 +373,17 @@ void BufferManager::UnregisterBlock(block_id_t block_id, bool can_destroy) {
 		blocks.erase(block_id);
 	}
 }
+
+void BufferManager::ReserveMemory(idx_t size) {
+	if (!EvictBlocks(size, maximum_memory)) {
+		throw OutOfMemoryException("could not reserve %lld bytes%s", size, InMemoryWarning());
+	}
+}
+
+void BufferManager::FreeReservedMemory(idx_t size) {
+	current_memory -= size;
+}
+
 void BufferManager::SetLimit(idx_t limit) {
 	lock_guard<mutex> l_lock(limit_lock);
 	// try to evict until the limit is reached
@@ -36,6 +36,21 @@ void TableDataReader::ReadTableData() {
 		auto row_group_pointer = RowGroup::Deserialize(reader, columns);
 		info.data->row_groups.push_back(move(row_group_pointer));
 	}
+
+	// deserialize the locations of the indexes of the UNIQUE and PRIMARY KEY constraints
+	auto index_count = reader.Read<uint64_t>();
+	info.data->indexes.reserve(index_count);
+	for (idx_t i = 0; i < index_count; i++) {
+		IndexPointer index_pointer;
+		index_pointer.root.block_id = reader.Read<block_id_t>();
+		index_pointer.root.offset = reader.Read<uint32_t>();
+		auto block_count = reader.Read<uint64_t>();
+		index_pointer.blocks.reserve(block_count);
+		for (idx_t block_idx = 0; block_idx < block_count; block_idx++) {
+			index_pointer.blocks.push_back(reader.Read<block_id_t>());
+		}
+		info.data->indexes.push_back(move(index_pointer));
+	}
 }
 
 } // namespace duckdb
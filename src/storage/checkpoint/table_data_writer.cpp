@@ -5,6 +5,9 @@
 
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/common/serializer/buffered_serializer.hpp"
+#include "duckdb/execution/index/art/art.hpp"
+#include "duckdb/planner/constraints/bound_unique_constraint.hpp"
+#include "duckdb/common/unordered_set.hpp"
 
 namespace duckdb {
 
@@ -17,8 +20,49 @@ TableDataWriter::~TableDataWriter() {
 }
 
 BlockPointer TableDataWriter::WriteTableData() {
+	// write the indexes of the UNIQUE and PRIMARY KEY constraints, so they don't have to be rebuilt on load
+	auto index_pointers = WriteIndexes();
 	// start scanning the table and append the data to the uncompressed segments
-	return table.storage->Checkpoint(*this);
+	auto pointer = table.storage->Checkpoint(*this);
+	// the locations of the indexes are stored after the row groups
+	meta_writer.Write<uint64_t>(index_pointers.size());
+	for (auto &index_pointer : index_pointers) {
+		meta_writer.Write<block_id_t>(index_pointer.root.block_id);
+		meta_writer.Write<uint32_t>(index_pointer.root.offset);
+		meta_writer.Write<uint64_t>(index_pointer.blocks.size());
+		for (auto &block_id : index_pointer.blocks) {
+			meta_writer.Write<block_id_t>(block_id);
+		}
+	}
+	return pointer;
+}
+
+vector<IndexPointer> TableDataWriter::WriteIndexes() {
+	// write the index of every UNIQUE and PRIMARY KEY constraint, in the order of the constraints
+	vector<IndexPointer> result;
+	unordered_set<Index *> written_indexes;
+	for (auto &constraint : table.bound_constraints) {
+		if (constraint->type != ConstraintType::UNIQUE) {
+			continue;
+		}
+		auto &unique = (BoundUniqueConstraint &)*constraint;
+		Index *constraint_index = nullptr;
+		table.storage->info->indexes.Scan([&](Index &index) {
+			if (index.type == IndexType::ART && index.is_unique && index.is_primary == unique.is_primary_key &&
+			    index.column_ids == unique.keys && written_indexes.find(&index) == written_indexes.end()) {
+				constraint_index = &index;
+				return true;
+			}
+			return false;
+		});
+		if (!constraint_index) {
+			throw InternalException("Could not find the index of a UNIQUE constraint of table \"%s\"", table.name);
+		}
+		written_indexes.insert(constraint_index);
+		auto &art = (ART &)*constraint_index;
+		result.push_back(art.Serialize(meta_writer));
+	}
+	return result;
 }
 
 CompressionType TableDataWriter::GetColumnCompressionType(idx_t i) {
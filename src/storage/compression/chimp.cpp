@@ -0,0 +1,552 @@
+#include "duckdb/common/limits.hpp"
+#include "duckdb/function/compression/compression.hpp"
+#include "duckdb/function/compression_function.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/statistics/numeric_statistics.hpp"
+#include "duckdb/storage/table/column_data_checkpointer.hpp"
+#include "duckdb/storage/table/column_segment.hpp"
+
+namespace duckdb {
+
+//! Chimp compression for floating point values: every value is XOR-ed with its predecessor, and only the meaningful
+//! bits of the XOR result are stored. Every value is encoded with a 2-bit flag:
+//! 00: the value is equal to the previous value
+//! 01: [leading zeros (3 bits)][significant bits (6 bits)][significant bits], for results with many trailing zeros
+//! 10: [leading zeros (3 bits)][all bits after the leading zeros]
+//! 11: [all bits after the leading zeros], using the leading zeros of the previous value
+//! The values are split into groups of CHIMP_GROUP_SIZE values that are encoded independently. The segment stores the
+//! offsets of the groups at the end of the segment (growing downwards), so a fetch only needs to decode one group.
+static constexpr const idx_t CHIMP_GROUP_SIZE = 1024;
+
+template <class T>
+struct ChimpType {};
+
+template <>
+struct ChimpType<double> {
+	using type = uint64_t;
+};
+
+template <>
+struct ChimpType<float> {
+	using type = uint32_t;
+};
+
+//! Writes a stream of bits, the most significant bit of every byte is written first. The buffer must be zeroed.
+struct ChimpBitWriter {
+	explicit ChimpBitWriter(data_ptr_t buffer_p) : buffer(buffer_p), bit_position(0) {
+	}
+
+	data_ptr_t buffer;
+	idx_t bit_position;
+
+	void WriteBits(uint64_t value, uint8_t count) {
+		while (count > 0) {
+			auto byte_offset = bit_position / 8;
+			uint8_t space = 8 - bit_position % 8;
+			uint8_t to_write = MinValue<uint8_t>(space, count);
+			auto bits = (uint8_t)((value >> (count - to_write)) & ((1U << to_write) - 1));
+			buffer[byte_offset] |= bits << (space - to_write);
+			bit_position += to_write;
+			count -= to_write;
+		}
+	}
+
+	idx_t BytesWritten() const {
+		return (bit_position + 7) / 8;
+	}
+};
+
+struct ChimpBitReader {
+	explicit ChimpBitReader(data_ptr_t buffer_p) : buffer(buffer_p), bit_position(0) {
+	}
+
+	data_ptr_t buffer;
+	idx_t bit_position;
+
+	uint64_t ReadBits(uint8_t count) {
+		uint64_t result = 0;
+		while (count > 0) {
+			auto byte_offset = bit_position / 8;
+			uint8_t available = 8 - bit_position % 8;
+			uint8_t to_read = MinValue<uint8_t>(available, count);
+			auto bits = (buffer[byte_offset] >> (available - to_read)) & ((1U << to_read) - 1);
+			result = (result << to_read) | bits;
+			bit_position += to_read;
+			count -= to_read;
+		}
+		return result;
+	}
+};
+
+template <class T>
+struct ChimpGroup {
+	using INTERNAL_TYPE = typename ChimpType<T>::type;
+
+	static constexpr const uint8_t BIT_SIZE = sizeof(INTERNAL_TYPE) * 8;
+	//! XOR results with more trailing zeros than this are stored without their trailing zeros
+	static constexpr const uint8_t TRAILING_ZERO_THRESHOLD = 6;
+	//! Marker for "no previous leading zero count"
+	static constexpr const uint8_t NO_LEADING_ZEROS = 255;
+	//! The maximum size of an encoded group (2 flag bits + 3 leading zero bits + 6 length bits + the value)
+	static constexpr const idx_t MAX_GROUP_SIZE = (CHIMP_GROUP_SIZE * (11 + BIT_SIZE) + 7) / 8;
+
+	//! The leading zero counts that can be represented, indexed by their 3-bit representation
+	static uint8_t LeadingZeroValue(uint8_t representation) {
+		static const uint8_t LEADING_ZERO_VALUES[] = {0, 8, 12, 16, 18, 20, 22, 24};
+		return LEADING_ZERO_VALUES[representation];
+	}
+
+	//! Rounds a leading zero count down to a representable value, returns the 3-bit representation
+	static uint8_t LeadingZeroRepresentation(uint8_t leading_zeros) {
+		if (leading_zeros >= 24) {
+			return 7;
+		} else if (leading_zeros >= 16) {
+			return 3 + (leading_zeros - 16) / 2;
+		} else if (leading_zeros >= 12) {
+			return 2;
+		} else if (leading_zeros >= 8) {
+			return 1;
+		}
+		return 0;
+	}
+
+	static uint8_t CountLeadingZeros(INTERNAL_TYPE value) {
+		D_ASSERT(value != 0);
+		uint8_t result = 0;
+		INTERNAL_TYPE mask = (INTERNAL_TYPE)1 << (BIT_SIZE - 1);
+		while (!(value & mask)) {
+			result++;
+			mask >>= 1;
+		}
+		return result;
+	}
+
+	static uint8_t CountTrailingZeros(INTERNAL_TYPE value) {
+		D_ASSERT(value != 0);
+		uint8_t result = 0;
+		while (!(value & 1)) {
+			result++;
+			value >>= 1;
+		}
+		return result;
+	}
+
+	//! Encodes a group of values into "dst" (which must hold MAX_GROUP_SIZE zeroed bytes), returns the encoded size
+	static idx_t Encode(INTERNAL_TYPE *values, idx_t count, data_ptr_t dst) {
+		ChimpBitWriter writer(dst);
+		INTERNAL_TYPE previous = 0;
+		uint8_t previous_leading_zeros = NO_LEADING_ZEROS;
+		for (idx_t i = 0; i < count; i++) {
+			INTERNAL_TYPE xor_result = values[i] ^ previous;
+			previous = values[i];
+			if (xor_result == 0) {
+				writer.WriteBits(0, 2);
+				continue;
+			}
+			auto representation = LeadingZeroRepresentation(CountLeadingZeros(xor_result));
+			auto leading_zeros = LeadingZeroValue(representation);
+			auto trailing_zeros = CountTrailingZeros(xor_result);
+			if (trailing_zeros > TRAILING_ZERO_THRESHOLD) {
+				uint8_t significant_bits = BIT_SIZE - leading_zeros - trailing_zeros;
+				writer.WriteBits(1, 2);
+				writer.WriteBits(representation, 3);
+				writer.WriteBits(significant_bits, 6);
+				writer.WriteBits(xor_result >> trailing_zeros, significant_bits);
+				previous_leading_zeros = leading_zeros;
+			} else if (leading_zeros == previous_leading_zeros) {
+				writer.WriteBits(3, 2);
+				writer.WriteBits(xor_result, BIT_SIZE - leading_zeros);
+			} else {
+				writer.WriteBits(2, 2);
+				writer.WriteBits(representation, 3);
+				writer.WriteBits(xor_result, BIT_SIZE - leading_zeros);
+				previous_leading_zeros = leading_zeros;
+			}
+		}
+		return writer.BytesWritten();
+	}
+
+	//! Decodes the first "count" values of a group
+	static void Decode(data_ptr_t src, idx_t count, INTERNAL_TYPE *dst) {
+		ChimpBitReader reader(src);
+		INTERNAL_TYPE previous = 0;
+		uint8_t previous_leading_zeros = NO_LEADING_ZEROS;
+		for (idx_t i = 0; i < count; i++) {
+			auto flag = reader.ReadBits(2);
+			INTERNAL_TYPE xor_result;
+			switch (flag) {
+			case 0:
+				xor_result = 0;
+				break;
+			case 1: {
+				auto leading_zeros = LeadingZeroValue(reader.ReadBits(3));
+				auto significant_bits = (uint8_t)reader.ReadBits(6);
+				uint8_t trailing_zeros = BIT_SIZE - leading_zeros - significant_bits;
+				xor_result = (INTERNAL_TYPE)reader.ReadBits(significant_bits) << trailing_zeros;
+				previous_leading_zeros = leading_zeros;
+				break;
+			}
+			case 3:
+				D_ASSERT(previous_leading_zeros != NO_LEADING_ZEROS);
+				xor_result = reader.ReadBits(BIT_SIZE - previous_leading_zeros);
+				break;
+			default: {
+				auto leading_zeros = LeadingZeroValue(reader.ReadBits(3));
+				xor_result = reader.ReadBits(BIT_SIZE - leading_zeros);
+				previous_leading_zeros = leading_zeros;
+				break;
+			}
+			}
+			previous ^= xor_result;
+			dst[i] = previous;
+		}
+	}
+};
+
+//===--------------------------------------------------------------------===//
+// Analyze
+//===--------------------------------------------------------------------===//
+template <class T>
+struct ChimpState {
+	using INTERNAL_TYPE = typename ChimpType<T>::type;
+
+	ChimpState() : buffer_idx(0), total_size(0), last_value(0) {
+	}
+
+	INTERNAL_TYPE buffer[CHIMP_GROUP_SIZE];
+	bool buffer_validity[CHIMP_GROUP_SIZE];
+	idx_t buffer_idx;
+	idx_t total_size;
+	//! NULL values are stored as a copy of the previous value, which only takes up two bits
+	INTERNAL_TYPE last_value;
+
+	void Update(T *data, ValidityMask &validity, idx_t idx) {
+		if (validity.RowIsValid(idx)) {
+			buffer_validity[buffer_idx] = true;
+			last_value = Load<INTERNAL_TYPE>((data_ptr_t)&data[idx]);
+		} else {
+			buffer_validity[buffer_idx] = false;
+		}
+		buffer[buffer_idx++] = last_value;
+	}
+};
+
+template <class T>
+struct ChimpAnalyzeState : public AnalyzeState {
+	ChimpState<T> state;
+	unique_ptr<data_t[]> scratch;
+
+	void Flush() {
+		if (state.buffer_idx == 0) {
+			return;
+		}
+		if (!scratch) {
+			scratch = unique_ptr<data_t[]>(new data_t[ChimpGroup<T>::MAX_GROUP_SIZE]);
+		}
+		// encode the group into a scratch buffer to determine its size
+		memset(scratch.get(), 0, ChimpGroup<T>::MAX_GROUP_SIZE);
+		state.total_size +=
+		    ChimpGroup<T>::Encode(state.buffer, state.buffer_idx, scratch.get()) + sizeof(uint32_t);
+		state.buffer_idx = 0;
+	}
+};
+
+template <class T>
+unique_ptr<AnalyzeState> ChimpInitAnalyze(ColumnData &col_data, PhysicalType type) {
+	return make_unique<ChimpAnalyzeState<T>>();
+}
+
+template <class T>
+bool ChimpAnalyze(AnalyzeState &state_p, Vector &input, idx_t count) {
+	auto &analyze_state = (ChimpAnalyzeState<T> &)state_p;
+	VectorData vdata;
+	input.Orrify(count, vdata);
+
+	auto data = (T *)vdata.data;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		analyze_state.state.Update(data, vdata.validity, idx);
+		if (analyze_state.state.buffer_idx == CHIMP_GROUP_SIZE) {
+			analyze_state.Flush();
+		}
+	}
+	return true;
+}
+
+template <class T>
+idx_t ChimpFinalAnalyze(AnalyzeState &state_p) {
+	auto &analyze_state = (ChimpAnalyzeState<T> &)state_p;
+	analyze_state.Flush();
+	return analyze_state.state.total_size;
+}
+
+//===--------------------------------------------------------------------===//
+// Compress
+//===--------------------------------------------------------------------===//
+template <class T>
+struct ChimpCompressState : public CompressionState {
+public:
+	explicit ChimpCompressState(ColumnDataCheckpointer &checkpointer) : checkpointer(checkpointer) {
+		auto &db = checkpointer.GetDatabase();
+		auto &type = checkpointer.GetType();
+		auto &config = DBConfig::GetConfig(db);
+		function = config.GetCompressionFunction(CompressionType::COMPRESSION_CHIMP, type.InternalType());
+		encode_buffer = unique_ptr<data_t[]>(new data_t[ChimpGroup<T>::MAX_GROUP_SIZE]);
+		CreateEmptySegment(checkpointer.GetRowGroup().start);
+	}
+
+	ColumnDataCheckpointer &checkpointer;
+	CompressionFunction *function;
+	unique_ptr<ColumnSegment> current_segment;
+	unique_ptr<BufferHandle> handle;
+
+	// Ptr to next free spot in segment;
+	data_ptr_t data_ptr;
+	// Ptr to next free spot for storing group offsets (growing downwards).
+	data_ptr_t offset_ptr;
+
+	ChimpState<T> state;
+	unique_ptr<data_t[]> encode_buffer;
+
+public:
+	// Space remaining between the offset_ptr growing down and data ptr growing up
+	idx_t RemainingSize() {
+		return offset_ptr - data_ptr;
+	}
+
+	void CreateEmptySegment(idx_t row_start) {
+		auto &db = checkpointer.GetDatabase();
+		auto &type = checkpointer.GetType();
+		auto compressed_segment = ColumnSegment::CreateTransientSegment(db, type, row_start);
+		compressed_segment->function = function;
+		current_segment = move(compressed_segment);
+		auto &buffer_manager = BufferManager::GetBufferManager(db);
+		handle = buffer_manager.Pin(current_segment->block);
+
+		data_ptr = handle->Ptr() + current_segment->GetBlockOffset() + sizeof(idx_t);
+		offset_ptr = handle->Ptr() + current_segment->GetBlockOffset() + Storage::BLOCK_SIZE - sizeof(uint32_t);
+	}
+
+	void Append(VectorData &vdata, idx_t count) {
+		auto data = (T *)vdata.data;
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = vdata.sel->get_index(i);
+			state.Update(data, vdata.validity, idx);
+			if (state.buffer_idx == CHIMP_GROUP_SIZE) {
+				FlushGroup();
+			}
+		}
+	}
+
+	void FlushGroup() {
+		if (state.buffer_idx == 0) {
+			return;
+		}
+		memset(encode_buffer.get(), 0, ChimpGroup<T>::MAX_GROUP_SIZE);
+		auto group_size = ChimpGroup<T>::Encode(state.buffer, state.buffer_idx, encode_buffer.get());
+		if (RemainingSize() < group_size + sizeof(uint32_t)) {
+			// Segment is full
+			auto row_start = current_segment->start + current_segment->count;
+			FlushSegment();
+			CreateEmptySegment(row_start);
+		}
+		for (idx_t i = 0; i < state.buffer_idx; i++) {
+			if (state.buffer_validity[i]) {
+				NumericStatistics::Update<T>(current_segment->stats, Load<T>((data_ptr_t)&state.buffer[i]));
+			}
+		}
+
+		Store<uint32_t>(data_ptr - (handle->node->buffer + current_segment->GetBlockOffset()), offset_ptr);
+		offset_ptr -= sizeof(uint32_t);
+		memcpy(data_ptr, encode_buffer.get(), group_size);
+		data_ptr += group_size;
+
+		current_segment->count += state.buffer_idx;
+		state.buffer_idx = 0;
+	}
+
+	void FlushSegment() {
+		auto &checkpoint_state = checkpointer.GetCheckpointState();
+
+		// Compact the segment by moving the group offsets next to the data.
+		idx_t minimal_offsets_offset = AlignValue(data_ptr - handle->node->buffer);
+		idx_t offsets_size = handle->node->buffer + Storage::BLOCK_SIZE - offset_ptr - sizeof(uint32_t);
+		idx_t total_segment_size = minimal_offsets_offset + offsets_size;
+		memmove(handle->node->buffer + minimal_offsets_offset, offset_ptr + sizeof(uint32_t), offsets_size);
+
+		// Store the offset of the first group offset (which is at the highest address).
+		Store<idx_t>(minimal_offsets_offset + offsets_size - sizeof(uint32_t), handle->node->buffer);
+		handle.reset();
+
+		checkpoint_state.FlushSegment(move(current_segment), total_segment_size);
+	}
+
+	void Finalize() {
+		FlushGroup();
+		FlushSegment();
+		current_segment.reset();
+	}
+};
+
+template <class T>
+unique_ptr<CompressionState> ChimpInitCompression(ColumnDataCheckpointer &checkpointer,
+                                                  unique_ptr<AnalyzeState> state) {
+	return make_unique<ChimpCompressState<T>>(checkpointer);
+}
+
+template <class T>
+void ChimpCompress(CompressionState &state_p, Vector &scan_vector, idx_t count) {
+	auto &state = (ChimpCompressState<T> &)state_p;
+	VectorData vdata;
+	scan_vector.Orrify(count, vdata);
+	state.Append(vdata, count);
+}
+
+template <class T>
+void ChimpFinalizeCompress(CompressionState &state_p) {
+	auto &state = (ChimpCompressState<T> &)state_p;
+	state.Finalize();
+}
+
+//===--------------------------------------------------------------------===//
+// Scan
+//===--------------------------------------------------------------------===//
+template <class T>
+struct ChimpScanState : public SegmentScanState {
+	using INTERNAL_TYPE = typename ChimpType<T>::type;
+
+public:
+	explicit ChimpScanState(ColumnSegment &segment) : segment_count(segment.count) {
+		auto &buffer_manager = BufferManager::GetBufferManager(segment.db);
+		handle = buffer_manager.Pin(segment.block);
+
+		// load offset to the group offsets
+		base_ptr = handle->node->buffer + segment.GetBlockOffset();
+		group_offsets_ptr = base_ptr + Load<idx_t>(base_ptr);
+	}
+
+	unique_ptr<BufferHandle> handle;
+	data_ptr_t base_ptr;
+	data_ptr_t group_offsets_ptr;
+	idx_t segment_count;
+
+	idx_t current_group = 0;
+	idx_t position_in_group = 0;
+	//! Whether or not the current group has been decoded into the decompression buffer
+	bool group_decoded = false;
+	INTERNAL_TYPE decompression_buffer[CHIMP_GROUP_SIZE];
+
+public:
+	void DecodeGroup() {
+		auto group_offset = Load<uint32_t>(group_offsets_ptr - current_group * sizeof(uint32_t));
+		auto group_count = MinValue<idx_t>(CHIMP_GROUP_SIZE, segment_count - current_group * CHIMP_GROUP_SIZE);
+		ChimpGroup<T>::Decode(base_ptr + group_offset, group_count, decompression_buffer);
+		group_decoded = true;
+	}
+
+	void Skip(idx_t skip_count) {
+		position_in_group += skip_count;
+		if (position_in_group >= CHIMP_GROUP_SIZE) {
+			current_group += position_in_group / CHIMP_GROUP_SIZE;
+			position_in_group %= CHIMP_GROUP_SIZE;
+			group_decoded = false;
+		}
+	}
+};
+
+template <class T>
+unique_ptr<SegmentScanState> ChimpInitScan(ColumnSegment &segment) {
+	auto result = make_unique<ChimpScanState<T>>(segment);
+	return move(result);
+}
+
+//===--------------------------------------------------------------------===//
+// Scan base data
+//===--------------------------------------------------------------------===//
+template <class T>
+void ChimpScanPartial(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result,
+                      idx_t result_offset) {
+	auto &scan_state = (ChimpScanState<T> &)*state.scan_state;
+
+	T *result_data = FlatVector::GetData<T>(result);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+
+	idx_t scanned = 0;
+	while (scanned < scan_count) {
+		auto to_scan = MinValue<idx_t>(scan_count - scanned, CHIMP_GROUP_SIZE - scan_state.position_in_group);
+		if (!scan_state.group_decoded) {
+			scan_state.DecodeGroup();
+		}
+		memcpy(result_data + result_offset + scanned, scan_state.decompression_buffer + scan_state.position_in_group,
+		       to_scan * sizeof(T));
+		scanned += to_scan;
+		scan_state.Skip(to_scan);
+	}
+}
+
+template <class T>
+void ChimpScan(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result) {
+	ChimpScanPartial<T>(segment, state, scan_count, result, 0);
+}
+
+//===--------------------------------------------------------------------===//
+// Fetch
+//===--------------------------------------------------------------------===//
+template <class T>
+void ChimpFetchRow(ColumnSegment &segment, ColumnFetchState &state, row_t row_id, Vector &result, idx_t result_idx) {
+	// the scan state is kept around, so fetching rows from the same group only decodes the group once
+	auto &segment_state = state.segment_states[&segment];
+	if (!segment_state) {
+		segment_state = ChimpInitScan<T>(segment);
+	}
+	auto &scan_state = (ChimpScanState<T> &)*segment_state;
+	idx_t group_idx = row_id / CHIMP_GROUP_SIZE;
+	if (!scan_state.group_decoded || scan_state.current_group != group_idx) {
+		scan_state.current_group = group_idx;
+		scan_state.DecodeGroup();
+	}
+
+	auto result_data = FlatVector::GetData<T>(result);
+	result_data[result_idx] = Load<T>((data_ptr_t)&scan_state.decompression_buffer[row_id % CHIMP_GROUP_SIZE]);
+}
+
+template <class T>
+void ChimpSkip(ColumnSegment &segment, ColumnScanState &state, idx_t skip_count) {
+	auto &scan_state = (ChimpScanState<T> &)*state.scan_state;
+	scan_state.Skip(skip_count);
+}
+
+//===--------------------------------------------------------------------===//
+// Get Function
+//===--------------------------------------------------------------------===//
+template <class T>
+CompressionFunction GetChimpFunction(PhysicalType data_type) {
+	return CompressionFunction(CompressionType::COMPRESSION_CHIMP, data_type, ChimpInitAnalyze<T>, ChimpAnalyze<T>,
+	                           ChimpFinalAnalyze<T>, ChimpInitCompression<T>, ChimpCompress<T>,
+	                           ChimpFinalizeCompress<T>, ChimpInitScan<T>, ChimpScan<T>, ChimpScanPartial<T>,
+	                           ChimpFetchRow<T>, ChimpSkip<T>);
+}
+
+CompressionFunction ChimpCompressionFun::GetFunction(PhysicalType type) {
+	switch (type) {
+	case PhysicalType::FLOAT:
+		return GetChimpFunction<float>(type);
+	case PhysicalType::DOUBLE:
+		return GetChimpFunction<double>(type);
+	default:
+		throw InternalException("Unsupported type for Chimp");
+	}
+}
+
+bool ChimpCompressionFun::TypeIsSupported(PhysicalType type) {
+	switch (type) {
+	case PhysicalType::FLOAT:
+	case PhysicalType::DOUBLE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,668 @@
+#include "duckdb/common/bitpacking.hpp"
+#include "duckdb/common/string_map_set.hpp"
+#include "duckdb/common/types/string_heap.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/function/compression/compression.hpp"
+#include "duckdb/function/compression_function.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/segment/uncompressed.hpp"
+#include "duckdb/storage/statistics/string_statistics.hpp"
+#include "duckdb/storage/table/column_data_checkpointer.hpp"
+#include "duckdb/storage/table/column_segment.hpp"
+
+namespace duckdb {
+
+//! The segment header of a dictionary compressed string segment
+//! The layout of a dictionary compressed segment is as follows:
+//! [header][bitpacked selection buffer][index buffer][ ... free space ... ][dictionary]
+//! The selection buffer holds, for every row, an index into the index buffer. The index buffer holds the offset of
+//! every unique string in the dictionary, measured from the end of the dictionary. Index 0 is reserved for NULL.
+struct DictionaryCompressionHeader {
+	//! The size of the dictionary
+	uint32_t dict_size;
+	//! The end of the dictionary
+	uint32_t dict_end;
+	//! The offset of the index buffer within the segment
+	uint32_t index_buffer_offset;
+	//! The amount of entries in the index buffer
+	uint32_t index_buffer_count;
+	//! The bit width of the packed selection buffer
+	uint32_t bitpacking_width;
+};
+
+struct DictionaryCompressionStorage {
+public:
+	//! The minimum space saving over uncompressed storage before dictionary compression is chosen
+	static constexpr float MINIMUM_COMPRESSION_RATIO = 1.2;
+	static constexpr uint16_t DICTIONARY_HEADER_SIZE = sizeof(DictionaryCompressionHeader);
+	//! If a finished segment occupies more than this amount of bytes we do not compact the dictionary
+	static constexpr idx_t COMPACTION_FLUSH_LIMIT = (idx_t)Storage::BLOCK_SIZE / 5 * 4;
+
+public:
+	static unique_ptr<AnalyzeState> StringInitAnalyze(ColumnData &col_data, PhysicalType type);
+	static bool StringAnalyze(AnalyzeState &state_p, Vector &input, idx_t count);
+	static idx_t StringFinalAnalyze(AnalyzeState &state_p);
+
+	static unique_ptr<CompressionState> InitCompression(ColumnDataCheckpointer &checkpointer,
+	                                                    unique_ptr<AnalyzeState> state);
+	static void Compress(CompressionState &state_p, Vector &scan_vector, idx_t count);
+	static void FinalizeCompress(CompressionState &state_p);
+
+	static unique_ptr<SegmentScanState> StringInitScan(ColumnSegment &segment);
+	template <bool ALLOW_DICT_VECTORS>
+	static void StringScanPartial(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result,
+	                              idx_t result_offset);
+	static void StringScan(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result);
+	static void StringFetchRow(ColumnSegment &segment, ColumnFetchState &state, row_t row_id, Vector &result,
+	                           idx_t result_idx);
+
+public:
+	static bool HasEnoughSpace(idx_t current_count, idx_t index_count, idx_t dict_size,
+	                           bitpacking_width_t packing_width);
+	static idx_t RequiredSpace(idx_t current_count, idx_t index_count, idx_t dict_size,
+	                           bitpacking_width_t packing_width);
+
+	static StringDictionaryContainer GetDictionary(ColumnSegment &segment, BufferHandle &handle);
+	static void SetDictionary(ColumnSegment &segment, BufferHandle &handle, StringDictionaryContainer container);
+	static string_t FetchStringFromDict(ColumnSegment &segment, StringDictionaryContainer dict, data_ptr_t baseptr,
+	                                    int32_t dict_offset, uint16_t string_len);
+	static uint16_t GetStringLength(uint32_t *index_buffer_ptr, sel_t index);
+};
+
+//===--------------------------------------------------------------------===//
+// Shared Analyze/Compress State
+//===--------------------------------------------------------------------===//
+//! Both the analyze and the compress step walk over the data in the same way: every string is looked up in the
+//! dictionary of the current segment, and a new segment is started whenever the next value no longer fits
+//! The analyze state only tracks the sizes, while the compress state actually writes the segments
+class DictionaryCompressionState : public CompressionState {
+public:
+	bool UpdateState(Vector &scan_vector, idx_t count) {
+		VectorData vdata;
+		scan_vector.Orrify(count, vdata);
+		auto data = (string_t *)vdata.data;
+		Verify();
+
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = vdata.sel->get_index(i);
+			idx_t string_size = 0;
+			bool new_string = false;
+			auto row_is_valid = vdata.validity.RowIsValid(idx);
+
+			if (row_is_valid) {
+				string_size = data[idx].GetSize();
+				if (string_size >= StringUncompressed::STRING_BLOCK_LIMIT) {
+					// big strings are not supported by dictionary compression
+					return false;
+				}
+				new_string = !LookupString(data[idx]);
+			}
+
+			bool fits = CalculateSpaceRequirements(new_string, string_size);
+			if (!fits) {
+				// the value does not fit in the current segment: flush it and start a new one
+				Flush();
+				new_string = row_is_valid;
+				fits = CalculateSpaceRequirements(new_string, string_size);
+				if (!fits) {
+					throw InternalException("Dictionary compression could not write to new segment");
+				}
+			}
+
+			if (!row_is_valid) {
+				AddNull();
+			} else if (new_string) {
+				AddNewString(data[idx]);
+			} else {
+				AddLastLookup();
+			}
+
+			Verify();
+		}
+
+		return true;
+	}
+
+protected:
+	//! Verify the state of the current segment
+	virtual void Verify() = 0;
+	//! Looks up a string in the dictionary of the current segment, returns true if it was found
+	virtual bool LookupString(string_t str) = 0;
+	//! Adds a string that was not found in the dictionary of the current segment
+	virtual void AddNewString(string_t str) = 0;
+	//! Adds a NULL value
+	virtual void AddNull() = 0;
+	//! Adds the string that was found in the previous call to LookupString
+	virtual void AddLastLookup() = 0;
+	//! Checks whether the next value fits in the current segment
+	virtual bool CalculateSpaceRequirements(bool new_string, idx_t string_size) = 0;
+	//! Flushes the current segment
+	virtual void Flush(bool final = false) = 0;
+};
+
+//===--------------------------------------------------------------------===//
+// Analyze
+//===--------------------------------------------------------------------===//
+struct DictionaryCompressionAnalyzeState : public DictionaryCompressionState {
+	DictionaryCompressionAnalyzeState()
+	    : segment_count(0), current_tuple_count(0), current_unique_count(0), current_dict_size(0), current_width(0),
+	      next_width(0) {
+	}
+
+	idx_t segment_count;
+	idx_t current_tuple_count;
+	idx_t current_unique_count;
+	idx_t current_dict_size;
+	//! Owns the (non-inlined) strings that are placed in the current set
+	StringHeap heap;
+	string_set_t current_set;
+	bitpacking_width_t current_width;
+	bitpacking_width_t next_width;
+
+protected:
+	void Verify() override {
+	}
+
+	bool LookupString(string_t str) override {
+		return current_set.count(str);
+	}
+
+	void AddNewString(string_t str) override {
+		current_tuple_count++;
+		current_unique_count++;
+		current_dict_size += str.GetSize();
+		if (str.IsInlined()) {
+			current_set.insert(str);
+		} else {
+			current_set.insert(heap.AddBlob(str.GetDataUnsafe(), str.GetSize()));
+		}
+		current_width = next_width;
+	}
+
+	void AddNull() override {
+		current_tuple_count++;
+	}
+
+	void AddLastLookup() override {
+		current_tuple_count++;
+	}
+
+	bool CalculateSpaceRequirements(bool new_string, idx_t string_size) override {
+		// note that the index buffer holds an additional entry for NULL
+		if (new_string) {
+			next_width = BitpackingPrimitives::MinimumBitWidth<sel_t>(current_unique_count + 1);
+			return DictionaryCompressionStorage::HasEnoughSpace(current_tuple_count + 1, current_unique_count + 2,
+			                                                    current_dict_size + string_size, next_width);
+		} else {
+			return DictionaryCompressionStorage::HasEnoughSpace(current_tuple_count + 1, current_unique_count + 1,
+			                                                    current_dict_size, current_width);
+		}
+	}
+
+	void Flush(bool final = false) override {
+		segment_count++;
+		current_tuple_count = 0;
+		current_unique_count = 0;
+		current_dict_size = 0;
+		current_width = 0;
+		next_width = 0;
+		current_set.clear();
+		heap.Destroy();
+	}
+};
+
+struct DictionaryAnalyzeState : public AnalyzeState {
+	DictionaryAnalyzeState() : analyze_state(make_unique<DictionaryCompressionAnalyzeState>()) {
+	}
+
+	unique_ptr<DictionaryCompressionAnalyzeState> analyze_state;
+};
+
+unique_ptr<AnalyzeState> DictionaryCompressionStorage::StringInitAnalyze(ColumnData &col_data, PhysicalType type) {
+	return make_unique<DictionaryAnalyzeState>();
+}
+
+bool DictionaryCompressionStorage::StringAnalyze(AnalyzeState &state_p, Vector &input, idx_t count) {
+	auto &state = (DictionaryAnalyzeState &)state_p;
+	return state.analyze_state->UpdateState(input, count);
+}
+
+idx_t DictionaryCompressionStorage::StringFinalAnalyze(AnalyzeState &state_p) {
+	auto &analyze_state = (DictionaryAnalyzeState &)state_p;
+	auto &state = *analyze_state.analyze_state;
+
+	auto width = BitpackingPrimitives::MinimumBitWidth<sel_t>(state.current_unique_count);
+	auto req_space =
+	    RequiredSpace(state.current_tuple_count, state.current_unique_count + 1, state.current_dict_size, width);
+
+	return MINIMUM_COMPRESSION_RATIO * (state.segment_count * Storage::BLOCK_SIZE + req_space);
+}
+
+//===--------------------------------------------------------------------===//
+// Compress
+//===--------------------------------------------------------------------===//
+struct DictionaryCompressionCompressState : public DictionaryCompressionState {
+	explicit DictionaryCompressionCompressState(ColumnDataCheckpointer &checkpointer_p)
+	    : checkpointer(checkpointer_p) {
+		auto &db = checkpointer.GetDatabase();
+		auto &config = DBConfig::GetConfig(db);
+		function = config.GetCompressionFunction(CompressionType::COMPRESSION_DICTIONARY, PhysicalType::VARCHAR);
+		CreateEmptySegment(checkpointer.GetRowGroup().start);
+	}
+
+	ColumnDataCheckpointer &checkpointer;
+	CompressionFunction *function;
+
+	// State regarding the current segment
+	unique_ptr<ColumnSegment> current_segment;
+	unique_ptr<BufferHandle> current_handle;
+	StringDictionaryContainer current_dictionary;
+	data_ptr_t current_end_ptr;
+
+	// Buffers and map for the current segment
+	//! Maps the strings in the dictionary to their index, the strings point into the dictionary of the segment
+	string_map_t<uint32_t> current_string_map;
+	vector<uint32_t> index_buffer;
+	vector<uint32_t> selection_buffer;
+
+	bitpacking_width_t current_width = 0;
+	bitpacking_width_t next_width = 0;
+
+	//! Result of the latest call to LookupString
+	uint32_t latest_lookup_result;
+
+public:
+	void CreateEmptySegment(idx_t row_start) {
+		auto &db = checkpointer.GetDatabase();
+		auto &type = checkpointer.GetType();
+		auto compressed_segment = ColumnSegment::CreateTransientSegment(db, type, row_start);
+		current_segment = move(compressed_segment);
+		current_segment->function = function;
+
+		// reset the buffers and the string map
+		current_string_map.clear();
+		index_buffer.clear();
+		// index 0 is reserved for NULL values
+		index_buffer.push_back(0);
+		selection_buffer.clear();
+
+		current_width = 0;
+		next_width = 0;
+
+		// reset the pointers into the current segment
+		auto &buffer_manager = BufferManager::GetBufferManager(db);
+		current_handle = buffer_manager.Pin(current_segment->block);
+		current_dictionary.size = 0;
+		current_dictionary.end = Storage::BLOCK_SIZE;
+		DictionaryCompressionStorage::SetDictionary(*current_segment, *current_handle, current_dictionary);
+		current_end_ptr = current_handle->node->buffer + current_dictionary.end;
+	}
+
+	void Finalize() {
+		Flush(true);
+	}
+
+protected:
+	void Verify() override {
+		current_dictionary.Verify();
+		D_ASSERT(current_segment->count == selection_buffer.size());
+		D_ASSERT(DictionaryCompressionStorage::HasEnoughSpace(current_segment->count.load(), index_buffer.size(),
+		                                                      current_dictionary.size, current_width));
+		D_ASSERT(current_dictionary.end == Storage::BLOCK_SIZE);
+		D_ASSERT(index_buffer.size() == current_string_map.size() + 1);
+	}
+
+	bool LookupString(string_t str) override {
+		auto entry = current_string_map.find(str);
+		if (entry == current_string_map.end()) {
+			return false;
+		}
+		latest_lookup_result = entry->second;
+		return true;
+	}
+
+	void AddNewString(string_t str) override {
+		auto &sstats = (StringStatistics &)*current_segment->stats.statistics;
+		sstats.Update(str);
+
+		// copy the string into the dictionary
+		current_dictionary.size += str.GetSize();
+		auto dict_pos = current_end_ptr - current_dictionary.size;
+		memcpy(dict_pos, str.GetDataUnsafe(), str.GetSize());
+		current_dictionary.Verify();
+		D_ASSERT(current_dictionary.end == Storage::BLOCK_SIZE);
+
+		// update the buffers and the map
+		index_buffer.push_back(current_dictionary.size);
+		selection_buffer.push_back(index_buffer.size() - 1);
+		if (str.IsInlined()) {
+			current_string_map[str] = index_buffer.size() - 1;
+		} else {
+			current_string_map[string_t((const char *)dict_pos, str.GetSize())] = index_buffer.size() - 1;
+		}
+		DictionaryCompressionStorage::SetDictionary(*current_segment, *current_handle, current_dictionary);
+
+		current_width = next_width;
+		current_segment->count++;
+	}
+
+	void AddNull() override {
+		selection_buffer.push_back(0);
+		current_segment->count++;
+	}
+
+	void AddLastLookup() override {
+		selection_buffer.push_back(latest_lookup_result);
+		current_segment->count++;
+	}
+
+	bool CalculateSpaceRequirements(bool new_string, idx_t string_size) override {
+		if (new_string) {
+			next_width = BitpackingPrimitives::MinimumBitWidth<sel_t>(index_buffer.size());
+			return DictionaryCompressionStorage::HasEnoughSpace(current_segment->count.load() + 1,
+			                                                    index_buffer.size() + 1,
+			                                                    current_dictionary.size + string_size, next_width);
+		} else {
+			return DictionaryCompressionStorage::HasEnoughSpace(current_segment->count.load() + 1, index_buffer.size(),
+			                                                    current_dictionary.size, current_width);
+		}
+	}
+
+	void Flush(bool final = false) override {
+		auto next_start = current_segment->start + current_segment->count;
+
+		auto segment_size = FinalizeSegment();
+		auto &state = checkpointer.GetCheckpointState();
+		state.FlushSegment(move(current_segment), segment_size);
+
+		if (!final) {
+			CreateEmptySegment(next_start);
+		}
+	}
+
+private:
+	//! Writes the selection and index buffers into the segment, and compacts the segment if possible
+	//! Returns the size of the segment
+	idx_t FinalizeSegment() {
+		D_ASSERT(current_dictionary.end == Storage::BLOCK_SIZE);
+
+		// calculate the sizes
+		auto compressed_selection_buffer_size =
+		    BitpackingPrimitives::GetRequiredSize(current_segment->count, current_width);
+		auto index_buffer_size = index_buffer.size() * sizeof(uint32_t);
+		auto total_size = DictionaryCompressionStorage::DICTIONARY_HEADER_SIZE + compressed_selection_buffer_size +
+		                  index_buffer_size + current_dictionary.size;
+
+		// calculate the pointers and offsets
+		auto base_ptr = current_handle->node->buffer;
+		auto header_ptr = (DictionaryCompressionHeader *)base_ptr;
+		auto compressed_selection_buffer_offset = DictionaryCompressionStorage::DICTIONARY_HEADER_SIZE;
+		auto index_buffer_offset = compressed_selection_buffer_offset + compressed_selection_buffer_size;
+
+		// write the compressed selection buffer
+		BitpackingPrimitives::PackBuffer<sel_t>(base_ptr + compressed_selection_buffer_offset,
+		                                        (sel_t *)selection_buffer.data(), current_segment->count,
+		                                        current_width);
+
+		// write the index buffer
+		memcpy(base_ptr + index_buffer_offset, index_buffer.data(), index_buffer_size);
+
+		// store the sizes and offsets in the segment header
+		Store<uint32_t>(index_buffer_offset, (data_ptr_t)&header_ptr->index_buffer_offset);
+		Store<uint32_t>(index_buffer.size(), (data_ptr_t)&header_ptr->index_buffer_count);
+		Store<uint32_t>((uint32_t)current_width, (data_ptr_t)&header_ptr->bitpacking_width);
+
+		D_ASSERT(current_width == BitpackingPrimitives::MinimumBitWidth<sel_t>(index_buffer.size() - 1));
+		D_ASSERT(DictionaryCompressionStorage::HasEnoughSpace(current_segment->count, index_buffer.size(),
+		                                                      current_dictionary.size, current_width));
+
+		if (total_size >= DictionaryCompressionStorage::COMPACTION_FLUSH_LIMIT) {
+			// the block is full enough, don't bother moving around the dictionary
+			current_handle.reset();
+			return Storage::BLOCK_SIZE;
+		}
+		// the block has space left: figure out how much space we can save
+		auto move_amount = Storage::BLOCK_SIZE - total_size;
+		// move the dictionary so it lines up exactly with the index buffer
+		auto new_dictionary_offset = index_buffer_offset + index_buffer_size;
+		memmove(base_ptr + new_dictionary_offset, base_ptr + current_dictionary.end - current_dictionary.size,
+		        current_dictionary.size);
+		current_dictionary.end -= move_amount;
+		D_ASSERT(current_dictionary.end == total_size);
+		// write the new dictionary (with the updated "end")
+		DictionaryCompressionStorage::SetDictionary(*current_segment, *current_handle, current_dictionary);
+		current_handle.reset();
+		return total_size;
+	}
+};
+
+unique_ptr<CompressionState> DictionaryCompressionStorage::InitCompression(ColumnDataCheckpointer &checkpointer,
+                                                                           unique_ptr<AnalyzeState> state) {
+	return make_unique<DictionaryCompressionCompressState>(checkpointer);
+}
+
+void DictionaryCompressionStorage::Compress(CompressionState &state_p, Vector &scan_vector, idx_t count) {
+	auto &state = (DictionaryCompressionCompressState &)state_p;
+	state.UpdateState(scan_vector, count);
+}
+
+void DictionaryCompressionStorage::FinalizeCompress(CompressionState &state_p) {
+	auto &state = (DictionaryCompressionCompressState &)state_p;
+	state.Finalize();
+}
+
+//===--------------------------------------------------------------------===//
+// Scan
+//===--------------------------------------------------------------------===//
+struct DictionaryScanState : public SegmentScanState {
+	unique_ptr<BufferHandle> handle;
+	//! The dictionary of the segment, materialized on the first scan that emits a dictionary vector
+	buffer_ptr<Vector> dictionary;
+	bitpacking_width_t current_width;
+	//! Buffer used to unpack the selection buffer when emitting flat vectors
+	unique_ptr<sel_t[]> sel_buffer;
+	idx_t sel_buffer_size = 0;
+};
+
+unique_ptr<SegmentScanState> DictionaryCompressionStorage::StringInitScan(ColumnSegment &segment) {
+	auto state = make_unique<DictionaryScanState>();
+	auto &buffer_manager = BufferManager::GetBufferManager(segment.db);
+	state->handle = buffer_manager.Pin(segment.block);
+
+	auto baseptr = state->handle->node->buffer + segment.GetBlockOffset();
+	auto header_ptr = (DictionaryCompressionHeader *)baseptr;
+	state->current_width = (bitpacking_width_t)(Load<uint32_t>((data_ptr_t)&header_ptr->bitpacking_width));
+	return move(state);
+}
+
+static void DictionaryInitializeVector(ColumnSegment &segment, DictionaryScanState &scan_state) {
+	auto baseptr = scan_state.handle->node->buffer + segment.GetBlockOffset();
+	auto dict = DictionaryCompressionStorage::GetDictionary(segment, *scan_state.handle);
+	auto header_ptr = (DictionaryCompressionHeader *)baseptr;
+	auto index_buffer_offset = Load<uint32_t>((data_ptr_t)&header_ptr->index_buffer_offset);
+	auto index_buffer_count = Load<uint32_t>((data_ptr_t)&header_ptr->index_buffer_count);
+	auto index_buffer_ptr = (uint32_t *)(baseptr + index_buffer_offset);
+
+	scan_state.dictionary = make_buffer<Vector>(segment.type, index_buffer_count);
+	auto dict_child_data = FlatVector::GetData<string_t>(*scan_state.dictionary);
+	for (uint32_t i = 0; i < index_buffer_count; i++) {
+		auto str_len = DictionaryCompressionStorage::GetStringLength(index_buffer_ptr, i);
+		dict_child_data[i] = DictionaryCompressionStorage::FetchStringFromDict(segment, dict, baseptr,
+		                                                                       index_buffer_ptr[i], str_len);
+	}
+	// the strings in the dictionary point into the block: keep the block pinned for as long as the dictionary lives
+	auto &buffer_manager = BufferManager::GetBufferManager(segment.db);
+	StringVector::AddHandle(*scan_state.dictionary, buffer_manager.Pin(segment.block));
+}
+
+//===--------------------------------------------------------------------===//
+// Scan base data
+//===--------------------------------------------------------------------===//
+template <bool ALLOW_DICT_VECTORS>
+void DictionaryCompressionStorage::StringScanPartial(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count,
+                                                     Vector &result, idx_t result_offset) {
+	auto &scan_state = (DictionaryScanState &)*state.scan_state;
+	auto start = segment.GetRelativeIndex(state.row_index);
+
+	auto baseptr = scan_state.handle->node->buffer + segment.GetBlockOffset();
+	auto dict = GetDictionary(segment, *scan_state.handle);
+	auto header_ptr = (DictionaryCompressionHeader *)baseptr;
+	auto index_buffer_offset = Load<uint32_t>((data_ptr_t)&header_ptr->index_buffer_offset);
+	auto index_buffer_ptr = (uint32_t *)(baseptr + index_buffer_offset);
+	auto base_data = (data_ptr_t)(baseptr + DICTIONARY_HEADER_SIZE);
+
+	// we unpack whole groups of BITPACKING_ALGORITHM_GROUP_SIZE values, starting at the group containing "start"
+	idx_t start_offset = start % BitpackingPrimitives::BITPACKING_ALGORITHM_GROUP_SIZE;
+	idx_t decompress_count = BitpackingPrimitives::RoundUpToAlgorithmGroupSize(scan_count + start_offset);
+	data_ptr_t src = &base_data[((start - start_offset) * scan_state.current_width) / 8];
+
+	if (!ALLOW_DICT_VECTORS || scan_count != STANDARD_VECTOR_SIZE || start_offset != 0) {
+		// emit a regular (flat) vector
+		if (scan_state.sel_buffer_size < decompress_count) {
+			scan_state.sel_buffer = unique_ptr<sel_t[]>(new sel_t[decompress_count]);
+			scan_state.sel_buffer_size = decompress_count;
+		}
+		auto sel_ptr = scan_state.sel_buffer.get();
+		BitpackingPrimitives::UnPackBuffer<sel_t>((data_ptr_t)sel_ptr, src, decompress_count,
+		                                          scan_state.current_width);
+
+		auto result_data = FlatVector::GetData<string_t>(result);
+		for (idx_t i = 0; i < scan_count; i++) {
+			auto string_number = sel_ptr[i + start_offset];
+			auto dict_offset = index_buffer_ptr[string_number];
+			auto str_len = GetStringLength(index_buffer_ptr, string_number);
+			result_data[result_offset + i] = FetchStringFromDict(segment, dict, baseptr, dict_offset, str_len);
+		}
+	} else {
+		// emit a dictionary vector that references the (lazily materialized) dictionary of the segment
+		D_ASSERT(result_offset == 0);
+		if (!scan_state.dictionary) {
+			DictionaryInitializeVector(segment, scan_state);
+		}
+		SelectionVector sel_vector(decompress_count);
+		BitpackingPrimitives::UnPackBuffer<sel_t>((data_ptr_t)sel_vector.data(), src, decompress_count,
+		                                          scan_state.current_width);
+		result.Slice(*scan_state.dictionary, sel_vector, scan_count);
+	}
+}
+
+void DictionaryCompressionStorage::StringScan(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count,
+                                              Vector &result) {
+	StringScanPartial<true>(segment, state, scan_count, result, 0);
+}
+
+//===--------------------------------------------------------------------===//
+// Fetch
+//===--------------------------------------------------------------------===//
+void DictionaryCompressionStorage::StringFetchRow(ColumnSegment &segment, ColumnFetchState &state, row_t row_id,
+                                                  Vector &result, idx_t result_idx) {
+	// fetch a single row from the string segment
+	// first pin the main buffer if it is not already pinned
+	auto primary_id = segment.block->BlockId();
+
+	BufferHandle *handle_ptr;
+	auto entry = state.handles.find(primary_id);
+	if (entry == state.handles.end()) {
+		// not pinned yet: pin it
+		auto &buffer_manager = BufferManager::GetBufferManager(segment.db);
+		auto handle = buffer_manager.Pin(segment.block);
+		handle_ptr = handle.get();
+		state.handles[primary_id] = move(handle);
+	} else {
+		// already pinned: use the pinned handle
+		handle_ptr = entry->second.get();
+	}
+
+	auto baseptr = handle_ptr->node->buffer + segment.GetBlockOffset();
+	auto header_ptr = (DictionaryCompressionHeader *)baseptr;
+	auto dict = GetDictionary(segment, *handle_ptr);
+	auto index_buffer_offset = Load<uint32_t>((data_ptr_t)&header_ptr->index_buffer_offset);
+	auto width = (bitpacking_width_t)(Load<uint32_t>((data_ptr_t)&header_ptr->bitpacking_width));
+	auto index_buffer_ptr = (uint32_t *)(baseptr + index_buffer_offset);
+	auto base_data = (data_ptr_t)(baseptr + DICTIONARY_HEADER_SIZE);
+	auto result_data = FlatVector::GetData<string_t>(result);
+
+	// unpack the group of the selection buffer that contains the row
+	idx_t group_offset = row_id % BitpackingPrimitives::BITPACKING_ALGORITHM_GROUP_SIZE;
+	sel_t decompression_buffer[BitpackingPrimitives::BITPACKING_ALGORITHM_GROUP_SIZE];
+	data_ptr_t src = &base_data[((row_id - group_offset) * width) / 8];
+	BitpackingPrimitives::UnPackBlock<sel_t>((data_ptr_t)decompression_buffer, src, width);
+
+	auto selection_value = decompression_buffer[group_offset];
+	auto dict_offset = index_buffer_ptr[selection_value];
+	auto str_len = GetStringLength(index_buffer_ptr, selection_value);
+
+	result_data[result_idx] = FetchStringFromDict(segment, dict, baseptr, dict_offset, str_len);
+}
+
+//===--------------------------------------------------------------------===//
+// Helper Functions
+//===--------------------------------------------------------------------===//
+bool DictionaryCompressionStorage::HasEnoughSpace(idx_t current_count, idx_t index_count, idx_t dict_size,
+                                                  bitpacking_width_t packing_width) {
+	return RequiredSpace(current_count, index_count, dict_size, packing_width) <= Storage::BLOCK_SIZE;
+}
+
+idx_t DictionaryCompressionStorage::RequiredSpace(idx_t current_count, idx_t index_count, idx_t dict_size,
+                                                  bitpacking_width_t packing_width) {
+	idx_t base_space = DICTIONARY_HEADER_SIZE + dict_size;
+	idx_t string_number_space = BitpackingPrimitives::GetRequiredSize(current_count, packing_width);
+	idx_t index_space = index_count * sizeof(uint32_t);
+
+	return base_space + index_space + string_number_space;
+}
+
+StringDictionaryContainer DictionaryCompressionStorage::GetDictionary(ColumnSegment &segment, BufferHandle &handle) {
+	auto header_ptr = (DictionaryCompressionHeader *)(handle.node->buffer + segment.GetBlockOffset());
+	StringDictionaryContainer container;
+	container.size = Load<uint32_t>((data_ptr_t)&header_ptr->dict_size);
+	container.end = Load<uint32_t>((data_ptr_t)&header_ptr->dict_end);
+	return container;
+}
+
+void DictionaryCompressionStorage::SetDictionary(ColumnSegment &segment, BufferHandle &handle,
+                                                 StringDictionaryContainer container) {
+	auto header_ptr = (DictionaryCompressionHeader *)(handle.node->buffer + segment.GetBlockOffset());
+	Store<uint32_t>(container.size, (data_ptr_t)&header_ptr->dict_size);
+	Store<uint32_t>(container.end, (data_ptr_t)&header_ptr->dict_end);
+}
+
+string_t DictionaryCompressionStorage::FetchStringFromDict(ColumnSegment &segment, StringDictionaryContainer dict,
+                                                           data_ptr_t baseptr, int32_t dict_offset,
+                                                           uint16_t string_len) {
+	D_ASSERT(dict_offset >= 0 && dict_offset <= Storage::BLOCK_SIZE);
+	if (dict_offset == 0) {
+		return string_t(nullptr, 0);
+	}
+	// normal string: read the string from the dictionary of this block
+	auto dict_end = baseptr + dict.end;
+	auto dict_pos = dict_end - dict_offset;
+	return string_t((const char *)dict_pos, string_len);
+}
+
+uint16_t DictionaryCompressionStorage::GetStringLength(uint32_t *index_buffer_ptr, sel_t index) {
+	if (index == 0) {
+		return 0;
+	}
+	return index_buffer_ptr[index] - index_buffer_ptr[index - 1];
+}
+
+//===--------------------------------------------------------------------===//
+// Get Function
+//===--------------------------------------------------------------------===//
+CompressionFunction DictionaryCompressionFun::GetFunction(PhysicalType data_type) {
+	return CompressionFunction(
+	    CompressionType::COMPRESSION_DICTIONARY, data_type, DictionaryCompressionStorage::StringInitAnalyze,
+	    DictionaryCompressionStorage::StringAnalyze, DictionaryCompressionStorage::StringFinalAnalyze,
+	    DictionaryCompressionStorage::InitCompression, DictionaryCompressionStorage::Compress,
+	    DictionaryCompressionStorage::FinalizeCompress, DictionaryCompressionStorage::StringInitScan,
+	    DictionaryCompressionStorage::StringScan, DictionaryCompressionStorage::StringScanPartial<false>,
+	    DictionaryCompressionStorage::StringFetchRow, UncompressedFunctions::EmptySkip);
+}
+
+bool DictionaryCompressionFun::TypeIsSupported(PhysicalType type) {
+	return type == PhysicalType::VARCHAR;
+}
+
+} // namespace duckdb
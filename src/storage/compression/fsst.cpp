@@ -0,0 +1,690 @@
+#include "duckdb/common/bitpacking.hpp"
+#include "duckdb/common/pair.hpp"
+#include "duckdb/common/types/string_heap.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/function/compression/compression.hpp"
+#include "duckdb/function/compression_function.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/segment/uncompressed.hpp"
+#include "duckdb/storage/statistics/string_statistics.hpp"
+#include "duckdb/storage/table/column_data_checkpointer.hpp"
+#include "duckdb/storage/table/column_segment.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Symbol Table
+//===--------------------------------------------------------------------===//
+//! A symbol of the FSST symbol table: a sequence of 1 to 8 bytes that is replaced by a single byte code
+struct FSSTSymbol {
+	FSSTSymbol() : length(0) {
+	}
+	FSSTSymbol(const_data_ptr_t data, uint8_t length_p) : length(length_p) {
+		D_ASSERT(length > 0 && length <= 8);
+		memcpy(bytes, data, length);
+	}
+
+	data_t bytes[8];
+	uint8_t length;
+
+	string ToString() const {
+		return string((const char *)bytes, length);
+	}
+};
+
+//! The FSST ("Fast Static Symbol Table") string codec. The symbol table holds up to 255 symbols of up to 8 bytes
+//! each. Compressed strings are sequences of single byte codes, code 255 is an escape code that is followed by a
+//! literal byte. The table is static: once built from a sample it is used to compress (and decompress) every string
+//! of a segment independently, which allows random access into the compressed data.
+class FSSTSymbolTable {
+public:
+	static constexpr const uint8_t ESCAPE_CODE = 255;
+	static constexpr const idx_t MAX_SYMBOLS = 255;
+	static constexpr const idx_t MAX_SYMBOL_LENGTH = 8;
+	//! The amount of times the symbol table is refined on the sample
+	static constexpr const idx_t BUILD_ROUNDS = 5;
+
+public:
+	//! Builds a symbol table from a sample of strings
+	static FSSTSymbolTable Build(const vector<string_t> &sample);
+	//! Reads a symbol table that was written with Serialize
+	static FSSTSymbolTable Deserialize(data_ptr_t ptr);
+
+	//! Compresses "len" bytes into "out", which must be at least 2 * len bytes large. Returns the compressed size.
+	idx_t Compress(const_data_ptr_t in, idx_t len, data_ptr_t out) const;
+	//! Returns the size of a string after decompression
+	idx_t DecompressedSize(const_data_ptr_t in, idx_t len) const;
+	//! Decompresses "len" bytes into "out", which must be large enough to hold DecompressedSize bytes
+	void Decompress(const_data_ptr_t in, idx_t len, data_ptr_t out) const;
+
+	//! The amount of bytes required to store the symbol table
+	idx_t SerializedSize() const;
+	//! Writes the symbol table, layout: [symbol count][symbol lengths][symbol bytes]
+	void Serialize(data_ptr_t ptr) const;
+
+private:
+	void AddSymbol(FSSTSymbol symbol);
+	//! Finds the longest symbol that matches the input at "in", returns ESCAPE_CODE if there is none
+	uint8_t FindLongestSymbol(const_data_ptr_t in, idx_t remaining) const;
+
+private:
+	vector<FSSTSymbol> symbols;
+	//! For every possible first byte, the codes of the symbols starting with that byte (longest symbols first)
+	vector<uint8_t> candidates[256];
+};
+
+void FSSTSymbolTable::AddSymbol(FSSTSymbol symbol) {
+	D_ASSERT(symbols.size() < MAX_SYMBOLS);
+	auto code = (uint8_t)symbols.size();
+	auto &list = candidates[symbol.bytes[0]];
+	symbols.push_back(symbol);
+	// keep the candidate list sorted on symbol length, so the first match is the longest match
+	auto pos = list.begin();
+	while (pos != list.end() && symbols[*pos].length >= symbol.length) {
+		pos++;
+	}
+	list.insert(pos, code);
+}
+
+uint8_t FSSTSymbolTable::FindLongestSymbol(const_data_ptr_t in, idx_t remaining) const {
+	for (auto code : candidates[in[0]]) {
+		auto &symbol = symbols[code];
+		if (symbol.length <= remaining && memcmp(symbol.bytes, in, symbol.length) == 0) {
+			return code;
+		}
+	}
+	return ESCAPE_CODE;
+}
+
+FSSTSymbolTable FSSTSymbolTable::Build(const vector<string_t> &sample) {
+	// the counters are indexed by code, codes [256, 512) represent escaped literal bytes
+	static constexpr const idx_t COUNTER_SIZE = 512;
+	FSSTSymbolTable table;
+	for (idx_t round = 0; round < BUILD_ROUNDS; round++) {
+		// encode the sample with the current table, and count how often every symbol and every pair of
+		// consecutive symbols occurs
+		vector<idx_t> single_counts(COUNTER_SIZE, 0);
+		unordered_map<uint32_t, idx_t> pair_counts;
+		for (auto &str : sample) {
+			auto data = (const_data_ptr_t)str.GetDataUnsafe();
+			auto len = str.GetSize();
+			idx_t pos = 0;
+			uint32_t prev_code = COUNTER_SIZE;
+			while (pos < len) {
+				uint32_t code = table.FindLongestSymbol(data + pos, len - pos);
+				if (code == ESCAPE_CODE) {
+					code = 256 + data[pos];
+					pos++;
+				} else {
+					pos += table.symbols[code].length;
+				}
+				single_counts[code]++;
+				if (prev_code != COUNTER_SIZE) {
+					pair_counts[prev_code * COUNTER_SIZE + code]++;
+				}
+				prev_code = code;
+			}
+		}
+		auto code_to_symbol = [&](uint32_t code) {
+			if (code >= 256) {
+				data_t byte = code - 256;
+				return FSSTSymbol(&byte, 1);
+			}
+			return table.symbols[code];
+		};
+
+		// the gain of a candidate symbol is the amount of bytes it would cover in the sample
+		unordered_map<string, idx_t> gains;
+		for (uint32_t code = 0; code < COUNTER_SIZE; code++) {
+			if (single_counts[code] == 0) {
+				continue;
+			}
+			auto symbol = code_to_symbol(code);
+			gains[symbol.ToString()] += single_counts[code] * symbol.length;
+		}
+		for (auto &entry : pair_counts) {
+			auto first = code_to_symbol(entry.first / COUNTER_SIZE);
+			auto second = code_to_symbol(entry.first % COUNTER_SIZE);
+			if (first.length + second.length > MAX_SYMBOL_LENGTH) {
+				continue;
+			}
+			gains[first.ToString() + second.ToString()] += entry.second * (first.length + second.length);
+		}
+
+		// the new table consists of the candidates with the highest gain
+		vector<pair<idx_t, string>> sorted_candidates;
+		sorted_candidates.reserve(gains.size());
+		for (auto &entry : gains) {
+			sorted_candidates.emplace_back(entry.second, entry.first);
+		}
+		std::sort(sorted_candidates.begin(), sorted_candidates.end(),
+		          [](const pair<idx_t, string> &a, const pair<idx_t, string> &b) {
+			          if (a.first != b.first) {
+				          return a.first > b.first;
+			          }
+			          return a.second < b.second;
+		          });
+		table = FSSTSymbolTable();
+		for (idx_t i = 0; i < sorted_candidates.size() && i < MAX_SYMBOLS; i++) {
+			auto &symbol = sorted_candidates[i].second;
+			table.AddSymbol(FSSTSymbol((const_data_ptr_t)symbol.c_str(), symbol.size()));
+		}
+	}
+	return table;
+}
+
+idx_t FSSTSymbolTable::Compress(const_data_ptr_t in, idx_t len, data_ptr_t out) const {
+	idx_t out_pos = 0;
+	idx_t pos = 0;
+	while (pos < len) {
+		auto code = FindLongestSymbol(in + pos, len - pos);
+		out[out_pos++] = code;
+		if (code == ESCAPE_CODE) {
+			out[out_pos++] = in[pos++];
+		} else {
+			pos += symbols[code].length;
+		}
+	}
+	return out_pos;
+}
+
+idx_t FSSTSymbolTable::DecompressedSize(const_data_ptr_t in, idx_t len) const {
+	idx_t result = 0;
+	for (idx_t pos = 0; pos < len; pos++) {
+		if (in[pos] == ESCAPE_CODE) {
+			pos++;
+			result++;
+		} else {
+			result += symbols[in[pos]].length;
+		}
+	}
+	return result;
+}
+
+void FSSTSymbolTable::Decompress(const_data_ptr_t in, idx_t len, data_ptr_t out) const {
+	for (idx_t pos = 0; pos < len; pos++) {
+		if (in[pos] == ESCAPE_CODE) {
+			*out++ = in[++pos];
+		} else {
+			auto &symbol = symbols[in[pos]];
+			memcpy(out, symbol.bytes, symbol.length);
+			out += symbol.length;
+		}
+	}
+}
+
+idx_t FSSTSymbolTable::SerializedSize() const {
+	idx_t result = 1 + symbols.size();
+	for (auto &symbol : symbols) {
+		result += symbol.length;
+	}
+	return result;
+}
+
+void FSSTSymbolTable::Serialize(data_ptr_t ptr) const {
+	*ptr++ = (uint8_t)symbols.size();
+	for (auto &symbol : symbols) {
+		*ptr++ = symbol.length;
+	}
+	for (auto &symbol : symbols) {
+		memcpy(ptr, symbol.bytes, symbol.length);
+		ptr += symbol.length;
+	}
+}
+
+FSSTSymbolTable FSSTSymbolTable::Deserialize(data_ptr_t ptr) {
+	FSSTSymbolTable result;
+	idx_t symbol_count = *ptr++;
+	auto data_ptr = ptr + symbol_count;
+	for (idx_t i = 0; i < symbol_count; i++) {
+		result.AddSymbol(FSSTSymbol(data_ptr, ptr[i]));
+		data_ptr += ptr[i];
+	}
+	return result;
+}
+
+//===--------------------------------------------------------------------===//
+// Storage
+//===--------------------------------------------------------------------===//
+//! The segment header of an FSST compressed string segment
+//! The layout of an FSST compressed segment is as follows:
+//! [header][bitpacked offsets][symbol table][ ... free space ... ][compressed strings]
+//! For row i the offsets hold the end of the compressed string at position i + 1, measured from the end of the
+//! dictionary, the first offset is always 0. NULL values and empty strings have a compressed length of 0.
+struct FSSTCompressionHeader {
+	//! The size of the dictionary holding the compressed strings
+	uint32_t dict_size;
+	//! The end of the dictionary
+	uint32_t dict_end;
+	//! The offset of the symbol table within the segment
+	uint32_t symbol_table_offset;
+	//! The bit width of the packed offsets
+	uint32_t bitpacking_width;
+};
+
+struct FSSTStorage {
+public:
+	//! The minimum space saving over uncompressed storage before FSST is chosen
+	static constexpr float MINIMUM_COMPRESSION_RATIO = 1.2;
+	static constexpr uint16_t FSST_HEADER_SIZE = sizeof(FSSTCompressionHeader);
+	//! The amount of string bytes the symbol table is built from
+	static constexpr idx_t SAMPLE_SIZE = 32768;
+	//! If a finished segment occupies more than this amount of bytes we do not compact the dictionary
+	static constexpr idx_t COMPACTION_FLUSH_LIMIT = (idx_t)Storage::BLOCK_SIZE / 5 * 4;
+
+public:
+	static unique_ptr<AnalyzeState> StringInitAnalyze(ColumnData &col_data, PhysicalType type);
+	static bool StringAnalyze(AnalyzeState &state_p, Vector &input, idx_t count);
+	static idx_t StringFinalAnalyze(AnalyzeState &state_p);
+
+	static unique_ptr<CompressionState> InitCompression(ColumnDataCheckpointer &checkpointer,
+	                                                    unique_ptr<AnalyzeState> state);
+	static void Compress(CompressionState &state_p, Vector &scan_vector, idx_t count);
+	static void FinalizeCompress(CompressionState &state_p);
+
+	static unique_ptr<SegmentScanState> StringInitScan(ColumnSegment &segment);
+	static void StringScanPartial(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result,
+	                              idx_t result_offset);
+	static void StringScan(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result);
+	static void StringFetchRow(ColumnSegment &segment, ColumnFetchState &state, row_t row_id, Vector &result,
+	                           idx_t result_idx);
+
+public:
+	static bool HasEnoughSpace(idx_t current_count, idx_t dict_size, idx_t symbol_table_size,
+	                           bitpacking_width_t packing_width);
+	static idx_t RequiredSpace(idx_t current_count, idx_t dict_size, idx_t symbol_table_size,
+	                           bitpacking_width_t packing_width);
+	//! Unpacks the offsets [start, start + count] into "dst", which must hold count + 2 * BITPACKING_ALGORITHM_GROUP_SIZE
+	//! values. Returns the position of offset "start" in "dst".
+	static idx_t UnpackOffsets(data_ptr_t baseptr, idx_t start, idx_t count, bitpacking_width_t width, uint32_t *dst);
+	//! Decompresses a string into the string heap of "result"
+	static string_t DecompressString(const FSSTSymbolTable &table, Vector &result, data_ptr_t dict_end,
+	                                 uint32_t start_offset, uint32_t end_offset);
+};
+
+//===--------------------------------------------------------------------===//
+// Analyze
+//===--------------------------------------------------------------------===//
+struct FSSTAnalyzeState : public AnalyzeState {
+	FSSTAnalyzeState() : count(0), total_string_size(0), sample_size(0) {
+	}
+
+	idx_t count;
+	idx_t total_string_size;
+	//! The sample the symbol table is built from, the strings are owned by the heap
+	StringHeap heap;
+	vector<string_t> sample;
+	idx_t sample_size;
+	//! The symbol table, built in the final analyze step
+	FSSTSymbolTable symbol_table;
+};
+
+unique_ptr<AnalyzeState> FSSTStorage::StringInitAnalyze(ColumnData &col_data, PhysicalType type) {
+	return make_unique<FSSTAnalyzeState>();
+}
+
+bool FSSTStorage::StringAnalyze(AnalyzeState &state_p, Vector &input, idx_t count) {
+	auto &state = (FSSTAnalyzeState &)state_p;
+	VectorData vdata;
+	input.Orrify(count, vdata);
+	auto data = (string_t *)vdata.data;
+
+	state.count += count;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if (!vdata.validity.RowIsValid(idx)) {
+			continue;
+		}
+		auto string_size = data[idx].GetSize();
+		if (string_size >= StringUncompressed::STRING_BLOCK_LIMIT) {
+			// big strings are not supported by FSST compression
+			return false;
+		}
+		state.total_string_size += string_size;
+		if (string_size > 0 && state.sample_size < SAMPLE_SIZE) {
+			state.sample.push_back(state.heap.AddBlob(data[idx].GetDataUnsafe(), string_size));
+			state.sample_size += string_size;
+		}
+	}
+	return true;
+}
+
+idx_t FSSTStorage::StringFinalAnalyze(AnalyzeState &state_p) {
+	auto &state = (FSSTAnalyzeState &)state_p;
+	state.symbol_table = FSSTSymbolTable::Build(state.sample);
+
+	// compress the sample to estimate the compression ratio
+	idx_t compressed_sample_size = 0;
+	vector<data_t> buffer;
+	for (auto &str : state.sample) {
+		buffer.resize(str.GetSize() * 2);
+		compressed_sample_size +=
+		    state.symbol_table.Compress((const_data_ptr_t)str.GetDataUnsafe(), str.GetSize(), buffer.data());
+	}
+	double compression_ratio = state.sample_size == 0 ? 1 : (double)compressed_sample_size / state.sample_size;
+	auto estimated_dict_size = (idx_t)(compression_ratio * state.total_string_size);
+
+	// the offsets are bitpacked at (up to) the width required to address a full block
+	auto width = BitpackingPrimitives::MinimumBitWidth<uint32_t>(
+	    (uint32_t)MinValue<idx_t>(estimated_dict_size, Storage::BLOCK_SIZE));
+	auto estimated_size = RequiredSpace(state.count, estimated_dict_size, 0, width);
+	auto segment_count = estimated_size / Storage::BLOCK_SIZE + 1;
+	estimated_size += segment_count * (FSST_HEADER_SIZE + state.symbol_table.SerializedSize());
+
+	return MINIMUM_COMPRESSION_RATIO * estimated_size;
+}
+
+//===--------------------------------------------------------------------===//
+// Compress
+//===--------------------------------------------------------------------===//
+struct FSSTCompressionState : public CompressionState {
+	FSSTCompressionState(ColumnDataCheckpointer &checkpointer_p, FSSTSymbolTable symbol_table_p)
+	    : checkpointer(checkpointer_p), symbol_table(move(symbol_table_p)) {
+		auto &db = checkpointer.GetDatabase();
+		auto &config = DBConfig::GetConfig(db);
+		function = config.GetCompressionFunction(CompressionType::COMPRESSION_FSST, PhysicalType::VARCHAR);
+		symbol_table_size = symbol_table.SerializedSize();
+		CreateEmptySegment(checkpointer.GetRowGroup().start);
+	}
+
+	ColumnDataCheckpointer &checkpointer;
+	CompressionFunction *function;
+	//! The symbol table used to compress all segments of the column
+	FSSTSymbolTable symbol_table;
+	idx_t symbol_table_size;
+
+	// State regarding the current segment
+	unique_ptr<ColumnSegment> current_segment;
+	unique_ptr<BufferHandle> current_handle;
+	StringDictionaryContainer current_dictionary;
+	data_ptr_t current_end_ptr;
+	//! The end offsets of the compressed strings of the current segment, starting with a 0
+	vector<uint32_t> offsets;
+	bitpacking_width_t current_width;
+	//! Buffer holding the compressed version of the current string
+	vector<data_t> compress_buffer;
+
+public:
+	void CreateEmptySegment(idx_t row_start) {
+		auto &db = checkpointer.GetDatabase();
+		auto &type = checkpointer.GetType();
+		auto compressed_segment = ColumnSegment::CreateTransientSegment(db, type, row_start);
+		current_segment = move(compressed_segment);
+		current_segment->function = function;
+
+		offsets.clear();
+		offsets.push_back(0);
+		current_width = 0;
+
+		auto &buffer_manager = BufferManager::GetBufferManager(db);
+		current_handle = buffer_manager.Pin(current_segment->block);
+		current_dictionary.size = 0;
+		current_dictionary.end = Storage::BLOCK_SIZE;
+		current_end_ptr = current_handle->node->buffer + current_dictionary.end;
+	}
+
+	void UpdateState(Vector &scan_vector, idx_t count) {
+		VectorData vdata;
+		scan_vector.Orrify(count, vdata);
+		auto data = (string_t *)vdata.data;
+
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = vdata.sel->get_index(i);
+			idx_t compressed_size = 0;
+			bool row_is_valid = vdata.validity.RowIsValid(idx);
+			if (row_is_valid) {
+				auto &str = data[idx];
+				compress_buffer.resize(MaxValue<idx_t>(compress_buffer.size(), str.GetSize() * 2));
+				compressed_size = symbol_table.Compress((const_data_ptr_t)str.GetDataUnsafe(), str.GetSize(),
+				                                        compress_buffer.data());
+			}
+
+			auto new_dict_size = current_dictionary.size + compressed_size;
+			auto new_width = BitpackingPrimitives::MinimumBitWidth<uint32_t>((uint32_t)new_dict_size);
+			if (!FSSTStorage::HasEnoughSpace(current_segment->count + 1, new_dict_size, symbol_table_size,
+			                                 new_width)) {
+				// the value does not fit in the current segment: flush it and start a new one
+				Flush();
+				new_dict_size = compressed_size;
+				new_width = BitpackingPrimitives::MinimumBitWidth<uint32_t>((uint32_t)new_dict_size);
+				if (!FSSTStorage::HasEnoughSpace(1, new_dict_size, symbol_table_size, new_width)) {
+					throw InternalException("FSST compression could not write to new segment");
+				}
+			}
+
+			if (row_is_valid) {
+				auto &sstats = (StringStatistics &)*current_segment->stats.statistics;
+				sstats.Update(data[idx]);
+				memcpy(current_end_ptr - new_dict_size, compress_buffer.data(), compressed_size);
+			}
+			current_dictionary.size = new_dict_size;
+			current_width = new_width;
+			offsets.push_back(new_dict_size);
+			current_segment->count++;
+		}
+	}
+
+	void Flush(bool final = false) {
+		auto next_start = current_segment->start + current_segment->count;
+
+		auto segment_size = FinalizeSegment();
+		auto &state = checkpointer.GetCheckpointState();
+		state.FlushSegment(move(current_segment), segment_size);
+
+		if (!final) {
+			CreateEmptySegment(next_start);
+		}
+	}
+
+	void Finalize() {
+		Flush(true);
+	}
+
+private:
+	//! Writes the offsets and the symbol table into the segment, and compacts the segment if possible
+	//! Returns the size of the segment
+	idx_t FinalizeSegment() {
+		D_ASSERT(current_dictionary.end == Storage::BLOCK_SIZE);
+		D_ASSERT(offsets.size() == current_segment->count + 1);
+
+		auto compressed_offsets_size = BitpackingPrimitives::GetRequiredSize(offsets.size(), current_width);
+		auto symbol_table_offset = FSSTStorage::FSST_HEADER_SIZE + compressed_offsets_size;
+		auto total_size = symbol_table_offset + symbol_table_size + current_dictionary.size;
+		D_ASSERT(total_size <= Storage::BLOCK_SIZE);
+
+		auto base_ptr = current_handle->node->buffer;
+		auto header_ptr = (FSSTCompressionHeader *)base_ptr;
+
+		// write the offsets and the symbol table
+		BitpackingPrimitives::PackBuffer<uint32_t>(base_ptr + FSSTStorage::FSST_HEADER_SIZE, offsets.data(),
+		                                           offsets.size(), current_width);
+		symbol_table.Serialize(base_ptr + symbol_table_offset);
+
+		Store<uint32_t>(symbol_table_offset, (data_ptr_t)&header_ptr->symbol_table_offset);
+		Store<uint32_t>((uint32_t)current_width, (data_ptr_t)&header_ptr->bitpacking_width);
+
+		if (total_size >= FSSTStorage::COMPACTION_FLUSH_LIMIT) {
+			// the block is full enough, don't bother moving around the dictionary
+			Store<uint32_t>(current_dictionary.size, (data_ptr_t)&header_ptr->dict_size);
+			Store<uint32_t>(current_dictionary.end, (data_ptr_t)&header_ptr->dict_end);
+			current_handle.reset();
+			return Storage::BLOCK_SIZE;
+		}
+		// the block has space left: move the dictionary so it lines up exactly with the symbol table
+		auto new_dictionary_offset = symbol_table_offset + symbol_table_size;
+		memmove(base_ptr + new_dictionary_offset, base_ptr + current_dictionary.end - current_dictionary.size,
+		        current_dictionary.size);
+		current_dictionary.end = total_size;
+		Store<uint32_t>(current_dictionary.size, (data_ptr_t)&header_ptr->dict_size);
+		Store<uint32_t>(current_dictionary.end, (data_ptr_t)&header_ptr->dict_end);
+		current_handle.reset();
+		return total_size;
+	}
+};
+
+unique_ptr<CompressionState> FSSTStorage::InitCompression(ColumnDataCheckpointer &checkpointer,
+                                                          unique_ptr<AnalyzeState> analyze_state_p) {
+	auto &analyze_state = (FSSTAnalyzeState &)*analyze_state_p;
+	return make_unique<FSSTCompressionState>(checkpointer, move(analyze_state.symbol_table));
+}
+
+void FSSTStorage::Compress(CompressionState &state_p, Vector &scan_vector, idx_t count) {
+	auto &state = (FSSTCompressionState &)state_p;
+	state.UpdateState(scan_vector, count);
+}
+
+void FSSTStorage::FinalizeCompress(CompressionState &state_p) {
+	auto &state = (FSSTCompressionState &)state_p;
+	state.Finalize();
+}
+
+//===--------------------------------------------------------------------===//
+// Scan
+//===--------------------------------------------------------------------===//
+struct FSSTScanState : public SegmentScanState {
+	unique_ptr<BufferHandle> handle;
+	FSSTSymbolTable symbol_table;
+	bitpacking_width_t current_width;
+	//! Buffer used to unpack the offsets
+	unique_ptr<uint32_t[]> offset_buffer;
+	idx_t offset_buffer_size = 0;
+};
+
+unique_ptr<SegmentScanState> FSSTStorage::StringInitScan(ColumnSegment &segment) {
+	auto state = make_unique<FSSTScanState>();
+	auto &buffer_manager = BufferManager::GetBufferManager(segment.db);
+	state->handle = buffer_manager.Pin(segment.block);
+
+	auto baseptr = state->handle->node->buffer + segment.GetBlockOffset();
+	auto header_ptr = (FSSTCompressionHeader *)baseptr;
+	state->current_width = (bitpacking_width_t)(Load<uint32_t>((data_ptr_t)&header_ptr->bitpacking_width));
+	auto symbol_table_offset = Load<uint32_t>((data_ptr_t)&header_ptr->symbol_table_offset);
+	state->symbol_table = FSSTSymbolTable::Deserialize(baseptr + symbol_table_offset);
+	return move(state);
+}
+
+//===--------------------------------------------------------------------===//
+// Scan base data
+//===--------------------------------------------------------------------===//
+void FSSTStorage::StringScanPartial(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result,
+                                    idx_t result_offset) {
+	auto &scan_state = (FSSTScanState &)*state.scan_state;
+	auto start = segment.GetRelativeIndex(state.row_index);
+
+	auto baseptr = scan_state.handle->node->buffer + segment.GetBlockOffset();
+	auto header_ptr = (FSSTCompressionHeader *)baseptr;
+	auto dict_end = baseptr + Load<uint32_t>((data_ptr_t)&header_ptr->dict_end);
+
+	auto required_size = scan_count + 2 * BitpackingPrimitives::BITPACKING_ALGORITHM_GROUP_SIZE;
+	if (scan_state.offset_buffer_size < required_size) {
+		scan_state.offset_buffer = unique_ptr<uint32_t[]>(new uint32_t[required_size]);
+		scan_state.offset_buffer_size = required_size;
+	}
+	auto offsets = scan_state.offset_buffer.get();
+	auto offset_start = UnpackOffsets(baseptr, start, scan_count, scan_state.current_width, offsets);
+
+	// the strings are only decompressed here, when they are actually scanned
+	auto result_data = FlatVector::GetData<string_t>(result);
+	for (idx_t i = 0; i < scan_count; i++) {
+		result_data[result_offset + i] = DecompressString(scan_state.symbol_table, result, dict_end,
+		                                                  offsets[offset_start + i], offsets[offset_start + i + 1]);
+	}
+}
+
+void FSSTStorage::StringScan(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result) {
+	StringScanPartial(segment, state, scan_count, result, 0);
+}
+
+//===--------------------------------------------------------------------===//
+// Fetch
+//===--------------------------------------------------------------------===//
+void FSSTStorage::StringFetchRow(ColumnSegment &segment, ColumnFetchState &state, row_t row_id, Vector &result,
+                                 idx_t result_idx) {
+	// the scan state is kept around, so the symbol table is only deserialized once per segment
+	auto &segment_state = state.segment_states[&segment];
+	if (!segment_state) {
+		segment_state = StringInitScan(segment);
+	}
+	auto &scan_state = (FSSTScanState &)*segment_state;
+
+	auto baseptr = scan_state.handle->node->buffer + segment.GetBlockOffset();
+	auto header_ptr = (FSSTCompressionHeader *)baseptr;
+	auto dict_end = baseptr + Load<uint32_t>((data_ptr_t)&header_ptr->dict_end);
+	auto width = scan_state.current_width;
+
+	// only unpack the (at most two) groups of offsets that hold the start and end of the string
+	uint32_t offsets[3 * BitpackingPrimitives::BITPACKING_ALGORITHM_GROUP_SIZE];
+	auto offset_start = UnpackOffsets(baseptr, row_id, 1, width, offsets);
+	auto start_offset = offsets[offset_start];
+	auto end_offset = offsets[offset_start + 1];
+
+	auto result_data = FlatVector::GetData<string_t>(result);
+	if (start_offset == end_offset) {
+		result_data[result_idx] = string_t(nullptr, 0);
+		return;
+	}
+	result_data[result_idx] = DecompressString(scan_state.symbol_table, result, dict_end, start_offset, end_offset);
+}
+
+//===--------------------------------------------------------------------===//
+// Helper Functions
+//===--------------------------------------------------------------------===//
+bool FSSTStorage::HasEnoughSpace(idx_t current_count, idx_t dict_size, idx_t symbol_table_size,
+                                 bitpacking_width_t packing_width) {
+	return RequiredSpace(current_count, dict_size, symbol_table_size, packing_width) <= Storage::BLOCK_SIZE;
+}
+
+idx_t FSSTStorage::RequiredSpace(idx_t current_count, idx_t dict_size, idx_t symbol_table_size,
+                                 bitpacking_width_t packing_width) {
+	// the offsets hold an additional (leading) entry
+	idx_t offset_space = BitpackingPrimitives::GetRequiredSize(current_count + 1, packing_width);
+	return FSST_HEADER_SIZE + offset_space + symbol_table_size + dict_size;
+}
+
+idx_t FSSTStorage::UnpackOffsets(data_ptr_t baseptr, idx_t start, idx_t count, bitpacking_width_t width,
+                                 uint32_t *dst) {
+	// we unpack whole groups of BITPACKING_ALGORITHM_GROUP_SIZE values, starting at the group containing "start"
+	idx_t start_offset = start % BitpackingPrimitives::BITPACKING_ALGORITHM_GROUP_SIZE;
+	idx_t decompress_count = BitpackingPrimitives::RoundUpToAlgorithmGroupSize(start_offset + count + 1);
+	auto src = baseptr + FSST_HEADER_SIZE + ((start - start_offset) * width) / 8;
+	BitpackingPrimitives::UnPackBuffer<uint32_t>((data_ptr_t)dst, src, decompress_count, width);
+	return start_offset;
+}
+
+string_t FSSTStorage::DecompressString(const FSSTSymbolTable &table, Vector &result, data_ptr_t dict_end,
+                                       uint32_t start_offset, uint32_t end_offset) {
+	D_ASSERT(start_offset <= end_offset);
+	if (start_offset == end_offset) {
+		return string_t(nullptr, 0);
+	}
+	// the compressed string is stored backwards from the end of the dictionary
+	auto compressed_ptr = dict_end - end_offset;
+	auto compressed_size = end_offset - start_offset;
+	auto decompressed_size = table.DecompressedSize(compressed_ptr, compressed_size);
+	auto str = StringVector::EmptyString(result, decompressed_size);
+	table.Decompress(compressed_ptr, compressed_size, (data_ptr_t)str.GetDataWriteable());
+	str.Finalize();
+	return str;
+}
+
+//===--------------------------------------------------------------------===//
+// Get Function
+//===--------------------------------------------------------------------===//
+CompressionFunction FSSTFun::GetFunction(PhysicalType data_type) {
+	D_ASSERT(data_type == PhysicalType::VARCHAR);
+	return CompressionFunction(CompressionType::COMPRESSION_FSST, data_type, FSSTStorage::StringInitAnalyze,
+	                           FSSTStorage::StringAnalyze, FSSTStorage::StringFinalAnalyze,
+	                           FSSTStorage::InitCompression, FSSTStorage::Compress, FSSTStorage::FinalizeCompress,
+	                           FSSTStorage::StringInitScan, FSSTStorage::StringScan, FSSTStorage::StringScanPartial,
+	                           FSSTStorage::StringFetchRow, UncompressedFunctions::EmptySkip);
+}
+
+bool FSSTFun::TypeIsSupported(PhysicalType type) {
+	return type == PhysicalType::VARCHAR;
+}
+
+} // namespace duckdb
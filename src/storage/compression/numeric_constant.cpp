@@ -1,4 +1,5 @@
 #include "duckdb/function/compression/compression.hpp"
+#include "duckdb/function/compression/compressed_filter.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/common/types/vector.hpp"
 #include "duckdb/storage/statistics/numeric_statistics.hpp"
@@ -22,6 +23,10 @@ unique_ptr<SegmentScanState> ConstantInitScan(ColumnSegment &segment) {
 void ConstantScanFunctionValidity(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result) {
 	auto &validity = (ValidityStatistics &)*segment.stats.statistics;
 	if (validity.has_null) {
+		if (result.GetVectorType() == VectorType::DICTIONARY_VECTOR) {
+			// the data was emitted as a dictionary vector: flatten it before turning it into a constant
+			result.Normalify(scan_count);
+		}
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
 		ConstantVector::SetNull(result, true);
 	}
@@ -34,6 +39,7 @@ void ConstantScanFunction(ColumnSegment &segment, ColumnScanState &state, idx_t
 	auto data = FlatVector::GetData<T>(result);
 	data[0] = nstats.min.GetValueUnsafe<T>();
 	result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	ConstantVector::SetNull(result, false);
 }
 
 //===--------------------------------------------------------------------===//
@@ -71,6 +77,22 @@ void ConstantScanPartial(ColumnSegment &segment, ColumnScanState &state, idx_t s
 	ConstantFillFunction<T>(segment, result, result_offset, scan_count);
 }
 
+//===--------------------------------------------------------------------===//
+// Filter
+//===--------------------------------------------------------------------===//
+template <class T>
+void ConstantFilterFunction(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result,
+                            SelectionVector &sel, idx_t &approved_tuple_count, const TableFilter &filter) {
+	// the comparison only has to be evaluated once for the entire vector
+	ConstantScanFunction<T>(segment, state, scan_count, result);
+	auto &constant_filter = (ConstantFilter &)filter;
+	auto value = ConstantVector::GetData<T>(result)[0];
+	auto constant = CompressedFilter::GetConstant<T>(constant_filter);
+	if (!CompressedFilter::Compare<T>(value, constant, constant_filter.comparison_type)) {
+		approved_tuple_count = 0;
+	}
+}
+
 //===--------------------------------------------------------------------===//
 // Fetch
 //===--------------------------------------------------------------------===//
@@ -98,7 +120,8 @@ template <class T>
 CompressionFunction ConstantGetFunction(PhysicalType data_type) {
 	return CompressionFunction(CompressionType::COMPRESSION_CONSTANT, data_type, nullptr, nullptr, nullptr, nullptr,
 	                           nullptr, nullptr, ConstantInitScan, ConstantScanFunction<T>, ConstantScanPartial<T>,
-	                           ConstantFetchRow<T>, UncompressedFunctions::EmptySkip);
+	                           ConstantFetchRow<T>, UncompressedFunctions::EmptySkip, nullptr, nullptr, nullptr, nullptr,
+	                           ConstantFilterFunction<T>);
 }
 
 CompressionFunction ConstantFun::GetFunction(PhysicalType data_type) {
@@ -0,0 +1,529 @@
+#include "duckdb/common/bitpacking.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/function/compression/compression.hpp"
+#include "duckdb/function/compression_function.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/statistics/numeric_statistics.hpp"
+#include "duckdb/storage/table/column_data_checkpointer.hpp"
+#include "duckdb/storage/table/column_segment.hpp"
+
+namespace duckdb {
+
+//! PFOR_DELTA compression: values are stored as the delta to their predecessor, which makes monotonic data (ids,
+//! timestamps) compress to a handful of bits per value. The deltas are split into groups of PFOR_GROUP_SIZE values,
+//! every group stores the deltas relative to the minimum delta of the group (frame of reference), bitpacked at a
+//! single width. Deltas that do not fit in that width are stored as patched exceptions.
+//! The layout of a group is as follows:
+//! [reference value][minimum delta][bit width][exception count][bitpacked deltas][exception positions][exceptions]
+//! The segment stores the offsets of the groups at the end of the segment (growing downwards), which allows a fetch
+//! to directly decode the group containing the row.
+static constexpr const idx_t PFOR_GROUP_SIZE = 1024;
+
+template <class T>
+struct PFORDeltaGroup {
+	using T_U = typename std::make_unsigned<T>::type;
+
+	static constexpr const idx_t EXCEPTION_SIZE = sizeof(uint16_t) + sizeof(T_U);
+	//! The header is padded to 8 bytes so the bitpacked deltas are aligned
+	static constexpr const idx_t HEADER_SIZE =
+	    (2 * sizeof(T) + sizeof(bitpacking_width_t) + sizeof(uint16_t) + 7) / 8 * 8;
+
+	//! The maximum size of an encoded group
+	static constexpr idx_t MaxGroupSize() {
+		return HEADER_SIZE + PFOR_GROUP_SIZE * sizeof(T_U) + PFOR_GROUP_SIZE * EXCEPTION_SIZE;
+	}
+
+	//! The amount of bits required to store a value, without rounding to efficient widths
+	static bitpacking_width_t RequiredBits(T_U value) {
+		bitpacking_width_t result = 0;
+		while (value) {
+			result++;
+			value >>= 1;
+		}
+		return result;
+	}
+
+	//! Encodes a group of values into "dst", returns the size of the encoded group
+	static idx_t Encode(T *values, idx_t count, data_ptr_t dst, T_U *delta_buffer) {
+		D_ASSERT(count > 0 && count <= PFOR_GROUP_SIZE);
+		// compute the deltas (with wrap-around arithmetic) and the minimum delta
+		T min_delta = 0;
+		for (idx_t i = 1; i < count; i++) {
+			auto delta = (T)((T_U)values[i] - (T_U)values[i - 1]);
+			if (i == 1 || delta < min_delta) {
+				min_delta = delta;
+			}
+			delta_buffer[i] = (T_U)delta;
+		}
+		// the first value is decoded as "reference + min_delta": its delta is set to min_delta, so it is stored as 0
+		// once the frame of reference (min_delta) is subtracted below
+		auto reference = (T)((T_U)values[0] - (T_U)min_delta);
+		delta_buffer[0] = (T_U)min_delta;
+		idx_t width_counts[sizeof(T_U) * 8 + 1];
+		memset(width_counts, 0, sizeof(width_counts));
+		for (idx_t i = 0; i < count; i++) {
+			delta_buffer[i] -= (T_U)min_delta;
+			width_counts[RequiredBits(delta_buffer[i])]++;
+		}
+		for (idx_t i = count; i < PFOR_GROUP_SIZE; i++) {
+			delta_buffer[i] = 0;
+		}
+
+		// pick the width that minimizes the size of the bitpacked deltas + exceptions
+		bitpacking_width_t width = sizeof(T_U) * 8;
+		idx_t best_size = NumericLimits<idx_t>::Maximum();
+		idx_t exception_count = 0;
+		for (idx_t candidate = sizeof(T_U) * 8 + 1; candidate > 0; candidate--) {
+			auto candidate_width = (bitpacking_width_t)(candidate - 1);
+			auto size = BitpackingPrimitives::GetRequiredSize(PFOR_GROUP_SIZE, candidate_width) +
+			            exception_count * EXCEPTION_SIZE;
+			if (size < best_size) {
+				best_size = size;
+				width = candidate_width;
+			}
+			// every value requiring exactly "candidate_width" bits is an exception for the next (smaller) width
+			exception_count += width_counts[candidate_width];
+		}
+
+		// write the header
+		auto ptr = dst;
+		Store<T>(reference, ptr);
+		ptr += sizeof(T);
+		Store<T>(min_delta, ptr);
+		ptr += sizeof(T);
+		Store<bitpacking_width_t>(width, ptr);
+		ptr += sizeof(bitpacking_width_t);
+		auto exception_count_ptr = ptr;
+		ptr = dst + HEADER_SIZE;
+
+		// gather the exceptions, and replace them in the delta buffer so they can be bitpacked
+		auto packed_ptr = ptr;
+		auto exception_positions_ptr = packed_ptr + BitpackingPrimitives::GetRequiredSize(PFOR_GROUP_SIZE, width);
+		uint16_t exceptions = 0;
+		for (idx_t i = 0; i < count; i++) {
+			if (RequiredBits(delta_buffer[i]) > width) {
+				exceptions++;
+			}
+		}
+		auto exception_values_ptr = exception_positions_ptr + exceptions * sizeof(uint16_t);
+		idx_t exception_idx = 0;
+		for (idx_t i = 0; i < count; i++) {
+			if (RequiredBits(delta_buffer[i]) <= width) {
+				continue;
+			}
+			Store<uint16_t>((uint16_t)i, exception_positions_ptr + exception_idx * sizeof(uint16_t));
+			Store<T_U>(delta_buffer[i], exception_values_ptr + exception_idx * sizeof(T_U));
+			delta_buffer[i] = 0;
+			exception_idx++;
+		}
+		Store<uint16_t>(exceptions, exception_count_ptr);
+		BitpackingPrimitives::PackBuffer<T_U>(packed_ptr, delta_buffer, PFOR_GROUP_SIZE, width);
+		// groups are aligned so the next group starts at an aligned address as well
+		return AlignValue<idx_t>(exception_values_ptr + exceptions * sizeof(T_U) - dst);
+	}
+
+	//! Decodes a full group of PFOR_GROUP_SIZE values from "src" into "dst"
+	static void Decode(data_ptr_t src, T *dst) {
+		auto reference = Load<T>(src);
+		src += sizeof(T);
+		auto min_delta = (T_U)Load<T>(src);
+		src += sizeof(T);
+		auto width = Load<bitpacking_width_t>(src);
+		src += sizeof(bitpacking_width_t);
+		auto exceptions = Load<uint16_t>(src);
+		src += HEADER_SIZE - 2 * sizeof(T) - sizeof(bitpacking_width_t);
+
+		// unpack the deltas straight into the result and patch the exceptions
+		auto deltas = (T_U *)dst;
+		BitpackingPrimitives::UnPackBuffer<T_U>((data_ptr_t)deltas, src, PFOR_GROUP_SIZE, width);
+		auto exception_positions_ptr = src + BitpackingPrimitives::GetRequiredSize(PFOR_GROUP_SIZE, width);
+		auto exception_values_ptr = exception_positions_ptr + exceptions * sizeof(uint16_t);
+		for (idx_t i = 0; i < exceptions; i++) {
+			auto position = Load<uint16_t>(exception_positions_ptr + i * sizeof(uint16_t));
+			deltas[position] = Load<T_U>(exception_values_ptr + i * sizeof(T_U));
+		}
+
+		// reconstruct the values with a prefix sum over the deltas
+		auto current = (T_U)reference;
+		for (idx_t i = 0; i < PFOR_GROUP_SIZE; i++) {
+			current += deltas[i] + min_delta;
+			deltas[i] = current;
+		}
+	}
+};
+
+//===--------------------------------------------------------------------===//
+// Analyze
+//===--------------------------------------------------------------------===//
+template <class T>
+struct PFORDeltaState {
+	using T_U = typename std::make_unsigned<T>::type;
+
+	PFORDeltaState() : buffer_idx(0), total_size(0), last_value(0) {
+	}
+
+	T buffer[PFOR_GROUP_SIZE];
+	bool buffer_validity[PFOR_GROUP_SIZE];
+	idx_t buffer_idx;
+	idx_t total_size;
+	//! NULL values are stored as a copy of the previous value, so they do not break up the run of deltas
+	T last_value;
+
+	T_U delta_buffer[PFOR_GROUP_SIZE];
+
+	void Update(T *data, ValidityMask &validity, idx_t idx) {
+		if (validity.RowIsValid(idx)) {
+			buffer_validity[buffer_idx] = true;
+			last_value = data[idx];
+		} else {
+			buffer_validity[buffer_idx] = false;
+		}
+		buffer[buffer_idx++] = last_value;
+	}
+};
+
+template <class T>
+struct PFORDeltaAnalyzeState : public AnalyzeState {
+	PFORDeltaState<T> state;
+	unique_ptr<data_t[]> scratch;
+
+	void Flush() {
+		if (state.buffer_idx == 0) {
+			return;
+		}
+		if (!scratch) {
+			scratch = unique_ptr<data_t[]>(new data_t[PFORDeltaGroup<T>::MaxGroupSize()]);
+		}
+		// encode the group into a scratch buffer to determine its size
+		state.total_size +=
+		    PFORDeltaGroup<T>::Encode(state.buffer, state.buffer_idx, scratch.get(), state.delta_buffer) +
+		    sizeof(uint32_t);
+		state.buffer_idx = 0;
+	}
+};
+
+template <class T>
+unique_ptr<AnalyzeState> PFORDeltaInitAnalyze(ColumnData &col_data, PhysicalType type) {
+	return make_unique<PFORDeltaAnalyzeState<T>>();
+}
+
+template <class T>
+bool PFORDeltaAnalyze(AnalyzeState &state_p, Vector &input, idx_t count) {
+	auto &analyze_state = (PFORDeltaAnalyzeState<T> &)state_p;
+	VectorData vdata;
+	input.Orrify(count, vdata);
+
+	auto data = (T *)vdata.data;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		analyze_state.state.Update(data, vdata.validity, idx);
+		if (analyze_state.state.buffer_idx == PFOR_GROUP_SIZE) {
+			analyze_state.Flush();
+		}
+	}
+	return true;
+}
+
+template <class T>
+idx_t PFORDeltaFinalAnalyze(AnalyzeState &state_p) {
+	auto &analyze_state = (PFORDeltaAnalyzeState<T> &)state_p;
+	analyze_state.Flush();
+	return analyze_state.state.total_size;
+}
+
+//===--------------------------------------------------------------------===//
+// Compress
+//===--------------------------------------------------------------------===//
+template <class T>
+struct PFORDeltaCompressState : public CompressionState {
+public:
+	explicit PFORDeltaCompressState(ColumnDataCheckpointer &checkpointer) : checkpointer(checkpointer) {
+		auto &db = checkpointer.GetDatabase();
+		auto &type = checkpointer.GetType();
+		auto &config = DBConfig::GetConfig(db);
+		function = config.GetCompressionFunction(CompressionType::COMPRESSION_PFOR_DELTA, type.InternalType());
+		encode_buffer = unique_ptr<data_t[]>(new data_t[PFORDeltaGroup<T>::MaxGroupSize()]);
+		CreateEmptySegment(checkpointer.GetRowGroup().start);
+	}
+
+	ColumnDataCheckpointer &checkpointer;
+	CompressionFunction *function;
+	unique_ptr<ColumnSegment> current_segment;
+	unique_ptr<BufferHandle> handle;
+
+	// Ptr to next free spot in segment;
+	data_ptr_t data_ptr;
+	// Ptr to next free spot for storing group offsets (growing downwards).
+	data_ptr_t offset_ptr;
+
+	PFORDeltaState<T> state;
+	unique_ptr<data_t[]> encode_buffer;
+
+public:
+	// Space remaining between the offset_ptr growing down and data ptr growing up
+	idx_t RemainingSize() {
+		return offset_ptr - data_ptr;
+	}
+
+	void CreateEmptySegment(idx_t row_start) {
+		auto &db = checkpointer.GetDatabase();
+		auto &type = checkpointer.GetType();
+		auto compressed_segment = ColumnSegment::CreateTransientSegment(db, type, row_start);
+		compressed_segment->function = function;
+		current_segment = move(compressed_segment);
+		auto &buffer_manager = BufferManager::GetBufferManager(db);
+		handle = buffer_manager.Pin(current_segment->block);
+
+		data_ptr = handle->Ptr() + current_segment->GetBlockOffset() + sizeof(idx_t);
+		offset_ptr = handle->Ptr() + current_segment->GetBlockOffset() + Storage::BLOCK_SIZE - sizeof(uint32_t);
+	}
+
+	void Append(VectorData &vdata, idx_t count) {
+		auto data = (T *)vdata.data;
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = vdata.sel->get_index(i);
+			state.Update(data, vdata.validity, idx);
+			if (state.buffer_idx == PFOR_GROUP_SIZE) {
+				FlushGroup();
+			}
+		}
+	}
+
+	void FlushGroup() {
+		if (state.buffer_idx == 0) {
+			return;
+		}
+		auto group_size =
+		    PFORDeltaGroup<T>::Encode(state.buffer, state.buffer_idx, encode_buffer.get(), state.delta_buffer);
+		if (RemainingSize() < group_size + sizeof(uint32_t)) {
+			// Segment is full
+			auto row_start = current_segment->start + current_segment->count;
+			FlushSegment();
+			CreateEmptySegment(row_start);
+		}
+		for (idx_t i = 0; i < state.buffer_idx; i++) {
+			if (state.buffer_validity[i]) {
+				NumericStatistics::Update<T>(current_segment->stats, state.buffer[i]);
+			}
+		}
+
+		Store<uint32_t>(data_ptr - (handle->node->buffer + current_segment->GetBlockOffset()), offset_ptr);
+		offset_ptr -= sizeof(uint32_t);
+		memcpy(data_ptr, encode_buffer.get(), group_size);
+		data_ptr += group_size;
+
+		current_segment->count += state.buffer_idx;
+		state.buffer_idx = 0;
+	}
+
+	void FlushSegment() {
+		auto &checkpoint_state = checkpointer.GetCheckpointState();
+
+		// Compact the segment by moving the group offsets next to the data.
+		idx_t minimal_offsets_offset = AlignValue(data_ptr - handle->node->buffer);
+		idx_t offsets_size = handle->node->buffer + Storage::BLOCK_SIZE - offset_ptr - sizeof(uint32_t);
+		idx_t total_segment_size = minimal_offsets_offset + offsets_size;
+		memmove(handle->node->buffer + minimal_offsets_offset, offset_ptr + sizeof(uint32_t), offsets_size);
+
+		// Store the offset of the first group offset (which is at the highest address).
+		Store<idx_t>(minimal_offsets_offset + offsets_size - sizeof(uint32_t), handle->node->buffer);
+		handle.reset();
+
+		checkpoint_state.FlushSegment(move(current_segment), total_segment_size);
+	}
+
+	void Finalize() {
+		FlushGroup();
+		FlushSegment();
+		current_segment.reset();
+	}
+};
+
+template <class T>
+unique_ptr<CompressionState> PFORDeltaInitCompression(ColumnDataCheckpointer &checkpointer,
+                                                      unique_ptr<AnalyzeState> state) {
+	return make_unique<PFORDeltaCompressState<T>>(checkpointer);
+}
+
+template <class T>
+void PFORDeltaCompress(CompressionState &state_p, Vector &scan_vector, idx_t count) {
+	auto &state = (PFORDeltaCompressState<T> &)state_p;
+	VectorData vdata;
+	scan_vector.Orrify(count, vdata);
+	state.Append(vdata, count);
+}
+
+template <class T>
+void PFORDeltaFinalizeCompress(CompressionState &state_p) {
+	auto &state = (PFORDeltaCompressState<T> &)state_p;
+	state.Finalize();
+}
+
+//===--------------------------------------------------------------------===//
+// Scan
+//===--------------------------------------------------------------------===//
+template <class T>
+struct PFORDeltaScanState : public SegmentScanState {
+public:
+	explicit PFORDeltaScanState(ColumnSegment &segment) {
+		auto &buffer_manager = BufferManager::GetBufferManager(segment.db);
+		handle = buffer_manager.Pin(segment.block);
+
+		// load offset to the group offsets
+		base_ptr = handle->node->buffer + segment.GetBlockOffset();
+		group_offsets_ptr = base_ptr + Load<idx_t>(base_ptr);
+	}
+
+	unique_ptr<BufferHandle> handle;
+	data_ptr_t base_ptr;
+	data_ptr_t group_offsets_ptr;
+
+	idx_t current_group = 0;
+	idx_t position_in_group = 0;
+	//! Whether or not the current group has been decoded into the decompression buffer
+	bool group_decoded = false;
+	T decompression_buffer[PFOR_GROUP_SIZE];
+
+public:
+	data_ptr_t GetGroupPtr(idx_t group_idx) {
+		auto group_offset = Load<uint32_t>(group_offsets_ptr - group_idx * sizeof(uint32_t));
+		return base_ptr + group_offset;
+	}
+
+	void DecodeGroup(T *dst) {
+		PFORDeltaGroup<T>::Decode(GetGroupPtr(current_group), dst);
+	}
+
+	void Skip(idx_t skip_count) {
+		position_in_group += skip_count;
+		if (position_in_group >= PFOR_GROUP_SIZE) {
+			current_group += position_in_group / PFOR_GROUP_SIZE;
+			position_in_group %= PFOR_GROUP_SIZE;
+			group_decoded = false;
+		}
+	}
+};
+
+template <class T>
+unique_ptr<SegmentScanState> PFORDeltaInitScan(ColumnSegment &segment) {
+	auto result = make_unique<PFORDeltaScanState<T>>(segment);
+	return move(result);
+}
+
+//===--------------------------------------------------------------------===//
+// Scan base data
+//===--------------------------------------------------------------------===//
+template <class T>
+void PFORDeltaScanPartial(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result,
+                          idx_t result_offset) {
+	auto &scan_state = (PFORDeltaScanState<T> &)*state.scan_state;
+
+	T *result_data = FlatVector::GetData<T>(result);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+
+	idx_t scanned = 0;
+	while (scanned < scan_count) {
+		auto to_scan = MinValue<idx_t>(scan_count - scanned, PFOR_GROUP_SIZE - scan_state.position_in_group);
+		T *current_result_ptr = result_data + result_offset + scanned;
+		if (to_scan == PFOR_GROUP_SIZE) {
+			// scanning an entire group: decode directly into the result vector
+			scan_state.DecodeGroup(current_result_ptr);
+		} else {
+			if (!scan_state.group_decoded) {
+				scan_state.DecodeGroup(scan_state.decompression_buffer);
+				scan_state.group_decoded = true;
+			}
+			memcpy(current_result_ptr, scan_state.decompression_buffer + scan_state.position_in_group,
+			       to_scan * sizeof(T));
+		}
+		scanned += to_scan;
+		scan_state.Skip(to_scan);
+	}
+}
+
+template <class T>
+void PFORDeltaScan(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result) {
+	PFORDeltaScanPartial<T>(segment, state, scan_count, result, 0);
+}
+
+//===--------------------------------------------------------------------===//
+// Fetch
+//===--------------------------------------------------------------------===//
+template <class T>
+void PFORDeltaFetchRow(ColumnSegment &segment, ColumnFetchState &state, row_t row_id, Vector &result,
+                       idx_t result_idx) {
+	// the scan state is kept around, so fetching rows from the same group only decodes the group once
+	auto &segment_state = state.segment_states[&segment];
+	if (!segment_state) {
+		segment_state = PFORDeltaInitScan<T>(segment);
+	}
+	auto &scan_state = (PFORDeltaScanState<T> &)*segment_state;
+	idx_t group_idx = row_id / PFOR_GROUP_SIZE;
+	if (!scan_state.group_decoded || scan_state.current_group != group_idx) {
+		scan_state.current_group = group_idx;
+		scan_state.DecodeGroup(scan_state.decompression_buffer);
+		scan_state.group_decoded = true;
+	}
+
+	auto result_data = FlatVector::GetData<T>(result);
+	result_data[result_idx] = scan_state.decompression_buffer[row_id % PFOR_GROUP_SIZE];
+}
+
+template <class T>
+void PFORDeltaSkip(ColumnSegment &segment, ColumnScanState &state, idx_t skip_count) {
+	auto &scan_state = (PFORDeltaScanState<T> &)*state.scan_state;
+	scan_state.Skip(skip_count);
+}
+
+//===--------------------------------------------------------------------===//
+// Get Function
+//===--------------------------------------------------------------------===//
+template <class T>
+CompressionFunction GetPFORDeltaFunction(PhysicalType data_type) {
+	return CompressionFunction(CompressionType::COMPRESSION_PFOR_DELTA, data_type, PFORDeltaInitAnalyze<T>,
+	                           PFORDeltaAnalyze<T>, PFORDeltaFinalAnalyze<T>, PFORDeltaInitCompression<T>,
+	                           PFORDeltaCompress<T>, PFORDeltaFinalizeCompress<T>, PFORDeltaInitScan<T>,
+	                           PFORDeltaScan<T>, PFORDeltaScanPartial<T>, PFORDeltaFetchRow<T>, PFORDeltaSkip<T>);
+}
+
+CompressionFunction PFORDeltaFun::GetFunction(PhysicalType type) {
+	switch (type) {
+	case PhysicalType::INT8:
+		return GetPFORDeltaFunction<int8_t>(type);
+	case PhysicalType::INT16:
+		return GetPFORDeltaFunction<int16_t>(type);
+	case PhysicalType::INT32:
+		return GetPFORDeltaFunction<int32_t>(type);
+	case PhysicalType::INT64:
+		return GetPFORDeltaFunction<int64_t>(type);
+	case PhysicalType::UINT8:
+		return GetPFORDeltaFunction<uint8_t>(type);
+	case PhysicalType::UINT16:
+		return GetPFORDeltaFunction<uint16_t>(type);
+	case PhysicalType::UINT32:
+		return GetPFORDeltaFunction<uint32_t>(type);
+	case PhysicalType::UINT64:
+		return GetPFORDeltaFunction<uint64_t>(type);
+	default:
+		throw InternalException("Unsupported type for PFOR_DELTA");
+	}
+}
+
+bool PFORDeltaFun::TypeIsSupported(PhysicalType type) {
+	switch (type) {
+	case PhysicalType::INT8:
+	case PhysicalType::INT16:
+	case PhysicalType::INT32:
+	case PhysicalType::INT64:
+	case PhysicalType::UINT8:
+	case PhysicalType::UINT16:
+	case PhysicalType::UINT32:
+	case PhysicalType::UINT64:
+		return true;
+	default:
+		return false;
+	}
+}
+
+} // namespace duckdb
@@ -1,4 +1,5 @@
 #include "duckdb/function/compression/compression.hpp"
+#include "duckdb/function/compression/compressed_filter.hpp"
 #include "duckdb/storage/statistics/numeric_statistics.hpp"
 #include "duckdb/storage/table/column_segment.hpp"
 #include "duckdb/function/compression_function.hpp"
@@ -319,8 +320,71 @@ void RLEScanPartial(ColumnSegment &segment, ColumnScanState &state, idx_t scan_c
 
 template <class T>
 void RLEScan(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result) {
-	// FIXME: emit constant vector if repetition of single value is >= scan_count
-	RLEScanPartial<T>(segment, state, scan_count, result, 0);
+	auto &scan_state = (RLEScanState<T> &)*state.scan_state;
+
+	auto data = scan_state.handle->node->buffer + segment.GetBlockOffset();
+	auto data_pointer = (T *)(data + RLEConstants::RLE_HEADER_SIZE);
+	auto index_pointer = (rle_count_t *)(data + scan_state.rle_count_offset);
+
+	idx_t remaining_in_entry = index_pointer[scan_state.entry_pos] - scan_state.position_in_entry;
+	if (remaining_in_entry < scan_count) {
+		// the vector spans multiple runs: expand them into a flat vector
+		RLEScanPartial<T>(segment, state, scan_count, result, 0);
+		return;
+	}
+	// the entire vector lies within a single run: emit a constant vector
+	result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	ConstantVector::GetData<T>(result)[0] = data_pointer[scan_state.entry_pos];
+	ConstantVector::SetNull(result, false);
+
+	scan_state.position_in_entry += scan_count;
+	if (scan_state.position_in_entry >= index_pointer[scan_state.entry_pos]) {
+		scan_state.entry_pos++;
+		scan_state.position_in_entry = 0;
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Filter
+//===--------------------------------------------------------------------===//
+template <class T>
+void RLEFilter(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result, SelectionVector &sel,
+               idx_t &approved_tuple_count, const TableFilter &filter) {
+	auto &scan_state = (RLEScanState<T> &)*state.scan_state;
+	auto &constant_filter = (ConstantFilter &)filter;
+	auto constant = CompressedFilter::GetConstant<T>(constant_filter);
+
+	auto data = scan_state.handle->node->buffer + segment.GetBlockOffset();
+	auto data_pointer = (T *)(data + RLEConstants::RLE_HEADER_SIZE);
+	auto index_pointer = (rle_count_t *)(data + scan_state.rle_count_offset);
+
+	auto result_data = FlatVector::GetData<T>(result);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	CompressedFilterSelection selection(sel, approved_tuple_count);
+	idx_t run_start = 0;
+	while (run_start < scan_count) {
+		idx_t run_end = MinValue<idx_t>(run_start + index_pointer[scan_state.entry_pos] - scan_state.position_in_entry,
+		                                scan_count);
+		// the comparison is evaluated only once per run
+		// the values are only written if the run has selected rows that pass the filter
+		if (selection.HasRowsBefore(run_end)) {
+			auto value = data_pointer[scan_state.entry_pos];
+			bool approved = CompressedFilter::Compare<T>(value, constant, constant_filter.comparison_type);
+			if (approved) {
+				for (idx_t i = run_start; i < run_end; i++) {
+					result_data[i] = value;
+				}
+			}
+			selection.SelectRange(run_end, approved);
+		}
+		scan_state.position_in_entry += run_end - run_start;
+		if (scan_state.position_in_entry >= index_pointer[scan_state.entry_pos]) {
+			scan_state.entry_pos++;
+			scan_state.position_in_entry = 0;
+		}
+		run_start = run_end;
+	}
+	selection.Finalize(approved_tuple_count);
 }
 
 //===--------------------------------------------------------------------===//
@@ -344,7 +408,8 @@ template <class T>
 CompressionFunction GetRLEFunction(PhysicalType data_type) {
 	return CompressionFunction(CompressionType::COMPRESSION_RLE, data_type, RLEInitAnalyze<T>, RLEAnalyze<T>,
 	                           RLEFinalAnalyze<T>, RLEInitCompression<T>, RLECompress<T>, RLEFinalizeCompress<T>,
-	                           RLEInitScan<T>, RLEScan<T>, RLEScanPartial<T>, RLEFetchRow<T>, RLESkip<T>);
+	                           RLEInitScan<T>, RLEScan<T>, RLEScanPartial<T>, RLEFetchRow<T>, RLESkip<T>, nullptr,
+	                           nullptr, nullptr, nullptr, RLEFilter<T>);
 }
 
 CompressionFunction RLEFun::GetFunction(PhysicalType type) {
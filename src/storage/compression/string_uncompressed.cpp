@@ -23,19 +23,6 @@ UncompressedStringSegmentState::~UncompressedStringSegmentState() {
 	}
 }
 
-struct StringDictionaryContainer {
-	//! The size of the dictionary
-	uint32_t size;
-	//! The end of the dictionary (typically Storage::BLOCK_SIZE)
-	uint32_t end;
-
-	void Verify() {
-		D_ASSERT(size <= Storage::BLOCK_SIZE);
-		D_ASSERT(end <= Storage::BLOCK_SIZE);
-		D_ASSERT(size <= end);
-	}
-};
-
 struct UncompressedStringStorage {
 public:
 	//! Dictionary header size at the beginning of the string segment (offset + length)
@@ -332,12 +332,42 @@ void ValidityScanPartial(ColumnSegment &segment, ColumnScanState &state, idx_t s
 #endif
 }
 
+//! Returns whether or not all rows in the range [start, start + count) of the validity segment are valid
+static bool ValidityRangeIsValid(validity_t *input_data, idx_t start, idx_t count) {
+	ValidityMask input_mask(input_data);
+	idx_t i = 0;
+	while (i < count) {
+		auto row_idx = start + i;
+		if (row_idx % ValidityMask::BITS_PER_VALUE == 0 && count - i >= ValidityMask::BITS_PER_VALUE) {
+			// check an entire validity entry at once
+			if (input_data[row_idx / ValidityMask::BITS_PER_VALUE] != ValidityMask::ValidityBuffer::MAX_ENTRY) {
+				return false;
+			}
+			i += ValidityMask::BITS_PER_VALUE;
+		} else {
+			if (!input_mask.RowIsValidUnsafe(row_idx)) {
+				return false;
+			}
+			i++;
+		}
+	}
+	return true;
+}
+
 void ValidityScan(ColumnSegment &segment, ColumnScanState &state, idx_t scan_count, Vector &result) {
+	auto &scan_state = (ValidityScanState &)*state.scan_state;
+	auto start = segment.GetRelativeIndex(state.row_index);
+	if (result.GetVectorType() != VectorType::FLAT_VECTOR) {
+		// the base data was emitted as a constant or dictionary vector
+		// if there are no NULL values in this range we don't need to flatten it
+		auto input_data = (validity_t *)(scan_state.handle->node->buffer + segment.GetBlockOffset());
+		if (ValidityRangeIsValid(input_data, start, scan_count)) {
+			return;
+		}
+	}
 	result.Normalify(scan_count);
 
-	auto start = segment.GetRelativeIndex(state.row_index);
 	if (start % ValidityMask::BITS_PER_VALUE == 0) {
-		auto &scan_state = (ValidityScanState &)*state.scan_state;
 
 		// aligned scan: no need to do anything fancy
 		// note: this is only an optimization which avoids having to do messy bitshifting in the common case
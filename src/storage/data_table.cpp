@@ -394,9 +394,13 @@ void DataTable::Fetch(Transaction &transaction, DataChunk &result, const vector<
 	// figure out which row_group to fetch from
 	auto row_ids = FlatVector::GetData<row_t>(row_identifiers);
 	idx_t count = 0;
+	RowGroup *row_group = nullptr;
 	for (idx_t i = 0; i < fetch_count; i++) {
 		auto row_id = row_ids[i];
-		auto row_group = (RowGroup *)row_groups->GetSegment(row_id);
+		// consecutive row ids are often in the same row group: only search the row group if they are not
+		if (!row_group || idx_t(row_id) < row_group->start || idx_t(row_id) >= row_group->start + row_group->count) {
+			row_group = (RowGroup *)row_groups->GetSegment(row_id);
+		}
 		if (!row_group->Fetch(transaction, row_id - row_group->start)) {
 			continue;
 		}
@@ -690,14 +694,23 @@ bool DataTable::AppendToIndexes(TableAppendState &state, DataChunk &chunk, row_t
 	vector<Index *> already_appended;
 	bool append_failed = false;
 	// now append the entries to the indices
-	info->indexes.Scan([&](Index &index) {
-		if (!index.Append(chunk, row_identifiers)) {
-			append_failed = true;
-			return true;
+	try {
+		info->indexes.Scan([&](Index &index) {
+			if (!index.Append(chunk, row_identifiers)) {
+				append_failed = true;
+				return true;
+			}
+			already_appended.push_back(&index);
+			return false;
+		});
+	} catch (...) {
+		// an index could not append the entries (e.g. because it ran out of memory)
+		// the failing index has already removed its own entries: remove the entries from the previous indexes
+		for (auto *index : already_appended) {
+			index->Delete(chunk, row_identifiers);
 		}
-		already_appended.push_back(&index);
-		return false;
-	});
+		throw;
+	}
 
 	if (append_failed) {
 		// constraint violation!
@@ -1045,6 +1058,7 @@ void DataTable::AddIndex(unique_ptr<Index> index, const vector<unique_ptr<Expres
 		IndexLock lock;
 		index->InitializeLock(lock);
 		ExpressionExecutor executor(expressions);
+		auto construct_state = index->InitializeConstruct();
 		while (true) {
 			intermediate.Reset();
 			// scan a new chunk from the table to index
@@ -1058,11 +1072,15 @@ void DataTable::AddIndex(unique_ptr<Index> index, const vector<unique_ptr<Expres
 			executor.Execute(intermediate, result);
 
 			// insert into the index
-			if (!index->Insert(lock, result, intermediate.data[intermediate.ColumnCount() - 1])) {
+			if (!index->ConstructAppend(lock, *construct_state, result,
+			                            intermediate.data[intermediate.ColumnCount() - 1])) {
 				throw ConstraintException(
 				    "Cant create unique index, table contains duplicate data on indexed column(s)");
 			}
 		}
+		if (!index->ConstructFinalize(lock, *construct_state)) {
+			throw ConstraintException("Cant create unique index, table contains duplicate data on indexed column(s)");
+		}
 	}
 	info->indexes.AddIndex(move(index));
 }
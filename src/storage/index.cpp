@@ -41,6 +41,18 @@ void Index::Delete(DataChunk &entries, Vector &row_identifiers) {
 	Delete(state, entries, row_identifiers);
 }
 
+unique_ptr<IndexConstructState> Index::InitializeConstruct() {
+	return make_unique<IndexConstructState>();
+}
+
+bool Index::ConstructAppend(IndexLock &lock, IndexConstructState &state, DataChunk &input, Vector &row_identifiers) {
+	return Insert(lock, input, row_identifiers);
+}
+
+bool Index::ConstructFinalize(IndexLock &lock, IndexConstructState &state) {
+	return true;
+}
+
 void Index::ExecuteExpressions(DataChunk &input, DataChunk &result) {
 	executor.Execute(input, result);
 }
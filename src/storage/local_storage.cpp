@@ -72,7 +72,7 @@ void LocalTableStorage::Clear() {
 			for (auto &expr : art.unbound_expressions) {
 				unbound_expressions.push_back(expr->Copy());
 			}
-			indexes.push_back(make_unique<ART>(art.column_ids, move(unbound_expressions), true));
+			indexes.push_back(make_unique<ART>(art.column_ids, move(unbound_expressions), table.db, true));
 		}
 		return false;
 	});
@@ -374,34 +374,47 @@ void LocalStorage::Flush(DataTable &table, LocalTableStorage &storage) {
 	TableAppendState append_state;
 	table.InitializeAppend(transaction, append_state, append_count);
 
-	bool constraint_violated = false;
-	ScanTableStorage(table, storage, [&](DataChunk &chunk) -> bool {
-		// append this chunk to the indexes of the table
-		if (!table.AppendToIndexes(append_state, chunk, append_state.current_row)) {
-			constraint_violated = true;
-			return false;
-		}
-		// append to base table
-		table.Append(transaction, chunk, append_state);
-		return true;
-	});
-	if (constraint_violated) {
-		// need to revert the append
+	// the end of the rows that have been appended to the indexes, the base table can lag behind if its append fails
+	row_t index_append_end = append_state.row_start;
+	auto revert_append = [&]() {
 		row_t current_row = append_state.row_start;
 		// remove the data from the indexes, if there are any indexes
 		ScanTableStorage(table, storage, [&](DataChunk &chunk) -> bool {
-			// append this chunk to the indexes of the table
-			table.RemoveFromIndexes(append_state, chunk, current_row);
-
-			current_row += chunk.size();
-			if (current_row >= append_state.current_row) {
+			if (current_row >= index_append_end) {
 				// finished deleting all rows from the index: abort now
 				return false;
 			}
+			// remove this chunk from the indexes of the table
+			table.RemoveFromIndexes(append_state, chunk, current_row);
+
+			current_row += chunk.size();
 			return true;
 		});
 		table.RevertAppendInternal(append_state.row_start, append_count);
 		storage.Clear();
+	};
+
+	bool constraint_violated = false;
+	try {
+		ScanTableStorage(table, storage, [&](DataChunk &chunk) -> bool {
+			// append this chunk to the indexes of the table
+			if (!table.AppendToIndexes(append_state, chunk, append_state.current_row)) {
+				constraint_violated = true;
+				return false;
+			}
+			index_append_end = append_state.current_row + chunk.size();
+			// append to base table
+			table.Append(transaction, chunk, append_state);
+			return true;
+		});
+	} catch (...) {
+		// the append failed (e.g. because it ran out of memory): revert the rows that were appended so far
+		revert_append();
+		throw;
+	}
+	if (constraint_violated) {
+		// need to revert the append
+		revert_append();
 		throw ConstraintException("PRIMARY KEY or UNIQUE constraint violated: duplicated key");
 	}
 	storage.Clear();
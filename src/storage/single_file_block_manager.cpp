@@ -216,6 +216,11 @@ bool SingleFileBlockManager::IsRootBlock(block_id_t root) {
 }
 
 block_id_t SingleFileBlockManager::GetFreeBlockId() {
+	lock_guard<mutex> lock(block_lock);
+	return GetFreeBlockIdInternal();
+}
+
+block_id_t SingleFileBlockManager::GetFreeBlockIdInternal() {
 	block_id_t block;
 	if (!free_list.empty()) {
 		// free list is non empty
@@ -231,6 +236,7 @@ block_id_t SingleFileBlockManager::GetFreeBlockId() {
 
 void SingleFileBlockManager::MarkBlockAsModified(block_id_t block_id) {
 	D_ASSERT(block_id >= 0);
+	lock_guard<mutex> lock(block_lock);
 
 	// check if the block is a multi-use block
 	auto entry = multi_use_blocks.find(block_id);
@@ -248,6 +254,7 @@ void SingleFileBlockManager::MarkBlockAsModified(block_id_t block_id) {
 }
 
 void SingleFileBlockManager::IncreaseBlockReferenceCount(block_id_t block_id) {
+	lock_guard<mutex> lock(block_lock);
 	D_ASSERT(free_list.find(block_id) == free_list.end());
 	auto entry = multi_use_blocks.find(block_id);
 	if (entry != multi_use_blocks.end()) {
@@ -300,7 +307,7 @@ vector<block_id_t> SingleFileBlockManager::GetFreeListBlocks() {
 		// reserve the blocks that we are going to write
 		// since these blocks are no longer free we cannot just include them in the free list!
 		for (idx_t i = 0; i < total_blocks; i++) {
-			auto block_id = GetFreeBlockId();
+			auto block_id = GetFreeBlockIdInternal();
 			free_list_blocks.push_back(block_id);
 		}
 	}
@@ -331,6 +338,7 @@ void SingleFileBlockManager::WriteHeader(DatabaseHeader header) {
 	// set the iteration count
 	header.iteration = ++iteration_count;
 
+	lock_guard<mutex> lock(block_lock);
 	vector<block_id_t> free_list_blocks = GetFreeListBlocks();
 
 	// now handle the free list
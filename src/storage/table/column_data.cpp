@@ -159,6 +159,51 @@ void ColumnData::Select(Transaction &transaction, idx_t vector_index, ColumnScan
 	ColumnSegment::FilterSelection(sel, result, filter, count, FlatVector::Validity(result));
 }
 
+bool ColumnData::FilterCompressedVector(ColumnScanState &state, Vector &result, SelectionVector &sel, idx_t &count,
+                                        const TableFilter &filter) {
+	if (!state.current) {
+		return false;
+	}
+	{
+		// updates have to be merged into the scanned vector before the filter can be evaluated
+		lock_guard<mutex> update_guard(update_lock);
+		if (updates) {
+			return false;
+		}
+	}
+	auto segment = state.current;
+	if (state.row_index == segment->start + segment->count) {
+		// the current segment is exhausted: the vector starts at the beginning of the next segment
+		if (!segment->next) {
+			return false;
+		}
+		segment = (ColumnSegment *)segment->next.get();
+	}
+	// the filter can only be evaluated if the entire vector lies within a single segment
+	idx_t scan_count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, segment->start + segment->count - state.row_index);
+	if ((scan_count < STANDARD_VECTOR_SIZE && segment->next) || !segment->SupportsFilter(filter)) {
+		return false;
+	}
+	if (segment != state.current) {
+		state.current = segment;
+		state.initialized = false;
+		state.segment_checked = false;
+	}
+	if (!state.initialized) {
+		state.current->InitializeScan(state);
+		state.internal_index = state.current->start;
+		state.initialized = true;
+	}
+	if (state.internal_index < state.row_index) {
+		state.current->Skip(state);
+	}
+	D_ASSERT(state.current->type == type);
+	state.current->Filter(state, scan_count, result, sel, count, filter);
+	state.row_index += scan_count;
+	state.internal_index = state.row_index;
+	return true;
+}
+
 void ColumnData::FilterScan(Transaction &transaction, idx_t vector_index, ColumnScanState &state, Vector &result,
                             SelectionVector &sel, idx_t count) {
 	Scan(transaction, vector_index, state, result);
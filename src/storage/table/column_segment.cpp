@@ -9,8 +9,10 @@
 #include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/planner/filter/conjunction_filter.hpp"
 #include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/dynamic_filter.hpp"
 #include "duckdb/planner/filter/null_filter.hpp"
 #include "duckdb/main/config.hpp"
+#include "duckdb/function/compression/compressed_filter.hpp"
 
 #include <cstring>
 
@@ -99,6 +101,19 @@ void ColumnSegment::ScanPartial(ColumnScanState &state, idx_t scan_count, Vector
 	function->scan_partial(*this, state, scan_count, result, result_offset);
 }
 
+//===--------------------------------------------------------------------===//
+// Compressed Filter
+//===--------------------------------------------------------------------===//
+bool ColumnSegment::SupportsFilter(const TableFilter &filter) {
+	return function->filter && CompressedFilter::IsSupported(filter);
+}
+
+void ColumnSegment::Filter(ColumnScanState &state, idx_t scan_count, Vector &result, SelectionVector &sel,
+                           idx_t &approved_tuple_count, const TableFilter &filter) {
+	D_ASSERT(SupportsFilter(filter));
+	function->filter(*this, state, scan_count, result, sel, approved_tuple_count, filter);
+}
+
 //===--------------------------------------------------------------------===//
 // Fetch
 //===--------------------------------------------------------------------===//
@@ -408,6 +423,20 @@ void ColumnSegment::FilterSelection(SelectionVector &sel, Vector &result, const
 	case TableFilterType::IS_NOT_NULL:
 		TemplatedNullSelection<false>(sel, approved_tuple_count, mask);
 		break;
+	case TableFilterType::DYNAMIC_FILTER: {
+		auto &data = *((DynamicFilter &)filter).data;
+		if (!data.initialized) {
+			// the hash join has not finished its build side: all rows pass
+			break;
+		}
+		if (data.range_filter) {
+			FilterSelection(sel, result, *data.range_filter, approved_tuple_count, mask);
+		}
+		if (data.HasBloomFilter()) {
+			data.FilterBloom(result, sel, approved_tuple_count, mask);
+		}
+		break;
+	}
 	default:
 		throw InternalException("FIXME: unsupported type for filter selection");
 	}
@@ -107,6 +107,11 @@ idx_t ListColumnData::ScanCount(ColumnScanState &state, Vector &result, idx_t co
 		D_ASSERT(child_entry.GetType().InternalType() == PhysicalType::STRUCT ||
 		         state.child_states[1].row_index + child_scan_count <= child_column->GetMaxEntry());
 		child_column->ScanCount(state.child_states[1], child_entry, child_scan_count);
+		if (child_entry.GetVectorType() != VectorType::FLAT_VECTOR) {
+			// compressed segments can emit constant or dictionary vectors, which are not supported as the child of a
+			// list
+			child_entry.Normalify(child_scan_count);
+		}
 	}
 
 	ListVector::SetListSize(result, child_scan_count);
@@ -67,6 +67,35 @@ idx_t StandardColumnData::ScanCommitted(idx_t vector_index, ColumnScanState &sta
 	return scan_count;
 }
 
+void StandardColumnData::Select(Transaction &transaction, idx_t vector_index, ColumnScanState &state, Vector &result,
+                                SelectionVector &sel, idx_t &count, const TableFilter &filter) {
+	D_ASSERT(state.row_index == state.child_states[0].row_index);
+	if (!FilterCompressedVector(state, result, sel, count, filter)) {
+		ColumnData::Select(transaction, vector_index, state, result, sel, count, filter);
+		return;
+	}
+	// the filter was evaluated on the compressed base data: scan the validity and remove any NULL values
+	validity.Scan(transaction, vector_index, state.child_states[0], result);
+	if (count == 0) {
+		return;
+	}
+	VectorData vdata;
+	result.Orrify(STANDARD_VECTOR_SIZE, vdata);
+	if (vdata.validity.AllValid()) {
+		return;
+	}
+	SelectionVector new_sel(count);
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = sel.get_index(i);
+		if (vdata.validity.RowIsValid(vdata.sel->get_index(idx))) {
+			new_sel.set_index(result_count++, idx);
+		}
+	}
+	sel.Initialize(new_sel);
+	count = result_count;
+}
+
 idx_t StandardColumnData::ScanCount(ColumnScanState &state, Vector &result, idx_t count) {
 	auto scan_count = ColumnData::ScanCount(state, result, count);
 	validity.ScanCount(state.child_states[0], result, count);
@@ -65,11 +65,19 @@ void StructColumnData::InitializeScanWithOffset(ColumnScanState &state, idx_t ro
 	}
 }
 
+static void FlattenDictionaryChild(Vector &child, idx_t count) {
+	// compressed segments can emit dictionary vectors, which are not supported as children of a struct
+	if (child.GetVectorType() == VectorType::DICTIONARY_VECTOR) {
+		child.Normalify(count);
+	}
+}
+
 idx_t StructColumnData::Scan(Transaction &transaction, idx_t vector_index, ColumnScanState &state, Vector &result) {
 	auto scan_count = validity.Scan(transaction, vector_index, state.child_states[0], result);
 	auto &child_entries = StructVector::GetEntries(result);
 	for (idx_t i = 0; i < sub_columns.size(); i++) {
 		sub_columns[i]->Scan(transaction, vector_index, state.child_states[i + 1], *child_entries[i]);
+		FlattenDictionaryChild(*child_entries[i], scan_count);
 	}
 	return scan_count;
 }
@@ -79,6 +87,7 @@ idx_t StructColumnData::ScanCommitted(idx_t vector_index, ColumnScanState &state
 	auto &child_entries = StructVector::GetEntries(result);
 	for (idx_t i = 0; i < sub_columns.size(); i++) {
 		sub_columns[i]->ScanCommitted(vector_index, state.child_states[i + 1], *child_entries[i], allow_updates);
+		FlattenDictionaryChild(*child_entries[i], scan_count);
 	}
 	return scan_count;
 }
@@ -88,6 +97,7 @@ idx_t StructColumnData::ScanCount(ColumnScanState &state, Vector &result, idx_t
 	auto &child_entries = StructVector::GetEntries(result);
 	for (idx_t i = 0; i < sub_columns.size(); i++) {
 		sub_columns[i]->ScanCount(state.child_states[i + 1], *child_entries[i], count);
+		FlattenDictionaryChild(*child_entries[i], scan_count);
 	}
 	return scan_count;
 }
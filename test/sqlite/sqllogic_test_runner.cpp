@@ -146,6 +146,10 @@ bool SQLLogicTestRunner::ForEachTokenReplace(const string &parameter, vector<str
 		result.push_back("uncompressed");
 		result.push_back("rle");
 		result.push_back("bitpacking");
+		result.push_back("pfor");
+		result.push_back("dictionary");
+		result.push_back("fsst");
+		result.push_back("chimp");
 		collection = true;
 	}
 	return collection;